@@ -5,11 +5,14 @@
 #include <nano/lib/utility.hpp>
 #include <nano/lib/work.hpp>
 #include <nano/node/common.hpp>
+#include <nano/secure/block_cache.hpp>
 #include <nano/secure/ledger.hpp>
+#include <nano/secure/membership_filter.hpp>
 #include <nano/secure/utility.hpp>
 #include <nano/secure/versioning.hpp>
 
 #include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
 
 #if NANO_ROCKSDB
 #include <nano/node/rocksdb/rocksdb.hpp>
@@ -21,6 +24,7 @@
 #include <gtest/gtest.h>
 
 #include <fstream>
+#include <thread>
 #include <unordered_set>
 
 #include <stdlib.h>
@@ -134,6 +138,346 @@ TEST (block_store, add_item)
 	ASSERT_EQ (nullptr, latest3);
 }
 
+TEST (membership_filter, rebuild)
+{
+	nano::membership_filter filter;
+	nano::uint256_union key1 (1);
+	nano::uint256_union key2 (2);
+	nano::uint256_union key3 (3);
+	ASSERT_TRUE (filter.may_contain (key1));
+	filter.rebuild_begin (16);
+	filter.rebuild_insert (key1);
+	// Inserts while rebuilding go to the new generation as well
+	filter.insert (key2);
+	filter.rebuild_end ();
+	ASSERT_TRUE (filter.may_contain (key1));
+	ASSERT_TRUE (filter.may_contain (key2));
+	ASSERT_FALSE (filter.may_contain (key3));
+	// Keys inserted before a rebuild started are only kept if the rebuild inserts them
+	filter.rebuild_begin (16);
+	filter.rebuild_insert (key2);
+	filter.rebuild_end ();
+	ASSERT_FALSE (filter.may_contain (key1));
+	ASSERT_TRUE (filter.may_contain (key2));
+}
+
+/**
+ * Writers insert keys while holding a lock and add them to a table, rebuilds wait for that lock after starting and then read the table, like membership_filters_build.
+ * Every key must survive the rebuilds no matter where they interleave with the inserts.
+ */
+TEST (membership_filter, rebuild_concurrent_insert)
+{
+	nano::membership_filter filter;
+	std::mutex table_mutex;
+	std::vector<nano::uint256_union> table;
+	uint64_t const key_count (100000);
+	std::atomic<uint64_t> key_counter{ 0 };
+	std::vector<std::thread> writers;
+	for (auto i (0); i < 2; ++i)
+	{
+		writers.emplace_back ([&]() {
+			for (auto key_number (++key_counter); key_number <= key_count; key_number = ++key_counter)
+			{
+				nano::uint256_union key (key_number);
+				nano::lock_guard<std::mutex> lock (table_mutex);
+				filter.insert (key);
+				table.push_back (key);
+			}
+		});
+	}
+	while (key_counter < key_count)
+	{
+		filter.rebuild_begin (key_count);
+		std::vector<nano::uint256_union> snapshot;
+		{
+			nano::lock_guard<std::mutex> lock (table_mutex);
+			snapshot = table;
+		}
+		for (auto const & key : snapshot)
+		{
+			filter.rebuild_insert (key);
+		}
+		filter.rebuild_end ();
+	}
+	for (auto & writer : writers)
+	{
+		writer.join ();
+	}
+	for (auto const & key : table)
+	{
+		ASSERT_TRUE (filter.may_contain (key));
+	}
+}
+
+TEST (block_store, membership_filters)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::open_block block1 (0, 1, 0, nano::keypair ().prv, 0, 0);
+	block1.sideband_set ({});
+	nano::pending_key pending1 (2, 3);
+	{
+		auto transaction (store->tx_begin_write ());
+		store->block_put (transaction, block1.hash (), block1);
+		store->pending_put (transaction, pending1, nano::pending_info ());
+	}
+	std::atomic<bool> stopped{ false };
+	ASSERT_TRUE (store->membership_filters_stale ());
+	ASSERT_FALSE (store->membership_filters_build (stopped));
+	ASSERT_FALSE (store->membership_filters_stale ());
+	ASSERT_NE (0, store->membership_filters_size ());
+	auto transaction (store->tx_begin_write ());
+	ASSERT_TRUE (store->block_exists (transaction, block1.hash ()));
+	ASSERT_FALSE (store->block_exists (transaction, block1.hash ().number () - 1));
+	ASSERT_TRUE (store->pending_exists (transaction, pending1));
+	ASSERT_FALSE (store->pending_exists (transaction, nano::pending_key (2, 4)));
+	// Entries put after the build are added to the filters
+	nano::open_block block2 (0, 2, 0, nano::keypair ().prv, 0, 0);
+	block2.sideband_set ({});
+	store->block_put (transaction, block2.hash (), block2);
+	ASSERT_TRUE (store->block_exists (transaction, block2.hash ()));
+	ASSERT_NE (nullptr, store->block_get (transaction, block2.hash ()));
+	nano::pending_key pending2 (4, 5);
+	store->pending_put (transaction, pending2, nano::pending_info ());
+	ASSERT_TRUE (store->pending_exists (transaction, pending2));
+	// Deleted entries stay in the filters until the next build, the tables still answer for them
+	store->block_del (transaction, block1.hash (), block1.type ());
+	ASSERT_FALSE (store->block_exists (transaction, block1.hash ()));
+	store->pending_del (transaction, pending1);
+	ASSERT_FALSE (store->pending_exists (transaction, pending1));
+}
+
+TEST (block_store, membership_filters_checkpoint)
+{
+	nano::logger_mt logger;
+	auto path (nano::unique_path ());
+	nano::open_block block1 (0, 1, 0, nano::keypair ().prv, 0, 0);
+	block1.sideband_set ({});
+	nano::pending_key pending1 (2, 3);
+	{
+		nano::mdb_store store (logger, path);
+		ASSERT_FALSE (store.init_error ());
+		auto transaction (store.tx_begin_write ());
+		store.block_put (transaction, block1.hash (), block1);
+		store.pending_put (transaction, pending1, nano::pending_info ());
+		// Filters which were never built aren't stored
+		store.membership_filters_checkpoint (transaction);
+		ASSERT_TRUE (store.membership_filters_checkpoint_load (transaction));
+	}
+	{
+		nano::mdb_store store (logger, path);
+		ASSERT_FALSE (store.init_error ());
+		std::atomic<bool> stopped{ false };
+		ASSERT_FALSE (store.membership_filters_build (stopped));
+		store.membership_filters_checkpoint (store.tx_begin_write ());
+	}
+	{
+		nano::mdb_store store (logger, path);
+		ASSERT_FALSE (store.init_error ());
+		ASSERT_TRUE (store.membership_filters_stale ());
+		auto transaction (store.tx_begin_write ());
+		ASSERT_FALSE (store.membership_filters_checkpoint_load (transaction));
+		ASSERT_FALSE (store.membership_filters_stale ());
+		ASSERT_TRUE (store.block_exists (transaction, block1.hash ()));
+		ASSERT_TRUE (store.pending_exists (transaction, pending1));
+		// Loading deletes the stored filters since they won't contain keys put from here on
+		nano::open_block block2 (0, 2, 0, nano::keypair ().prv, 0, 0);
+		block2.sideband_set ({});
+		store.block_put (transaction, block2.hash (), block2);
+		ASSERT_TRUE (store.block_exists (transaction, block2.hash ()));
+	}
+	{
+		nano::mdb_store store (logger, path);
+		ASSERT_FALSE (store.init_error ());
+		ASSERT_TRUE (store.membership_filters_checkpoint_load (store.tx_begin_write ()));
+		ASSERT_TRUE (store.membership_filters_stale ());
+		std::atomic<bool> stopped{ false };
+		ASSERT_FALSE (store.membership_filters_build (stopped));
+		store.membership_filters_checkpoint (store.tx_begin_write ());
+	}
+	// Deleting without loading, as done by a run with the filters disabled
+	nano::mdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_write ());
+	store.membership_filters_checkpoint_del (transaction);
+	ASSERT_TRUE (store.membership_filters_checkpoint_load (transaction));
+	ASSERT_TRUE (store.membership_filters_stale ());
+}
+
+TEST (block_store, block_cache)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	auto & cache (store->block_cache_get ());
+	cache.capacity_set (1024);
+	nano::keypair key1;
+	nano::open_block open (0, 1, key1.pub, key1.prv, key1.pub, 0);
+	open.sideband_set (nano::block_sideband (key1.pub, 0, 2, 1, 3, nano::epoch::epoch_0, false, false, false));
+	nano::keypair key2;
+	nano::open_block other (0, 1, key2.pub, key2.prv, key2.pub, 0);
+	other.sideband_set (nano::block_sideband (key2.pub, 0, 2, 1, 3, nano::epoch::epoch_0, false, false, false));
+	{
+		auto transaction (store->tx_begin_write ());
+		store->block_put (transaction, open.hash (), open);
+		store->block_put (transaction, other.hash (), other);
+		// Blocks aren't cached before the transaction writing them commits
+		ASSERT_NE (nullptr, store->block_get (transaction, open.hash ()));
+		ASSERT_EQ (0, cache.size ());
+	}
+	auto transaction (store->tx_begin_read ());
+	auto block1 (store->block_get (transaction, open.hash ()));
+	ASSERT_EQ (1, cache.size ());
+	auto block2 (store->block_get (transaction, open.hash ()));
+	ASSERT_EQ (block1, block2);
+	ASSERT_EQ (1, cache.hits.load ());
+	ASSERT_EQ (2, cache.misses.load ());
+	ASSERT_NE (nullptr, store->block_get (transaction, other.hash ()));
+	ASSERT_EQ (2, cache.size ());
+	// Putting a successor rewrites the sideband of the previous block, readers with an older snapshot bypass the cache for it
+	nano::send_block send (open.hash (), 4, 1, key1.prv, key1.pub, 0);
+	send.sideband_set (nano::block_sideband (key1.pub, 0, 1, 2, 5, nano::epoch::epoch_0, false, false, false));
+	{
+		auto write (store->tx_begin_write ());
+		store->block_put (write, send.hash (), send);
+	}
+	ASSERT_EQ (1, cache.size ());
+	ASSERT_TRUE (store->block_get (transaction, open.hash ())->sideband ().successor.is_zero ());
+	ASSERT_EQ (1, cache.size ());
+	ASSERT_EQ (nullptr, store->block_get (transaction, send.hash ()));
+	// Blocks the commit didn't touch are still served to the older snapshot
+	auto hits (cache.hits.load ());
+	ASSERT_NE (nullptr, store->block_get (transaction, other.hash ()));
+	ASSERT_EQ (hits + 1, cache.hits.load ());
+	transaction.refresh ();
+	ASSERT_EQ (send.hash (), store->block_get (transaction, open.hash ())->sideband ().successor);
+	ASSERT_NE (nullptr, store->block_get (transaction, send.hash ()));
+	ASSERT_EQ (3, cache.size ());
+	// Rolling back drops both blocks
+	{
+		auto write (store->tx_begin_write ());
+		store->block_del (write, send.hash (), send.type ());
+		store->block_successor_clear (write, open.hash ());
+	}
+	ASSERT_EQ (1, cache.size ());
+	transaction.refresh ();
+	ASSERT_EQ (nullptr, store->block_get (transaction, send.hash ()));
+	ASSERT_TRUE (store->block_get (transaction, open.hash ())->sideband ().successor.is_zero ());
+	// A capacity of 0 disables the cache
+	cache.capacity_set (0);
+	ASSERT_EQ (0, cache.size ());
+	ASSERT_NE (nullptr, store->block_get (transaction, open.hash ()));
+	ASSERT_EQ (0, cache.size ());
+}
+
+TEST (block_store, block_view)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::keypair key1;
+	// Putting each block sets the successor of its previous block
+	nano::open_block open (16, 17, key1.pub, key1.prv, key1.pub, 18);
+	open.sideband_set (nano::block_sideband (key1.pub, 0, 20, 1, 21, nano::epoch::epoch_0, false, false, false));
+	nano::state_block state (key1.pub, open.hash (), 2, 3, 4, key1.prv, key1.pub, 5);
+	state.sideband_set (nano::block_sideband (key1.pub, 0, 3, 2, 8, nano::epoch::epoch_1, true, false, false));
+	nano::send_block send (state.hash (), 10, 11, key1.prv, key1.pub, 12);
+	send.sideband_set (nano::block_sideband (key1.pub, 0, 11, 3, 15, nano::epoch::epoch_0, false, false, false));
+	auto transaction (store->tx_begin_write ());
+	ASSERT_FALSE (store->block_view_get (transaction, state.hash ()).exists ());
+	store->block_put (transaction, open.hash (), open);
+	store->block_put (transaction, state.hash (), state);
+	store->block_put (transaction, send.hash (), send);
+	auto state_view (store->block_view_get (transaction, state.hash ()));
+	ASSERT_TRUE (state_view.has_sideband ());
+	ASSERT_EQ (nano::block_type::state, state_view.type ());
+	ASSERT_EQ (key1.pub, state_view.account ());
+	ASSERT_EQ (open.hash (), state_view.previous ());
+	ASSERT_EQ (2, state_view.representative ().number ());
+	ASSERT_EQ (3, state_view.balance ().number ());
+	ASSERT_EQ (4, state_view.link ().number ());
+	ASSERT_EQ (send.hash (), state_view.successor ());
+	ASSERT_EQ (2, state_view.height ());
+	ASSERT_EQ (8, state_view.timestamp ());
+	ASSERT_EQ (state.sideband ().details, state_view.details ());
+	ASSERT_EQ (state, *state_view.block ());
+	auto send_view (store->block_view_get (transaction, send.hash ()));
+	ASSERT_EQ (state.hash (), send_view.previous ());
+	ASSERT_EQ (key1.pub, send_view.account ());
+	ASSERT_EQ (11, send_view.balance ().number ());
+	ASSERT_TRUE (send_view.successor ().is_zero ());
+	ASSERT_EQ (3, send_view.height ());
+	ASSERT_EQ (15, send_view.timestamp ());
+	auto open_view (store->block_view_get (transaction, open.hash ()));
+	ASSERT_TRUE (open_view.previous ().is_zero ());
+	ASSERT_EQ (16, open_view.source ().number ());
+	ASSERT_EQ (17, open_view.representative ().number ());
+	ASSERT_EQ (key1.pub, open_view.account ());
+	ASSERT_EQ (20, open_view.balance ().number ());
+	ASSERT_EQ (state.hash (), open_view.successor ());
+	ASSERT_EQ (1, open_view.height ());
+	ASSERT_EQ (21, open_view.timestamp ());
+	// Serialized view is the network format of the block
+	std::vector<uint8_t> bytes;
+	{
+		nano::vectorstream stream (bytes);
+		open_view.serialize (stream);
+	}
+	nano::bufferstream stream (bytes.data (), bytes.size ());
+	auto open_deserialized (nano::deserialize_block (stream));
+	ASSERT_NE (nullptr, open_deserialized);
+	ASSERT_EQ (open, *open_deserialized);
+}
+
+TEST (block_store, block_summary)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::keypair key1;
+	nano::open_block open (16, 17, key1.pub, key1.prv, key1.pub, 18);
+	open.sideband_set (nano::block_sideband (key1.pub, 0, 20, 1, 21, nano::epoch::epoch_0, false, false, false));
+	nano::state_block state (key1.pub, open.hash (), 2, 3, 4, key1.prv, key1.pub, 5);
+	state.sideband_set (nano::block_sideband (key1.pub, 0, 3, 2, 8, nano::epoch::epoch_1, true, false, false));
+	auto transaction (store->tx_begin_write ());
+	nano::block_summary summary;
+	ASSERT_TRUE (store->block_summary_get (transaction, open.hash (), summary));
+	store->block_put (transaction, open.hash (), open);
+	ASSERT_FALSE (store->block_summary_get (transaction, open.hash (), summary));
+	ASSERT_EQ (key1.pub, summary.account);
+	ASSERT_EQ (1, summary.height);
+	ASSERT_EQ (20, summary.balance.number ());
+	ASSERT_TRUE (summary.successor.is_zero ());
+	// Putting the next block updates the successor in the summary of its previous block
+	store->block_put (transaction, state.hash (), state);
+	ASSERT_FALSE (store->block_summary_get (transaction, open.hash (), summary));
+	ASSERT_EQ (state.hash (), summary.successor);
+	ASSERT_EQ (state.hash (), store->block_successor (transaction, open.hash ()));
+	ASSERT_FALSE (store->block_summary_get (transaction, state.hash (), summary));
+	ASSERT_EQ (nano::block_summary (store->block_view_get (transaction, state.hash ())), summary);
+	ASSERT_EQ (2, store->block_account_height (transaction, state.hash ()));
+	ASSERT_EQ (3, store->block_balance (transaction, state.hash ()));
+	ASSERT_EQ (key1.pub, store->block_account (transaction, state.hash ()));
+	ASSERT_EQ (nano::epoch::epoch_1, store->block_version (transaction, state.hash ()));
+	store->block_successor_clear (transaction, open.hash ());
+	ASSERT_FALSE (store->block_summary_get (transaction, open.hash (), summary));
+	ASSERT_TRUE (summary.successor.is_zero ());
+	store->block_del (transaction, state.hash (), state.type ());
+	ASSERT_TRUE (store->block_summary_get (transaction, state.hash (), summary));
+	// Serialized summaries have a fixed width
+	std::vector<uint8_t> bytes;
+	{
+		nano::vectorstream stream (bytes);
+		summary.serialize (stream);
+	}
+	ASSERT_EQ (nano::block_summary::size, bytes.size ());
+	nano::bufferstream stream (bytes.data (), bytes.size ());
+	nano::block_summary summary1;
+	ASSERT_FALSE (summary1.deserialize (stream));
+	ASSERT_EQ (summary, summary1);
+}
+
 TEST (block_store, clear_successor)
 {
 	nano::logger_mt logger;
@@ -256,6 +600,113 @@ TEST (block_store, add_pending)
 	ASSERT_TRUE (store->pending_get (transaction, key2, pending2));
 }
 
+TEST (block_store, batch_get)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::keypair key1;
+	nano::open_block open (0, 1, key1.pub, key1.prv, key1.pub, 0);
+	open.sideband_set (nano::block_sideband (key1.pub, 0, 10, 1, 2, nano::epoch::epoch_0, false, false, false));
+	nano::state_block state (key1.pub, open.hash (), key1.pub, 5, 4, key1.prv, key1.pub, 0);
+	state.sideband_set (nano::block_sideband (key1.pub, 0, 5, 2, 3, nano::epoch::epoch_0, true, false, false));
+	nano::account_info info (state.hash (), key1.pub, open.hash (), 5, 3, 2, nano::epoch::epoch_0);
+	nano::pending_key pending_key (key1.pub, state.hash ());
+	nano::pending_info pending (key1.pub, 5, nano::epoch::epoch_0);
+	{
+		auto transaction (store->tx_begin_write ());
+		store->block_put (transaction, open.hash (), open);
+		store->block_put (transaction, state.hash (), state);
+		store->confirmation_height_put (transaction, key1.pub, { 0, nano::block_hash (0) });
+		store->account_put (transaction, key1.pub, info);
+		store->pending_put (transaction, pending_key, pending);
+		// Lookups in a write transaction see its own writes
+		auto blocks (store->blocks_get (transaction, { state.hash (), open.hash () }));
+		ASSERT_EQ (2, blocks.size ());
+		ASSERT_EQ (state, *blocks[0]);
+		ASSERT_EQ (open, *blocks[1]);
+	}
+	auto transaction (store->tx_begin_read ());
+	// Results are in the order of the keys, including missing and repeated ones
+	auto blocks (store->blocks_get (transaction, { nano::block_hash (1), state.hash (), open.hash (), state.hash () }));
+	ASSERT_EQ (4, blocks.size ());
+	ASSERT_EQ (nullptr, blocks[0]);
+	ASSERT_EQ (state, *blocks[1]);
+	ASSERT_EQ (state.sideband ().height, blocks[1]->sideband ().height);
+	ASSERT_EQ (open, *blocks[2]);
+	ASSERT_EQ (state.hash (), blocks[2]->sideband ().successor);
+	ASSERT_EQ (state, *blocks[3]);
+	ASSERT_TRUE (store->blocks_get (transaction, {}).empty ());
+	auto accounts (store->accounts_get (transaction, { nano::keypair ().pub, key1.pub }));
+	ASSERT_EQ (2, accounts.size ());
+	ASSERT_FALSE (accounts[0]);
+	ASSERT_TRUE (accounts[1]);
+	ASSERT_EQ (info, *accounts[1]);
+	auto pendings (store->pending_get_many (transaction, { pending_key, nano::pending_key (key1.pub, open.hash ()) }));
+	ASSERT_EQ (2, pendings.size ());
+	ASSERT_TRUE (pendings[0]);
+	ASSERT_EQ (pending, *pendings[0]);
+	ASSERT_FALSE (pendings[1]);
+}
+
+TEST (block_store, profile)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::keypair key1;
+	nano::account_info info (1, 2, 3, 4, 5, 6, nano::epoch::epoch_0);
+	auto & profile (store->profile_get ());
+	ASSERT_FALSE (profile.enabled ());
+	boost::property_tree::ptree json;
+	{
+		auto transaction (store->tx_begin_write ());
+		store->confirmation_height_put (transaction, key1.pub, { 0, nano::block_hash (0) });
+		store->account_put (transaction, key1.pub, info);
+	}
+	profile.serialize (json);
+	ASSERT_TRUE (json.get_child ("tables").empty ());
+	profile.enable (true);
+	{
+		auto transaction (store->tx_begin_write ());
+		store->account_put (transaction, key1.pub, info);
+		nano::account_info info2;
+		ASSERT_FALSE (store->account_get (transaction, key1.pub, info2));
+		ASSERT_TRUE (store->account_get (transaction, nano::keypair ().pub, info2));
+		size_t steps (0);
+		for (auto i (store->latest_begin (transaction)), n (store->latest_end ()); i != n; ++i)
+		{
+			++steps;
+		}
+		ASSERT_EQ (1, steps);
+		store->account_del (transaction, key1.pub);
+	}
+	json.clear ();
+	profile.serialize (json);
+	auto & accounts (json.get_child ("tables.accounts"));
+	ASSERT_EQ (1, accounts.get<uint64_t> ("put.count"));
+	ASSERT_EQ (sizeof (nano::account) + info.db_size (), accounts.get<uint64_t> ("put.bytes"));
+	// Only the lookup which found the account read any bytes
+	ASSERT_EQ (2, accounts.get<uint64_t> ("get.count"));
+	ASSERT_EQ (info.db_size (), accounts.get<uint64_t> ("get.bytes"));
+	// The seek reads the only account, stepping past it reaches the end
+	ASSERT_EQ (1, accounts.get<uint64_t> ("iterate.count"));
+	ASSERT_EQ (sizeof (nano::account) + info.db_size (), accounts.get<uint64_t> ("iterate.bytes"));
+	ASSERT_EQ (1, accounts.get<uint64_t> ("next.count"));
+	ASSERT_EQ (0, accounts.get<uint64_t> ("next.bytes"));
+	ASSERT_EQ (1, accounts.get<uint64_t> ("del.count"));
+	uint64_t histogram_total (0);
+	for (auto & bucket : accounts.get_child ("get.latency_histogram"))
+	{
+		histogram_total += bucket.second.get_value<uint64_t> ();
+	}
+	ASSERT_EQ (2, histogram_total);
+	profile.clear ();
+	json.clear ();
+	profile.serialize (json);
+	ASSERT_TRUE (json.get_child ("tables").empty ());
+}
+
 TEST (block_store, pending_iterator)
 {
 	nano::logger_mt logger;
@@ -660,6 +1111,143 @@ TEST (mdb_block_store, bad_path)
 	ASSERT_TRUE (store.init_error ());
 }
 
+TEST (mdb_block_store, read_txn_pool)
+{
+	bool error (false);
+	nano::mdb_env env (error, nano::unique_path ());
+	ASSERT_FALSE (error);
+	// One idle transaction per shard
+	nano::mdb_read_txn_pool pool (nano::mdb_read_txn_pool::shard_count);
+	{
+		auto transaction (env.tx_begin_read (nano::mdb_txn_callbacks{}, &pool));
+	}
+	ASSERT_EQ (1, pool.created.load ());
+	ASSERT_EQ (1, pool.size ());
+	{
+		auto transaction1 (env.tx_begin_read (nano::mdb_txn_callbacks{}, &pool));
+		ASSERT_EQ (0, pool.size ());
+		// A reset transaction goes back to the pool as well
+		auto transaction2 (env.tx_begin_read (nano::mdb_txn_callbacks{}, &pool));
+		transaction2.reset ();
+	}
+	ASSERT_EQ (1, pool.reused.load ());
+	ASSERT_EQ (2, pool.created.load ());
+	// The shard was full when the last transaction was returned, so it ended
+	ASSERT_EQ (1, pool.size ());
+	pool.clear ();
+	ASSERT_EQ (0, pool.size ());
+}
+
+TEST (mdb_block_store, read_txn_pool_snapshot)
+{
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, nano::unique_path ());
+	ASSERT_FALSE (store.init_error ());
+	nano::keypair key1;
+	nano::open_block open (0, 1, key1.pub, key1.prv, key1.pub, 0);
+	open.sideband_set (nano::block_sideband (key1.pub, 0, 2, 1, 3, nano::epoch::epoch_0, false, false, false));
+	{
+		auto transaction (store.tx_begin_read ());
+		ASSERT_FALSE (store.block_exists (transaction, open.hash ()));
+	}
+	{
+		auto transaction (store.tx_begin_write ());
+		store.block_put (transaction, open.hash (), open);
+	}
+	// A reused transaction is renewed with a new snapshot
+	auto transaction (store.tx_begin_read ());
+	ASSERT_TRUE (store.block_exists (transaction, open.hash ()));
+}
+
+TEST (mdb_block_store, online_compaction)
+{
+	nano::logger_mt logger;
+	auto path (nano::unique_path ());
+	nano::keypair key1;
+	nano::open_block open (0, 1, key1.pub, key1.prv, key1.pub, 0);
+	open.sideband_set (nano::block_sideband (key1.pub, 0, 2, 1, 3, nano::epoch::epoch_0, false, false, false));
+	nano::send_block send (open.hash (), 4, 1, key1.prv, key1.pub, 0);
+	send.sideband_set (nano::block_sideband (key1.pub, 0, 1, 2, 5, nano::epoch::epoch_0, false, false, false));
+	{
+		nano::mdb_store store (logger, path);
+		ASSERT_FALSE (store.init_error ());
+		{
+			auto transaction (store.tx_begin_write ());
+			store.block_put (transaction, open.hash (), open);
+		}
+		// Nothing to pause before the copy starts
+		ASSERT_TRUE (store.compaction_pause (true));
+		// An open transaction keeps the finished copy from being swapped in
+		auto reader (std::make_unique<nano::read_transaction> (store.tx_begin_read ()));
+		ASSERT_FALSE (store.compaction_start ());
+		ASSERT_TRUE (store.compaction_start ());
+		// Written after the copy began, these are replayed on the copy
+		{
+			auto transaction (store.tx_begin_write ());
+			store.block_put (transaction, send.hash (), send);
+			store.block_del (transaction, open.hash (), open.type ());
+		}
+		auto deadline (std::chrono::steady_clock::now () + std::chrono::seconds (10));
+		boost::property_tree::ptree status;
+		store.compaction_status (status);
+		while (status.get<std::string> ("state") != "ready" || status.get<uint64_t> ("swap_attempts") == 0)
+		{
+			ASSERT_LT (std::chrono::steady_clock::now (), deadline);
+			std::this_thread::sleep_for (std::chrono::milliseconds (10));
+			store.compaction_status (status);
+		}
+		ASSERT_EQ (status.get<uint64_t> ("entries_total"), status.get<uint64_t> ("entries_copied"));
+		reader.reset ();
+		while (status.get<std::string> ("state") != "swapped")
+		{
+			ASSERT_LT (std::chrono::steady_clock::now (), deadline);
+			std::this_thread::sleep_for (std::chrono::milliseconds (10));
+			store.compaction_status (status);
+		}
+		// The store keeps running on the compacted file
+		ASSERT_FALSE (boost::filesystem::exists (path.string () + ".compact"));
+		{
+			auto transaction (store.tx_begin_write ());
+			ASSERT_TRUE (store.block_exists (transaction, send.hash ()));
+			ASSERT_FALSE (store.block_exists (transaction, open.hash ()));
+			store.block_put (transaction, open.hash (), open);
+		}
+	}
+	nano::mdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+	ASSERT_TRUE (store.block_exists (transaction, send.hash ()));
+	ASSERT_TRUE (store.block_exists (transaction, open.hash ()));
+}
+
+TEST (mdb_block_store, group_sync)
+{
+	nano::logger_mt logger;
+	nano::lmdb_config lmdb_config;
+	lmdb_config.sync = nano::lmdb_config::sync_strategy::group;
+	lmdb_config.group_sync_interval = std::chrono::seconds (60);
+	lmdb_config.group_sync_commits = 4;
+	nano::mdb_store store (logger, nano::unique_path (), nano::txn_tracking_config{}, std::chrono::seconds (5), lmdb_config);
+	ASSERT_FALSE (store.init_error ());
+	// Reaching the commit threshold flushes without waiting for the interval
+	for (auto i (0); i < 4; ++i)
+	{
+		auto transaction (store.tx_begin_write ());
+		store.version_put (transaction, store.version);
+	}
+	auto deadline (std::chrono::steady_clock::now () + std::chrono::seconds (10));
+	boost::property_tree::ptree status;
+	store.durability_status (status);
+	ASSERT_EQ ("group", status.get<std::string> ("sync"));
+	while (status.get<uint64_t> ("durable_txn_id") != status.get<uint64_t> ("last_txn_id"))
+	{
+		ASSERT_LT (std::chrono::steady_clock::now (), deadline);
+		std::this_thread::sleep_for (std::chrono::milliseconds (10));
+		store.durability_status (status);
+	}
+	ASSERT_GT (status.get<uint64_t> ("syncs"), 0);
+}
+
 TEST (block_store, DISABLED_already_open) // File can be shared
 {
 	auto path (nano::unique_path ());
@@ -2035,6 +2623,61 @@ TEST (mdb_block_store, upgrade_v17_v18)
 	ASSERT_LT (17, store.version_get (transaction));
 }
 
+TEST (mdb_block_store, upgrade_v18_v19)
+{
+	auto path (nano::unique_path ());
+	nano::genesis genesis;
+	nano::keypair key1;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::send_block send (genesis.hash (), key1.pub, nano::genesis_amount - nano::Gxrb_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	nano::open_block open (send.hash (), key1.pub, key1.pub, key1.prv, key1.pub, *pool.generate (key1.pub));
+	nano::state_block state (key1.pub, open.hash (), key1.pub, nano::Gxrb_ratio - 1, nano::test_genesis_key.pub, key1.prv, key1.pub, *pool.generate (open.hash ()));
+	{
+		nano::logger_mt logger;
+		nano::mdb_store store (logger, path);
+		nano::stat stats;
+		nano::ledger ledger (store, stats);
+		auto transaction (store.tx_begin_write ());
+		store.initialize (transaction, genesis, ledger.cache);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, open).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, state).code);
+		// Summaries written by a previous version can't be trusted, leave a stale one behind
+		nano::block_summary stale;
+		ASSERT_FALSE (store.block_summary_get (transaction, send.hash (), stale));
+		stale.balance = 0;
+		ASSERT_FALSE (mdb_put (store.env.tx (transaction), store.block_summaries, nano::mdb_val (send.hash ()), nano::mdb_val (stale), 0));
+		store.version_put (transaction, 18);
+	}
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_write ());
+	ASSERT_EQ (19, store.version_get (transaction));
+	ASSERT_EQ (0, store.count (transaction, store.block_summaries));
+	// Lookups fall back to the block entries until blocks are summarized
+	nano::block_summary summary;
+	ASSERT_TRUE (store.block_summary_get (transaction, send.hash (), summary));
+	ASSERT_EQ (nano::genesis_amount - nano::Gxrb_ratio, store.block_balance (transaction, send.hash ()));
+	ASSERT_EQ (state.hash (), store.block_successor (transaction, open.hash ()));
+	// Building resumes from the cursor on every call
+	auto calls (0);
+	while (!store.block_summaries_build (transaction, 1))
+	{
+		++calls;
+	}
+	ASSERT_EQ (3, calls);
+	ASSERT_EQ (4, store.count (transaction, store.block_summaries));
+	for (auto hash : { genesis.hash (), send.hash (), open.hash (), state.hash () })
+	{
+		ASSERT_FALSE (store.block_summary_get (transaction, hash, summary));
+		ASSERT_EQ (nano::block_summary (store.block_view_get (transaction, hash)), summary);
+	}
+	ASSERT_EQ (nano::genesis_amount - nano::Gxrb_ratio, store.block_balance (transaction, send.hash ()));
+	ASSERT_EQ (2, store.block_account_height (transaction, state.hash ()));
+	ASSERT_TRUE (store.block_summaries_build (transaction, 1));
+}
+
 TEST (mdb_block_store, upgrade_backup)
 {
 	auto dir (nano::unique_path ());
@@ -2250,6 +2893,101 @@ TEST (block_store, rocksdb_force_test_env_variable)
 #endif
 }
 
+#if NANO_ROCKSDB
+TEST (block_store, rocksdb_write_batch)
+{
+	nano::logger_mt logger;
+	auto path (nano::unique_path ());
+	nano::rocksdb_config config;
+	config.enable = true;
+	config.write_batch = true;
+	nano::keypair key1;
+	nano::open_block open (0, 1, key1.pub, key1.prv, key1.pub, 0);
+	open.sideband_set (nano::block_sideband (key1.pub, 0, 2, 1, 3, nano::epoch::epoch_0, false, false, false));
+	nano::send_block send (open.hash (), 4, 1, key1.prv, key1.pub, 0);
+	send.sideband_set (nano::block_sideband (key1.pub, 0, 1, 2, 5, nano::epoch::epoch_0, false, false, false));
+	{
+		nano::rocksdb_store store (logger, path, config);
+		ASSERT_FALSE (store.init_error ());
+		{
+			auto transaction (store.tx_begin_write ());
+			store.block_put (transaction, open.hash (), open);
+			store.block_put (transaction, send.hash (), send);
+			// Reads and counts in the transaction see its own writes
+			ASSERT_TRUE (store.block_exists (transaction, open.hash ()));
+			ASSERT_EQ (2, store.block_count (transaction).sum ());
+			auto read (store.tx_begin_read ());
+			ASSERT_FALSE (store.block_exists (read, open.hash ()));
+			ASSERT_EQ (0, store.block_count (read).sum ());
+		}
+		auto transaction (store.tx_begin_read ());
+		ASSERT_TRUE (store.block_exists (transaction, send.hash ()));
+		ASSERT_EQ (2, store.block_count (transaction).sum ());
+		{
+			auto write (store.tx_begin_write ());
+			store.block_del (write, send.hash (), send.type ());
+		}
+	}
+	// Counts are checkpointed with each batch
+	nano::rocksdb_store store (logger, path, config);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+	ASSERT_EQ (1, store.block_count (transaction).sum ());
+	ASSERT_TRUE (store.block_exists (transaction, open.hash ()));
+	ASSERT_FALSE (store.block_exists (transaction, send.hash ()));
+}
+
+TEST (block_store, rocksdb_write_batch_clear)
+{
+	nano::logger_mt logger;
+	nano::rocksdb_config config;
+	config.enable = true;
+	config.write_batch = true;
+	nano::rocksdb_store store (logger, nano::unique_path (), config);
+	ASSERT_FALSE (store.init_error ());
+	auto block (std::make_shared<nano::send_block> (0, 1, 2, nano::keypair ().prv, 4, 5));
+	{
+		auto transaction (store.tx_begin_write ());
+		store.unchecked_put (transaction, block->previous (), block);
+		store.online_weight_put (transaction, 1, 2);
+		// Writes batched before a table is cleared don't end up in its dropped column family
+		store.unchecked_clear (transaction);
+		store.online_weight_clear (transaction);
+		ASSERT_EQ (0, store.unchecked_count (transaction));
+		store.online_weight_put (transaction, 3, 4);
+		ASSERT_EQ (1, store.online_weight_count (transaction));
+	}
+	auto transaction (store.tx_begin_read ());
+	ASSERT_EQ (0, store.unchecked_count (transaction));
+	ASSERT_EQ (1, store.online_weight_count (transaction));
+}
+
+TEST (block_store, rocksdb_fifo_style_change)
+{
+	nano::logger_mt logger;
+	auto path (nano::unique_path ());
+	nano::rocksdb_config config;
+	config.enable = true;
+	{
+		nano::rocksdb_store store (logger, path, config);
+		ASSERT_FALSE (store.init_error ());
+		store.online_weight_put (store.tx_begin_write (), 1, 2);
+	}
+	// Switching online weight to FIFO compaction recreates the table instead of failing to open it
+	config.fifo_max_size = 1;
+	{
+		nano::rocksdb_store store (logger, path, config);
+		ASSERT_FALSE (store.init_error ());
+		ASSERT_EQ (0, store.online_weight_count (store.tx_begin_read ()));
+		store.online_weight_put (store.tx_begin_write (), 1, 2);
+	}
+	// Entries are kept while the style stays the same
+	nano::rocksdb_store store (logger, path, config);
+	ASSERT_FALSE (store.init_error ());
+	ASSERT_EQ (1, store.online_weight_count (store.tx_begin_read ()));
+}
+#endif
+
 namespace
 {
 void write_sideband_v12 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block & block_a, nano::block_hash const & successor_a, MDB_dbi db_a)
@@ -724,7 +724,7 @@ TEST (bootstrap_processor, lazy_max_pull_count)
 	}
 
 	auto transaction = node1->store.tx_begin_read ();
-	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->store.unchecked_count (transaction));
+	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->unchecked.count (transaction));
 	node1->stop ();
 }
 
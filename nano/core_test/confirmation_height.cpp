@@ -266,7 +266,7 @@ TEST (confirmation_height, gap_bootstrap)
 		// Confirmation heights should not be updated
 		{
 			auto transaction (node1.store.tx_begin_read ());
-			auto unchecked_count (node1.store.unchecked_count (transaction));
+			auto unchecked_count (node1.unchecked.count (transaction));
 			ASSERT_EQ (unchecked_count, 2);
 
 			nano::confirmation_height_info confirmation_height_info;
@@ -282,7 +282,7 @@ TEST (confirmation_height, gap_bootstrap)
 		// Confirmation height should be unchanged and unchecked should now be 0
 		{
 			auto transaction (node1.store.tx_begin_read ());
-			auto unchecked_count (node1.store.unchecked_count (transaction));
+			auto unchecked_count (node1.unchecked.count (transaction));
 			ASSERT_EQ (unchecked_count, 0);
 
 			nano::confirmation_height_info confirmation_height_info;
@@ -375,7 +375,7 @@ TEST (confirmation_height, gap_live)
 
 		// This should confirm the open block and the source of the receive blocks
 		auto transaction (node->store.tx_begin_read ());
-		auto unchecked_count (node->store.unchecked_count (transaction));
+		auto unchecked_count (node->unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 
 		nano::confirmation_height_info confirmation_height_info;
@@ -1668,3 +1668,43 @@ TEST (confirmation_height, election_winner_details_clearing_node_process_confirm
 	node->process_confirmed (election, 1000000);
 	ASSERT_EQ (0, node->active.election_winner_details_size ());
 }
+
+TEST (confirmation_height, group_commit)
+{
+	nano::write_database_queue write_database_queue;
+	std::atomic<unsigned> syncs{ 0 };
+	write_database_queue.group_commit (1s, [&syncs]() { ++syncs; });
+	{
+		// Nobody waiting, the commit has to sync
+		auto scoped_write_guard = write_database_queue.wait (nano::writer::process_batch);
+		ASSERT_FALSE (write_database_queue.defer_sync ());
+		// Other writers don't share a sync
+		ASSERT_FALSE (write_database_queue.process (nano::writer::testing));
+		ASSERT_FALSE (write_database_queue.defer_sync ());
+	}
+	ASSERT_TRUE (write_database_queue.process (nano::writer::testing));
+	write_database_queue.pop ();
+	{
+		auto scoped_write_guard = write_database_queue.wait (nano::writer::process_batch);
+		ASSERT_FALSE (write_database_queue.process (nano::writer::confirmation_height));
+		ASSERT_TRUE (write_database_queue.defer_sync ());
+		ASSERT_EQ (1, write_database_queue.deferred_syncs);
+	}
+	// Cementing is next, so the deferred commit is not synced on release
+	ASSERT_EQ (0, syncs);
+	{
+		auto scoped_write_guard = write_database_queue.wait (nano::writer::confirmation_height);
+		ASSERT_FALSE (write_database_queue.defer_sync ());
+	}
+	ASSERT_EQ (0, syncs);
+	{
+		auto scoped_write_guard = write_database_queue.wait (nano::writer::process_batch);
+		ASSERT_FALSE (write_database_queue.process (nano::writer::confirmation_height));
+		ASSERT_TRUE (write_database_queue.defer_sync ());
+	}
+	// Nothing else to commit in the group, the release syncs instead
+	ASSERT_TRUE (write_database_queue.process (nano::writer::confirmation_height));
+	write_database_queue.pop ();
+	ASSERT_EQ (1, syncs);
+	ASSERT_EQ (2, write_database_queue.deferred_syncs);
+}
@@ -2,6 +2,7 @@
 #include <nano/lib/stats.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/node/election.hpp>
+#include <nano/node/ledger_export.hpp>
 #include <nano/node/testing.hpp>
 
 #include <gtest/gtest.h>
@@ -638,6 +639,155 @@ TEST (ledger, representation_changes)
 	ASSERT_EQ (2, rep_weights.representation_get (key1.pub));
 }
 
+TEST (ledger, representation_add_dual)
+{
+	nano::rep_weights rep_weights;
+	nano::keypair key1;
+	nano::keypair key2;
+	rep_weights.representation_put (key1.pub, 10);
+	auto snapshot1 (rep_weights.get_rep_amounts ());
+	ASSERT_EQ (1, snapshot1->size ());
+	// Snapshot is shared until a weight changes
+	ASSERT_EQ (snapshot1, rep_weights.get_rep_amounts ());
+	rep_weights.representation_add_dual (key1.pub, 0 - nano::uint128_t (4), key2.pub, 4);
+	ASSERT_EQ (6, rep_weights.representation_get (key1.pub));
+	ASSERT_EQ (4, rep_weights.representation_get (key2.pub));
+	// Same representative on both sides
+	rep_weights.representation_add_dual (key1.pub, 0 - nano::uint128_t (6), key1.pub, 6);
+	ASSERT_EQ (6, rep_weights.representation_get (key1.pub));
+	auto snapshot2 (rep_weights.get_rep_amounts ());
+	ASSERT_NE (snapshot1, snapshot2);
+	ASSERT_EQ (2, snapshot2->size ());
+	ASSERT_EQ (10, snapshot1->at (key1.pub));
+	ASSERT_EQ (6, snapshot2->at (key1.pub));
+}
+
+TEST (ledger, rep_weights_checkpoint)
+{
+	nano::logger_mt logger;
+	auto path (nano::unique_path ());
+	nano::mdb_store store (logger, path);
+	ASSERT_TRUE (!store.init_error ());
+	nano::stat stats;
+	nano::genesis genesis;
+	nano::keypair key1;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	{
+		nano::ledger ledger (store, stats);
+		store.initialize (store.tx_begin_write (), genesis, ledger.cache);
+		nano::state_block change1 (nano::genesis_account, genesis.hash (), key1.pub, nano::genesis_amount, 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+		ASSERT_EQ (nano::process_result::progress, ledger.process (store.tx_begin_write (), change1).code);
+		ledger.rep_weights_checkpoint (store.tx_begin_write ());
+		ASSERT_TRUE (ledger.rep_weights_checkpointed);
+	}
+	{
+		// Changing the account behind the ledger's back shows whether weights came from the checkpoint or a scan
+		auto transaction (store.tx_begin_write ());
+		nano::account_info info;
+		ASSERT_FALSE (store.account_get (transaction, nano::genesis_account, info));
+		auto modified (info);
+		modified.representative = nano::genesis_account;
+		store.account_put (transaction, nano::genesis_account, modified);
+	}
+	{
+		nano::ledger ledger (store, stats);
+		ASSERT_TRUE (ledger.rep_weights_checkpointed);
+		ASSERT_EQ (nano::genesis_amount, ledger.weight (key1.pub));
+		ASSERT_EQ (0, ledger.weight (nano::genesis_account));
+		ASSERT_EQ (1, ledger.cache.account_count);
+		// Processing a block deletes the checkpoint
+		nano::state_block change2 (nano::genesis_account, ledger.latest (store.tx_begin_read (), nano::genesis_account), key1.pub, nano::genesis_amount, 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (ledger.latest (store.tx_begin_read (), nano::genesis_account)));
+		ASSERT_EQ (nano::process_result::progress, ledger.process (store.tx_begin_write (), change2).code);
+		ASSERT_FALSE (ledger.rep_weights_checkpointed);
+		ASSERT_TRUE (store.rep_weights_checkpoint_get (store.tx_begin_read (), [](uint8_t const *, size_t) {}));
+	}
+	nano::ledger ledger (store, stats);
+	ASSERT_FALSE (ledger.rep_weights_checkpointed);
+	ASSERT_EQ (nano::genesis_amount, ledger.weight (key1.pub));
+}
+
+TEST (ledger, cache_counters)
+{
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store.init_error ());
+	nano::stat stats;
+	nano::genesis genesis;
+	{
+		nano::ledger ledger (store, stats);
+		ASSERT_FALSE (ledger.cache_counters_loaded);
+		auto transaction (store.tx_begin_write ());
+		store.initialize (transaction, genesis, ledger.cache);
+		ledger.cache_counters_write (transaction);
+	}
+	std::atomic<bool> stopped{ false };
+	{
+		nano::ledger ledger (store, stats);
+		ASSERT_TRUE (ledger.cache_counters_loaded);
+		ASSERT_EQ (1, ledger.cache.cemented_count);
+		ASSERT_FALSE (ledger.cache_counters_validate (stopped));
+		// A stale count is used on start and corrected by validation
+		store.cache_counters_put (store.tx_begin_write (), 0, false);
+	}
+	{
+		nano::ledger ledger (store, stats);
+		ASSERT_TRUE (ledger.cache_counters_loaded);
+		ASSERT_EQ (0, ledger.cache.cemented_count);
+		ASSERT_TRUE (ledger.cache_counters_validate (stopped));
+		ASSERT_EQ (1, ledger.cache.cemented_count);
+		ledger.cache_counters_write (store.tx_begin_write ());
+		ASSERT_FALSE (ledger.cache_counters_validate (stopped));
+		// Counters ahead of the ledger can't be valid
+		store.cache_counters_put (store.tx_begin_write (), 2, false);
+	}
+	nano::ledger ledger (store, stats);
+	ASSERT_FALSE (ledger.cache_counters_loaded);
+	ASSERT_EQ (1, ledger.cache.cemented_count);
+	ASSERT_FALSE (ledger.cache_timing.empty ());
+}
+
+TEST (ledger, export)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::stat stats;
+	nano::ledger ledger (*store, stats);
+	nano::genesis genesis;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::keypair key1;
+	{
+		auto transaction (store->tx_begin_write ());
+		store->initialize (transaction, genesis, ledger.cache);
+		nano::send_block send (genesis.hash (), key1.pub, 50, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
+	}
+	auto path (nano::unique_path ());
+	nano::ledger_export exporter (*store, path, 4);
+	ASSERT_FALSE (exporter.run ());
+	ASSERT_EQ (1, exporter.accounts.load ());
+	ASSERT_EQ (2, exporter.blocks.load ());
+	ASSERT_EQ (1, exporter.pending.load ());
+	ASSERT_EQ (1, exporter.confirmation_heights.load ());
+	// Every shard writes its files
+	for (auto shard (0); shard < 4; ++shard)
+	{
+		ASSERT_TRUE (boost::filesystem::exists (path / boost::str (boost::format ("accounts.%1%.col") % shard)));
+	}
+	uint64_t blocks_size (0);
+	for (auto shard (0); shard < 4; ++shard)
+	{
+		blocks_size += boost::filesystem::file_size (path / boost::str (boost::format ("blocks.%1%.col") % shard));
+	}
+	size_t header_size (8 + 1 + 14 * 2 + std::string ("accounthashtypeheightpreviousrepresentativelinkbalancetimestampepochflagssuccessorworksignature").size ());
+	size_t row_size (32 + 32 + 1 + 8 + 32 + 32 + 32 + 16 + 8 + 1 + 1 + 32 + 8 + 64);
+	// Each file ends with an empty chunk, the one with the genesis account also has a chunk of both blocks
+	// The account column of that chunk is run length encoded, so is the timestamp column if both blocks were written in the same second
+	size_t chunk_header_size (4 + 14);
+	auto expected_size (4 * (header_size + chunk_header_size) + chunk_header_size + 2 * row_size - 2 * 32 + (4 + 32));
+	ASSERT_TRUE (blocks_size == expected_size || blocks_size == expected_size - 2 * 8 + (4 + 8));
+}
+
 TEST (ledger, representation)
 {
 	nano::logger_mt logger;
@@ -2687,6 +2837,81 @@ TEST (ledger, block_hash_account_conflict)
 	ASSERT_EQ (*open_epoch1, *winner4.second);
 }
 
+TEST (ledger, partition)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::stat stats;
+	nano::ledger ledger (*store, stats);
+	nano::genesis genesis;
+	auto transaction (store->tx_begin_write ());
+	store->initialize (transaction, genesis, ledger.cache);
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::keypair key1;
+	nano::keypair key2;
+	auto send1 (std::make_shared<nano::state_block> (nano::genesis_account, genesis.hash (), nano::genesis_account, nano::genesis_amount - 1, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ())));
+	auto send2 (std::make_shared<nano::state_block> (nano::genesis_account, send1->hash (), nano::genesis_account, nano::genesis_amount - 2, key2.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (send1->hash ())));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, *send1).code);
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, *send2).code);
+	// Opens of unrelated accounts with sources already in the ledger are independent
+	auto open1 (std::make_shared<nano::state_block> (key1.pub, 0, key1.pub, 1, send1->hash (), key1.prv, key1.pub, *pool.generate (key1.pub)));
+	auto open2 (std::make_shared<nano::state_block> (key2.pub, 0, key2.pub, 1, send2->hash (), key2.prv, key2.pub, *pool.generate (key2.pub)));
+	// Send from key1 to key2 and its receive, linked through the source
+	auto send3 (std::make_shared<nano::state_block> (key1.pub, open1->hash (), key1.pub, 0, key2.pub, key1.prv, key1.pub, *pool.generate (open1->hash ())));
+	auto receive1 (std::make_shared<nano::state_block> (key2.pub, open2->hash (), key2.pub, 2, send3->hash (), key2.prv, key2.pub, *pool.generate (open2->hash ())));
+	auto partitions1 (ledger.partition (transaction, { open1, open2 }));
+	ASSERT_EQ (2, partitions1.size ());
+	auto partitions2 (ledger.partition (transaction, { open1, open2, send3, receive1 }));
+	ASSERT_EQ (1, partitions2.size ());
+	ASSERT_EQ ((std::vector<size_t>{ 0, 1, 2, 3 }), partitions2[0]);
+	auto partitions3 (ledger.partition (transaction, { open2, send3, open1 }));
+	ASSERT_EQ (2, partitions3.size ());
+	ASSERT_EQ ((std::vector<size_t>{ 0 }), partitions3[0]);
+	ASSERT_EQ ((std::vector<size_t>{ 1, 2 }), partitions3[1]);
+}
+
+TEST (ledger, snapshot_check)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::stat stats;
+	nano::ledger ledger (*store, stats);
+	nano::genesis genesis;
+	auto transaction (store->tx_begin_write ());
+	store->initialize (transaction, genesis, ledger.cache);
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::keypair key1;
+	nano::send_block send1 (genesis.hash (), key1.pub, nano::genesis_amount - 1, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	nano::send_block send2 (send1.hash (), key1.pub, nano::genesis_amount - 2, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (send1.hash ()));
+	nano::state_block send3 (nano::genesis_account, send2.hash (), nano::genesis_account, nano::genesis_amount - 3, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (send2.hash ()));
+	nano::send_block fork1 (genesis.hash (), key1.pub, nano::genesis_amount - 2, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	nano::send_block bad_signature (genesis.hash (), key1.pub, nano::genesis_amount - 3, key1.prv, key1.pub, *pool.generate (genesis.hash ()));
+	std::unordered_set<nano::block_hash> earlier;
+	// Blocks which can be added are checked without writing them
+	auto result1 (ledger.snapshot_check (transaction, send1, nano::signature_verification::unknown, earlier));
+	ASSERT_EQ (nano::process_result::progress, result1.code);
+	ASSERT_EQ (nano::signature_verification::valid, result1.verified);
+	ASSERT_FALSE (store->block_exists (transaction, send1.hash ()));
+	ASSERT_EQ (1, ledger.cache.block_count);
+	ASSERT_EQ (nano::process_result::gap_previous, ledger.snapshot_check (transaction, send2, nano::signature_verification::unknown, earlier).code);
+	auto result3 (ledger.snapshot_check (transaction, send3, nano::signature_verification::unknown, earlier));
+	ASSERT_EQ (nano::process_result::gap_previous, result3.code);
+	ASSERT_EQ (nano::signature_verification::valid, result3.verified);
+	ASSERT_EQ (nano::process_result::bad_signature, ledger.snapshot_check (transaction, bad_signature, nano::signature_verification::unknown, earlier).code);
+	// Blocks of the partition which may be added before this one leave only results they can't change
+	earlier.insert (send1.hash ());
+	ASSERT_EQ (nano::process_result::progress, ledger.snapshot_check (transaction, send2, nano::signature_verification::unknown, earlier).code);
+	ASSERT_EQ (nano::process_result::gap_previous, ledger.snapshot_check (transaction, send3, nano::signature_verification::unknown, earlier).code);
+	ASSERT_EQ (nano::process_result::progress, ledger.snapshot_check (transaction, bad_signature, nano::signature_verification::unknown, earlier).code);
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send1).code);
+	ASSERT_EQ (nano::process_result::old, ledger.snapshot_check (transaction, send1, nano::signature_verification::unknown, earlier).code);
+	ASSERT_EQ (nano::process_result::fork, ledger.snapshot_check (transaction, fork1, nano::signature_verification::unknown, {}).code);
+	ASSERT_EQ (nano::process_result::progress, ledger.snapshot_check (transaction, fork1, nano::signature_verification::unknown, earlier).code);
+	ASSERT_EQ (nano::process_result::progress, ledger.snapshot_check (transaction, send2, nano::signature_verification::unknown, {}).code);
+}
+
 TEST (ledger, could_fit)
 {
 	nano::logger_mt logger;
@@ -2765,10 +2990,10 @@ TEST (ledger, unchecked_epoch)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, epoch1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, epoch1->previous ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid_epoch);
 	}
@@ -2778,7 +3003,7 @@ TEST (ledger, unchecked_epoch)
 	{
 		auto transaction (node1.store.tx_begin_read ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, epoch1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 		nano::account_info info;
@@ -2810,10 +3035,10 @@ TEST (ledger, unchecked_epoch_invalid)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 2);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, epoch1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, epoch1->previous ()));
 		ASSERT_EQ (blocks.size (), 2);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid);
 		ASSERT_EQ (blocks[1].verified, nano::signature_verification::valid);
@@ -2826,7 +3051,7 @@ TEST (ledger, unchecked_epoch_invalid)
 		ASSERT_FALSE (node1.store.block_exists (transaction, epoch1->hash ()));
 		ASSERT_TRUE (node1.store.block_exists (transaction, epoch2->hash ()));
 		ASSERT_TRUE (node1.active.empty ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 		nano::account_info info;
@@ -2860,10 +3085,10 @@ TEST (ledger, unchecked_open)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, open1->source ()));
+		auto blocks (node1.unchecked.get (transaction, open1->source ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid);
 	}
@@ -2872,7 +3097,7 @@ TEST (ledger, unchecked_open)
 	{
 		auto transaction (node1.store.tx_begin_read ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, open1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 	}
@@ -2898,10 +3123,10 @@ TEST (ledger, unchecked_receive)
 	// Previous block for receive1 is unknown, signature cannot be validated
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, receive1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, receive1->previous ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::unknown);
 	}
@@ -2910,10 +3135,10 @@ TEST (ledger, unchecked_receive)
 	// Previous block for receive1 is known, signature was validated
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, receive1->source ()));
+		auto blocks (node1.unchecked.get (transaction, receive1->source ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid);
 	}
@@ -2922,7 +3147,7 @@ TEST (ledger, unchecked_receive)
 	{
 		auto transaction (node1.store.tx_begin_read ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, receive1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 	}
@@ -3258,3 +3483,37 @@ TEST (ledger, backtrack)
 	ASSERT_EQ (nullptr, ledger.backtrack (transaction, nullptr, 0));
 	ASSERT_EQ (nullptr, ledger.backtrack (transaction, nullptr, 10));
 }
+
+TEST (ledger, accounts_pending)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::stat stats;
+	nano::ledger ledger (*store, stats);
+	// Enough accounts in between for the scan to both step over entries and seek past them
+	std::vector<nano::account> accounts;
+	{
+		auto transaction (store->tx_begin_write ());
+		for (auto i (1); i <= 100; ++i)
+		{
+			nano::account account (i * 2);
+			accounts.push_back (account);
+			for (auto j (0); j < i % 3; ++j)
+			{
+				store->pending_put (transaction, nano::pending_key (account, i * 10 + j), nano::pending_info (0, i, nano::epoch::epoch_0));
+			}
+		}
+	}
+	std::vector<nano::account> requested{ accounts[50], nano::account (1), accounts[3], accounts[99], accounts[3], accounts[0], nano::account (1000), accounts[1] };
+	auto transaction (store->tx_begin_read ());
+	auto pending (ledger.accounts_pending (transaction, requested));
+	ASSERT_EQ (requested.size (), pending.size ());
+	for (size_t i (0); i < requested.size (); ++i)
+	{
+		ASSERT_EQ (ledger.account_pending (transaction, requested[i]), pending[i]);
+	}
+	ASSERT_EQ (4, pending[2]);
+	ASSERT_EQ (0, pending[1]);
+	ASSERT_TRUE (ledger.accounts_pending (transaction, {}).empty ());
+}
@@ -64,9 +64,10 @@ TEST (message_parser, exact_confirm_ack_size)
 	nano::system system (1);
 	test_visitor visitor;
 	nano::network_filter filter (1);
+	nano::network_filter vote_filter (1);
 	nano::block_uniquer block_uniquer;
 	nano::vote_uniquer vote_uniquer (block_uniquer);
-	nano::message_parser parser (filter, block_uniquer, vote_uniquer, visitor, system.work, false);
+	nano::message_parser parser (filter, vote_filter, block_uniquer, vote_uniquer, visitor, system.work, false);
 	auto block (std::make_shared<nano::send_block> (1, 1, 2, nano::keypair ().prv, 4, *system.work.generate (nano::root (1))));
 	auto vote (std::make_shared<nano::vote> (0, nano::keypair ().prv, 0, std::move (block)));
 	nano::confirm_ack message (vote);
@@ -98,9 +99,10 @@ TEST (message_parser, exact_confirm_req_size)
 	nano::system system (1);
 	test_visitor visitor;
 	nano::network_filter filter (1);
+	nano::network_filter vote_filter (1);
 	nano::block_uniquer block_uniquer;
 	nano::vote_uniquer vote_uniquer (block_uniquer);
-	nano::message_parser parser (filter, block_uniquer, vote_uniquer, visitor, system.work, false);
+	nano::message_parser parser (filter, vote_filter, block_uniquer, vote_uniquer, visitor, system.work, false);
 	auto block (std::make_shared<nano::send_block> (1, 1, 2, nano::keypair ().prv, 4, *system.work.generate (nano::root (1))));
 	nano::confirm_req message (std::move (block));
 	std::vector<uint8_t> bytes;
@@ -131,9 +133,10 @@ TEST (message_parser, exact_confirm_req_hash_size)
 	nano::system system (1);
 	test_visitor visitor;
 	nano::network_filter filter (1);
+	nano::network_filter vote_filter (1);
 	nano::block_uniquer block_uniquer;
 	nano::vote_uniquer vote_uniquer (block_uniquer);
-	nano::message_parser parser (filter, block_uniquer, vote_uniquer, visitor, system.work, true);
+	nano::message_parser parser (filter, vote_filter, block_uniquer, vote_uniquer, visitor, system.work, true);
 	nano::send_block block (1, 1, 2, nano::keypair ().prv, 4, *system.work.generate (nano::root (1)));
 	nano::confirm_req message (block.hash (), block.root ());
 	std::vector<uint8_t> bytes;
@@ -164,9 +167,10 @@ TEST (message_parser, exact_publish_size)
 	nano::system system (1);
 	test_visitor visitor;
 	nano::network_filter filter (1);
+	nano::network_filter vote_filter (1);
 	nano::block_uniquer block_uniquer;
 	nano::vote_uniquer vote_uniquer (block_uniquer);
-	nano::message_parser parser (filter, block_uniquer, vote_uniquer, visitor, system.work, true);
+	nano::message_parser parser (filter, vote_filter, block_uniquer, vote_uniquer, visitor, system.work, true);
 	auto block (std::make_shared<nano::send_block> (1, 1, 2, nano::keypair ().prv, 4, *system.work.generate (nano::root (1))));
 	nano::publish message (std::move (block));
 	std::vector<uint8_t> bytes;
@@ -197,9 +201,10 @@ TEST (message_parser, exact_keepalive_size)
 	nano::system system (1);
 	test_visitor visitor;
 	nano::network_filter filter (1);
+	nano::network_filter vote_filter (1);
 	nano::block_uniquer block_uniquer;
 	nano::vote_uniquer vote_uniquer (block_uniquer);
-	nano::message_parser parser (filter, block_uniquer, vote_uniquer, visitor, system.work, true);
+	nano::message_parser parser (filter, vote_filter, block_uniquer, vote_uniquer, visitor, system.work, true);
 	nano::keepalive message;
 	std::vector<uint8_t> bytes;
 	{
@@ -223,3 +228,67 @@ TEST (message_parser, exact_keepalive_size)
 	ASSERT_EQ (1, visitor.keepalive_count);
 	ASSERT_NE (parser.status, nano::message_parser::parse_status::success);
 }
+
+TEST (message_parser, payload_size_mismatch)
+{
+	nano::system system (1);
+	test_visitor visitor;
+	nano::network_filter filter (16);
+	nano::network_filter vote_filter (16);
+	nano::block_uniquer block_uniquer;
+	nano::vote_uniquer vote_uniquer (block_uniquer);
+	nano::message_parser parser (filter, vote_filter, block_uniquer, vote_uniquer, visitor, system.work, true);
+	auto block (std::make_shared<nano::send_block> (1, 1, 2, nano::keypair ().prv, 4, *system.work.generate (nano::root (1))));
+	nano::publish message (std::move (block));
+	std::vector<uint8_t> bytes;
+	{
+		nano::vectorstream stream (bytes);
+		message.serialize (stream, false);
+	}
+	std::vector<uint8_t> truncated (bytes.begin (), bytes.end () - 1);
+	parser.deserialize_buffer (truncated.data (), truncated.size ());
+	ASSERT_EQ (nano::message_parser::parse_status::invalid_publish_message, parser.status);
+	ASSERT_EQ (0, visitor.publish_count);
+	// The malformed payload is rejected before reaching the filter
+	auto header_size (nano::message_header::size);
+	ASSERT_FALSE (filter.apply (truncated.data () + header_size, truncated.size () - header_size));
+	parser.deserialize_buffer (bytes.data (), bytes.size ());
+	ASSERT_EQ (nano::message_parser::parse_status::success, parser.status);
+	ASSERT_EQ (1, visitor.publish_count);
+	parser.deserialize_buffer (bytes.data (), bytes.size ());
+	ASSERT_EQ (nano::message_parser::parse_status::duplicate_publish_message, parser.status);
+	ASSERT_EQ (1, visitor.publish_count);
+}
+
+TEST (message_parser, duplicate_confirm_ack)
+{
+	nano::system system (1);
+	test_visitor visitor;
+	nano::network_filter filter (16);
+	nano::network_filter vote_filter (16);
+	nano::block_uniquer block_uniquer;
+	nano::vote_uniquer vote_uniquer (block_uniquer);
+	nano::message_parser parser (filter, vote_filter, block_uniquer, vote_uniquer, visitor, system.work, true);
+	auto vote (std::make_shared<nano::vote> (0, nano::keypair ().prv, 0, std::vector<nano::block_hash>{ 1 }));
+	nano::confirm_ack message (vote);
+	std::vector<uint8_t> bytes;
+	{
+		nano::vectorstream stream (bytes);
+		message.serialize (stream, false);
+	}
+	parser.deserialize_buffer (bytes.data (), bytes.size ());
+	ASSERT_EQ (nano::message_parser::parse_status::success, parser.status);
+	ASSERT_EQ (1, visitor.confirm_ack_count);
+	// A replay of the same payload is dropped before its vote is created
+	auto uniquer_size (vote_uniquer.size ());
+	parser.deserialize_buffer (bytes.data (), bytes.size ());
+	ASSERT_EQ (nano::message_parser::parse_status::duplicate_confirm_ack_message, parser.status);
+	ASSERT_EQ (1, visitor.confirm_ack_count);
+	ASSERT_EQ (uniquer_size, vote_uniquer.size ());
+	// Clearing the digest, as done when the vote processor drops the vote, lets the next replay through
+	auto header_size (nano::message_header::size);
+	vote_filter.clear (bytes.data () + header_size, bytes.size () - header_size);
+	parser.deserialize_buffer (bytes.data (), bytes.size ());
+	ASSERT_EQ (nano::message_parser::parse_status::success, parser.status);
+	ASSERT_EQ (2, visitor.confirm_ack_count);
+}
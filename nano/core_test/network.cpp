@@ -236,6 +236,29 @@ TEST (network, multi_keepalive)
 	node2->stop ();
 }
 
+TEST (network, udp_batch)
+{
+	nano::system system;
+	nano::node_flags node_flags;
+	node_flags.disable_udp = false;
+	nano::node_config node_config (nano::get_available_port (), system.logging);
+	node_config.udp_batch_size = 8;
+	auto node0 = system.add_node (node_config, node_flags);
+	node_config.peering_port = nano::get_available_port ();
+	auto node1 = system.add_node (node_config, node_flags);
+	auto channel (std::make_shared<nano::transport::channel_udp> (node1->network.udp_channels, node0->network.endpoint (), node1->network_params.protocol.protocol_version));
+	// More sends than fit in one batch
+	for (auto i (0); i < 20; ++i)
+	{
+		node1->network.send_keepalive (channel);
+	}
+	system.deadline_set (10s);
+	while (node0->stats.count (nano::stat::type::message, nano::stat::detail::keepalive, nano::stat::dir::in) < 20)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+}
+
 TEST (network, send_discarded_publish)
 {
 	nano::system system (2);
@@ -777,6 +800,86 @@ TEST (message_buffer_manager, stats)
 	ASSERT_EQ (1, stats.count (nano::stat::type::udp, nano::stat::detail::overflow));
 }
 
+namespace
+{
+nano::tcp_message_item tcp_message (uint16_t port_a)
+{
+	return nano::tcp_message_item{ std::make_shared<nano::keepalive> (), nano::tcp_endpoint (boost::asio::ip::address_v6::loopback (), port_a), 0, nullptr, nano::bootstrap_server_type::realtime };
+}
+}
+
+TEST (tcp_message_manager, round_robin)
+{
+	nano::stat stats;
+	nano::tcp_message_manager manager (stats, 4);
+	for (auto i (0); i < 4; ++i)
+	{
+		manager.put_message (tcp_message (1000));
+	}
+	manager.put_message (tcp_message (2000));
+	manager.put_message (tcp_message (2000));
+	ASSERT_EQ (6, manager.size ());
+	std::vector<nano::tcp_message_item> items;
+	manager.get_messages (items, 5);
+	ASSERT_EQ (5, items.size ());
+	std::vector<uint16_t> ports;
+	for (auto const & item : items)
+	{
+		ports.push_back (item.endpoint.port ());
+	}
+	ASSERT_EQ ((std::vector<uint16_t>{ 1000, 2000, 1000, 2000, 1000 }), ports);
+	ASSERT_EQ (1000, manager.get_message ().endpoint.port ());
+	ASSERT_EQ (0, manager.size ());
+}
+
+TEST (tcp_message_manager, weighted)
+{
+	nano::stat stats;
+	nano::tcp_message_manager manager (stats, 4);
+	auto representative (tcp_message (1000).endpoint);
+	manager.set_weights ({ { representative, nano::Gxrb_ratio } });
+	for (auto i (0); i < 10; ++i)
+	{
+		manager.put_message (tcp_message (1000));
+		manager.put_message (tcp_message (2000));
+	}
+	std::vector<nano::tcp_message_item> items;
+	manager.get_messages (items, 11);
+	ASSERT_EQ (11, items.size ());
+	// The representative takes a full quantum before the other peer is serviced once
+	for (auto i (0u); i < nano::tcp_message_manager::max_quantum; ++i)
+	{
+		ASSERT_EQ (representative, items[i].endpoint);
+	}
+	ASSERT_EQ (2000, items[8].endpoint.port ());
+	ASSERT_EQ (representative, items[9].endpoint);
+	ASSERT_EQ (representative, items[10].endpoint);
+}
+
+TEST (tcp_message_manager, flood)
+{
+	nano::stat stats;
+	nano::tcp_message_manager manager (stats, 4);
+	std::vector<nano::tcp_message_item> sent;
+	for (auto i (0); i < 17; ++i)
+	{
+		sent.push_back (tcp_message (1000));
+		manager.put_message (sent.back ());
+	}
+	manager.put_message (tcp_message (2000));
+	// The oldest message of the flooding peer is dropped
+	ASSERT_EQ (17, manager.size ());
+	ASSERT_EQ (1, stats.count (nano::stat::type::tcp, nano::stat::detail::tcp_message_drop, nano::stat::dir::in));
+	ASSERT_EQ (sent[1].message, manager.get_message ().message);
+	ASSERT_EQ (2000, manager.get_message ().endpoint.port ());
+	manager.stop ();
+	std::vector<nano::tcp_message_item> items;
+	manager.get_messages (items, 32);
+	ASSERT_EQ (15, items.size ());
+	manager.get_messages (items, 32);
+	ASSERT_EQ (15, items.size ());
+}
+
 TEST (tcp_listener, tcp_node_id_handshake)
 {
 	nano::system system (1);
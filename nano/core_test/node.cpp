@@ -312,7 +312,7 @@ TEST (node, auto_bootstrap)
 	}
 
 	auto transaction = node1->store.tx_begin_read ();
-	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->store.unchecked_count (transaction));
+	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->unchecked.count (transaction));
 
 	node1->stop ();
 }
@@ -3262,8 +3262,7 @@ TEST (node, block_processor_signatures)
 	// Invalid signature to unchecked
 	{
 		auto transaction (node1.store.tx_begin_write ());
-		node1.store.unchecked_put (transaction, send5->previous (), send5);
-		++node1.ledger.cache.unchecked_count;
+		node1.unchecked.put (transaction, nano::unchecked_key (send5->previous (), send5->hash ()), nano::unchecked_info (send5, send5->account (), nano::seconds_since_epoch ()));
 	}
 	auto receive1 (std::make_shared<nano::state_block> (key1.pub, 0, nano::test_genesis_key.pub, nano::Gxrb_ratio, send1->hash (), key1.prv, key1.pub, 0));
 	node1.work_generate_blocking (*receive1);
@@ -3375,6 +3374,103 @@ TEST (node, block_processor_half_full)
 	ASSERT_FALSE (node.block_processor.full ());
 }
 
+TEST (node, block_processor_pipeline)
+{
+	nano::system system;
+	nano::node_flags node_flags;
+	node_flags.block_processor_prevalidation_threads = 2;
+	auto & node = *system.add_node (nano::node_config (nano::get_available_port (), system.logging), node_flags);
+	nano::genesis genesis;
+	nano::keypair key;
+	// Legacy block, account is resolved from the previous block during prevalidation
+	auto send1 (std::make_shared<nano::send_block> (genesis.hash (), key.pub, nano::genesis_amount - nano::Gxrb_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	auto send2 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send1->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 2 * nano::Gxrb_ratio, key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (send1->hash ())));
+	node.block_processor.add (send1);
+	node.block_processor.flush ();
+	node.block_processor.add (send2);
+	node.block_processor.flush ();
+	ASSERT_TRUE (node.ledger.block_exists (send1->hash ()));
+	ASSERT_TRUE (node.ledger.block_exists (send2->hash ()));
+	ASSERT_EQ (0, node.block_processor.size ());
+	// Blocks already in the ledger skip signature verification and are classified as old by the committer
+	node.block_processor.add (send2);
+	node.block_processor.flush ();
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::ledger, nano::stat::detail::old));
+	auto container_info (nano::collect_container_info (node.block_processor, "block_processor"));
+	auto composite (dynamic_cast<nano::container_info_composite *> (container_info.get ()));
+	ASSERT_NE (nullptr, composite);
+	std::vector<std::string> names;
+	for (auto const & child : composite->get_children ())
+	{
+		if (child->is_composite ())
+		{
+			names.push_back (static_cast<nano::container_info_composite *> (child.get ())->get_name ());
+		}
+	}
+	ASSERT_NE (names.end (), std::find (names.begin (), names.end (), "prevalidation"));
+	ASSERT_NE (names.end (), std::find (names.begin (), names.end (), "commit_timing"));
+	ASSERT_NE (names.end (), std::find (names.begin (), names.end (), "post_commit_timing"));
+}
+
+TEST (node, block_processor_prevalidation_order)
+{
+	nano::system system;
+	nano::node_flags node_flags;
+	node_flags.block_processor_prevalidation_threads = 4;
+	auto & node = *system.add_node (nano::node_config (nano::get_available_port (), system.logging), node_flags);
+	nano::genesis genesis;
+	std::vector<std::shared_ptr<nano::state_block>> blocks;
+	auto previous (genesis.hash ());
+	for (auto i (1); i <= 600; ++i)
+	{
+		blocks.push_back (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, previous, nano::test_genesis_key.pub, nano::genesis_amount - i, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (previous)));
+		previous = blocks.back ()->hash ();
+	}
+	for (auto const & block : blocks)
+	{
+		node.block_processor.add (block);
+	}
+	node.block_processor.flush ();
+	// Batches prevalidated concurrently are committed in the order the chain was added, without any gaps
+	ASSERT_TRUE (node.ledger.block_exists (blocks.back ()->hash ()));
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::ledger, nano::stat::detail::gap_previous));
+	ASSERT_EQ (0, node.unchecked.count (node.store.tx_begin_read ()));
+}
+
+TEST (node, block_processor_snapshot_validation)
+{
+	nano::system system;
+	nano::node_flags node_flags;
+	node_flags.block_processor_parallel_validation_threads = 4;
+	auto & node = *system.add_node (nano::node_config (nano::get_available_port (), system.logging), node_flags);
+	nano::genesis genesis;
+	nano::keypair key;
+	auto send1 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - 1, key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	auto send2 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send1->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 2, key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (send1->hash ())));
+	auto open (std::make_shared<nano::state_block> (key.pub, 0, key.pub, 2, send2->hash (), key.prv, key.pub, *system.work.generate (key.pub)));
+	// Blocks written outside of the block processor are accounted for so snapshot verdicts are not reused across them
+	ASSERT_EQ (nano::process_result::progress, node.process (*send1).code);
+	ASSERT_EQ (1, node.block_processor.external_writes_started);
+	ASSERT_EQ (1, node.block_processor.external_writes_finished);
+	node.block_processor.add (send1);
+	node.block_processor.add (open);
+	node.block_processor.add (send2);
+	node.block_processor.flush ();
+	ASSERT_EQ (4, node.ledger.cache.block_count);
+	ASSERT_TRUE (node.ledger.block_exists (open->hash ()));
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::ledger, nano::stat::detail::old));
+	// Local blocks from wallets and RPC are accounted for as well, so their queued successors aren't left with a gap verdict
+	auto send3 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send2->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 3, key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (send2->hash ())));
+	auto send4 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send3->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 4, key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (send3->hash ())));
+	ASSERT_EQ (nano::process_result::progress, node.process_local (send3).code);
+	ASSERT_EQ (2, node.block_processor.external_writes_started);
+	ASSERT_EQ (2, node.block_processor.external_writes_finished);
+	node.block_processor.add (send4);
+	node.block_processor.flush ();
+	ASSERT_TRUE (node.ledger.block_exists (send4->hash ()));
+	ASSERT_EQ (0, node.unchecked.count (node.store.tx_begin_read ()));
+}
+
 TEST (node, confirm_back)
 {
 	nano::system system (1);
@@ -3539,7 +3635,7 @@ TEST (node, unchecked_cleanup)
 	node.config.unchecked_cutoff_time = std::chrono::seconds (2);
 	{
 		auto transaction (node.store.tx_begin_read ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node.ledger.cache.unchecked_count);
 	}
@@ -3548,7 +3644,7 @@ TEST (node, unchecked_cleanup)
 	ASSERT_TRUE (node.network.publish_filter.apply (bytes.data (), bytes.size ()));
 	{
 		auto transaction (node.store.tx_begin_read ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node.ledger.cache.unchecked_count);
 	}
@@ -3557,12 +3653,125 @@ TEST (node, unchecked_cleanup)
 	ASSERT_FALSE (node.network.publish_filter.apply (bytes.data (), bytes.size ()));
 	{
 		auto transaction (node.store.tx_begin_read ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node.ledger.cache.unchecked_count);
 	}
 }
 
+TEST (node, unchecked_map_budget)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	auto send1 (std::make_shared<nano::send_block> (1, 0, 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	auto send2 (std::make_shared<nano::send_block> (2, 0, 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	nano::unchecked_key key1 (send1->previous (), send1->hash ());
+	nano::unchecked_key key2 (send2->previous (), send2->hash ());
+	nano::unchecked_info info1 (send1, 0, nano::seconds_since_epoch ());
+	nano::unchecked_info info2 (send2, 0, nano::seconds_since_epoch ());
+	// Budget only fits one entry, the oldest one is spilled to the table
+	{
+		std::atomic<uint64_t> count{ 0 };
+		nano::unchecked_map unchecked (node.store, count, nano::block::size (nano::block_type::send) + 256, true);
+		auto transaction (node.store.tx_begin_write ());
+		unchecked.put (transaction, key1, info1);
+		ASSERT_EQ (0, unchecked.spilled ());
+		unchecked.put (transaction, key2, info2);
+		ASSERT_EQ (1, unchecked.spilled ());
+		ASSERT_EQ (2, count);
+		ASSERT_EQ (2, unchecked.count (transaction));
+		ASSERT_TRUE (node.store.unchecked_exists (transaction, key1));
+		ASSERT_FALSE (node.store.unchecked_exists (transaction, key2));
+		ASSERT_EQ (1, unchecked.get (transaction, 1).size ());
+		ASSERT_EQ (1, unchecked.get (transaction, 2).size ());
+		unchecked.del (transaction, key1);
+		unchecked.del (transaction, key2);
+		ASSERT_EQ (0, unchecked.spilled ());
+		ASSERT_EQ (0, count);
+		ASSERT_EQ (0, unchecked.count (transaction));
+	}
+	// Without spilling the oldest entry is dropped
+	{
+		std::atomic<uint64_t> count{ 0 };
+		nano::unchecked_map unchecked (node.store, count, nano::block::size (nano::block_type::send) + 256, false);
+		auto transaction (node.store.tx_begin_write ());
+		unchecked.put (transaction, key1, info1);
+		unchecked.put (transaction, key2, info2);
+		ASSERT_EQ (0, unchecked.spilled ());
+		ASSERT_EQ (1, count);
+		ASSERT_FALSE (unchecked.exists (transaction, key1));
+		ASSERT_TRUE (unchecked.exists (transaction, key2));
+		ASSERT_EQ (0, node.store.unchecked_count (transaction));
+	}
+}
+
+TEST (node, unchecked_map_for_each)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	auto send1 (std::make_shared<nano::send_block> (1, 0, 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	auto send2 (std::make_shared<nano::send_block> (2, 0, 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	nano::unchecked_key key1 (send1->previous (), send1->hash ());
+	nano::unchecked_key key2 (send2->previous (), send2->hash ());
+	auto now (nano::seconds_since_epoch ());
+	std::atomic<uint64_t> count{ 0 };
+	nano::unchecked_map unchecked (node.store, count, nano::block::size (nano::block_type::send) + 256, true);
+	{
+		auto transaction (node.store.tx_begin_write ());
+		unchecked.put (transaction, key1, nano::unchecked_info (send1, 0, now));
+		unchecked.put (transaction, key2, nano::unchecked_info (send2, 0, now));
+	}
+	ASSERT_EQ (1, unchecked.spilled ());
+	// The entry spilled to the table comes before the one in memory
+	std::vector<nano::unchecked_key> keys;
+	unchecked.for_each (node.store.tx_begin_read (), nano::unchecked_key (0, 0), [&keys](nano::unchecked_key const & key_a, nano::unchecked_info const &) {
+		keys.push_back (key_a);
+		return true;
+	});
+	ASSERT_EQ ((std::vector<nano::unchecked_key>{ key1, key2 }), keys);
+	// Entries left in the table are counted even if the ledger cache didn't count them
+	std::atomic<uint64_t> count_uncached{ 0 };
+	nano::unchecked_map unchecked_uncached (node.store, count_uncached, 0, true);
+	ASSERT_EQ (1, unchecked_uncached.spilled ());
+	// Only entries in memory older than the cutoff are erased
+	ASSERT_TRUE (unchecked.erase_older (now).empty ());
+	ASSERT_EQ (1, unchecked.erase_older (now + 1).size ());
+	ASSERT_EQ (1, count);
+}
+
+TEST (node, unchecked_cleaner)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	std::atomic<uint64_t> count{ 0 };
+	// Nothing fits in memory so every entry is spilled to the table
+	nano::unchecked_map unchecked (node.store, count, 0, true);
+	nano::unchecked_cleaner cleaner (node.store, unchecked, node.write_database_queue, node.network.publish_filter, node.stats, 2);
+	auto now (nano::seconds_since_epoch ());
+	{
+		auto transaction (node.store.tx_begin_write ());
+		for (auto i (1); i <= 4; ++i)
+		{
+			// Dependencies spread over the key space so both ranges have entries
+			nano::block_hash dependency (nano::uint256_t (i) << 253);
+			auto block (std::make_shared<nano::send_block> (dependency, 0, 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+			unchecked.put (transaction, nano::unchecked_key (dependency, block->hash ()), nano::unchecked_info (block, 0, i == 4 ? now : now - 60));
+		}
+	}
+	ASSERT_EQ (4, unchecked.spilled ());
+	ASSERT_EQ (3, cleaner.run (now - 30));
+	ASSERT_EQ (1, count);
+	ASSERT_EQ (3, node.stats.count (nano::stat::type::unchecked, nano::stat::detail::cleanup_deleted, nano::stat::dir::in));
+	ASSERT_EQ (4, node.stats.count (nano::stat::type::unchecked, nano::stat::detail::cleanup_scanned, nano::stat::dir::in));
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::unchecked, nano::stat::detail::cleanup_passes, nano::stat::dir::in));
+	auto transaction (node.store.tx_begin_read ());
+	ASSERT_EQ (1, node.store.unchecked_count (transaction));
+	// A finished pass starts over from the beginning of the table
+	nano::unchecked_key cursor (1, 1);
+	ASSERT_FALSE (node.store.unchecked_cleanup_cursor_get (transaction, cursor));
+	ASSERT_EQ (nano::unchecked_key (), cursor);
+}
+
 /** This checks that a node can be opened (without being blocked) when a write lock is held elsewhere */
 TEST (node, dont_write_lock_node)
 {
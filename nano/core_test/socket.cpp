@@ -205,3 +205,69 @@ TEST (socket, concurrent_writes)
 		t.join ();
 	}
 }
+
+TEST (socket, write_batch)
+{
+	auto node_flags = nano::inactive_node_flag_defaults ();
+	node_flags.read_only = false;
+	nano::inactive_node inactivenode (nano::unique_path (), node_flags);
+	auto node = inactivenode.node;
+
+	nano::thread_runner runner (node->io_ctx, 1);
+
+	// More bytes than a single write takes, so queued buffers are written in several batches
+	constexpr size_t message_count = 100;
+	constexpr size_t message_size = 1000;
+	auto server_port (nano::get_available_port ());
+	boost::asio::ip::tcp::endpoint endpoint (boost::asio::ip::address_v4::any (), server_port);
+
+	auto server_socket (std::make_shared<nano::server_socket> (node, endpoint, 1, nano::socket::concurrency::multi_writer));
+	boost::system::error_code ec;
+	server_socket->start (ec);
+	ASSERT_FALSE (ec);
+
+	auto received (std::make_shared<std::vector<uint8_t>> (message_count * message_size));
+	nano::util::counted_completion read_completion (1);
+	std::vector<std::shared_ptr<nano::socket>> connections;
+	server_socket->on_connection ([&connections, &read_completion, received](std::shared_ptr<nano::socket> new_connection, boost::system::error_code const & ec_a) {
+		connections.push_back (new_connection);
+		new_connection->async_read (received, received->size (), [&read_completion](boost::system::error_code const & ec, size_t size_a) {
+			if (!ec)
+			{
+				read_completion.increment ();
+			}
+		});
+		return true;
+	});
+
+	auto client (std::make_shared<nano::socket> (node, boost::none, nano::socket::concurrency::multi_writer));
+	nano::util::counted_completion write_completion (message_count);
+	std::atomic<size_t> written (0);
+	client->async_connect (boost::asio::ip::tcp::endpoint (boost::asio::ip::address_v4::loopback (), server_port),
+	[client, &write_completion, &written](boost::system::error_code const & ec_a) {
+		for (size_t i = 0; i < message_count; i++)
+		{
+			std::vector<uint8_t> buff (message_size, static_cast<uint8_t> (i));
+			client->async_write (nano::shared_const_buffer (std::move (buff)), [&write_completion, &written](boost::system::error_code const & ec, size_t size_a) {
+				if (!ec)
+				{
+					written += size_a;
+					write_completion.increment ();
+				}
+			});
+		}
+	});
+	ASSERT_FALSE (write_completion.await_count_for (10s));
+	ASSERT_FALSE (read_completion.await_count_for (10s));
+	// Every callback is given the size of its own buffer and the buffers arrive in order
+	ASSERT_EQ (message_count * message_size, written);
+	for (size_t i = 0; i < message_count; i++)
+	{
+		ASSERT_EQ (static_cast<uint8_t> (i), (*received)[i * message_size]);
+		ASSERT_EQ (static_cast<uint8_t> (i), (*received)[(i + 1) * message_size - 1]);
+	}
+
+	node->stop ();
+	runner.stop_event_processing ();
+	runner.join ();
+}
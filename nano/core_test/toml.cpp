@@ -115,6 +115,7 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ss << R"toml(
 	[node]
 	[node.diagnostics.txn_tracking]
+	[node.diagnostics.store_profile]
 	[node.httpcallback]
 	[node.ipc.local]
 	[node.ipc.tcp]
@@ -151,6 +152,7 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.backup_before_upgrade, defaults.node.backup_before_upgrade);
 	ASSERT_EQ (conf.node.bandwidth_limit, defaults.node.bandwidth_limit);
 	ASSERT_EQ (conf.node.bandwidth_limit_burst_ratio, defaults.node.bandwidth_limit_burst_ratio);
+	ASSERT_EQ (conf.node.block_cache_size, defaults.node.block_cache_size);
 	ASSERT_EQ (conf.node.block_processor_batch_max_time, defaults.node.block_processor_batch_max_time);
 	ASSERT_EQ (conf.node.bootstrap_connections, defaults.node.bootstrap_connections);
 	ASSERT_EQ (conf.node.bootstrap_connections_max, defaults.node.bootstrap_connections_max);
@@ -161,9 +163,11 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.enable_voting, defaults.node.enable_voting);
 	ASSERT_EQ (conf.node.external_address, defaults.node.external_address);
 	ASSERT_EQ (conf.node.external_port, defaults.node.external_port);
+	ASSERT_EQ (conf.node.group_commit_max_latency, defaults.node.group_commit_max_latency);
 	ASSERT_EQ (conf.node.io_threads, defaults.node.io_threads);
 	ASSERT_EQ (conf.node.deprecated_lmdb_max_dbs, defaults.node.deprecated_lmdb_max_dbs);
 	ASSERT_EQ (conf.node.max_work_generate_multiplier, defaults.node.max_work_generate_multiplier);
+	ASSERT_EQ (conf.node.membership_filters, defaults.node.membership_filters);
 	ASSERT_EQ (conf.node.network_threads, defaults.node.network_threads);
 	ASSERT_EQ (conf.node.secondary_work_peers, defaults.node.secondary_work_peers);
 	ASSERT_EQ (conf.node.work_watcher_period, defaults.node.work_watcher_period);
@@ -175,10 +179,14 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.preconfigured_peers, defaults.node.preconfigured_peers);
 	ASSERT_EQ (conf.node.preconfigured_representatives, defaults.node.preconfigured_representatives);
 	ASSERT_EQ (conf.node.receive_minimum, defaults.node.receive_minimum);
+	ASSERT_EQ (conf.node.rep_weights_checkpoint, defaults.node.rep_weights_checkpoint);
 	ASSERT_EQ (conf.node.signature_checker_threads, defaults.node.signature_checker_threads);
 	ASSERT_EQ (conf.node.tcp_incoming_connections_max, defaults.node.tcp_incoming_connections_max);
 	ASSERT_EQ (conf.node.tcp_io_timeout, defaults.node.tcp_io_timeout);
+	ASSERT_EQ (conf.node.udp_batch_size, defaults.node.udp_batch_size);
 	ASSERT_EQ (conf.node.unchecked_cutoff_time, defaults.node.unchecked_cutoff_time);
+	ASSERT_EQ (conf.node.unchecked_memory_budget, defaults.node.unchecked_memory_budget);
+	ASSERT_EQ (conf.node.unchecked_spill, defaults.node.unchecked_spill);
 	ASSERT_EQ (conf.node.use_memory_pools, defaults.node.use_memory_pools);
 	ASSERT_EQ (conf.node.vote_generator_delay, defaults.node.vote_generator_delay);
 	ASSERT_EQ (conf.node.vote_generator_threshold, defaults.node.vote_generator_threshold);
@@ -239,6 +247,7 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.diagnostics_config.txn_tracking.ignore_writes_below_block_processor_max_time, defaults.node.diagnostics_config.txn_tracking.ignore_writes_below_block_processor_max_time);
 	ASSERT_EQ (conf.node.diagnostics_config.txn_tracking.min_read_txn_time, defaults.node.diagnostics_config.txn_tracking.min_read_txn_time);
 	ASSERT_EQ (conf.node.diagnostics_config.txn_tracking.min_write_txn_time, defaults.node.diagnostics_config.txn_tracking.min_write_txn_time);
+	ASSERT_EQ (conf.node.diagnostics_config.store_profile.enable, defaults.node.diagnostics_config.store_profile.enable);
 
 	ASSERT_EQ (conf.node.stat_config.sampling_enabled, defaults.node.stat_config.sampling_enabled);
 	ASSERT_EQ (conf.node.stat_config.interval, defaults.node.stat_config.interval);
@@ -253,17 +262,27 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.lmdb_config.sync, defaults.node.lmdb_config.sync);
 	ASSERT_EQ (conf.node.lmdb_config.max_databases, defaults.node.lmdb_config.max_databases);
 	ASSERT_EQ (conf.node.lmdb_config.map_size, defaults.node.lmdb_config.map_size);
+	ASSERT_EQ (conf.node.lmdb_config.read_txn_pool_size, defaults.node.lmdb_config.read_txn_pool_size);
+	ASSERT_EQ (conf.node.lmdb_config.group_sync_interval, defaults.node.lmdb_config.group_sync_interval);
+	ASSERT_EQ (conf.node.lmdb_config.group_sync_commits, defaults.node.lmdb_config.group_sync_commits);
 
 	ASSERT_EQ (conf.node.rocksdb_config.enable, defaults.node.rocksdb_config.enable);
 	ASSERT_EQ (conf.node.rocksdb_config.bloom_filter_bits, defaults.node.rocksdb_config.bloom_filter_bits);
 	ASSERT_EQ (conf.node.rocksdb_config.block_cache, defaults.node.rocksdb_config.block_cache);
 	ASSERT_EQ (conf.node.rocksdb_config.io_threads, defaults.node.rocksdb_config.io_threads);
 	ASSERT_EQ (conf.node.rocksdb_config.enable_pipelined_write, defaults.node.rocksdb_config.enable_pipelined_write);
+	ASSERT_EQ (conf.node.rocksdb_config.write_batch, defaults.node.rocksdb_config.write_batch);
 	ASSERT_EQ (conf.node.rocksdb_config.cache_index_and_filter_blocks, defaults.node.rocksdb_config.cache_index_and_filter_blocks);
 	ASSERT_EQ (conf.node.rocksdb_config.block_size, defaults.node.rocksdb_config.block_size);
 	ASSERT_EQ (conf.node.rocksdb_config.memtable_size, defaults.node.rocksdb_config.memtable_size);
 	ASSERT_EQ (conf.node.rocksdb_config.num_memtables, defaults.node.rocksdb_config.num_memtables);
 	ASSERT_EQ (conf.node.rocksdb_config.total_memtable_size, defaults.node.rocksdb_config.total_memtable_size);
+	ASSERT_EQ (conf.node.rocksdb_config.point_lookup_bloom_filter_bits, defaults.node.rocksdb_config.point_lookup_bloom_filter_bits);
+	ASSERT_EQ (conf.node.rocksdb_config.point_lookup_hash_index, defaults.node.rocksdb_config.point_lookup_hash_index);
+	ASSERT_EQ (conf.node.rocksdb_config.pending_prefix_bloom_filter_bits, defaults.node.rocksdb_config.pending_prefix_bloom_filter_bits);
+	ASSERT_EQ (conf.node.rocksdb_config.fifo_max_size, defaults.node.rocksdb_config.fifo_max_size);
+	ASSERT_EQ (conf.node.rocksdb_config.fifo_ttl, defaults.node.rocksdb_config.fifo_ttl);
+	ASSERT_EQ (conf.node.rocksdb_config.cold_block_cache, defaults.node.rocksdb_config.cold_block_cache);
 }
 
 TEST (toml, optional_child)
@@ -396,6 +415,7 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	backup_before_upgrade = true
 	bandwidth_limit = 999
 	bandwidth_limit_burst_ratio = 999.9
+	block_cache_size = 999
 	block_processor_batch_max_time = 999
 	bootstrap_connections = 999
 	bootstrap_connections_max = 999
@@ -406,8 +426,10 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	enable_voting = false
 	external_address = "0:0:0:0:0:ffff:7f01:101"
 	external_port = 999
+	group_commit_max_latency = 999
 	io_threads = 999
 	lmdb_max_dbs = 999
+	membership_filters = false
 	network_threads = 999
 	online_weight_minimum = "999"
 	online_weight_quorum = 99
@@ -417,10 +439,14 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	preconfigured_peers = ["test.org"]
 	preconfigured_representatives = ["nano_3arg3asgtigae3xckabaaewkx3bzsh7nwz7jkmjos79ihyaxwphhm6qgjps4"]
 	receive_minimum = "999"
+	rep_weights_checkpoint = false
 	signature_checker_threads = 999
 	tcp_incoming_connections_max = 999
 	tcp_io_timeout = 999
+	udp_batch_size = 999
 	unchecked_cutoff_time = 999
+	unchecked_memory_budget = 999
+	unchecked_spill = false
 	use_memory_pools = false
 	vote_generator_delay = 999
 	vote_generator_threshold = 9
@@ -437,6 +463,9 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	min_read_txn_time = 999
 	min_write_txn_time = 999
 
+	[node.diagnostics.store_profile]
+	enable = true
+
 	[node.httpcallback]
 	address = "test.org"
 	port = 999
@@ -510,6 +539,9 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	sync = "nosync_safe"
 	max_databases = 999
 	map_size = 999
+	read_txn_pool_size = 16
+	group_sync_interval = 250
+	group_sync_commits = 64
 
 	[node.rocksdb]
 	enable = true
@@ -517,11 +549,18 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	block_cache = 512
 	io_threads = 99
 	enable_pipelined_write = true
+	write_batch = true
 	cache_index_and_filter_blocks = true
 	block_size = 16
 	memtable_size = 128
 	num_memtables = 3
 	total_memtable_size = 0
+	point_lookup_bloom_filter_bits = 12
+	point_lookup_hash_index = false
+	pending_prefix_bloom_filter_bits = 12
+	fifo_max_size = 999
+	fifo_ttl = 999
+	cold_block_cache = 999
 
 	[node.experimental]
 	secondary_work_peers = ["test.org:998"]
@@ -563,6 +602,7 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.backup_before_upgrade, defaults.node.backup_before_upgrade);
 	ASSERT_NE (conf.node.bandwidth_limit, defaults.node.bandwidth_limit);
 	ASSERT_NE (conf.node.bandwidth_limit_burst_ratio, defaults.node.bandwidth_limit_burst_ratio);
+	ASSERT_NE (conf.node.block_cache_size, defaults.node.block_cache_size);
 	ASSERT_NE (conf.node.block_processor_batch_max_time, defaults.node.block_processor_batch_max_time);
 	ASSERT_NE (conf.node.bootstrap_connections, defaults.node.bootstrap_connections);
 	ASSERT_NE (conf.node.bootstrap_connections_max, defaults.node.bootstrap_connections_max);
@@ -573,9 +613,11 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.enable_voting, defaults.node.enable_voting);
 	ASSERT_NE (conf.node.external_address, defaults.node.external_address);
 	ASSERT_NE (conf.node.external_port, defaults.node.external_port);
+	ASSERT_NE (conf.node.group_commit_max_latency, defaults.node.group_commit_max_latency);
 	ASSERT_NE (conf.node.io_threads, defaults.node.io_threads);
 	ASSERT_NE (conf.node.deprecated_lmdb_max_dbs, defaults.node.deprecated_lmdb_max_dbs);
 	ASSERT_NE (conf.node.max_work_generate_multiplier, defaults.node.max_work_generate_multiplier);
+	ASSERT_NE (conf.node.membership_filters, defaults.node.membership_filters);
 	ASSERT_NE (conf.node.frontiers_confirmation, defaults.node.frontiers_confirmation);
 	ASSERT_NE (conf.node.network_threads, defaults.node.network_threads);
 	ASSERT_NE (conf.node.secondary_work_peers, defaults.node.secondary_work_peers);
@@ -588,10 +630,14 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.preconfigured_peers, defaults.node.preconfigured_peers);
 	ASSERT_NE (conf.node.preconfigured_representatives, defaults.node.preconfigured_representatives);
 	ASSERT_NE (conf.node.receive_minimum, defaults.node.receive_minimum);
+	ASSERT_NE (conf.node.rep_weights_checkpoint, defaults.node.rep_weights_checkpoint);
 	ASSERT_NE (conf.node.signature_checker_threads, defaults.node.signature_checker_threads);
 	ASSERT_NE (conf.node.tcp_incoming_connections_max, defaults.node.tcp_incoming_connections_max);
 	ASSERT_NE (conf.node.tcp_io_timeout, defaults.node.tcp_io_timeout);
+	ASSERT_NE (conf.node.udp_batch_size, defaults.node.udp_batch_size);
 	ASSERT_NE (conf.node.unchecked_cutoff_time, defaults.node.unchecked_cutoff_time);
+	ASSERT_NE (conf.node.unchecked_memory_budget, defaults.node.unchecked_memory_budget);
+	ASSERT_NE (conf.node.unchecked_spill, defaults.node.unchecked_spill);
 	ASSERT_NE (conf.node.use_memory_pools, defaults.node.use_memory_pools);
 	ASSERT_NE (conf.node.vote_generator_delay, defaults.node.vote_generator_delay);
 	ASSERT_NE (conf.node.vote_generator_threshold, defaults.node.vote_generator_threshold);
@@ -652,6 +698,7 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.diagnostics_config.txn_tracking.ignore_writes_below_block_processor_max_time, defaults.node.diagnostics_config.txn_tracking.ignore_writes_below_block_processor_max_time);
 	ASSERT_NE (conf.node.diagnostics_config.txn_tracking.min_read_txn_time, defaults.node.diagnostics_config.txn_tracking.min_read_txn_time);
 	ASSERT_NE (conf.node.diagnostics_config.txn_tracking.min_write_txn_time, defaults.node.diagnostics_config.txn_tracking.min_write_txn_time);
+	ASSERT_NE (conf.node.diagnostics_config.store_profile.enable, defaults.node.diagnostics_config.store_profile.enable);
 
 	ASSERT_NE (conf.node.stat_config.sampling_enabled, defaults.node.stat_config.sampling_enabled);
 	ASSERT_NE (conf.node.stat_config.interval, defaults.node.stat_config.interval);
@@ -666,17 +713,27 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.lmdb_config.sync, defaults.node.lmdb_config.sync);
 	ASSERT_NE (conf.node.lmdb_config.max_databases, defaults.node.lmdb_config.max_databases);
 	ASSERT_NE (conf.node.lmdb_config.map_size, defaults.node.lmdb_config.map_size);
+	ASSERT_NE (conf.node.lmdb_config.read_txn_pool_size, defaults.node.lmdb_config.read_txn_pool_size);
+	ASSERT_NE (conf.node.lmdb_config.group_sync_interval, defaults.node.lmdb_config.group_sync_interval);
+	ASSERT_NE (conf.node.lmdb_config.group_sync_commits, defaults.node.lmdb_config.group_sync_commits);
 
 	ASSERT_NE (conf.node.rocksdb_config.enable, defaults.node.rocksdb_config.enable);
 	ASSERT_NE (conf.node.rocksdb_config.bloom_filter_bits, defaults.node.rocksdb_config.bloom_filter_bits);
 	ASSERT_NE (conf.node.rocksdb_config.block_cache, defaults.node.rocksdb_config.block_cache);
 	ASSERT_NE (conf.node.rocksdb_config.io_threads, defaults.node.rocksdb_config.io_threads);
 	ASSERT_NE (conf.node.rocksdb_config.enable_pipelined_write, defaults.node.rocksdb_config.enable_pipelined_write);
+	ASSERT_NE (conf.node.rocksdb_config.write_batch, defaults.node.rocksdb_config.write_batch);
 	ASSERT_NE (conf.node.rocksdb_config.cache_index_and_filter_blocks, defaults.node.rocksdb_config.cache_index_and_filter_blocks);
 	ASSERT_NE (conf.node.rocksdb_config.block_size, defaults.node.rocksdb_config.block_size);
 	ASSERT_NE (conf.node.rocksdb_config.memtable_size, defaults.node.rocksdb_config.memtable_size);
 	ASSERT_NE (conf.node.rocksdb_config.num_memtables, defaults.node.rocksdb_config.num_memtables);
 	ASSERT_NE (conf.node.rocksdb_config.total_memtable_size, defaults.node.rocksdb_config.total_memtable_size);
+	ASSERT_NE (conf.node.rocksdb_config.point_lookup_bloom_filter_bits, defaults.node.rocksdb_config.point_lookup_bloom_filter_bits);
+	ASSERT_NE (conf.node.rocksdb_config.point_lookup_hash_index, defaults.node.rocksdb_config.point_lookup_hash_index);
+	ASSERT_NE (conf.node.rocksdb_config.pending_prefix_bloom_filter_bits, defaults.node.rocksdb_config.pending_prefix_bloom_filter_bits);
+	ASSERT_NE (conf.node.rocksdb_config.fifo_max_size, defaults.node.rocksdb_config.fifo_max_size);
+	ASSERT_NE (conf.node.rocksdb_config.fifo_ttl, defaults.node.rocksdb_config.fifo_ttl);
+	ASSERT_NE (conf.node.rocksdb_config.cold_block_cache, defaults.node.rocksdb_config.cold_block_cache);
 }
 
 /** There should be no required values **/
@@ -1,3 +1,4 @@
+#include <nano/lib/mpmc_ring.hpp>
 #include <nano/lib/optional_ptr.hpp>
 #include <nano/lib/rate_limiting.hpp>
 #include <nano/lib/threading.hpp>
@@ -230,4 +231,71 @@ TEST (relaxed_atomic_integral, many_threads)
 
 	// Check values
 	ASSERT_EQ (0, atomic);
-}
\ No newline at end of file
+}
+
+TEST (mpmc_ring, basic)
+{
+	nano::mpmc_ring<int> ring (3);
+	ASSERT_EQ (4, ring.capacity ());
+	int value (0);
+	ASSERT_FALSE (ring.pop (value));
+	for (auto i (0); i < 4; ++i)
+	{
+		ASSERT_TRUE (ring.push (i));
+	}
+	ASSERT_FALSE (ring.push (4));
+	ASSERT_TRUE (ring.pop (value));
+	ASSERT_EQ (0, value);
+	ASSERT_TRUE (ring.push (4));
+	for (auto i (1); i < 5; ++i)
+	{
+		ASSERT_TRUE (ring.pop (value));
+		ASSERT_EQ (i, value);
+	}
+	ASSERT_FALSE (ring.pop (value));
+}
+
+TEST (mpmc_ring, many_threads)
+{
+	nano::mpmc_ring<uint64_t> ring (64);
+	std::vector<std::thread> threads;
+	auto num = 4;
+	uint64_t const per_thread (10000);
+	std::atomic<uint64_t> sum{ 0 };
+	std::atomic<uint64_t> popped{ 0 };
+	for (int i = 0; i < num; ++i)
+	{
+		threads.emplace_back ([&ring, per_thread] {
+			for (uint64_t value (1); value <= per_thread; ++value)
+			{
+				while (!ring.push (value))
+				{
+					std::this_thread::yield ();
+				}
+			}
+		});
+		threads.emplace_back ([&ring, &sum, &popped, num, per_thread] {
+			uint64_t value (0);
+			while (popped < num * per_thread)
+			{
+				if (ring.pop (value))
+				{
+					sum += value;
+					++popped;
+				}
+				else
+				{
+					std::this_thread::yield ();
+				}
+			}
+		});
+	}
+
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+
+	// Every value was popped exactly once
+	ASSERT_EQ (num * per_thread * (per_thread + 1) / 2, sum);
+}
@@ -159,7 +159,7 @@ TEST (vote_processor, weights)
 
 	// Wait for representatives
 	system.deadline_set (10s);
-	while (node.ledger.cache.rep_weights.get_rep_amounts ().size () != 4)
+	while (node.ledger.cache.rep_weights.get_rep_amounts ()->size () != 4)
 	{
 		ASSERT_NO_ERROR (system.poll ());
 	}
@@ -40,6 +40,10 @@ nano::error nano::diagnostics_config::serialize_toml (nano::tomlconfig & toml) c
 	txn_tracking_l.put ("min_write_txn_time", txn_tracking.min_write_txn_time.count (), "Log stacktrace when write transactions are held longer than this duration.\ntype:milliseconds");
 	txn_tracking_l.put ("ignore_writes_below_block_processor_max_time", txn_tracking.ignore_writes_below_block_processor_max_time, "Ignore any block processor writes less than block_processor_batch_max_time.\ntype:bool");
 	toml.put_child ("txn_tracking", txn_tracking_l);
+
+	nano::tomlconfig store_profile_l;
+	store_profile_l.put ("enable", store_profile.enable, "Record per table operation counts, latency histograms and bytes read or written, reported by the stats RPC with type \"store\". Adds a clock read to each database operation.\ntype:bool");
+	toml.put_child ("store_profile", store_profile_l);
 	return toml.get_error ();
 }
 
@@ -59,5 +63,11 @@ nano::error nano::diagnostics_config::deserialize_toml (nano::tomlconfig & toml)
 
 		txn_tracking_l->get_optional<bool> ("ignore_writes_below_block_processor_max_time", txn_tracking.ignore_writes_below_block_processor_max_time);
 	}
+
+	auto store_profile_l (toml.get_optional_child ("store_profile"));
+	if (store_profile_l)
+	{
+		store_profile_l->get_optional<bool> ("enable", store_profile.enable);
+	}
 	return toml.get_error ();
 }
@@ -18,6 +18,13 @@ public:
 	bool ignore_writes_below_block_processor_max_time{ true };
 };
 
+class store_profile_config final
+{
+public:
+	/** If true, record per table counts, latencies and bytes of ledger database operations */
+	bool enable{ false };
+};
+
 /** Configuration options for diagnostics information */
 class diagnostics_config final
 {
@@ -28,5 +35,6 @@ public:
 	nano::error deserialize_toml (nano::tomlconfig &);
 
 	txn_tracking_config txn_tracking;
+	store_profile_config store_profile;
 };
 }
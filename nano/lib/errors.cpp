@@ -169,6 +169,10 @@ std::string nano::error_rpc_messages::message (int ev) const
 			return "Provided work is already enough for given difficulty";
 		case nano::error_rpc::block_work_version_mismatch:
 			return "Work version mismatch for block";
+		case nano::error_rpc::compaction_not_copying:
+			return "There is no database compaction copy in progress to pause or resume";
+		case nano::error_rpc::compaction_not_started:
+			return "Database compaction could not be started, it is either already running or not supported by the database backend";
 		case nano::error_rpc::confirmation_height_not_processing:
 			return "There are no blocks currently being processed for adding confirmation height";
 		case nano::error_rpc::confirmation_not_found:
@@ -181,6 +185,8 @@ std::string nano::error_rpc_messages::message (int ev) const
 			return "Legacy bootstrap is disabled";
 		case nano::error_rpc::invalid_balance:
 			return "Invalid balance number";
+		case nano::error_rpc::invalid_compaction_command:
+			return "Invalid compaction command, expected start, pause, resume or status";
 		case nano::error_rpc::invalid_destinations:
 			return "Invalid destinations number";
 		case nano::error_rpc::invalid_epoch:
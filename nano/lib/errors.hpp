@@ -97,12 +97,15 @@ enum class error_rpc
 	block_root_mismatch,
 	block_work_enough,
 	block_work_version_mismatch,
+	compaction_not_copying,
+	compaction_not_started,
 	confirmation_height_not_processing,
 	confirmation_not_found,
 	difficulty_limit,
 	disabled_bootstrap_lazy,
 	disabled_bootstrap_legacy,
 	invalid_balance,
+	invalid_compaction_command,
 	invalid_destinations,
 	invalid_epoch,
 	invalid_epoch_signer,
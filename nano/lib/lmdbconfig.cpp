@@ -4,28 +4,38 @@
 
 #include <iostream>
 
-nano::error nano::lmdb_config::serialize_toml (nano::tomlconfig & toml) const
+std::string nano::lmdb_config::sync_strategy_string (nano::lmdb_config::sync_strategy sync_a)
 {
-	std::string sync_string;
-	switch (sync)
+	std::string result;
+	switch (sync_a)
 	{
 		case nano::lmdb_config::sync_strategy::always:
-			sync_string = "always";
+			result = "always";
 			break;
 		case nano::lmdb_config::sync_strategy::nosync_safe:
-			sync_string = "nosync_safe";
+			result = "nosync_safe";
 			break;
 		case nano::lmdb_config::sync_strategy::nosync_unsafe:
-			sync_string = "nosync_unsafe";
+			result = "nosync_unsafe";
 			break;
 		case nano::lmdb_config::sync_strategy::nosync_unsafe_large_memory:
-			sync_string = "nosync_unsafe_large_memory";
+			result = "nosync_unsafe_large_memory";
+			break;
+		case nano::lmdb_config::sync_strategy::group:
+			result = "group";
 			break;
 	}
+	return result;
+}
 
-	toml.put ("sync", sync_string, "Sync strategy for flushing commits to the ledger database. This does not affect the wallet database.\ntype:string,{always, nosync_safe, nosync_unsafe, nosync_unsafe_large_memory}");
+nano::error nano::lmdb_config::serialize_toml (nano::tomlconfig & toml) const
+{
+	toml.put ("sync", sync_strategy_string (sync), "Sync strategy for flushing commits to the ledger database. This does not affect the wallet database.\ntype:string,{always, nosync_safe, nosync_unsafe, nosync_unsafe_large_memory, group}");
+	toml.put ("group_sync_interval", group_sync_interval.count (), "Longest time a commit waits to be flushed to disk with the group sync strategy. An operating system crash may lose the commits made since the last flush.\ntype:milliseconds");
+	toml.put ("group_sync_commits", group_sync_commits, "Number of commits which are flushed to disk without waiting for the interval with the group sync strategy.\ntype:uint64");
 	toml.put ("max_databases", max_databases, "Maximum open lmdb databases. Increase default if more than 100 wallets is required.\nNote: external management is recommended when a large amounts of wallets are required (see https://docs.nano.org/integration-guides/key-management/).\ntype:uin32");
 	toml.put ("map_size", map_size, "Maximum ledger database map size in bytes.\ntype:uint64");
+	toml.put ("read_txn_pool_size", read_txn_pool_size, "Maximum idle read transactions kept for reuse by the ledger database. Each holds a reader slot, 0 disables reuse.\ntype:uint64");
 	return toml.get_error ();
 }
 
@@ -35,6 +45,11 @@ nano::error nano::lmdb_config::deserialize_toml (nano::tomlconfig & toml, bool i
 	auto default_max_databases = max_databases;
 	toml.get_optional<uint32_t> ("max_databases", max_databases);
 	toml.get_optional<size_t> ("map_size", map_size);
+	toml.get_optional<size_t> ("read_txn_pool_size", read_txn_pool_size);
+	auto group_sync_interval_l (group_sync_interval.count ());
+	toml.get_optional ("group_sync_interval", group_sync_interval_l);
+	group_sync_interval = std::chrono::milliseconds (group_sync_interval_l);
+	toml.get_optional<uint64_t> ("group_sync_commits", group_sync_commits);
 
 	// For now we accept either setting, but not both
 	if (!params.network.is_test_network () && is_deprecated_lmdb_dbs_used && default_max_databases != max_databases)
@@ -62,6 +77,10 @@ nano::error nano::lmdb_config::deserialize_toml (nano::tomlconfig & toml, bool i
 		{
 			sync = nano::lmdb_config::sync_strategy::nosync_unsafe_large_memory;
 		}
+		else if (sync_string == "group")
+		{
+			sync = nano::lmdb_config::sync_strategy::group;
+		}
 		else
 		{
 			toml.get_error ().set (sync_string + " is not a valid sync option");
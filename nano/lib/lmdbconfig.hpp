@@ -2,6 +2,8 @@
 
 #include <nano/lib/errors.hpp>
 
+#include <chrono>
+#include <string>
 #include <thread>
 
 namespace nano
@@ -36,15 +38,29 @@ public:
 		 * may be slower.
 		 * @warning Do not use this option if external processes uses the database concurrently.
 		 */
-		nosync_unsafe_large_memory
+		nosync_unsafe_large_memory,
+
+		/**
+		 * Commits don't wait for a flush to disk, a background thread flushes them every group_sync_interval or after
+		 * group_sync_commits commits, whichever comes first. A system crash loses at most the commits since the last flush,
+		 * which is reported by the database_durability RPC. Integrity is kept on filesystems with write ordering, as with nosync_unsafe.
+		 */
+		group
 	};
+	static std::string sync_strategy_string (sync_strategy);
 
 	nano::error serialize_toml (nano::tomlconfig & toml_a) const;
 	nano::error deserialize_toml (nano::tomlconfig & toml_a, bool is_deprecated_lmdb_dbs_used);
 
 	/** Sync strategy for the ledger database */
 	sync_strategy sync{ always };
+	/** Longest time commits wait to be flushed when using the group sync strategy */
+	std::chrono::milliseconds group_sync_interval{ 100 };
+	/** Commits which trigger a flush before the interval elapses when using the group sync strategy */
+	uint64_t group_sync_commits{ 1024 };
 	uint32_t max_databases{ 128 };
 	size_t map_size{ 128ULL * 1024 * 1024 * 1024 };
+	/** Idle read transactions kept for reuse, each holds a reader slot */
+	size_t read_txn_pool_size{ 32 };
 };
 }
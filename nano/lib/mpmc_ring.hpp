@@ -0,0 +1,125 @@
+#pragma once
+
+#include <nano/lib/utility.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Bounded multi-producer multi-consumer queue which doesn't lock. Every cell has a sequence number telling producers and consumers
+ * whose turn it is, a position is claimed with a compare-exchange and published by advancing the sequence of its cell.
+ * Capacity is rounded up to a power of two.
+ */
+template <typename T>
+class mpmc_ring final
+{
+public:
+	explicit mpmc_ring (size_t capacity_a) :
+	cells (round_up (capacity_a)),
+	mask (cells.size () - 1)
+	{
+		for (size_t i (0); i < cells.size (); ++i)
+		{
+			cells[i].sequence.store (i, std::memory_order_relaxed);
+		}
+	}
+
+	/** Returns false if the ring is full */
+	bool push (T const & value_a)
+	{
+		auto result (false);
+		auto position (enqueue_position.load (std::memory_order_relaxed));
+		for (auto done (false); !done;)
+		{
+			auto & cell (cells[position & mask]);
+			auto sequence (cell.sequence.load (std::memory_order_acquire));
+			auto difference (static_cast<std::ptrdiff_t> (sequence - position));
+			if (difference == 0)
+			{
+				// On failure position is reloaded with the current value
+				if (enqueue_position.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+				{
+					cell.value = value_a;
+					cell.sequence.store (position + 1, std::memory_order_release);
+					result = true;
+					done = true;
+				}
+			}
+			else if (difference < 0)
+			{
+				// The cell still holds the value from the previous lap
+				done = true;
+			}
+			else
+			{
+				position = enqueue_position.load (std::memory_order_relaxed);
+			}
+		}
+		return result;
+	}
+
+	/** Returns false if the ring is empty */
+	bool pop (T & value_a)
+	{
+		auto result (false);
+		auto position (dequeue_position.load (std::memory_order_relaxed));
+		for (auto done (false); !done;)
+		{
+			auto & cell (cells[position & mask]);
+			auto sequence (cell.sequence.load (std::memory_order_acquire));
+			auto difference (static_cast<std::ptrdiff_t> (sequence - (position + 1)));
+			if (difference == 0)
+			{
+				if (dequeue_position.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+				{
+					value_a = cell.value;
+					// Frees the cell for the producer one lap ahead
+					cell.sequence.store (position + mask + 1, std::memory_order_release);
+					result = true;
+					done = true;
+				}
+			}
+			else if (difference < 0)
+			{
+				// Nothing has been published in this cell yet
+				done = true;
+			}
+			else
+			{
+				position = dequeue_position.load (std::memory_order_relaxed);
+			}
+		}
+		return result;
+	}
+
+	size_t capacity () const
+	{
+		return cells.size ();
+	}
+
+private:
+	class cell final
+	{
+	public:
+		std::atomic<size_t> sequence;
+		T value;
+	};
+	static size_t round_up (size_t capacity_a)
+	{
+		debug_assert (capacity_a > 0);
+		size_t result (1);
+		while (result < capacity_a)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+	std::vector<cell> cells;
+	size_t const mask;
+	// Producers and consumers update separate cache lines
+	alignas (64) std::atomic<size_t> enqueue_position{ 0 };
+	alignas (64) std::atomic<size_t> dequeue_position{ 0 };
+};
+}
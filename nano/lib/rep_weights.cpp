@@ -1,50 +1,102 @@
 #include <nano/lib/rep_weights.hpp>
 #include <nano/secure/blockstore.hpp>
 
+size_t constexpr nano::rep_weights::shard_count;
+
 void nano::rep_weights::representation_add (nano::account const & source_rep, nano::uint128_t const & amount_a)
 {
-	nano::lock_guard<std::mutex> guard (mutex);
-	auto source_previous (get (source_rep));
-	put (source_rep, source_previous + amount_a);
+	auto & shard_l (shard_for (source_rep));
+	{
+		nano::lock_guard<std::mutex> guard (shard_l.mutex);
+		auto source_previous (get (shard_l, source_rep));
+		put (shard_l, source_rep, source_previous + amount_a);
+	}
+	++generation;
+}
+
+void nano::rep_weights::representation_add_dual (nano::account const & source_rep_1, nano::uint128_t const & amount_1, nano::account const & source_rep_2, nano::uint128_t const & amount_2)
+{
+	auto & shard_1 (shard_for (source_rep_1));
+	auto & shard_2 (shard_for (source_rep_2));
+	if (&shard_1 == &shard_2)
+	{
+		nano::lock_guard<std::mutex> guard (shard_1.mutex);
+		put (shard_1, source_rep_1, get (shard_1, source_rep_1) + amount_1);
+		put (shard_1, source_rep_2, get (shard_1, source_rep_2) + amount_2);
+	}
+	else
+	{
+		// Shards are always locked in the same order so concurrent dual updates cannot deadlock
+		auto first (&shard_1 < &shard_2 ? &shard_1 : &shard_2);
+		auto second (&shard_1 < &shard_2 ? &shard_2 : &shard_1);
+		nano::lock_guard<std::mutex> guard_1 (first->mutex);
+		nano::lock_guard<std::mutex> guard_2 (second->mutex);
+		put (shard_1, source_rep_1, get (shard_1, source_rep_1) + amount_1);
+		put (shard_2, source_rep_2, get (shard_2, source_rep_2) + amount_2);
+	}
+	++generation;
 }
 
 void nano::rep_weights::representation_put (nano::account const & account_a, nano::uint128_union const & representation_a)
 {
-	nano::lock_guard<std::mutex> guard (mutex);
-	put (account_a, representation_a);
+	auto & shard_l (shard_for (account_a));
+	{
+		nano::lock_guard<std::mutex> guard (shard_l.mutex);
+		put (shard_l, account_a, representation_a);
+	}
+	++generation;
 }
 
 nano::uint128_t nano::rep_weights::representation_get (nano::account const & account_a)
 {
-	nano::lock_guard<std::mutex> lk (mutex);
-	return get (account_a);
+	auto & shard_l (shard_for (account_a));
+	nano::lock_guard<std::mutex> lk (shard_l.mutex);
+	return get (shard_l, account_a);
 }
 
-/** Makes a copy */
-std::unordered_map<nano::account, nano::uint128_t> nano::rep_weights::get_rep_amounts ()
+std::shared_ptr<nano::rep_weights::rep_amounts_t const> nano::rep_weights::get_rep_amounts ()
 {
-	nano::lock_guard<std::mutex> guard (mutex);
-	return rep_amounts;
+	nano::lock_guard<std::mutex> guard (snapshot_mutex);
+	auto generation_l (generation.load ());
+	if (snapshot == nullptr || snapshot_generation != generation_l)
+	{
+		// Changes made while copying bump the generation again, so the next call picks them up
+		auto rep_amounts_l (std::make_shared<rep_amounts_t> ());
+		for (auto & shard_l : shards)
+		{
+			nano::lock_guard<std::mutex> shard_guard (shard_l.mutex);
+			rep_amounts_l->insert (shard_l.rep_amounts.begin (), shard_l.rep_amounts.end ());
+		}
+		snapshot = rep_amounts_l;
+		snapshot_generation = generation_l;
+	}
+	return snapshot;
 }
 
-void nano::rep_weights::put (nano::account const & account_a, nano::uint128_union const & representation_a)
+nano::rep_weights::shard & nano::rep_weights::shard_for (nano::account const & account_a)
 {
-	auto it = rep_amounts.find (account_a);
+	static_assert ((shard_count & (shard_count - 1)) == 0, "Shard count must be a power of 2");
+	return shards[account_a.bytes[0] & (shard_count - 1)];
+}
+
+void nano::rep_weights::put (shard & shard_a, nano::account const & account_a, nano::uint128_union const & representation_a)
+{
+	auto it = shard_a.rep_amounts.find (account_a);
 	auto amount = representation_a.number ();
-	if (it != rep_amounts.end ())
+	if (it != shard_a.rep_amounts.end ())
 	{
 		it->second = amount;
 	}
 	else
 	{
-		rep_amounts.emplace (account_a, amount);
+		shard_a.rep_amounts.emplace (account_a, amount);
 	}
 }
 
-nano::uint128_t nano::rep_weights::get (nano::account const & account_a)
+nano::uint128_t nano::rep_weights::get (shard & shard_a, nano::account const & account_a)
 {
-	auto it = rep_amounts.find (account_a);
-	if (it != rep_amounts.end ())
+	auto it = shard_a.rep_amounts.find (account_a);
+	if (it != shard_a.rep_amounts.end ())
 	{
 		return it->second;
 	}
@@ -56,13 +108,13 @@ nano::uint128_t nano::rep_weights::get (nano::account const & account_a)
 
 std::unique_ptr<nano::container_info_component> nano::collect_container_info (nano::rep_weights & rep_weights, const std::string & name)
 {
-	size_t rep_amounts_count;
-
+	size_t rep_amounts_count (0);
+	for (auto & shard : rep_weights.shards)
 	{
-		nano::lock_guard<std::mutex> guard (rep_weights.mutex);
-		rep_amounts_count = rep_weights.rep_amounts.size ();
+		nano::lock_guard<std::mutex> guard (shard.mutex);
+		rep_amounts_count += shard.rep_amounts.size ();
 	}
-	auto sizeof_element = sizeof (decltype (rep_weights.rep_amounts)::value_type);
+	auto sizeof_element = sizeof (nano::rep_weights::rep_amounts_t::value_type);
 	auto composite = std::make_unique<nano::container_info_composite> (name);
 	composite->add_component (std::make_unique<nano::container_info_leaf> (container_info{ "rep_amounts", rep_amounts_count, sizeof_element }));
 	return composite;
@@ -3,6 +3,8 @@
 #include <nano/lib/numbers.hpp>
 #include <nano/lib/utility.hpp>
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -12,19 +14,39 @@ namespace nano
 class block_store;
 class transaction;
 
+/**
+ * Voting weight of each representative. Weights are split by account over independently locked shards so
+ * weight lookups from vote processing only contend with updates to representatives in the same shard.
+ */
 class rep_weights
 {
 public:
+	using rep_amounts_t = std::unordered_map<nano::account, nano::uint128_t>;
 	void representation_add (nano::account const & source_a, nano::uint128_t const & amount_a);
+	/** Moves weight between two representatives as a single update */
+	void representation_add_dual (nano::account const & source_a, nano::uint128_t const & amount_a, nano::account const & source_2_a, nano::uint128_t const & amount_2_a);
 	nano::uint128_t representation_get (nano::account const & account_a);
 	void representation_put (nano::account const & account_a, nano::uint128_union const & representation_a);
-	std::unordered_map<nano::account, nano::uint128_t> get_rep_amounts ();
+	/** Snapshot of all weights, shared between callers until a weight changes */
+	std::shared_ptr<rep_amounts_t const> get_rep_amounts ();
+	static size_t constexpr shard_count{ 16 };
 
 private:
-	std::mutex mutex;
-	std::unordered_map<nano::account, nano::uint128_t> rep_amounts;
-	void put (nano::account const & account_a, nano::uint128_union const & representation_a);
-	nano::uint128_t get (nano::account const & account_a);
+	class shard final
+	{
+	public:
+		std::mutex mutex;
+		rep_amounts_t rep_amounts;
+	};
+	std::array<shard, shard_count> shards;
+	// Incremented on every change to invalidate the snapshot
+	std::atomic<uint64_t> generation{ 0 };
+	std::mutex snapshot_mutex;
+	std::shared_ptr<rep_amounts_t const> snapshot;
+	uint64_t snapshot_generation{ 0 };
+	shard & shard_for (nano::account const & account_a);
+	void put (shard &, nano::account const & account_a, nano::uint128_union const & representation_a);
+	nano::uint128_t get (shard &, nano::account const & account_a);
 
 	friend std::unique_ptr<container_info_component> collect_container_info (rep_weights &, const std::string &);
 };
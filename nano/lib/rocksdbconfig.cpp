@@ -5,6 +5,7 @@ nano::error nano::rocksdb_config::serialize_toml (nano::tomlconfig & toml) const
 {
 	toml.put ("enable", enable, "Whether to use the RocksDB backend for the ledger database.\ntype:bool");
 	toml.put ("enable_pipelined_write", enable_pipelined_write, "Whether to use 2 separate write queues for memtable/WAL, true is recommended.\ntype:bool");
+	toml.put ("write_batch", write_batch, "Whether writes are collected in batches written at once instead of going through transactions, keeping table counts in memory. Faster when blocks are processed in bulk such as bootstrapping.\ntype:bool");
 	toml.put ("cache_index_and_filter_blocks", cache_index_and_filter_blocks, "Whether index and filter blocks are stored in block_cache, true is recommended.\ntype:bool");
 	toml.put ("bloom_filter_bits", bloom_filter_bits, "Number of bits to use with a bloom filter. Helps with point reads but uses more memory. 0 disables the bloom filter, 10 is recommended.\ntype:uint32");
 	toml.put ("block_cache", block_cache, "Size (MB) of the block cache; A larger number will increase performance of read operations. At least 512MB is recommended.\ntype:uint64");
@@ -13,6 +14,12 @@ nano::error nano::rocksdb_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("num_memtables", num_memtables, "Number of memtables to keep in memory per column family. 2 is the minimum, 3 is recommended.\ntype:uint32");
 	toml.put ("memtable_size", memtable_size, "Amount of memory (MB) to build up before flushing to disk for an individual column family. Large values increase performance. 64 or 128 is recommended.\ntype:uint32");
 	toml.put ("total_memtable_size", total_memtable_size, "Total memory (MB) which can be used across all memtables, set to 0 for unconstrained.\ntype:uint32");
+	toml.put ("point_lookup_bloom_filter_bits", point_lookup_bloom_filter_bits, "Number of bits to use with the bloom filter of the accounts, blocks and confirmation height tables, which are mostly read by key. Overrides bloom_filter_bits for these tables, 0 disables the bloom filter.\ntype:uint32");
+	toml.put ("point_lookup_hash_index", point_lookup_hash_index, "Whether blocks of the accounts, blocks and confirmation height tables have a hash index, making reads by key faster at the cost of a few percent of space.\ntype:bool");
+	toml.put ("pending_prefix_bloom_filter_bits", pending_prefix_bloom_filter_bits, "Number of bits to use with the bloom filter of the pending table, which also filters on the account part of the key. 0 disables the bloom filter.\ntype:uint32");
+	toml.put ("fifo_max_size", fifo_max_size, "Size (MB) the online weight table is kept under by dropping its oldest files, set to 0 to compact it like other tables. Changing between 0 and another value clears the table on the next start.\ntype:uint64");
+	toml.put ("fifo_ttl", fifo_ttl, "Age (hours) after which files of the online weight table are dropped when fifo_max_size is set, 0 keeps them until the size is reached.\ntype:uint64");
+	toml.put ("cold_block_cache", cold_block_cache, "Size (MB) of the block cache used by tables other than accounts, blocks, confirmation height and pending.\ntype:uint64");
 	return toml.get_error ();
 }
 
@@ -20,6 +27,7 @@ nano::error nano::rocksdb_config::deserialize_toml (nano::tomlconfig & toml)
 {
 	toml.get_optional<bool> ("enable", enable);
 	toml.get_optional<bool> ("enable_pipelined_write", enable_pipelined_write);
+	toml.get_optional<bool> ("write_batch", write_batch);
 	toml.get_optional<bool> ("cache_index_and_filter_blocks", cache_index_and_filter_blocks);
 	toml.get_optional<unsigned> ("bloom_filter_bits", bloom_filter_bits);
 	toml.get_optional<uint64_t> ("block_cache", block_cache);
@@ -28,12 +36,26 @@ nano::error nano::rocksdb_config::deserialize_toml (nano::tomlconfig & toml)
 	toml.get_optional<unsigned> ("num_memtables", num_memtables);
 	toml.get_optional<unsigned> ("memtable_size", memtable_size);
 	toml.get_optional<unsigned> ("total_memtable_size", total_memtable_size);
+	toml.get_optional<unsigned> ("point_lookup_bloom_filter_bits", point_lookup_bloom_filter_bits);
+	toml.get_optional<bool> ("point_lookup_hash_index", point_lookup_hash_index);
+	toml.get_optional<unsigned> ("pending_prefix_bloom_filter_bits", pending_prefix_bloom_filter_bits);
+	toml.get_optional<uint64_t> ("fifo_max_size", fifo_max_size);
+	toml.get_optional<uint64_t> ("fifo_ttl", fifo_ttl);
+	toml.get_optional<uint64_t> ("cold_block_cache", cold_block_cache);
 
 	// Validate ranges
 	if (bloom_filter_bits > 100)
 	{
 		toml.get_error ().set ("bloom_filter_bits is too high");
 	}
+	if (point_lookup_bloom_filter_bits > 100)
+	{
+		toml.get_error ().set ("point_lookup_bloom_filter_bits is too high");
+	}
+	if (pending_prefix_bloom_filter_bits > 100)
+	{
+		toml.get_error ().set ("pending_prefix_bloom_filter_bits is too high");
+	}
 	if (num_memtables < 2)
 	{
 		toml.get_error ().set ("num_memtables must be at least 2");
@@ -20,10 +20,18 @@ public:
 	uint64_t block_cache{ 64 }; // MB
 	unsigned io_threads{ std::thread::hardware_concurrency () };
 	bool enable_pipelined_write{ false };
+	bool write_batch{ false };
 	bool cache_index_and_filter_blocks{ false };
 	unsigned block_size{ 4 }; // KB
 	unsigned memtable_size{ 32 }; // MB
 	unsigned num_memtables{ 2 }; // Need a minimum of 2
 	unsigned total_memtable_size{ 512 }; // MB
+	// Table profiles, the block cache above is only used by the accounts, blocks, confirmation height and pending tables
+	unsigned point_lookup_bloom_filter_bits{ 10 }; // Accounts, blocks and confirmation height
+	bool point_lookup_hash_index{ true }; // Accounts, blocks and confirmation height
+	unsigned pending_prefix_bloom_filter_bits{ 10 };
+	uint64_t fifo_max_size{ 0 }; // MB, online weight
+	uint64_t fifo_ttl{ 30 * 24 }; // Hours, online weight
+	uint64_t cold_block_cache{ 8 }; // MB
 };
 }
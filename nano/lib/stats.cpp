@@ -450,6 +450,9 @@ std::string nano::stat::type_to_string (uint32_t key)
 		case nano::stat::type::telemetry:
 			res = "telemetry";
 			break;
+		case nano::stat::type::unchecked:
+			res = "unchecked";
+			break;
 	}
 	return res;
 }
@@ -652,6 +655,9 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::tcp_excluded:
 			res = "tcp_excluded";
 			break;
+		case nano::stat::detail::tcp_message_drop:
+			res = "tcp_message_drop";
+			break;
 		case nano::stat::detail::unreachable_host:
 			res = "unreachable_host";
 			break;
@@ -727,6 +733,9 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::duplicate_publish:
 			res = "duplicate_publish";
 			break;
+		case nano::stat::detail::duplicate_confirm_ack:
+			res = "duplicate_confirm_ack";
+			break;
 		case nano::stat::detail::different_genesis_hash:
 			res = "different_genesis_hash";
 			break;
@@ -748,6 +757,24 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::failed_send_telemetry_req:
 			res = "failed_send_telemetry_req";
 			break;
+		case nano::stat::detail::cleanup_scanned:
+			res = "cleanup_scanned";
+			break;
+		case nano::stat::detail::cleanup_deleted:
+			res = "cleanup_deleted";
+			break;
+		case nano::stat::detail::cleanup_batches:
+			res = "cleanup_batches";
+			break;
+		case nano::stat::detail::cleanup_yields:
+			res = "cleanup_yields";
+			break;
+		case nano::stat::detail::cleanup_passes:
+			res = "cleanup_passes";
+			break;
+		case nano::stat::detail::cleanup_time_ms:
+			res = "cleanup_time_ms";
+			break;
 	}
 	return res;
 }
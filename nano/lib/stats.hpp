@@ -202,6 +202,7 @@ public:
 		requests,
 		filter,
 		telemetry,
+		unchecked,
 	};
 
 	/** Optional detail type */
@@ -302,6 +303,7 @@ public:
 		tcp_write_drop,
 		tcp_write_no_socket_drop,
 		tcp_excluded,
+		tcp_message_drop,
 
 		// ipc
 		invocations,
@@ -328,6 +330,7 @@ public:
 
 		// duplicate
 		duplicate_publish,
+		duplicate_confirm_ack,
 
 		// telemetry
 		invalid_signature,
@@ -336,7 +339,15 @@ public:
 		request_within_protection_cache_zone,
 		no_response_received,
 		unsolicited_telemetry_ack,
-		failed_send_telemetry_req
+		failed_send_telemetry_req,
+
+		// unchecked
+		cleanup_scanned,
+		cleanup_deleted,
+		cleanup_batches,
+		cleanup_yields,
+		cleanup_passes,
+		cleanup_time_ms
 	};
 
 	/** Direction of the stat. If the direction is irrelevant, use in */
@@ -39,6 +39,15 @@ std::string nano::thread_role::get_string (nano::thread_role::name role)
 		case nano::thread_role::name::block_processing:
 			thread_role_name_string = "Blck processing";
 			break;
+		case nano::thread_role::name::block_prevalidation:
+			thread_role_name_string = "Blck prevalid";
+			break;
+		case nano::thread_role::name::block_post_commit:
+			thread_role_name_string = "Blck postcommit";
+			break;
+		case nano::thread_role::name::block_validation:
+			thread_role_name_string = "Blck validation";
+			break;
 		case nano::thread_role::name::request_loop:
 			thread_role_name_string = "Request loop";
 			break;
@@ -81,6 +90,21 @@ std::string nano::thread_role::get_string (nano::thread_role::name role)
 		case nano::thread_role::name::epoch_upgrader:
 			thread_role_name_string = "Epoch upgrader";
 			break;
+		case nano::thread_role::name::membership_filters:
+			thread_role_name_string = "Filters builder";
+			break;
+		case nano::thread_role::name::db_compaction:
+			thread_role_name_string = "DB compaction";
+			break;
+		case nano::thread_role::name::block_summaries:
+			thread_role_name_string = "Block summaries";
+			break;
+		case nano::thread_role::name::db_group_sync:
+			thread_role_name_string = "DB group sync";
+			break;
+		case nano::thread_role::name::cache_counters:
+			thread_role_name_string = "Cache counters";
+			break;
 	}
 
 	/*
@@ -22,6 +22,9 @@ namespace thread_role
 		alarm,
 		vote_processing,
 		block_processing,
+		block_prevalidation,
+		block_post_commit,
+		block_validation,
 		request_loop,
 		wallet_actions,
 		bootstrap_initiator,
@@ -35,7 +38,12 @@ namespace thread_role
 		worker,
 		request_aggregator,
 		state_block_signature_verification,
-		epoch_upgrader
+		epoch_upgrader,
+		membership_filters,
+		db_compaction,
+		block_summaries,
+		db_group_sync,
+		cache_counters
 	};
 	/*
 	 * Get/Set the identifier for the current thread
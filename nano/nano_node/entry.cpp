@@ -13,8 +13,11 @@
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
+#include <ctime>
+#include <map>
 #include <numeric>
 #include <sstream>
 
@@ -48,6 +51,45 @@ public:
 };
 std::istream & operator>> (std::istream & in, uint64_from_hex & out_val);
 
+/** Discards parsed messages when profiling the message parser */
+class null_message_visitor final : public nano::message_visitor
+{
+public:
+	void keepalive (nano::keepalive const &) override
+	{
+	}
+	void publish (nano::publish const &) override
+	{
+	}
+	void confirm_req (nano::confirm_req const &) override
+	{
+	}
+	void confirm_ack (nano::confirm_ack const &) override
+	{
+	}
+	void bulk_pull (nano::bulk_pull const &) override
+	{
+	}
+	void bulk_pull_account (nano::bulk_pull_account const &) override
+	{
+	}
+	void bulk_push (nano::bulk_push const &) override
+	{
+	}
+	void frontier_req (nano::frontier_req const &) override
+	{
+	}
+	void node_id_handshake (nano::node_id_handshake const &) override
+	{
+	}
+	void telemetry_req (nano::telemetry_req const &) override
+	{
+	}
+	void telemetry_ack (nano::telemetry_ack const &) override
+	{
+	}
+};
+
 class address_library_pair
 {
 public:
@@ -90,7 +132,10 @@ int main (int argc, char * const * argv)
 		("debug_verify_profile_batch", "Profile batch signature verification")
 		("debug_profile_bootstrap", "Profile bootstrap style blocks processing (at least 10GB of free storage space required)")
 		("debug_profile_sign", "Profile signature generation")
+		("debug_profile_udp", "Profile sending and receiving <count> datagrams over loopback one at a time and in batches, per core")
+		("debug_profile_message_parser", "Profile parsing <count> realtime messages of a mix of publishes, duplicate publishes, votes, replayed votes, truncated messages and keepalives")
 		("debug_profile_process", "Profile active blocks processing (only for nano_test_network)")
+		("debug_profile_parallel_process", "Profile blocks processing arriving out of order with 0 to N parallel validation threads (only for nano_test_network)")
 		("debug_profile_votes", "Profile votes processing (only for nano_test_network)")
 		("debug_profile_frontiers_confirmation", "Profile frontiers confirmation speed (only for nano_test_network)")
 		("debug_random_feed", "Generates output to RNG test suites")
@@ -99,6 +144,7 @@ int main (int argc, char * const * argv)
 		("debug_cemented_block_count", "Displays the number of cemented (confirmed) blocks")
 		("debug_stacktrace", "Display an example stacktrace")
 		("debug_account_versions", "Display the total counts of each version for all accounts (including unpocketed)")
+		("debug_store_profile", "Read the account, confirmation height, pending and head block entries of up to <count> accounts and display the time spent in each table")
 		("validate_blocks,debug_validate_blocks", "Check all blocks for correct hash, signature, work value")
 		("platform", boost::program_options::value<std::string> (), "Defines the <platform> for OpenCL commands")
 		("device", boost::program_options::value<std::string> (), "Defines <device> for OpenCL command")
@@ -175,7 +221,7 @@ int main (int argc, char * const * argv)
 				auto node = inactive_node.node;
 
 				auto const hardcoded = node->get_bootstrap_weights ().second;
-				auto const ledger_unfiltered = node->ledger.cache.rep_weights.get_rep_amounts ();
+				auto const ledger_unfiltered = *node->ledger.cache.rep_weights.get_rep_amounts ();
 
 				auto get_total = [](decltype (hardcoded) const & reps) -> nano::uint128_union {
 					return std::accumulate (reps.begin (), reps.end (), nano::uint128_t{ 0 }, [](auto sum, auto const & rep) { return sum + rep.second; });
@@ -399,8 +445,8 @@ int main (int argc, char * const * argv)
 			auto node = inactive_node.node;
 			auto transaction (node->store.tx_begin_read ());
 			nano::uint128_t total;
-			auto rep_amounts = node->ledger.cache.rep_weights.get_rep_amounts ();
-			std::map<nano::account, nano::uint128_t> ordered_reps (rep_amounts.begin (), rep_amounts.end ());
+			auto rep_amounts (node->ledger.cache.rep_weights.get_rep_amounts ());
+			std::map<nano::account, nano::uint128_t> ordered_reps (rep_amounts->begin (), rep_amounts->end ());
 			for (auto const & rep : ordered_reps)
 			{
 				total += rep.second;
@@ -901,6 +947,154 @@ int main (int argc, char * const * argv)
 				std::cerr << boost::str (boost::format ("%|1$ 12d|\n") % std::chrono::duration_cast<std::chrono::microseconds> (end1 - begin1).count ());
 			}
 		}
+		else if (vm.count ("debug_profile_udp"))
+		{
+			size_t count (1024 * 1024);
+			auto count_it = vm.find ("count");
+			if (count_it != vm.end ())
+			{
+				try
+				{
+					count = boost::lexical_cast<size_t> (count_it->second.as<std::string> ());
+				}
+				catch (boost::bad_lexical_cast &)
+				{
+					std::cerr << "Invalid count\n";
+					return -1;
+				}
+			}
+			boost::asio::io_context io_ctx;
+			boost::asio::ip::udp::socket sender (io_ctx, nano::endpoint (boost::asio::ip::address_v6::loopback (), 0));
+			boost::asio::ip::udp::socket receiver (io_ctx, nano::endpoint (boost::asio::ip::address_v6::loopback (), 0));
+			receiver.set_option (boost::asio::socket_base::receive_buffer_size (8 * 1024 * 1024));
+			auto destination (receiver.local_endpoint ());
+			// About the size of a vote, each round sends a batch and then receives it
+			size_t const batch_size (32);
+			std::vector<uint8_t> payload (200, 0);
+			std::vector<uint8_t> slab (batch_size * nano::network::buffer_size);
+			std::vector<nano::message_buffer> entries (batch_size);
+			std::vector<nano::message_buffer *> buffers;
+			for (size_t i (0); i < batch_size; ++i)
+			{
+				entries[i].buffer = slab.data () + i * nano::network::buffer_size;
+				buffers.push_back (&entries[i]);
+			}
+			auto profile = [count](std::string const & name_a, std::function<size_t ()> const & round_a) {
+				auto cpu_begin (std::clock ());
+				auto begin (std::chrono::steady_clock::now ());
+				size_t datagrams (0);
+				while (datagrams < count)
+				{
+					datagrams += round_a ();
+				}
+				auto cpu_seconds (std::max (static_cast<double> (std::clock () - cpu_begin) / CLOCKS_PER_SEC, 1e-6));
+				auto milliseconds (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - begin).count ());
+				std::cout << boost::str (boost::format ("%1%: %2% datagrams in %3% ms, %4% datagrams/s per core\n") % name_a % datagrams % milliseconds % static_cast<uint64_t> (datagrams / cpu_seconds));
+			};
+			profile ("send_to/receive_from", [&]() {
+				for (size_t i (0); i < batch_size; ++i)
+				{
+					sender.send_to (boost::asio::buffer (payload), destination);
+				}
+				for (size_t i (0); i < batch_size; ++i)
+				{
+					receiver.receive_from (boost::asio::buffer (entries[i].buffer, nano::network::buffer_size), entries[i].endpoint);
+				}
+				return batch_size;
+			});
+			if (nano::transport::udp_batch_supported ())
+			{
+				std::vector<nano::transport::udp_send_item> items (batch_size, { nano::shared_const_buffer (payload), destination, nullptr });
+				std::vector<size_t> sizes;
+				profile ("sendmmsg/recvmmsg", [&]() {
+					size_t sent (0);
+					boost::system::error_code ec;
+					while (sent < batch_size && !ec)
+					{
+						sent += nano::transport::udp_send_batch (sender, items.data () + sent, batch_size - sent, sizes, ec);
+					}
+					// Loopback delivers synchronously, so every datagram sent is waiting
+					ec.clear ();
+					auto received (nano::transport::udp_receive_batch (receiver, buffers, nano::network::buffer_size, ec));
+					return std::max<size_t> (received, 1);
+				});
+			}
+			else
+			{
+				std::cout << "Batched UDP system calls are not supported on this platform\n";
+			}
+		}
+		else if (vm.count ("debug_profile_message_parser"))
+		{
+			size_t count (64 * 1024);
+			auto count_it = vm.find ("count");
+			if (count_it != vm.end ())
+			{
+				try
+				{
+					count = boost::lexical_cast<size_t> (count_it->second.as<std::string> ());
+				}
+				catch (boost::bad_lexical_cast &)
+				{
+					std::cerr << "Invalid count\n";
+					return -1;
+				}
+			}
+			std::cout << "Generating messages\n";
+			// Blocks and votes are usually received from several peers, so half of each are repeats
+			std::vector<std::vector<uint8_t>> corpus;
+			auto serialize = [&corpus](nano::message const & message_a) {
+				std::vector<uint8_t> bytes;
+				{
+					nano::vectorstream stream (bytes);
+					message_a.serialize (stream, false);
+				}
+				corpus.push_back (std::move (bytes));
+			};
+			nano::keypair key;
+			std::vector<nano::keypair> representatives (8);
+			nano::block_hash previous (1);
+			for (uint64_t i (0); corpus.size () < count; ++i)
+			{
+				auto block (std::make_shared<nano::state_block> (key.pub, previous, key.pub, i, key.pub, key.prv, key.pub, 0));
+				previous = block->hash ();
+				nano::publish publish (block);
+				serialize (publish);
+				serialize (publish);
+				auto const & representative (representatives[i % representatives.size ()]);
+				nano::confirm_ack confirm (std::make_shared<nano::vote> (representative.pub, representative.prv, i, std::vector<nano::block_hash> (12, previous)));
+				serialize (confirm);
+				serialize (confirm);
+				auto truncated (corpus[corpus.size () - 4]);
+				truncated.pop_back ();
+				corpus.push_back (std::move (truncated));
+				if (i % 16 == 0)
+				{
+					serialize (nano::keepalive ());
+				}
+			}
+			null_message_visitor visitor;
+			nano::network_filter filter (256 * 1024);
+			nano::network_filter vote_filter (256 * 1024);
+			nano::block_uniquer block_uniquer;
+			nano::vote_uniquer vote_uniquer (block_uniquer);
+			nano::work_pool work (std::numeric_limits<unsigned>::max ());
+			nano::message_parser parser (filter, vote_filter, block_uniquer, vote_uniquer, visitor, work, false);
+			std::map<nano::message_parser::parse_status, size_t> statuses;
+			auto begin (std::chrono::steady_clock::now ());
+			for (auto const & bytes : corpus)
+			{
+				parser.deserialize_buffer (bytes.data (), bytes.size ());
+				++statuses[parser.status];
+			}
+			auto microseconds (std::max<int64_t> (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin).count (), 1));
+			std::cout << boost::str (boost::format ("%1% messages parsed in %2% us, %3% messages/s\n") % corpus.size () % microseconds % (corpus.size () * 1000000 / microseconds));
+			for (auto const & status : statuses)
+			{
+				parser.status = status.first;
+				std::cout << boost::str (boost::format ("%1%: %2%\n") % parser.status_string () % status.second);
+			}
+		}
 		else if (vm.count ("debug_profile_process"))
 		{
 			nano::network_constants::set_active_network (nano::nano_networks::nano_test_network);
@@ -1026,6 +1220,126 @@ int main (int argc, char * const * argv)
 			node->stop ();
 			std::cout << boost::str (boost::format ("%|1$ 12d| us \n%2% blocks per second\n") % time % (max_blocks * 1000000 / time));
 		}
+		else if (vm.count ("debug_profile_parallel_process"))
+		{
+			nano::network_constants::set_active_network (nano::nano_networks::nano_test_network);
+			nano::network_params test_params;
+			nano::block_builder builder;
+			size_t num_accounts (10000);
+			size_t num_iterations (5); // 10,000 * 5 * 2 = 100,000 blocks
+			size_t max_blocks (2 * num_accounts * num_iterations + num_accounts * 2); //  100,000 + 2 * 10,000 = 120,000 blocks
+			// Bulk pull serves blocks from the frontier backwards, reverse chunks of blocks to produce the same gaps
+			size_t reversed_chunk (1024);
+			std::cout << boost::str (boost::format ("Starting pregenerating %1% blocks\n") % max_blocks);
+			nano::system system;
+			nano::work_pool work (std::numeric_limits<unsigned>::max ());
+			nano::logging logging;
+			nano::genesis genesis;
+			nano::block_hash genesis_latest (genesis.hash ());
+			nano::uint128_t genesis_balance (std::numeric_limits<nano::uint128_t>::max ());
+			std::vector<nano::keypair> keys (num_accounts);
+			std::vector<nano::root> frontiers (num_accounts);
+			std::vector<nano::uint128_t> balances (num_accounts, 1000000000);
+			std::vector<std::shared_ptr<nano::block>> blocks;
+			blocks.reserve (max_blocks);
+			for (auto i (0); i != num_accounts; ++i)
+			{
+				genesis_balance = genesis_balance - 1000000000;
+
+				auto send = builder.state ()
+				            .account (test_params.ledger.test_genesis_key.pub)
+				            .previous (genesis_latest)
+				            .representative (test_params.ledger.test_genesis_key.pub)
+				            .balance (genesis_balance)
+				            .link (keys[i].pub)
+				            .sign (test_params.ledger.test_genesis_key.prv, test_params.ledger.test_genesis_key.pub)
+				            .work (*work.generate (nano::work_version::work_1, genesis_latest, test_params.network.publish_thresholds.epoch_1))
+				            .build ();
+
+				genesis_latest = send->hash ();
+				blocks.push_back (std::move (send));
+
+				auto open = builder.state ()
+				            .account (keys[i].pub)
+				            .previous (0)
+				            .representative (keys[i].pub)
+				            .balance (balances[i])
+				            .link (genesis_latest)
+				            .sign (keys[i].prv, keys[i].pub)
+				            .work (*work.generate (nano::work_version::work_1, keys[i].pub, test_params.network.publish_thresholds.epoch_1))
+				            .build ();
+
+				frontiers[i] = open->hash ();
+				blocks.push_back (std::move (open));
+			}
+			for (auto i (0); i != num_iterations; ++i)
+			{
+				for (auto j (0); j != num_accounts; ++j)
+				{
+					size_t other (num_accounts - j - 1);
+					--balances[j];
+
+					auto send = builder.state ()
+					            .account (keys[j].pub)
+					            .previous (frontiers[j])
+					            .representative (keys[j].pub)
+					            .balance (balances[j])
+					            .link (keys[other].pub)
+					            .sign (keys[j].prv, keys[j].pub)
+					            .work (*work.generate (nano::work_version::work_1, frontiers[j], test_params.network.publish_thresholds.epoch_1))
+					            .build ();
+
+					frontiers[j] = send->hash ();
+					blocks.push_back (std::move (send));
+					++balances[other];
+
+					auto receive = builder.state ()
+					               .account (keys[other].pub)
+					               .previous (frontiers[other])
+					               .representative (keys[other].pub)
+					               .balance (balances[other])
+					               .link (static_cast<nano::block_hash const &> (frontiers[j]))
+					               .sign (keys[other].prv, keys[other].pub)
+					               .work (*work.generate (nano::work_version::work_1, frontiers[other], test_params.network.publish_thresholds.epoch_1))
+					               .build ();
+
+					frontiers[other] = receive->hash ();
+					blocks.push_back (std::move (receive));
+				}
+			}
+			for (auto i (blocks.begin ()); i != blocks.end (); i += std::min<size_t> (reversed_chunk, blocks.end () - i))
+			{
+				std::reverse (i, i + std::min<size_t> (reversed_chunk, blocks.end () - i));
+			}
+			std::vector<unsigned> thread_counts{ 0 };
+			for (auto threads (1u); threads <= std::max (1u, std::thread::hardware_concurrency ()); threads *= 2)
+			{
+				thread_counts.push_back (threads);
+			}
+			for (auto threads : thread_counts)
+			{
+				auto path (nano::unique_path ());
+				logging.init (path);
+				nano::node_flags node_flags;
+				nano::update_flags (node_flags, vm);
+				node_flags.block_processor_parallel_validation_threads = threads;
+				auto node (std::make_shared<nano::node> (system.io_ctx, 24001, path, system.alarm, logging, work, node_flags));
+				auto begin (std::chrono::high_resolution_clock::now ());
+				for (auto const & block : blocks)
+				{
+					node->process_active (block);
+				}
+				while (node->ledger.cache.block_count != max_blocks + 1)
+				{
+					std::this_thread::sleep_for (std::chrono::milliseconds (10));
+				}
+				node->block_processor.flush ();
+				auto end (std::chrono::high_resolution_clock::now ());
+				auto time (std::chrono::duration_cast<std::chrono::microseconds> (end - begin).count ());
+				node->stop ();
+				std::cout << boost::str (boost::format ("%1% parallel validation threads: %|2$ 12d| us, %3% blocks per second\n") % threads % time % (max_blocks * 1000000 / time));
+			}
+		}
 		else if (vm.count ("debug_profile_votes"))
 		{
 			nano::network_constants::set_active_network (nano::nano_networks::nano_test_network);
@@ -1821,6 +2135,49 @@ int main (int argc, char * const * argv)
 			nano::inactive_node node (data_path, node_flags);
 			std::cout << "Total cemented block count: " << node.node->ledger.cache.cemented_count << std::endl;
 		}
+		else if (vm.count ("debug_store_profile"))
+		{
+			size_t count (100 * 1024);
+			auto count_it = vm.find ("count");
+			if (count_it != vm.end ())
+			{
+				try
+				{
+					count = boost::lexical_cast<size_t> (count_it->second.as<std::string> ());
+				}
+				catch (boost::bad_lexical_cast &)
+				{
+					std::cerr << "Invalid count\n";
+					return -1;
+				}
+			}
+			auto inactive_node = nano::default_inactive_node (data_path, vm);
+			auto node = inactive_node->node;
+			auto & profile (node->store.profile_get ());
+			profile.clear ();
+			profile.enable (true);
+			auto transaction (node->store.tx_begin_read ());
+			size_t accounts (0);
+			size_t pending (0);
+			for (auto i (node->store.latest_begin (transaction)), n (node->store.latest_end ()); i != n && accounts < count; ++i, ++accounts)
+			{
+				nano::account const & account (i->first);
+				nano::account_info const & info (i->second);
+				nano::confirmation_height_info confirmation_height_info;
+				node->store.confirmation_height_get (transaction, account, confirmation_height_info);
+				for (auto j (node->store.pending_begin (transaction, nano::pending_key (account, 0))), m (node->store.pending_end ()); j != m && nano::pending_key (j->first).account == account; ++j)
+				{
+					++pending;
+				}
+				node->store.block_get (transaction, info.head);
+			}
+			profile.enable (false);
+			boost::property_tree::ptree json;
+			profile.serialize (json);
+			json.put ("accounts", accounts);
+			json.put ("pending", pending);
+			boost::property_tree::write_json (std::cout, json);
+		}
 		else if (vm.count ("debug_stacktrace"))
 		{
 			std::cout << boost::stacktrace::stacktrace ();
@@ -845,11 +845,20 @@ bool nano::active_transactions::restart (std::shared_ptr<nano::block> const & bl
 	if (recently_dropped.find (block_a->qualified_root ()) > std::chrono::steady_clock::now () - recently_dropped_cutoff)
 	{
 		auto hash (block_a->hash ());
-		auto ledger_block (node.store.block_get (transaction_a, hash));
-		if (ledger_block != nullptr && ledger_block->block_work () != block_a->block_work () && !node.block_confirmed_or_being_confirmed (transaction_a, hash))
+		auto stored_block (node.store.block_get (transaction_a, hash));
+		if (stored_block != nullptr && stored_block->block_work () != block_a->block_work () && !node.block_confirmed_or_being_confirmed (transaction_a, hash))
 		{
-			if (block_a->difficulty () > ledger_block->difficulty ())
+			if (block_a->difficulty () > stored_block->difficulty ())
 			{
+				// Blocks from the store can be shared through the block cache, work is set on a copy
+				std::vector<uint8_t> bytes;
+				{
+					nano::vectorstream stream (bytes);
+					stored_block->serialize (stream);
+				}
+				nano::bufferstream stream (bytes.data (), bytes.size ());
+				auto ledger_block (nano::deserialize_block (stream, stored_block->type ()));
+				ledger_block->sideband_set (stored_block->sideband ());
 				// Re-writing the block is necessary to avoid the same work being received later to force restarting the election
 				// The existing block is re-written, not the arriving block, as that one might not have gone through a full signature check
 				ledger_block->block_work_set (block_a->block_work ());
@@ -0,0 +1,288 @@
+#include <nano/lib/logger_mt.hpp>
+#include <nano/lib/threading.hpp>
+#include <nano/lib/timer.hpp>
+#include <nano/node/block_prevalidation.hpp>
+#include <nano/node/nodeconfig.hpp>
+#include <nano/node/signatures.hpp>
+#include <nano/secure/blockstore.hpp>
+#include <nano/secure/ledger.hpp>
+
+#include <boost/format.hpp>
+
+size_t constexpr nano::block_prevalidation::batch_size;
+
+void nano::stage_timing::add (std::chrono::microseconds const & duration_a)
+{
+	++batches;
+	total += duration_a.count ();
+}
+
+uint64_t nano::stage_timing::average () const
+{
+	auto batches_l (batches.load ());
+	return batches_l != 0 ? total.load () / batches_l : 0;
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (stage_timing & stage_timing, const std::string & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "batches", static_cast<size_t> (stage_timing.batches), 0 }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "average_batch_us", static_cast<size_t> (stage_timing.average ()), 0 }));
+	return composite;
+}
+
+nano::block_prevalidation::block_prevalidation (nano::ledger & ledger_a, nano::signature_checker & signature_checker_a, nano::node_config & node_config_a, nano::logger_mt & logger_a, unsigned thread_count_a) :
+ledger (ledger_a),
+signature_checker (signature_checker_a),
+node_config (node_config_a),
+logger (logger_a)
+{
+	for (auto i (0u); i < std::max (1u, thread_count_a); ++i)
+	{
+		threads.emplace_back ([this]() {
+			nano::thread_role::set (nano::thread_role::name::block_prevalidation);
+			this->run ();
+		});
+	}
+}
+
+nano::block_prevalidation::~block_prevalidation ()
+{
+	stop ();
+}
+
+void nano::block_prevalidation::stop ()
+{
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		stopped = true;
+	}
+	condition.notify_all ();
+	for (auto & thread : threads)
+	{
+		if (thread.joinable ())
+		{
+			thread.join ();
+		}
+	}
+}
+
+void nano::block_prevalidation::run ()
+{
+	nano::unique_lock<std::mutex> lk (mutex);
+	while (!stopped)
+	{
+		if (!blocks.empty ())
+		{
+			++active;
+			// Sequence numbers are taken with the items so batches can be handed on in the order they were queued
+			auto sequence (next_sequence++);
+			nano::block_prevalidation::batch batch_l;
+			batch_l.items = setup_items (batch_size);
+			lk.unlock ();
+			batch_l.results = prevalidate (batch_l.items);
+			handoff (sequence, std::move (batch_l));
+			lk.lock ();
+			--active;
+			if (active == 0 && blocks.empty ())
+			{
+				lk.unlock ();
+				transition_inactive_callback ();
+				lk.lock ();
+			}
+		}
+		else
+		{
+			condition.wait (lk);
+		}
+	}
+}
+
+bool nano::block_prevalidation::is_active ()
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	return active != 0;
+}
+
+void nano::block_prevalidation::add (nano::unchecked_info const & info_a)
+{
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		blocks.push_back (info_a);
+	}
+	condition.notify_one ();
+}
+
+size_t nano::block_prevalidation::size ()
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	return blocks.size ();
+}
+
+std::deque<nano::unchecked_info> nano::block_prevalidation::setup_items (size_t max_count)
+{
+	std::deque<nano::unchecked_info> items;
+	if (blocks.size () <= max_count)
+	{
+		items.swap (blocks);
+	}
+	else
+	{
+		for (auto i (0); i < max_count; ++i)
+		{
+			items.push_back (std::move (blocks.front ()));
+			blocks.pop_front ();
+		}
+		debug_assert (!blocks.empty ());
+		// Let another thread pick up the remainder
+		condition.notify_one ();
+	}
+	return items;
+}
+
+std::vector<nano::process_result> nano::block_prevalidation::prevalidate (std::deque<nano::unchecked_info> & items)
+{
+	nano::timer<std::chrono::microseconds> timer_l (nano::timer_state::started);
+	std::vector<nano::process_result> results (items.size (), nano::process_result::progress);
+	{
+		auto transaction (ledger.store.tx_begin_read ());
+		for (auto i (0); i < items.size (); ++i)
+		{
+			auto & item (items[i]);
+			auto const & block (*item.block);
+			auto const & hash (block.hash ());
+			if (ledger.store.block_exists (transaction, block.type (), hash))
+			{
+				results[i] = nano::process_result::old;
+			}
+			else if (nano::work_validate_entry (block))
+			{
+				results[i] = nano::process_result::insufficient_work;
+			}
+			else if (item.verified == nano::signature_verification::unknown && item.account.is_zero ())
+			{
+				switch (block.type ())
+				{
+					case nano::block_type::send:
+					case nano::block_type::receive:
+					case nano::block_type::change:
+					{
+						// Account of a legacy block is the account of its previous block, unknown until the previous is in the ledger
+						auto previous (ledger.store.block_get (transaction, block.previous ()));
+						if (previous != nullptr)
+						{
+							item.account = ledger.store.block_account_calculated (*previous);
+						}
+						break;
+					}
+					default:
+						break;
+				}
+			}
+		}
+	}
+	verify_signatures (items, results);
+	auto elapsed (timer_l.stop ());
+	timing.add (elapsed);
+	if (node_config.logging.timing_logging () && elapsed > std::chrono::milliseconds (10))
+	{
+		logger.try_log (boost::str (boost::format ("Prevalidated %1% blocks in %2% %3%") % items.size () % elapsed.count () % timer_l.unit ()));
+	}
+	return results;
+}
+
+void nano::block_prevalidation::verify_signatures (std::deque<nano::unchecked_info> & items, std::vector<nano::process_result> & results)
+{
+	// Blocks whose signer isn't known yet are verified by the ledger, they are gaps until their previous block arrives
+	std::vector<size_t> positions;
+	for (auto i (0); i < items.size (); ++i)
+	{
+		auto const & item (items[i]);
+		auto type (item.block->type ());
+		if (results[i] == nano::process_result::progress && item.verified == nano::signature_verification::unknown && (type == nano::block_type::state || type == nano::block_type::open || !item.account.is_zero ()))
+		{
+			positions.push_back (i);
+		}
+	}
+	if (!positions.empty ())
+	{
+		auto size (positions.size ());
+		std::vector<nano::block_hash> hashes;
+		hashes.reserve (size);
+		std::vector<unsigned char const *> messages;
+		messages.reserve (size);
+		std::vector<size_t> lengths;
+		lengths.reserve (size);
+		std::vector<nano::account> accounts;
+		accounts.reserve (size);
+		std::vector<unsigned char const *> pub_keys;
+		pub_keys.reserve (size);
+		std::vector<nano::signature> blocks_signatures;
+		blocks_signatures.reserve (size);
+		std::vector<unsigned char const *> signatures;
+		signatures.reserve (size);
+		std::vector<int> verifications (size, 0);
+		auto const & epochs (ledger.network_params.ledger.epochs);
+		for (auto position : positions)
+		{
+			auto const & item (items[position]);
+			hashes.push_back (item.block->hash ());
+			messages.push_back (hashes.back ().bytes.data ());
+			lengths.push_back (sizeof (decltype (hashes)::value_type));
+			nano::account account (item.block->account ());
+			if (!item.block->link ().is_zero () && epochs.is_epoch_link (item.block->link ()))
+			{
+				account = epochs.signer (epochs.epoch (item.block->link ()));
+			}
+			else if (!item.account.is_zero ())
+			{
+				account = item.account;
+			}
+			accounts.push_back (account);
+			pub_keys.push_back (accounts.back ().bytes.data ());
+			blocks_signatures.push_back (item.block->block_signature ());
+			signatures.push_back (blocks_signatures.back ().bytes.data ());
+		}
+		nano::signature_check_set check = { size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data () };
+		signature_checker.verify (check);
+		for (auto i (0); i < size; ++i)
+		{
+			debug_assert (verifications[i] == 1 || verifications[i] == 0);
+			auto & item (items[positions[i]]);
+			if (!item.block->link ().is_zero () && epochs.is_epoch_link (item.block->link ()))
+			{
+				// A state block with an epoch link may also be a send signed by the account, the ledger checks those
+				item.verified = verifications[i] == 1 ? nano::signature_verification::valid_epoch : nano::signature_verification::unknown;
+			}
+			else if (verifications[i] == 1)
+			{
+				item.verified = nano::signature_verification::valid;
+			}
+			else
+			{
+				results[positions[i]] = nano::process_result::bad_signature;
+			}
+		}
+	}
+}
+
+void nano::block_prevalidation::handoff (uint64_t sequence_a, nano::block_prevalidation::batch && batch_a)
+{
+	nano::lock_guard<std::mutex> guard (handoff_mutex);
+	completed.emplace (sequence_a, std::move (batch_a));
+	// Whichever thread finishes the earliest outstanding batch hands on every batch that is ready after it
+	for (auto i (completed.begin ()); i != completed.end () && i->first == next_handoff; i = completed.begin ())
+	{
+		blocks_prevalidated_callback (i->second.items, i->second.results);
+		completed.erase (i);
+		++next_handoff;
+	}
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (block_prevalidation & block_prevalidation, const std::string & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "blocks", block_prevalidation.size (), sizeof (decltype (block_prevalidation.blocks)::value_type) }));
+	composite->add_component (collect_container_info (block_prevalidation.timing, "timing"));
+	return composite;
+}
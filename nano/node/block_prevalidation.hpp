@@ -0,0 +1,88 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+#include <nano/secure/common.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace nano
+{
+class ledger;
+class logger_mt;
+class node_config;
+class signature_checker;
+
+/** Accumulated processing time of a block processor pipeline stage */
+class stage_timing final
+{
+public:
+	void add (std::chrono::microseconds const &);
+	uint64_t average () const;
+	std::atomic<uint64_t> batches{ 0 };
+	std::atomic<uint64_t> total{ 0 };
+};
+
+std::unique_ptr<nano::container_info_component> collect_container_info (stage_timing & stage_timing, const std::string & name);
+
+/**
+ * First stage of the block processor pipeline, runs read-only checks on a pool of threads so the committer holding the write transaction has less to do.
+ * Blocks already in the ledger are flagged as old, work is validated and signatures are batch verified, resolving the account of legacy blocks from
+ * their previous block. Batches are handed on in the order they were taken so blocks of an account chain reach the committer in the order they arrived.
+ */
+class block_prevalidation final
+{
+public:
+	block_prevalidation (nano::ledger &, nano::signature_checker &, nano::node_config &, nano::logger_mt &, unsigned);
+	~block_prevalidation ();
+	void add (nano::unchecked_info const & info_a);
+	size_t size ();
+	void stop ();
+	bool is_active ();
+
+	/** Called in order for each batch, with old, insufficient_work, bad_signature or progress for each block */
+	std::function<void(std::deque<nano::unchecked_info> &, std::vector<nano::process_result> const &)> blocks_prevalidated_callback;
+	std::function<void()> transition_inactive_callback;
+	nano::stage_timing timing;
+	static size_t constexpr batch_size{ 256 };
+
+private:
+	class batch final
+	{
+	public:
+		std::deque<nano::unchecked_info> items;
+		std::vector<nano::process_result> results;
+	};
+	nano::ledger & ledger;
+	nano::signature_checker & signature_checker;
+	nano::node_config & node_config;
+	nano::logger_mt & logger;
+
+	std::mutex mutex;
+	bool stopped{ false };
+	unsigned active{ 0 };
+	std::deque<nano::unchecked_info> blocks;
+	uint64_t next_sequence{ 0 };
+	nano::condition_variable condition;
+	std::vector<std::thread> threads;
+	/** Batches finished ahead of an earlier one, held until they can be handed on in order */
+	std::mutex handoff_mutex;
+	std::map<uint64_t, nano::block_prevalidation::batch> completed;
+	uint64_t next_handoff{ 0 };
+
+	void run ();
+	std::deque<nano::unchecked_info> setup_items (size_t);
+	std::vector<nano::process_result> prevalidate (std::deque<nano::unchecked_info> &);
+	void verify_signatures (std::deque<nano::unchecked_info> &, std::vector<nano::process_result> &);
+	void handoff (uint64_t, nano::block_prevalidation::batch &&);
+
+	friend std::unique_ptr<container_info_component> collect_container_info (block_prevalidation & block_prevalidation, const std::string & name);
+};
+
+std::unique_ptr<nano::container_info_component> collect_container_info (block_prevalidation & block_prevalidation, const std::string & name);
+}
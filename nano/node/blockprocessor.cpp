@@ -1,3 +1,4 @@
+#include <nano/boost/asio/post.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/lib/timer.hpp>
 #include <nano/node/blockprocessor.hpp>
@@ -8,7 +9,10 @@
 
 #include <boost/format.hpp>
 
+#include <future>
+
 std::chrono::milliseconds constexpr nano::block_processor::confirmation_request_delay;
+size_t constexpr nano::block_processor::snapshot_batch_size;
 
 nano::block_post_events::~block_post_events ()
 {
@@ -22,12 +26,27 @@ nano::block_processor::block_processor (nano::node & node_a, nano::write_databas
 next_log (std::chrono::steady_clock::now ()),
 node (node_a),
 write_database_queue (write_database_queue_a),
-state_block_signature_verification (node.checker, node.ledger.network_params.ledger.epochs, node.config, node.logger, node.flags.block_processor_verification_size)
+block_prevalidation (node.ledger, node.checker, node.config, node.logger, node.flags.block_processor_prevalidation_threads),
+state_block_signature_verification (node.checker, node.ledger.network_params.ledger.epochs, node.config, node.logger, node.flags.block_processor_verification_size),
+post_commit_thread ([this]() {
+	nano::thread_role::set (nano::thread_role::name::block_post_commit);
+	this->process_post_commit ();
+}),
+validation_pool (std::max (node.flags.block_processor_parallel_validation_threads, 1u) - 1)
 {
+	for (auto i (1u); i < node.flags.block_processor_parallel_validation_threads; ++i)
+	{
+		boost::asio::post (validation_pool, []() {
+			nano::thread_role::set (nano::thread_role::name::block_validation);
+		});
+	}
+	block_prevalidation.blocks_prevalidated_callback = [this](std::deque<nano::unchecked_info> & items, std::vector<nano::process_result> const & results) {
+		this->process_prevalidated_blocks (items, results);
+	};
 	state_block_signature_verification.blocks_verified_callback = [this](std::deque<nano::unchecked_info> & items, std::vector<int> const & verifications, std::vector<nano::block_hash> const & hashes, std::vector<nano::signature> const & blocks_signatures) {
 		this->process_verified_state_blocks (items, verifications, hashes, blocks_signatures);
 	};
-	state_block_signature_verification.transition_inactive_callback = [this]() {
+	auto transition_inactive = [this]() {
 		if (this->flushing)
 		{
 			{
@@ -37,6 +56,8 @@ state_block_signature_verification (node.checker, node.ledger.network_params.led
 			this->condition.notify_all ();
 		}
 	};
+	block_prevalidation.transition_inactive_callback = transition_inactive;
+	state_block_signature_verification.transition_inactive_callback = transition_inactive;
 }
 
 nano::block_processor::~block_processor ()
@@ -46,12 +67,18 @@ nano::block_processor::~block_processor ()
 
 void nano::block_processor::stop ()
 {
+	block_prevalidation.stop ();
 	{
 		nano::lock_guard<std::mutex> lock (mutex);
 		stopped = true;
 	}
 	condition.notify_all ();
+	post_commit_condition.notify_all ();
 	state_block_signature_verification.stop ();
+	if (post_commit_thread.joinable ())
+	{
+		post_commit_thread.join ();
+	}
 }
 
 void nano::block_processor::flush ()
@@ -59,7 +86,7 @@ void nano::block_processor::flush ()
 	node.checker.flush ();
 	flushing = true;
 	nano::unique_lock<std::mutex> lock (mutex);
-	while (!stopped && (have_blocks () || active || state_block_signature_verification.is_active ()))
+	while (!stopped && (have_blocks () || active || post_commit_active || block_prevalidation.is_active () || state_block_signature_verification.is_active ()))
 	{
 		condition.wait (lock);
 	}
@@ -69,7 +96,7 @@ void nano::block_processor::flush ()
 size_t nano::block_processor::size ()
 {
 	nano::unique_lock<std::mutex> lock (mutex);
-	return (blocks.size () + state_block_signature_verification.size () + forced.size ());
+	return (blocks.size () + block_prevalidation.size () + state_block_signature_verification.size () + forced.size () + post_commit_events.size ());
 }
 
 bool nano::block_processor::full ()
@@ -91,6 +118,19 @@ void nano::block_processor::add (std::shared_ptr<nano::block> block_a, uint64_t
 void nano::block_processor::add (nano::unchecked_info const & info_a, const bool push_front_preference_a)
 {
 	debug_assert (!nano::work_validate_entry (*info_a.block));
+	if (push_front_preference_a)
+	{
+		// Blocks from unchecked have already been seen by the ledger, skip prevalidation
+		queue_prevalidated (info_a, true);
+	}
+	else
+	{
+		block_prevalidation.add (info_a);
+	}
+}
+
+void nano::block_processor::queue_prevalidated (nano::unchecked_info const & info_a, const bool push_front_preference_a)
+{
 	bool quarter_full (size () > node.flags.block_processor_full_size / 4);
 	if (info_a.verified == nano::signature_verification::unknown && (info_a.block->type () == nano::block_type::state || info_a.block->type () == nano::block_type::open || !info_a.account.is_zero ()))
 	{
@@ -153,6 +193,34 @@ void nano::block_processor::process_blocks ()
 	}
 }
 
+void nano::block_processor::process_post_commit ()
+{
+	nano::unique_lock<std::mutex> lock (mutex);
+	while (!stopped)
+	{
+		if (!post_commit_events.empty ())
+		{
+			std::deque<std::function<void()>> events;
+			events.swap (post_commit_events);
+			post_commit_active = true;
+			lock.unlock ();
+			nano::timer<std::chrono::microseconds> timer_l (nano::timer_state::started);
+			for (auto const & event : events)
+			{
+				event ();
+			}
+			post_commit_timing.add (timer_l.stop ());
+			lock.lock ();
+			post_commit_active = false;
+			condition.notify_all ();
+		}
+		else
+		{
+			post_commit_condition.wait (lock);
+		}
+	}
+}
+
 bool nano::block_processor::should_log ()
 {
 	auto result (false);
@@ -168,7 +236,43 @@ bool nano::block_processor::should_log ()
 bool nano::block_processor::have_blocks ()
 {
 	debug_assert (!mutex.try_lock ());
-	return !blocks.empty () || !forced.empty () || state_block_signature_verification.size () != 0;
+	return !blocks.empty () || !forced.empty () || !post_commit_events.empty () || block_prevalidation.size () != 0 || state_block_signature_verification.size () != 0;
+}
+
+void nano::block_processor::process_prevalidated_blocks (std::deque<nano::unchecked_info> & items, std::vector<nano::process_result> const & results)
+{
+	debug_assert (items.size () == results.size ());
+	{
+		// Queued in one go so blocks of an account chain stay in the order they were added
+		nano::lock_guard<std::mutex> guard (mutex);
+		for (auto i (0); i < items.size (); ++i)
+		{
+			switch (results[i])
+			{
+				case nano::process_result::insufficient_work:
+				{
+					if (node.config.logging.ledger_logging ())
+					{
+						node.logger.try_log (boost::str (boost::format ("Insufficient work for %1%") % items[i].block->hash ().to_string ()));
+					}
+					node.stats.inc (nano::stat::type::ledger, nano::stat::detail::insufficient_work);
+					break;
+				}
+				case nano::process_result::bad_signature:
+				{
+					requeue_invalid (items[i].block->hash (), items[i]);
+					break;
+				}
+				default:
+				{
+					// Old blocks are classified by the committer, the rest have been verified or are left for the ledger to verify
+					blocks.push_back (std::move (items[i]));
+					break;
+				}
+			}
+		}
+	}
+	condition.notify_all ();
 }
 
 void nano::block_processor::process_verified_state_blocks (std::deque<nano::unchecked_info> & items, std::vector<int> const & verifications, std::vector<nano::block_hash> const & hashes, std::vector<nano::signature> const & blocks_signatures)
@@ -212,78 +316,200 @@ void nano::block_processor::process_verified_state_blocks (std::deque<nano::unch
 
 void nano::block_processor::process_batch (nano::unique_lock<std::mutex> & lock_a)
 {
-	auto scoped_write_guard = write_database_queue.wait (nano::writer::process_batch);
 	block_post_events post_events;
-	auto transaction (node.store.tx_begin_write ({ tables::accounts, nano::tables::cached_counts, nano::tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked }, { tables::confirmation_height }));
-	nano::timer<std::chrono::milliseconds> timer_l;
-	lock_a.lock ();
-	timer_l.start ();
-	// Processing blocks
-	unsigned number_of_blocks_processed (0), number_of_forced_processed (0);
-	while ((!blocks.empty () || !forced.empty ()) && (timer_l.before_deadline (node.config.block_processor_batch_max_time) || (number_of_blocks_processed < node.flags.block_processor_batch_size)) && !awaiting_write)
+	// Check queued blocks concurrently against a ledger snapshot before the write lock is taken
+	std::deque<std::pair<nano::block_hash, nano::process_return>> verdicts;
+	auto external_writes (external_writes_finished.load ());
+	if (node.flags.block_processor_parallel_validation_threads != 0 && external_writes == external_writes_started)
 	{
-		if ((blocks.size () + state_block_signature_verification.size () + forced.size () > 64) && should_log ())
-		{
-			node.logger.always_log (boost::str (boost::format ("%1% blocks (+ %2% state blocks) (+ %3% forced) in processing queue") % blocks.size () % state_block_signature_verification.size () % forced.size ()));
-		}
-		nano::unchecked_info info;
-		nano::block_hash hash (0);
-		bool force (false);
-		if (forced.empty ())
-		{
-			info = blocks.front ();
-			blocks.pop_front ();
-			hash = info.block->hash ();
-		}
-		else
+		verdicts = snapshot_validate ();
+	}
+	nano::timer<std::chrono::microseconds> commit_timer (nano::timer_state::started);
+	{
+		auto scoped_write_guard = write_database_queue.wait (nano::writer::process_batch);
+		auto transaction (node.store.tx_begin_write ({ tables::accounts, tables::block_summaries, nano::tables::cached_counts, nano::tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked }, { tables::confirmation_height }));
+		// Verdicts only hold if no other writer added blocks since the snapshot was taken
+		if (external_writes_started != external_writes)
 		{
-			info = nano::unchecked_info (forced.front (), 0, nano::seconds_since_epoch (), nano::signature_verification::unknown);
-			forced.pop_front ();
-			hash = info.block->hash ();
-			force = true;
-			number_of_forced_processed++;
+			verdicts.clear ();
 		}
-		lock_a.unlock ();
-		if (force)
+		nano::timer<std::chrono::milliseconds> timer_l;
+		lock_a.lock ();
+		timer_l.start ();
+		// Processing blocks
+		unsigned number_of_blocks_processed (0), number_of_forced_processed (0);
+		while ((!blocks.empty () || !forced.empty ()) && (timer_l.before_deadline (node.config.block_processor_batch_max_time) || (number_of_blocks_processed < node.flags.block_processor_batch_size)) && !awaiting_write)
 		{
-			auto successor (node.ledger.successor (transaction, info.block->qualified_root ()));
-			if (successor != nullptr && successor->hash () != hash)
+			if ((blocks.size () + block_prevalidation.size () + state_block_signature_verification.size () + forced.size () > 64) && should_log ())
+			{
+				node.logger.always_log (boost::str (boost::format ("%1% blocks (+ %2% prevalidating) (+ %3% state blocks) (+ %4% forced) in processing queue") % blocks.size () % block_prevalidation.size () % state_block_signature_verification.size () % forced.size ()));
+			}
+			nano::unchecked_info info;
+			nano::block_hash hash (0);
+			bool force (false);
+			if (forced.empty ())
+			{
+				info = blocks.front ();
+				blocks.pop_front ();
+				hash = info.block->hash ();
+			}
+			else
+			{
+				info = nano::unchecked_info (forced.front (), 0, nano::seconds_since_epoch (), nano::signature_verification::unknown);
+				forced.pop_front ();
+				hash = info.block->hash ();
+				force = true;
+				number_of_forced_processed++;
+			}
+			lock_a.unlock ();
+			if (force)
 			{
-				// Replace our block with the winner and roll back any dependent blocks
-				node.logger.always_log (boost::str (boost::format ("Rolling back %1% and replacing with %2%") % successor->hash ().to_string () % hash.to_string ()));
-				std::vector<std::shared_ptr<nano::block>> rollback_list;
-				if (node.ledger.rollback (transaction, successor->hash (), rollback_list))
+				auto successor (node.ledger.successor (transaction, info.block->qualified_root ()));
+				if (successor != nullptr && successor->hash () != hash)
 				{
-					node.logger.always_log (nano::severity_level::error, boost::str (boost::format ("Failed to roll back %1% because it or a successor was confirmed") % successor->hash ().to_string ()));
+					// Rolled back blocks are no longer old
+					verdicts.clear ();
+					// Replace our block with the winner and roll back any dependent blocks
+					node.logger.always_log (boost::str (boost::format ("Rolling back %1% and replacing with %2%") % successor->hash ().to_string () % hash.to_string ()));
+					std::vector<std::shared_ptr<nano::block>> rollback_list;
+					if (node.ledger.rollback (transaction, successor->hash (), rollback_list))
+					{
+						node.logger.always_log (nano::severity_level::error, boost::str (boost::format ("Failed to roll back %1% because it or a successor was confirmed") % successor->hash ().to_string ()));
+					}
+					else
+					{
+						node.logger.always_log (boost::str (boost::format ("%1% blocks rolled back") % rollback_list.size ()));
+					}
+					// Deleting from votes cache & wallet work watcher, stop active transaction
+					for (auto & i : rollback_list)
+					{
+						node.votes_cache.remove (i->hash ());
+						node.wallets.watcher->remove (*i);
+						// Stop all rolled back active transactions except initial
+						if (i->hash () != successor->hash ())
+						{
+							node.active.erase (*i);
+						}
+					}
 				}
-				else
+			}
+			number_of_blocks_processed++;
+			// Verdicts are used in the order of the checked batch only
+			auto in_order (!verdicts.empty () && verdicts.front ().first == hash);
+			if (in_order && verdicts.front ().second.code != nano::process_result::progress)
+			{
+				handle_result (transaction, post_events, info, verdicts.front ().second, false, nano::block_origin::remote);
+			}
+			else
+			{
+				if (in_order && verdicts.front ().second.verified != nano::signature_verification::unknown)
 				{
-					node.logger.always_log (boost::str (boost::format ("%1% blocks rolled back") % rollback_list.size ()));
+					// The signature was checked against the snapshot already
+					info.verified = verdicts.front ().second.verified;
 				}
-				// Deleting from votes cache & wallet work watcher, stop active transaction
-				for (auto & i : rollback_list)
+				auto result (process_one (transaction, post_events, info));
+				// Blocks pushed to the front or forced after the snapshot change the ledger the verdicts were made against
+				if (!in_order && result.code == nano::process_result::progress)
 				{
-					node.votes_cache.remove (i->hash ());
-					node.wallets.watcher->remove (*i);
-					// Stop all rolled back active transactions except initial
-					if (i->hash () != successor->hash ())
-					{
-						node.active.erase (*i);
-					}
+					verdicts.clear ();
 				}
 			}
+			if (in_order)
+			{
+				verdicts.pop_front ();
+			}
+			lock_a.lock ();
 		}
-		number_of_blocks_processed++;
-		process_one (transaction, post_events, info);
-		lock_a.lock ();
+		awaiting_write = false;
+		lock_a.unlock ();
+
+		if (node.config.logging.timing_logging () && number_of_blocks_processed != 0 && timer_l.stop () > std::chrono::milliseconds (100))
+		{
+			node.logger.always_log (boost::str (boost::format ("Processed %1% blocks (%2% blocks were forced) in %3% %4%") % number_of_blocks_processed % number_of_forced_processed % timer_l.value ().count () % timer_l.unit ()));
+		}
+	}
+	commit_timing.add (commit_timer.stop ());
+	// Observers run on the post-commit stage so the next batch can start as soon as the write transaction is committed
+	if (!post_events.events.empty ())
+	{
+		{
+			nano::lock_guard<std::mutex> guard (mutex);
+			std::move (post_events.events.begin (), post_events.events.end (), std::back_inserter (post_commit_events));
+		}
+		post_events.events.clear ();
+		post_commit_condition.notify_one ();
 	}
-	awaiting_write = false;
-	lock_a.unlock ();
+}
 
-	if (node.config.logging.timing_logging () && number_of_blocks_processed != 0 && timer_l.stop () > std::chrono::milliseconds (100))
+std::deque<std::pair<nano::block_hash, nano::process_return>> nano::block_processor::snapshot_validate ()
+{
+	std::vector<nano::unchecked_info> batch;
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		auto count (std::min (blocks.size (), node.flags.block_processor_batch_size != 0 ? node.flags.block_processor_batch_size : snapshot_batch_size));
+		batch.assign (blocks.begin (), blocks.begin () + count);
+	}
+	std::deque<std::pair<nano::block_hash, nano::process_return>> result;
+	if (!batch.empty ())
 	{
-		node.logger.always_log (boost::str (boost::format ("Processed %1% blocks (%2% blocks were forced) in %3% %4%") % number_of_blocks_processed % number_of_forced_processed % timer_l.value ().count () % timer_l.unit ()));
+		nano::timer<std::chrono::microseconds> timer_l (nano::timer_state::started);
+		std::vector<std::shared_ptr<nano::block>> batch_blocks;
+		batch_blocks.reserve (batch.size ());
+		std::transform (batch.begin (), batch.end (), std::back_inserter (batch_blocks), [](nano::unchecked_info const & info_a) { return info_a.block; });
+		auto partitions (node.ledger.partition (node.store.tx_begin_read (), batch_blocks));
+		std::vector<nano::process_return> returns (batch.size ());
+		std::atomic<size_t> next (0);
+		auto validate = [this, &batch, &partitions, &returns, &next]() {
+			auto transaction (node.store.tx_begin_read ());
+			for (auto i (next++); i < partitions.size (); i = next++)
+			{
+				std::unordered_set<nano::block_hash> earlier;
+				for (auto position : partitions[i])
+				{
+					auto const & info (batch[position]);
+					returns[position] = node.ledger.snapshot_check (transaction, *info.block, info.verified, earlier);
+					// Blocks with a final result won't be added, so they leave the snapshot as it is for the rest of the partition
+					if (returns[position].code == nano::process_result::progress)
+					{
+						earlier.insert (info.block->hash ());
+					}
+				}
+			}
+		};
+		auto helpers (std::min<size_t> (node.flags.block_processor_parallel_validation_threads, partitions.size ()));
+		helpers = helpers > 0 ? helpers - 1 : 0;
+		std::atomic<size_t> remaining (helpers);
+		std::promise<void> promise;
+		auto future (promise.get_future ());
+		for (auto i (0u); i < helpers; ++i)
+		{
+			boost::asio::post (validation_pool, [&validate, &remaining, &promise]() {
+				validate ();
+				if (--remaining == 0)
+				{
+					promise.set_value ();
+				}
+			});
+		}
+		validate ();
+		if (helpers > 0)
+		{
+			future.wait ();
+		}
+		size_t resolved (0);
+		for (auto i (0); i < batch.size (); ++i)
+		{
+			resolved += returns[i].code != nano::process_result::progress;
+			result.emplace_back (batch[i].block->hash (), returns[i]);
+		}
+		auto elapsed (timer_l.stop ());
+		snapshot_timing.add (elapsed);
+		if (node.config.logging.timing_logging () && elapsed > std::chrono::milliseconds (100))
+		{
+			node.logger.always_log (boost::str (boost::format ("Validated %1% blocks in %2% partitions against ledger snapshot (%3% resolved without writing) in %4% %5%") % batch.size () % partitions.size () % resolved % elapsed.count () % timer_l.unit ()));
+		}
 	}
+	return result;
 }
 
 void nano::block_processor::process_live (nano::block_hash const & hash_a, std::shared_ptr<nano::block> block_a, nano::process_return const & process_return_a, const bool watch_work_a, nano::block_origin const origin_a)
@@ -326,9 +552,14 @@ void nano::block_processor::process_live (nano::block_hash const & hash_a, std::
 
 nano::process_return nano::block_processor::process_one (nano::write_transaction const & transaction_a, block_post_events & events_a, nano::unchecked_info info_a, const bool watch_work_a, nano::block_origin const origin_a)
 {
-	nano::process_return result;
+	auto result (node.ledger.process (transaction_a, *(info_a.block), info_a.verified));
+	handle_result (transaction_a, events_a, info_a, result, watch_work_a, origin_a);
+	return result;
+}
+
+void nano::block_processor::handle_result (nano::write_transaction const & transaction_a, block_post_events & events_a, nano::unchecked_info info_a, nano::process_return const & result, const bool watch_work_a, nano::block_origin const origin_a)
+{
 	auto hash (info_a.block->hash ());
-	result = node.ledger.process (transaction_a, *(info_a.block), info_a.verified);
 	switch (result.code)
 	{
 		case nano::process_result::progress:
@@ -359,13 +590,7 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 				info_a.modified = nano::seconds_since_epoch ();
 			}
 
-			nano::unchecked_key unchecked_key (info_a.block->previous (), hash);
-			auto exists = node.store.unchecked_exists (transaction_a, unchecked_key);
-			node.store.unchecked_put (transaction_a, unchecked_key, info_a);
-			if (!exists)
-			{
-				++node.ledger.cache.unchecked_count;
-			}
+			node.unchecked.put (transaction_a, nano::unchecked_key (info_a.block->previous (), hash), info_a);
 
 			node.gap_cache.add (hash);
 			node.stats.inc (nano::stat::type::ledger, nano::stat::detail::gap_previous);
@@ -383,13 +608,7 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 				info_a.modified = nano::seconds_since_epoch ();
 			}
 
-			nano::unchecked_key unchecked_key (node.ledger.block_source (transaction_a, *(info_a.block)), hash);
-			auto exists = node.store.unchecked_exists (transaction_a, unchecked_key);
-			node.store.unchecked_put (transaction_a, unchecked_key, info_a);
-			if (!exists)
-			{
-				++node.ledger.cache.unchecked_count;
-			}
+			node.unchecked.put (transaction_a, nano::unchecked_key (node.ledger.block_source (transaction_a, *(info_a.block)), hash), info_a);
 
 			node.gap_cache.add (hash);
 			node.stats.inc (nano::stat::type::ledger, nano::stat::detail::gap_source);
@@ -478,7 +697,6 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 			break;
 		}
 	}
-	return result;
 }
 
 nano::process_return nano::block_processor::process_one (nano::write_transaction const & transaction_a, block_post_events & events_a, std::shared_ptr<nano::block> block_a, const bool watch_work_a)
@@ -503,14 +721,12 @@ void nano::block_processor::process_old (nano::write_transaction const & transac
 
 void nano::block_processor::queue_unchecked (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a)
 {
-	auto unchecked_blocks (node.store.unchecked_get (transaction_a, hash_a));
+	auto unchecked_blocks (node.unchecked.get (transaction_a, hash_a));
 	for (auto & info : unchecked_blocks)
 	{
 		if (!node.flags.disable_block_processor_unchecked_deletion)
 		{
-			node.store.unchecked_del (transaction_a, nano::unchecked_key (hash_a, info.block->hash ()));
-			debug_assert (node.ledger.cache.unchecked_count > 0);
-			--node.ledger.cache.unchecked_count;
+			node.unchecked.del (transaction_a, nano::unchecked_key (hash_a, info.block->hash ()));
 		}
 		add (info, true);
 	}
@@ -527,16 +743,23 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (bl
 {
 	size_t blocks_count;
 	size_t forced_count;
+	size_t post_commit_count;
 
 	{
 		nano::lock_guard<std::mutex> guard (block_processor.mutex);
 		blocks_count = block_processor.blocks.size ();
 		forced_count = block_processor.forced.size ();
+		post_commit_count = block_processor.post_commit_events.size ();
 	}
 
 	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (collect_container_info (block_processor.block_prevalidation, "prevalidation"));
 	composite->add_component (collect_container_info (block_processor.state_block_signature_verification, "state_block_signature_verification"));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "blocks", blocks_count, sizeof (decltype (block_processor.blocks)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "forced", forced_count, sizeof (decltype (block_processor.forced)::value_type) }));
+	composite->add_component (collect_container_info (block_processor.snapshot_timing, "snapshot_timing"));
+	composite->add_component (collect_container_info (block_processor.commit_timing, "commit_timing"));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "post_commit", post_commit_count, sizeof (decltype (block_processor.post_commit_events)::value_type) }));
+	composite->add_component (collect_container_info (block_processor.post_commit_timing, "post_commit_timing"));
 	return composite;
 }
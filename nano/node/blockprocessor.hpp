@@ -1,6 +1,8 @@
 #pragma once
 
+#include <nano/boost/asio/thread_pool.hpp>
 #include <nano/lib/blocks.hpp>
+#include <nano/node/block_prevalidation.hpp>
 #include <nano/node/state_block_signature_verification.hpp>
 #include <nano/secure/common.hpp>
 
@@ -12,6 +14,7 @@
 
 #include <chrono>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace nano
@@ -36,7 +39,9 @@ public:
 
 /**
  * Processing blocks is a potentially long IO operation.
- * This class isolates block insertion from other operations like servicing network operations
+ * This class isolates block insertion from other operations like servicing network operations.
+ * Blocks go through a pipeline: read-only prevalidation with work and signature checks on a thread pool,
+ * a single committer applying blocks to the ledger under the write transaction and a post-commit stage notifying observers.
  */
 class block_processor final
 {
@@ -55,15 +60,25 @@ public:
 	bool should_log ();
 	bool have_blocks ();
 	void process_blocks ();
+	void process_post_commit ();
 	nano::process_return process_one (nano::write_transaction const &, block_post_events &, nano::unchecked_info, const bool = false, nano::block_origin const = nano::block_origin::remote);
 	nano::process_return process_one (nano::write_transaction const &, block_post_events &, std::shared_ptr<nano::block>, const bool = false);
 	std::atomic<bool> flushing{ false };
+	// Blocks written to the ledger outside of the block processor, started and committed
+	std::atomic<uint64_t> external_writes_started{ 0 };
+	std::atomic<uint64_t> external_writes_finished{ 0 };
 	// Delay required for average network propagartion before requesting confirmation
 	static std::chrono::milliseconds constexpr confirmation_request_delay{ 1500 };
+	// Default number of queued blocks classified against the ledger snapshot per write transaction
+	static size_t constexpr snapshot_batch_size{ 16 * 1024 };
 
 private:
 	void queue_unchecked (nano::write_transaction const &, nano::block_hash const &);
 	void process_batch (nano::unique_lock<std::mutex> &);
+	std::deque<std::pair<nano::block_hash, nano::process_return>> snapshot_validate ();
+	void handle_result (nano::write_transaction const &, block_post_events &, nano::unchecked_info, nano::process_return const &, const bool, nano::block_origin const);
+	void queue_prevalidated (nano::unchecked_info const &, const bool);
+	void process_prevalidated_blocks (std::deque<nano::unchecked_info> &, std::vector<nano::process_result> const &);
 	void process_live (nano::block_hash const &, std::shared_ptr<nano::block>, nano::process_return const &, const bool = false, nano::block_origin const = nano::block_origin::remote);
 	void process_old (nano::write_transaction const &, std::shared_ptr<nano::block> const &, nano::block_origin const);
 	void requeue_invalid (nano::block_hash const &, nano::unchecked_info const &);
@@ -74,11 +89,21 @@ private:
 	std::chrono::steady_clock::time_point next_log;
 	std::deque<nano::unchecked_info> blocks;
 	std::deque<std::shared_ptr<nano::block>> forced;
+	std::deque<std::function<void()>> post_commit_events;
+	bool post_commit_active{ false };
 	nano::condition_variable condition;
+	nano::condition_variable post_commit_condition;
 	nano::node & node;
 	nano::write_database_queue & write_database_queue;
 	std::mutex mutex;
+	nano::stage_timing snapshot_timing;
+	nano::stage_timing commit_timing;
+	nano::stage_timing post_commit_timing;
+	nano::block_prevalidation block_prevalidation;
 	nano::state_block_signature_verification state_block_signature_verification;
+	std::thread post_commit_thread;
+	// Helpers for snapshot validation, the block processing thread takes part as well
+	boost::asio::thread_pool validation_pool;
 
 	friend std::unique_ptr<container_info_component> collect_container_info (block_processor & block_processor, const std::string & name);
 };
@@ -480,18 +480,24 @@ void nano::bulk_pull_server::set_current_end ()
 
 void nano::bulk_pull_server::send_next ()
 {
-	auto block (get_next ());
-	if (block != nullptr)
+	std::vector<uint8_t> send_buffer;
+	auto hash (current);
 	{
-		std::vector<uint8_t> send_buffer;
+		// Blocks are written straight from the database entry without being deserialized
+		auto transaction (connection->node->store.tx_begin_read ());
+		auto view (get_next (transaction));
+		if (view.exists ())
 		{
 			nano::vectorstream stream (send_buffer);
-			nano::serialize_block (stream, *block);
+			view.serialize (stream);
 		}
+	}
+	if (!send_buffer.empty ())
+	{
 		auto this_l (shared_from_this ());
 		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ()));
+			connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % hash.to_string ()));
 		}
 		connection->socket->async_write (nano::shared_const_buffer (std::move (send_buffer)), [this_l](boost::system::error_code const & ec, size_t size_a) {
 			this_l->sent_action (ec, size_a);
@@ -505,7 +511,13 @@ void nano::bulk_pull_server::send_next ()
 
 std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
 {
-	std::shared_ptr<nano::block> result;
+	auto transaction (connection->node->store.tx_begin_read ());
+	return get_next (transaction).block ();
+}
+
+nano::block_view nano::bulk_pull_server::get_next (nano::transaction const & transaction_a)
+{
+	nano::block_view result;
 	bool send_current = false, set_current_to_end = false;
 
 	/*
@@ -544,10 +556,10 @@ std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
 
 	if (send_current)
 	{
-		result = connection->node->block (current);
-		if (result != nullptr && set_current_to_end == false)
+		result = connection->node->store.block_view_get (transaction_a, current);
+		if (result.exists () && set_current_to_end == false)
 		{
-			auto previous (result->previous ());
+			auto previous (result.previous ());
 			if (!previous.is_zero ())
 			{
 				current = previous;
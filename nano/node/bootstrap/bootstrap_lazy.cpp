@@ -377,34 +377,41 @@ void nano::bootstrap_attempt_lazy::lazy_block_state_backlog_check (std::shared_p
 
 void nano::bootstrap_attempt_lazy::lazy_backlog_cleanup ()
 {
-	uint64_t read_count (0);
 	auto transaction (node->store.tx_begin_read ());
-	for (auto it (lazy_state_backlog.begin ()), end (lazy_state_backlog.end ()); it != end && !stopped;)
+	auto it (lazy_state_backlog.begin ());
+	while (it != lazy_state_backlog.end () && !stopped)
 	{
-		if (node->store.block_exists (transaction, it->first))
+		// Previous blocks are read a batch at a time, erasing other entries leaves the iterators of the batch valid
+		std::vector<decltype (lazy_state_backlog)::iterator> batch;
+		std::vector<nano::block_hash> hashes;
+		for (; it != lazy_state_backlog.end () && batch.size () < batch_read_size; ++it)
+		{
+			batch.push_back (it);
+			hashes.push_back (it->first);
+		}
+		auto blocks (node->store.blocks_get (transaction, hashes));
+		for (size_t i (0), n (batch.size ()); i < n && !stopped; ++i)
 		{
-			auto next_block (it->second);
-			if (node->ledger.balance (transaction, it->first) <= next_block.balance) // balance
+			auto next_block (batch[i]->second);
+			if (blocks[i] != nullptr)
 			{
-				lazy_add (next_block.link, next_block.retry_limit); // link
+				if (node->store.block_balance_calculated (blocks[i]) <= next_block.balance) // balance
+				{
+					lazy_add (next_block.link, next_block.retry_limit); // link
+				}
+				else
+				{
+					lazy_destinations_increment (next_block.link);
+				}
+				lazy_state_backlog.erase (batch[i]);
 			}
 			else
 			{
-				lazy_destinations_increment (next_block.link);
+				lazy_add (batch[i]->first, next_block.retry_limit);
 			}
-			it = lazy_state_backlog.erase (it);
-		}
-		else
-		{
-			lazy_add (it->first, it->second.retry_limit);
-			++it;
 		}
 		// We don't want to open read transactions for too long
-		++read_count;
-		if (read_count % batch_read_size == 0)
-		{
-			transaction.refresh ();
-		}
+		transaction.refresh ();
 	}
 }
 
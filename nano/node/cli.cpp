@@ -1,7 +1,9 @@
+#include <nano/lib/timer.hpp>
 #include <nano/lib/tomlconfig.hpp>
 #include <nano/node/cli.hpp>
 #include <nano/node/common.hpp>
 #include <nano/node/daemonconfig.hpp>
+#include <nano/node/ledger_export.hpp>
 #include <nano/node/node.hpp>
 
 #include <boost/format.hpp>
@@ -46,6 +48,7 @@ void nano::add_node_options (boost::program_options::options_description & descr
 	("account_key", "Get the public key for <account>")
 	("vacuum", "Compact database. If data_path is missing, the database in data directory is compacted.")
 	("snapshot", "Compact database and create snapshot, functions similar to vacuum but does not replace the existing database")
+	("export_ledger", "Export accounts, blocks, pending entries and confirmation heights to columnar files in the <file> directory, or export in the data directory. The ledger must not be in use by a running node")
 	("data_path", boost::program_options::value<std::string> (), "Use the supplied path as the data directory")
 	("network", boost::program_options::value<std::string> (), "Use the supplied network (live, beta or test)")
 	("clear_send_ids", "Remove all send IDs from the database (dangerous: not intended for production use)")
@@ -98,10 +101,13 @@ void nano::add_node_flag_options (boost::program_options::options_description &
 		("disable_block_processor_unchecked_deletion", "Disable deletion of unchecked blocks after processing")
 		("allow_bootstrap_peers_duplicates", "Allow multiple connections to same peer in bootstrap attempts")
 		("fast_bootstrap", "Increase bootstrap speed for high end nodes with higher limits")
+		("validate_cache_counters", "Recount cemented blocks in the background on start and correct the stored ledger cache counters, for databases modified by older versions")
 		("batch_size", boost::program_options::value<std::size_t>(), "(Deprecated) Increase sideband batch size, default 512. This change only affects nodes upgrading from v17 (or earlier) of the node.")
 		("block_processor_batch_size", boost::program_options::value<std::size_t>(), "Increase block processor transaction batch write size, default 0 (limited by config block_processor_batch_max_time), 256k for fast_bootstrap")
 		("block_processor_full_size", boost::program_options::value<std::size_t>(), "Increase block processor allowed blocks queue size before dropping live network packets and holding bootstrap download, default 65536, 1 million for fast_bootstrap")
 		("block_processor_verification_size", boost::program_options::value<std::size_t>(), "Increase batch signature verification size in block processor, default 0 (limited by config signature_checker_threads), unlimited for fast_bootstrap")
+		("block_processor_prevalidation_threads", boost::program_options::value<unsigned>(), "Number of threads running read-only checks on blocks before they are queued for writing, default a quarter of the hardware threads (at least 1)")
+		("block_processor_parallel_validation_threads", boost::program_options::value<unsigned>(), "Number of threads checking queued blocks on disjoint accounts against a ledger snapshot before each write transaction, default 0 (disabled), hardware threads for fast_bootstrap")
 		("inactive_votes_cache_size", boost::program_options::value<std::size_t>(), "Increase cached votes without active elections size, default 16384")
 		("vote_processor_capacity", boost::program_options::value<std::size_t>(), "Vote processor queue size before dropping votes, default 144k")
 		;
@@ -140,12 +146,14 @@ std::error_code nano::update_flags (nano::node_flags & flags_a, boost::program_o
 	flags_a.disable_block_processor_unchecked_deletion = (vm.count ("disable_block_processor_unchecked_deletion") > 0);
 	flags_a.allow_bootstrap_peers_duplicates = (vm.count ("allow_bootstrap_peers_duplicates") > 0);
 	flags_a.fast_bootstrap = (vm.count ("fast_bootstrap") > 0);
+	flags_a.validate_cache_counters = (vm.count ("validate_cache_counters") > 0);
 	if (flags_a.fast_bootstrap)
 	{
 		flags_a.disable_block_processor_unchecked_deletion = true;
 		flags_a.block_processor_batch_size = 256 * 1024;
 		flags_a.block_processor_full_size = 1024 * 1024;
 		flags_a.block_processor_verification_size = std::numeric_limits<size_t>::max ();
+		flags_a.block_processor_parallel_validation_threads = std::max (1u, std::thread::hardware_concurrency ());
 	}
 	auto block_processor_batch_size_it = vm.find ("block_processor_batch_size");
 	if (block_processor_batch_size_it != vm.end ())
@@ -162,6 +170,16 @@ std::error_code nano::update_flags (nano::node_flags & flags_a, boost::program_o
 	{
 		flags_a.block_processor_verification_size = block_processor_verification_size_it->second.as<size_t> ();
 	}
+	auto block_processor_prevalidation_threads_it = vm.find ("block_processor_prevalidation_threads");
+	if (block_processor_prevalidation_threads_it != vm.end ())
+	{
+		flags_a.block_processor_prevalidation_threads = block_processor_prevalidation_threads_it->second.as<unsigned> ();
+	}
+	auto block_processor_parallel_validation_threads_it = vm.find ("block_processor_parallel_validation_threads");
+	if (block_processor_parallel_validation_threads_it != vm.end ())
+	{
+		flags_a.block_processor_parallel_validation_threads = block_processor_parallel_validation_threads_it->second.as<unsigned> ();
+	}
 	auto inactive_votes_cache_size_it = vm.find ("inactive_votes_cache_size");
 	if (inactive_votes_cache_size_it != vm.end ())
 	{
@@ -203,7 +221,7 @@ bool copy_database (boost::filesystem::path const & data_path, boost::program_op
 		if (vm.count ("unchecked_clear"))
 		{
 			auto transaction (node.node->store.tx_begin_write ());
-			node.node->store.unchecked_clear (transaction);
+			node.node->unchecked.clear (transaction);
 		}
 		if (vm.count ("clear_send_ids"))
 		{
@@ -437,6 +455,34 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 			std::cerr << "Snapshot failed (unknown reason)" << std::endl;
 		}
 	}
+	else if (vm.count ("export_ledger"))
+	{
+		auto node_flags = nano::inactive_node_flag_defaults ();
+		nano::update_flags (node_flags, vm);
+		nano::inactive_node node (data_path, node_flags);
+		if (!node.node->init_error ())
+		{
+			auto export_path (vm.count ("file") == 1 ? boost::filesystem::path (vm["file"].as<std::string> ()) : data_path / "export");
+			std::cout << "Exporting ledger to " << export_path << std::endl;
+			std::cout << "This may take a while..." << std::endl;
+			nano::timer<std::chrono::seconds> timer;
+			timer.start ();
+			nano::ledger_export exporter (node.node->store, export_path, std::max (1u, std::thread::hardware_concurrency ()));
+			if (!exporter.run ())
+			{
+				std::cout << boost::str (boost::format ("Exported %1% accounts, %2% blocks, %3% pending entries and %4% confirmation heights in %5% %6%") % exporter.accounts.load () % exporter.blocks.load () % exporter.pending.load () % exporter.confirmation_heights.load () % timer.stop ().count () % timer.unit ()) << std::endl;
+			}
+			else
+			{
+				std::cerr << "Export failed, files could not be written to " << export_path << std::endl;
+				ec = nano::error_cli::generic;
+			}
+		}
+		else
+		{
+			database_write_lock_error (ec);
+		}
+	}
 	else if (vm.count ("unchecked_clear"))
 	{
 		boost::filesystem::path data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : nano::working_path ();
@@ -447,7 +493,7 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 		if (!node.node->init_error ())
 		{
 			auto transaction (node.node->store.tx_begin_write ());
-			node.node->store.unchecked_clear (transaction);
+			node.node->unchecked.clear (transaction);
 			std::cout << "Unchecked blocks deleted" << std::endl;
 		}
 		else
@@ -540,6 +586,7 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 						{
 							node.node->store.confirmation_height_clear (transaction, account, confirmation_height_info.height);
 						}
+						node.node->store.cache_counters_del (transaction);
 
 						std::cout << "Confirmation height of account " << account_str << " is set to " << conf_height_reset_num << std::endl;
 					}
@@ -1228,6 +1275,9 @@ void reset_confirmation_heights (nano::block_store & store)
 	// Then make sure the confirmation height of the genesis account open block is 1
 	nano::network_params network_params;
 	store.confirmation_height_put (transaction, network_params.ledger.genesis_account, { 1, network_params.ledger.genesis_hash });
+
+	// The stored cemented count no longer matches, have the next start count again
+	store.cache_counters_del (transaction);
 }
 
 bool is_using_rocksdb (boost::filesystem::path const & data_path, std::error_code & ec)
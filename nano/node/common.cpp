@@ -322,6 +322,10 @@ std::string nano::message_parser::status_string ()
 		{
 			return "duplicate_publish_message";
 		}
+		case nano::message_parser::parse_status::duplicate_confirm_ack_message:
+		{
+			return "duplicate_confirm_ack_message";
+		}
 	}
 
 	debug_assert (false);
@@ -329,8 +333,9 @@ std::string nano::message_parser::status_string ()
 	return "[unknown parse_status]";
 }
 
-nano::message_parser::message_parser (nano::network_filter & publish_filter_a, nano::block_uniquer & block_uniquer_a, nano::vote_uniquer & vote_uniquer_a, nano::message_visitor & visitor_a, nano::work_pool & pool_a, bool use_epoch_2_min_version_a) :
+nano::message_parser::message_parser (nano::network_filter & publish_filter_a, nano::network_filter & vote_filter_a, nano::block_uniquer & block_uniquer_a, nano::vote_uniquer & vote_uniquer_a, nano::message_visitor & visitor_a, nano::work_pool & pool_a, bool use_epoch_2_min_version_a) :
 publish_filter (publish_filter_a),
+vote_filter (vote_filter_a),
 block_uniquer (block_uniquer_a),
 vote_uniquer (vote_uniquer_a),
 visitor (visitor_a),
@@ -358,17 +363,30 @@ void nano::message_parser::deserialize_buffer (uint8_t const * buffer_a, size_t
 			}
 			else
 			{
+				auto payload_size (size_a - header.size);
 				switch (header.type)
 				{
 					case nano::message_type::keepalive:
 					{
-						deserialize_keepalive (stream, header);
+						if (!payload_size_mismatch (header, payload_size))
+						{
+							deserialize_keepalive (stream, header);
+						}
+						else
+						{
+							status = parse_status::invalid_keepalive_message;
+						}
 						break;
 					}
 					case nano::message_type::publish:
 					{
 						nano::uint128_t digest;
-						if (!publish_filter.apply (buffer_a + header.size, size_a - header.size, &digest))
+						// Malformed publishes are rejected before being added to the filter
+						if (payload_size_mismatch (header, payload_size))
+						{
+							status = parse_status::invalid_publish_message;
+						}
+						else if (!publish_filter.apply (buffer_a + header.size, payload_size, &digest))
 						{
 							deserialize_publish (stream, header, digest);
 						}
@@ -380,17 +398,44 @@ void nano::message_parser::deserialize_buffer (uint8_t const * buffer_a, size_t
 					}
 					case nano::message_type::confirm_req:
 					{
-						deserialize_confirm_req (stream, header);
+						if (!payload_size_mismatch (header, payload_size))
+						{
+							deserialize_confirm_req (stream, header);
+						}
+						else
+						{
+							status = parse_status::invalid_confirm_req_message;
+						}
 						break;
 					}
 					case nano::message_type::confirm_ack:
 					{
-						deserialize_confirm_ack (stream, header);
+						nano::uint128_t digest;
+						// Votes are replayed by many peers, the same payload is dropped before its vote and blocks are created
+						if (payload_size_mismatch (header, payload_size))
+						{
+							status = parse_status::invalid_confirm_ack_message;
+						}
+						else if (!vote_filter.apply (buffer_a + header.size, payload_size, &digest))
+						{
+							deserialize_confirm_ack (stream, header, digest);
+						}
+						else
+						{
+							status = parse_status::duplicate_confirm_ack_message;
+						}
 						break;
 					}
 					case nano::message_type::node_id_handshake:
 					{
-						deserialize_node_id_handshake (stream, header);
+						if (!payload_size_mismatch (header, payload_size))
+						{
+							deserialize_node_id_handshake (stream, header);
+						}
+						else
+						{
+							status = parse_status::invalid_node_id_handshake_message;
+						}
 						break;
 					}
 					case nano::message_type::telemetry_req:
@@ -474,10 +519,10 @@ void nano::message_parser::deserialize_confirm_req (nano::stream & stream_a, nan
 	}
 }
 
-void nano::message_parser::deserialize_confirm_ack (nano::stream & stream_a, nano::message_header const & header_a)
+void nano::message_parser::deserialize_confirm_ack (nano::stream & stream_a, nano::message_header const & header_a, nano::uint128_t const & digest_a)
 {
 	auto error (false);
-	nano::confirm_ack incoming (error, stream_a, header_a, &vote_uniquer);
+	nano::confirm_ack incoming (error, stream_a, header_a, digest_a, &vote_uniquer);
 	if (!error && at_end (stream_a))
 	{
 		for (auto & vote_block : incoming.vote->blocks)
@@ -545,6 +590,39 @@ void nano::message_parser::deserialize_telemetry_ack (nano::stream & stream_a, n
 	}
 }
 
+bool nano::message_parser::payload_size_mismatch (nano::message_header const & header_a, size_t payload_size_a)
+{
+	auto result (false);
+	auto block_type (header_a.block_type ());
+	auto has_block (block_type != nano::block_type::invalid && block_type != nano::block_type::not_a_block);
+	switch (header_a.type)
+	{
+		case nano::message_type::keepalive:
+		case nano::message_type::node_id_handshake:
+		{
+			result = payload_size_a != header_a.payload_length_bytes ();
+			break;
+		}
+		case nano::message_type::publish:
+		{
+			result = !has_block || payload_size_a != header_a.payload_length_bytes ();
+			break;
+		}
+		case nano::message_type::confirm_req:
+		case nano::message_type::confirm_ack:
+		{
+			// Messages with hashes are checked while deserializing
+			result = has_block && payload_size_a != header_a.payload_length_bytes ();
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+	return result;
+}
+
 bool nano::message_parser::at_end (nano::stream & stream_a)
 {
 	uint8_t junk;
@@ -795,9 +873,10 @@ size_t nano::confirm_req::size (nano::block_type type_a, size_t count)
 	return result;
 }
 
-nano::confirm_ack::confirm_ack (bool & error_a, nano::stream & stream_a, nano::message_header const & header_a, nano::vote_uniquer * uniquer_a) :
+nano::confirm_ack::confirm_ack (bool & error_a, nano::stream & stream_a, nano::message_header const & header_a, nano::uint128_t const & digest_a, nano::vote_uniquer * uniquer_a) :
 message (header_a),
-vote (nano::make_shared<nano::vote> (error_a, stream_a, header.block_type ()))
+vote (nano::make_shared<nano::vote> (error_a, stream_a, header.block_type ())),
+digest (digest_a)
 {
 	if (!error_a && uniquer_a)
 	{
@@ -351,9 +351,11 @@ void nano::confirmation_height_bounded::cement_blocks (nano::write_guard & scope
 	nano::timer<> cemented_batch_timer;
 	auto error = false;
 	{
-		// This only writes to the confirmation_height table and is the only place to do so in a single process
-		auto transaction (ledger.store.tx_begin_write ({}, { nano::tables::confirmation_height }));
+		// This only writes to the confirmation_height table and the cache counters in meta, and is the only place to do so in a single process
+		auto transaction (ledger.store.tx_begin_write ({}, { nano::tables::confirmation_height, nano::tables::meta }));
 		cemented_batch_timer.start ();
+		// Stored cache counters are written once before each commit rather than for every account
+		auto counters_dirty (false);
 		// Cement all pending entries, each entry is specific to an account and contains the least amount
 		// of blocks to retain consistent cementing across all account chains to genesis.
 		while (!error && !pending_writes.empty ())
@@ -361,7 +363,7 @@ void nano::confirmation_height_bounded::cement_blocks (nano::write_guard & scope
 			const auto & pending = pending_writes.front ();
 			const auto & account = pending.account;
 
-			auto write_confirmation_height = [&account, &ledger = ledger, &transaction](uint64_t num_blocks_cemented, uint64_t confirmation_height, nano::block_hash const & confirmed_frontier) {
+			auto write_confirmation_height = [&account, &ledger = ledger, &transaction, &counters_dirty](uint64_t num_blocks_cemented, uint64_t confirmation_height, nano::block_hash const & confirmed_frontier) {
 #ifndef NDEBUG
 				// Extra debug checks
 				nano::confirmation_height_info confirmation_height_info;
@@ -372,6 +374,7 @@ void nano::confirmation_height_bounded::cement_blocks (nano::write_guard & scope
 #endif
 				ledger.store.confirmation_height_put (transaction, account, nano::confirmation_height_info{ confirmation_height, confirmed_frontier });
 				ledger.cache.cemented_count += num_blocks_cemented;
+				counters_dirty = true;
 				ledger.stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed, nano::stat::dir::in, num_blocks_cemented);
 				ledger.stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed_bounded, nano::stat::dir::in, num_blocks_cemented);
 			};
@@ -438,6 +441,8 @@ void nano::confirmation_height_bounded::cement_blocks (nano::write_guard & scope
 						auto num_blocks_cemented = num_blocks_iterated - total_blocks_cemented + 1;
 						total_blocks_cemented += num_blocks_cemented;
 						write_confirmation_height (num_blocks_cemented, start_height + total_blocks_cemented - 1, new_cemented_frontier);
+						ledger.cache_counters_write (transaction);
+						counters_dirty = false;
 						transaction.commit ();
 						logger.always_log (boost::str (boost::format ("Cemented %1% blocks in %2% %3% (bounded processor)") % cemented_blocks.size () % time_spent_cementing % cemented_batch_timer.unit ()));
 
@@ -504,6 +509,10 @@ void nano::confirmation_height_bounded::cement_blocks (nano::write_guard & scope
 			pending_writes.pop_front ();
 			--pending_writes_size;
 		}
+		if (counters_dirty)
+		{
+			ledger.cache_counters_write (transaction);
+		}
 	}
 	auto time_spent_cementing = cemented_batch_timer.since_start ().count ();
 	if (time_spent_cementing > 50)
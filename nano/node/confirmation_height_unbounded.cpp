@@ -341,7 +341,7 @@ void nano::confirmation_height_unbounded::cement_blocks (nano::write_guard & sco
 	std::vector<std::shared_ptr<nano::block>> cemented_blocks;
 	auto error = false;
 	{
-		auto transaction (ledger.store.tx_begin_write ({}, { nano::tables::confirmation_height }));
+		auto transaction (ledger.store.tx_begin_write ({}, { nano::tables::confirmation_height, nano::tables::meta }));
 		cemented_batch_timer.start ();
 		while (!pending_writes.empty ())
 		{
@@ -387,6 +387,8 @@ void nano::confirmation_height_unbounded::cement_blocks (nano::write_guard & sco
 			pending_writes.erase (pending_writes.begin ());
 			--pending_writes_size;
 		}
+		// Stored cache counters are written once per transaction rather than for every account
+		ledger.cache_counters_write (transaction);
 	}
 
 	auto time_spent_cementing = cemented_batch_timer.since_start ().count ();
@@ -813,19 +813,27 @@ void nano::json_handler::account_weight ()
 
 void nano::json_handler::accounts_balances ()
 {
-	boost::property_tree::ptree balances;
-	for (auto & accounts : request.get_child ("accounts"))
+	std::vector<nano::account> accounts;
+	for (auto & accounts_l : request.get_child ("accounts"))
 	{
-		auto account (account_impl (accounts.second.data ()));
+		auto account (account_impl (accounts_l.second.data ()));
 		if (!ec)
 		{
-			boost::property_tree::ptree entry;
-			auto balance (node.balance_pending (account));
-			entry.put ("balance", balance.first.convert_to<std::string> ());
-			entry.put ("pending", balance.second.convert_to<std::string> ());
-			balances.push_back (std::make_pair (account.to_account (), entry));
+			accounts.push_back (account);
 		}
 	}
+	boost::property_tree::ptree balances;
+	auto transaction (node.store.tx_begin_read ());
+	auto infos (node.store.accounts_get (transaction, accounts));
+	auto pendings (node.ledger.accounts_pending (transaction, accounts));
+	for (size_t i (0), n (accounts.size ()); i < n; ++i)
+	{
+		boost::property_tree::ptree entry;
+		nano::uint128_t balance (infos[i] ? infos[i]->balance.number () : 0);
+		entry.put ("balance", balance.convert_to<std::string> ());
+		entry.put ("pending", pendings[i].convert_to<std::string> ());
+		balances.push_back (std::make_pair (accounts[i].to_account (), entry));
+	}
 	response_l.add_child ("balances", balances);
 	response_errors ();
 }
@@ -1123,91 +1131,128 @@ void nano::json_handler::blocks_info ()
 	const bool json_block_l = request.get<bool> ("json_block", false);
 	const bool include_not_found = request.get<bool> ("include_not_found", false);
 
+	// Hashes up to the first one which can't be decoded are looked up together
+	std::vector<std::string> hashes_text;
+	std::vector<nano::block_hash> hashes;
+	auto bad_hash (false);
+	for (boost::property_tree::ptree::value_type & hashes_l : request.get_child ("hashes"))
+	{
+		std::string hash_text = hashes_l.second.data ();
+		nano::block_hash hash;
+		if (hash.decode_hex (hash_text))
+		{
+			bad_hash = true;
+			break;
+		}
+		hashes_text.push_back (hash_text);
+		hashes.push_back (hash);
+	}
 	boost::property_tree::ptree blocks;
 	boost::property_tree::ptree blocks_not_found;
 	auto transaction (node.store.tx_begin_read ());
-	for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
+	auto blocks_l (node.store.blocks_get (transaction, hashes));
+	// Whether each block is still pending, only sends to a non-zero destination are looked up
+	std::vector<bool> pending_l (hashes.size (), false);
+	if (pending)
 	{
-		if (!ec)
+		std::vector<size_t> indices;
+		std::vector<nano::pending_key> pending_keys;
+		for (size_t i (0), n (blocks_l.size ()); i < n; ++i)
 		{
-			std::string hash_text = hashes.second.data ();
-			nano::block_hash hash;
-			if (!hash.decode_hex (hash_text))
+			if (blocks_l[i] != nullptr)
 			{
-				auto block (node.store.block_get (transaction, hash));
-				if (block != nullptr)
+				auto destination (node.ledger.block_destination (transaction, *blocks_l[i]));
+				if (!destination.is_zero ())
 				{
-					boost::property_tree::ptree entry;
-					nano::account account (block->account ().is_zero () ? block->sideband ().account : block->account ());
-					entry.put ("block_account", account.to_account ());
-					auto amount (node.ledger.amount (transaction, hash));
-					entry.put ("amount", amount.convert_to<std::string> ());
-					auto balance (node.ledger.balance (transaction, hash));
-					entry.put ("balance", balance.convert_to<std::string> ());
-					entry.put ("height", std::to_string (block->sideband ().height));
-					entry.put ("local_timestamp", std::to_string (block->sideband ().timestamp));
-					auto confirmed (node.ledger.block_confirmed (transaction, hash));
-					entry.put ("confirmed", confirmed);
-
-					if (json_block_l)
-					{
-						boost::property_tree::ptree block_node_l;
-						block->serialize_json (block_node_l);
-						entry.add_child ("contents", block_node_l);
-					}
-					else
-					{
-						std::string contents;
-						block->serialize_json (contents);
-						entry.put ("contents", contents);
-					}
-					if (block->type () == nano::block_type::state)
-					{
-						auto subtype (nano::state_subtype (block->sideband ().details));
-						entry.put ("subtype", subtype);
-					}
-					if (pending)
-					{
-						bool exists (false);
-						auto destination (node.ledger.block_destination (transaction, *block));
-						if (!destination.is_zero ())
-						{
-							exists = node.store.pending_exists (transaction, nano::pending_key (destination, hash));
-						}
-						entry.put ("pending", exists ? "1" : "0");
-					}
-					if (source)
-					{
-						nano::block_hash source_hash (node.ledger.block_source (transaction, *block));
-						auto block_a (node.store.block_get (transaction, source_hash));
-						if (block_a != nullptr)
-						{
-							auto source_account (node.ledger.account (transaction, source_hash));
-							entry.put ("source_account", source_account.to_account ());
-						}
-						else
-						{
-							entry.put ("source_account", "0");
-						}
-					}
-					blocks.push_back (std::make_pair (hash_text, entry));
+					indices.push_back (i);
+					pending_keys.emplace_back (destination, hashes[i]);
 				}
-				else if (include_not_found)
+			}
+		}
+		auto pending_infos (node.store.pending_get_many (transaction, pending_keys));
+		for (size_t i (0), n (indices.size ()); i < n; ++i)
+		{
+			pending_l[indices[i]] = pending_infos[i].is_initialized ();
+		}
+	}
+	std::vector<std::shared_ptr<nano::block>> sources_l;
+	if (source)
+	{
+		std::vector<nano::block_hash> source_hashes;
+		for (auto const & block : blocks_l)
+		{
+			source_hashes.push_back (block != nullptr ? node.ledger.block_source (transaction, *block) : nano::block_hash (0));
+		}
+		sources_l = node.store.blocks_get (transaction, source_hashes);
+	}
+	for (size_t i (0), n (hashes.size ()); i < n && !ec; ++i)
+	{
+		auto const & hash (hashes[i]);
+		auto const & hash_text (hashes_text[i]);
+		auto const & block (blocks_l[i]);
+		if (block != nullptr)
+		{
+			boost::property_tree::ptree entry;
+			nano::account account (block->account ().is_zero () ? block->sideband ().account : block->account ());
+			entry.put ("block_account", account.to_account ());
+			auto amount (node.ledger.amount (transaction, hash));
+			entry.put ("amount", amount.convert_to<std::string> ());
+			auto balance (node.ledger.balance (transaction, hash));
+			entry.put ("balance", balance.convert_to<std::string> ());
+			entry.put ("height", std::to_string (block->sideband ().height));
+			entry.put ("local_timestamp", std::to_string (block->sideband ().timestamp));
+			auto confirmed (node.ledger.block_confirmed (transaction, hash));
+			entry.put ("confirmed", confirmed);
+
+			if (json_block_l)
+			{
+				boost::property_tree::ptree block_node_l;
+				block->serialize_json (block_node_l);
+				entry.add_child ("contents", block_node_l);
+			}
+			else
+			{
+				std::string contents;
+				block->serialize_json (contents);
+				entry.put ("contents", contents);
+			}
+			if (block->type () == nano::block_type::state)
+			{
+				auto subtype (nano::state_subtype (block->sideband ().details));
+				entry.put ("subtype", subtype);
+			}
+			if (pending)
+			{
+				entry.put ("pending", pending_l[i] ? "1" : "0");
+			}
+			if (source)
+			{
+				if (sources_l[i] != nullptr)
 				{
-					boost::property_tree::ptree entry;
-					entry.put ("", hash_text);
-					blocks_not_found.push_back (std::make_pair ("", entry));
+					auto source_account (node.store.block_account_calculated (*sources_l[i]));
+					entry.put ("source_account", source_account.to_account ());
 				}
 				else
 				{
-					ec = nano::error_blocks::not_found;
+					entry.put ("source_account", "0");
 				}
 			}
-			else
-			{
-				ec = nano::error_blocks::bad_hash_number;
-			}
+			blocks.push_back (std::make_pair (hash_text, entry));
 		}
+		else if (include_not_found)
+		{
+			boost::property_tree::ptree entry;
+			entry.put ("", hash_text);
+			blocks_not_found.push_back (std::make_pair ("", entry));
+		}
+		else
+		{
+			ec = nano::error_blocks::not_found;
+		}
+	}
+	if (!ec && bad_hash)
+	{
+		ec = nano::error_blocks::bad_hash_number;
 	}
 	if (!ec)
 	{
@@ -1953,6 +1998,44 @@ void nano::json_handler::confirmation_quorum ()
 	response_errors ();
 }
 
+void nano::json_handler::database_compaction ()
+{
+	auto command (request.get<std::string> ("command", "status"));
+	if (command == "start")
+	{
+		if (node.store.compaction_start ())
+		{
+			ec = nano::error_rpc::compaction_not_started;
+		}
+	}
+	else if (command == "pause" || command == "resume")
+	{
+		if (node.store.compaction_pause (command == "pause"))
+		{
+			ec = nano::error_rpc::compaction_not_copying;
+		}
+	}
+	else if (command != "status")
+	{
+		ec = nano::error_rpc::invalid_compaction_command;
+	}
+	if (!ec)
+	{
+		boost::property_tree::ptree status;
+		node.store.compaction_status (status);
+		response_l.put_child ("compaction", status);
+	}
+	response_errors ();
+}
+
+void nano::json_handler::database_durability ()
+{
+	boost::property_tree::ptree status;
+	node.store.durability_status (status);
+	response_l.put_child ("durability", status);
+	response_errors ();
+}
+
 void nano::json_handler::database_txn_tracker ()
 {
 	boost::property_tree::ptree json;
@@ -2393,8 +2476,9 @@ void nano::json_handler::account_history ()
 		boost::property_tree::ptree history;
 		bool output_raw (request.get_optional<bool> ("raw") == true);
 		response_l.put ("account", account.to_account ());
-		auto block (node.store.block_get (transaction, hash));
-		while (block != nullptr && count > 0)
+		// Blocks skipped by the offset are only walked through, not deserialized
+		auto view (node.store.block_view_get (transaction, hash));
+		while (view.exists () && count > 0)
 		{
 			if (offset > 0)
 			{
@@ -2402,6 +2486,7 @@ void nano::json_handler::account_history ()
 			}
 			else
 			{
+				auto block (view.block ());
 				boost::property_tree::ptree entry;
 				history_visitor visitor (*this, output_raw, transaction, entry, hash, accounts_to_filter);
 				block->visit (visitor);
@@ -2419,8 +2504,8 @@ void nano::json_handler::account_history ()
 					--count;
 				}
 			}
-			hash = reverse ? node.store.block_successor (transaction, hash) : block->previous ();
-			block = node.store.block_get (transaction, hash);
+			hash = reverse ? view.successor () : view.previous ();
+			view = node.store.block_view_get (transaction, hash);
 		}
 		response_l.add_child ("history", history);
 		if (!hash.is_zero ())
@@ -3276,7 +3361,8 @@ void nano::json_handler::representatives ()
 	{
 		const bool sorting = request.get<bool> ("sorting", false);
 		boost::property_tree::ptree representatives;
-		auto rep_amounts = node.ledger.cache.rep_weights.get_rep_amounts ();
+		auto rep_amounts_l (node.ledger.cache.rep_weights.get_rep_amounts ());
+		auto const & rep_amounts (*rep_amounts_l);
 		if (!sorting) // Simple
 		{
 			std::map<nano::account, nano::uint128_t> ordered (rep_amounts.begin (), rep_amounts.end ());
@@ -3698,6 +3784,10 @@ void nano::json_handler::stats ()
 		node.stats.log_samples (*sink);
 		use_sink = true;
 	}
+	else if (type == "store")
+	{
+		node.store.profile_get ().serialize (response_l);
+	}
 	else
 	{
 		ec = nano::error_rpc::invalid_missing_type;
@@ -3719,6 +3809,7 @@ void nano::json_handler::stats ()
 void nano::json_handler::stats_clear ()
 {
 	node.stats.clear ();
+	node.store.profile_get ().clear ();
 	response_l.put ("success", "");
 	std::stringstream ostream;
 	boost::property_tree::write_json (ostream, response_l);
@@ -3907,9 +3998,11 @@ void nano::json_handler::unchecked ()
 	{
 		boost::property_tree::ptree unchecked;
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
-		{
-			nano::unchecked_info const & info (i->second);
+		node.unchecked.for_each (transaction, nano::unchecked_key (0, 0), [&unchecked, count, json_block_l](nano::unchecked_key const &, nano::unchecked_info const & info) {
+			if (unchecked.size () >= count)
+			{
+				return false;
+			}
 			if (json_block_l)
 			{
 				boost::property_tree::ptree block_node_l;
@@ -3922,7 +4015,8 @@ void nano::json_handler::unchecked ()
 				info.block->serialize_json (contents);
 				unchecked.put (info.block->hash ().to_string (), contents);
 			}
-		}
+			return true;
+		});
 		response_l.add_child ("blocks", unchecked);
 	}
 	response_errors ();
@@ -3932,8 +4026,7 @@ void nano::json_handler::unchecked_clear ()
 {
 	node.worker.push_task (create_worker_task ([](std::shared_ptr<nano::json_handler> const & rpc_l) {
 		auto transaction (rpc_l->node.store.tx_begin_write ({ tables::unchecked }));
-		rpc_l->node.store.unchecked_clear (transaction);
-		rpc_l->node.ledger.cache.unchecked_count = 0;
+		rpc_l->node.unchecked.clear (transaction);
 		rpc_l->response_l.put ("success", "");
 		rpc_l->response_errors ();
 	}));
@@ -3946,12 +4039,10 @@ void nano::json_handler::unchecked_get ()
 	if (!ec)
 	{
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n; ++i)
-		{
-			nano::unchecked_key const & key (i->first);
-			if (key.hash == hash)
+		node.unchecked.for_each (transaction, nano::unchecked_key (0, 0), [this, &hash, json_block_l](nano::unchecked_key const & key, nano::unchecked_info const & info) {
+			auto found (key.hash == hash);
+			if (found)
 			{
-				nano::unchecked_info const & info (i->second);
 				response_l.put ("modified_timestamp", std::to_string (info.modified));
 
 				if (json_block_l)
@@ -3966,9 +4057,9 @@ void nano::json_handler::unchecked_get ()
 					info.block->serialize_json (contents);
 					response_l.put ("contents", contents);
 				}
-				break;
 			}
-		}
+			return !found;
+		});
 		if (response_l.empty ())
 		{
 			ec = nano::error_blocks::not_found;
@@ -3994,11 +4085,13 @@ void nano::json_handler::unchecked_keys ()
 	{
 		boost::property_tree::ptree unchecked;
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction, nano::unchecked_key (key, 0))), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
-		{
+		node.unchecked.for_each (transaction, nano::unchecked_key (key, 0), [&unchecked, count, json_block_l](nano::unchecked_key const & key_a, nano::unchecked_info const & info) {
+			if (unchecked.size () >= count)
+			{
+				return false;
+			}
 			boost::property_tree::ptree entry;
-			nano::unchecked_info const & info (i->second);
-			entry.put ("key", i->first.key ().to_string ());
+			entry.put ("key", key_a.key ().to_string ());
 			entry.put ("hash", info.block->hash ().to_string ());
 			entry.put ("modified_timestamp", std::to_string (info.modified));
 			if (json_block_l)
@@ -4014,7 +4107,8 @@ void nano::json_handler::unchecked_keys ()
 				entry.put ("contents", contents);
 			}
 			unchecked.push_back (std::make_pair ("", entry));
-		}
+			return true;
+		});
 		response_l.add_child ("unchecked", unchecked);
 	}
 	response_errors ();
@@ -5060,6 +5154,8 @@ ipc_json_handler_no_arg_func_map create_ipc_json_handler_no_arg_func_map ()
 	no_arg_funcs.emplace ("confirmation_history", &nano::json_handler::confirmation_history);
 	no_arg_funcs.emplace ("confirmation_info", &nano::json_handler::confirmation_info);
 	no_arg_funcs.emplace ("confirmation_quorum", &nano::json_handler::confirmation_quorum);
+	no_arg_funcs.emplace ("database_compaction", &nano::json_handler::database_compaction);
+	no_arg_funcs.emplace ("database_durability", &nano::json_handler::database_durability);
 	no_arg_funcs.emplace ("database_txn_tracker", &nano::json_handler::database_txn_tracker);
 	no_arg_funcs.emplace ("delegators", &nano::json_handler::delegators);
 	no_arg_funcs.emplace ("delegators_count", &nano::json_handler::delegators_count);
@@ -64,6 +64,8 @@ public:
 	void confirmation_info ();
 	void confirmation_quorum ();
 	void confirmation_height_currently_processing ();
+	void database_compaction ();
+	void database_durability ();
 	void database_txn_tracker ();
 	void delegators ();
 	void delegators_count ();
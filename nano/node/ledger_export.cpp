@@ -0,0 +1,250 @@
+#include <nano/node/ledger_export.hpp>
+#include <nano/secure/blockstore.hpp>
+
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+
+#include <algorithm>
+
+size_t constexpr nano::ledger_export::chunk_rows;
+uint8_t constexpr nano::ledger_export::codec_none;
+uint8_t constexpr nano::ledger_export::codec_run_length;
+
+nano::ledger_export::ledger_export (nano::block_store & store_a, boost::filesystem::path const & directory_a, unsigned shards_a) :
+store (store_a),
+directory (directory_a),
+shards (std::max (1u, shards_a))
+{
+}
+
+bool nano::ledger_export::run ()
+{
+	boost::system::error_code ec;
+	boost::filesystem::create_directories (directory, ec);
+	auto error (static_cast<bool> (ec));
+	if (!error)
+	{
+		std::vector<std::promise<void>> snapshots (shards);
+		std::vector<std::future<bool>> results;
+		{
+			// No writer can commit while the write lock is held, so every shard's read transaction starts from the same ledger state
+			auto transaction (store.tx_begin_write ());
+			for (auto i (0u); i < shards; ++i)
+			{
+				results.push_back (std::async (std::launch::async, [this, i, &snapshot = snapshots[i]]() {
+					return export_shard (i, snapshot);
+				}));
+			}
+			for (auto & snapshot : snapshots)
+			{
+				snapshot.get_future ().wait ();
+			}
+		}
+		for (auto & result : results)
+		{
+			error |= result.get ();
+		}
+	}
+	return error;
+}
+
+bool nano::ledger_export::export_shard (unsigned shard_a, std::promise<void> & snapshot_a)
+{
+	// Accounts are split in ranges of equal size, the last one extends to the end of the tables
+	auto step (std::numeric_limits<nano::uint256_t>::max () / shards);
+	nano::account begin (step * shard_a);
+	auto last (shard_a + 1 == shards);
+	nano::uint256_t end (last ? 0 : step * (shard_a + 1));
+	auto in_range = [last, &end](nano::account const & account_a) {
+		return last || account_a.number () < end;
+	};
+	auto path = [this, shard_a](std::string const & table_a) {
+		return directory / boost::str (boost::format ("%1%.%2%.col") % table_a % shard_a);
+	};
+	table_file accounts_file (path ("accounts"), { { "account", 32 }, { "head", 32 }, { "representative", 32 }, { "open_block", 32 }, { "balance", 16 }, { "modified", 8 }, { "block_count", 8 }, { "epoch", 1 } });
+	table_file blocks_file (path ("blocks"), { { "account", 32 }, { "hash", 32 }, { "type", 1 }, { "height", 8 }, { "previous", 32 }, { "representative", 32 }, { "link", 32 }, { "balance", 16 }, { "timestamp", 8 }, { "epoch", 1 }, { "flags", 1 }, { "successor", 32 }, { "work", 8 }, { "signature", 64 } });
+	table_file pending_file (path ("pending"), { { "account", 32 }, { "hash", 32 }, { "source", 32 }, { "amount", 16 }, { "epoch", 1 } });
+	table_file confirmation_height_file (path ("confirmation_height"), { { "account", 32 }, { "height", 8 }, { "frontier", 32 } });
+
+	auto transaction (store.tx_begin_read ());
+	snapshot_a.set_value ();
+	for (auto i (store.latest_begin (transaction, begin)), n (store.latest_end ()); i != n && in_range (i->first); ++i)
+	{
+		nano::account const & account (i->first);
+		nano::account_info const & info (i->second);
+		accounts_file.put (0, account);
+		accounts_file.put (1, info.head);
+		accounts_file.put (2, info.representative);
+		accounts_file.put (3, info.open_block);
+		accounts_file.put (4, info.balance);
+		accounts_file.put (5, info.modified);
+		accounts_file.put (6, info.block_count);
+		accounts_file.put (7, static_cast<uint8_t> (info.epoch ()));
+		accounts_file.row_end ();
+		++accounts;
+		for (auto hash (info.open_block); !hash.is_zero ();)
+		{
+			auto block (store.block_get (transaction, hash));
+			release_assert (block != nullptr);
+			auto const & sideband (block->sideband ());
+			// Legacy blocks keep their destination or source where state blocks have their link
+			nano::uint256_union link;
+			switch (block->type ())
+			{
+				case nano::block_type::send:
+					link = static_cast<nano::send_block const &> (*block).hashables.destination;
+					break;
+				case nano::block_type::receive:
+				case nano::block_type::open:
+					link = block->source ();
+					break;
+				default:
+					link = block->link ();
+					break;
+			}
+			auto const & details (sideband.details);
+			blocks_file.put (0, account);
+			blocks_file.put (1, hash);
+			blocks_file.put (2, static_cast<uint8_t> (block->type ()));
+			blocks_file.put (3, sideband.height);
+			blocks_file.put (4, block->previous ());
+			blocks_file.put (5, block->representative ());
+			blocks_file.put (6, link);
+			blocks_file.put (7, block->type () == nano::block_type::state ? block->balance () : sideband.balance);
+			blocks_file.put (8, sideband.timestamp);
+			blocks_file.put (9, static_cast<uint8_t> (details.epoch));
+			blocks_file.put (10, static_cast<uint8_t> ((details.is_send ? 1 : 0) | (details.is_receive ? 2 : 0) | (details.is_epoch ? 4 : 0)));
+			blocks_file.put (11, sideband.successor);
+			blocks_file.put (12, block->block_work ());
+			blocks_file.put (13, block->block_signature ());
+			blocks_file.row_end ();
+			++blocks;
+			hash = sideband.successor;
+		}
+	}
+	for (auto i (store.pending_begin (transaction, nano::pending_key (begin, 0))), n (store.pending_end ()); i != n && in_range (i->first.account); ++i)
+	{
+		pending_file.put (0, i->first.account);
+		pending_file.put (1, i->first.hash);
+		pending_file.put (2, i->second.source);
+		pending_file.put (3, i->second.amount);
+		pending_file.put (4, static_cast<uint8_t> (i->second.epoch));
+		pending_file.row_end ();
+		++pending;
+	}
+	for (auto i (store.confirmation_height_begin (transaction, begin)), n (store.confirmation_height_end ()); i != n && in_range (i->first); ++i)
+	{
+		confirmation_height_file.put (0, i->first);
+		confirmation_height_file.put (1, i->second.height);
+		confirmation_height_file.put (2, i->second.frontier);
+		confirmation_height_file.row_end ();
+		++confirmation_heights;
+	}
+	auto error (accounts_file.finish ());
+	error |= blocks_file.finish ();
+	error |= pending_file.finish ();
+	error |= confirmation_height_file.finish ();
+	return error;
+}
+
+nano::ledger_export::table_file::table_file (boost::filesystem::path const & path_a, std::vector<std::pair<std::string, uint8_t>> const & columns_a) :
+stream (path_a.string (), std::ios::binary | std::ios::trunc),
+columns (columns_a.size ())
+{
+	stream.write ("NANOCOL1", 8);
+	stream.put (static_cast<char> (columns_a.size ()));
+	for (auto const & column : columns_a)
+	{
+		stream.put (static_cast<char> (column.first.size ()));
+		stream.write (column.first.data (), column.first.size ());
+		stream.put (static_cast<char> (column.second));
+		widths.push_back (column.second);
+	}
+}
+
+void nano::ledger_export::table_file::put (size_t column_a, nano::uint256_union const & value_a)
+{
+	put (column_a, value_a.bytes.data (), value_a.bytes.size ());
+}
+
+void nano::ledger_export::table_file::put (size_t column_a, nano::uint512_union const & value_a)
+{
+	put (column_a, value_a.bytes.data (), value_a.bytes.size ());
+}
+
+void nano::ledger_export::table_file::put (size_t column_a, nano::amount const & value_a)
+{
+	put (column_a, value_a.bytes.data (), value_a.bytes.size ());
+}
+
+void nano::ledger_export::table_file::put (size_t column_a, uint64_t value_a)
+{
+	boost::endian::native_to_big_inplace (value_a);
+	put (column_a, reinterpret_cast<uint8_t const *> (&value_a), sizeof (value_a));
+}
+
+void nano::ledger_export::table_file::put (size_t column_a, uint8_t value_a)
+{
+	put (column_a, &value_a, sizeof (value_a));
+}
+
+void nano::ledger_export::table_file::put (size_t column_a, uint8_t const * data_a, size_t size_a)
+{
+	debug_assert (size_a == widths[column_a]);
+	columns[column_a].insert (columns[column_a].end (), data_a, data_a + size_a);
+}
+
+void nano::ledger_export::table_file::row_end ()
+{
+	if (++rows == chunk_rows)
+	{
+		flush ();
+	}
+}
+
+bool nano::ledger_export::table_file::finish ()
+{
+	if (rows > 0)
+	{
+		flush ();
+	}
+	// An empty chunk ends the file, so truncated files can be told apart
+	flush ();
+	stream.close ();
+	return stream.fail ();
+}
+
+void nano::ledger_export::table_file::flush ()
+{
+	auto rows_l (boost::endian::native_to_big (static_cast<uint32_t> (rows)));
+	stream.write (reinterpret_cast<char const *> (&rows_l), sizeof (rows_l));
+	for (auto i (0u); i < columns.size (); ++i)
+	{
+		auto & column (columns[i]);
+		auto width (widths[i]);
+		// Repeated values such as the account of each block in a chain are stored once per run
+		std::vector<uint8_t> runs;
+		for (auto begin (column.begin ()); begin != column.end () && runs.size () < column.size ();)
+		{
+			auto end (begin + width);
+			uint32_t count (1);
+			while (end != column.end () && std::equal (begin, begin + width, end))
+			{
+				end += width;
+				++count;
+			}
+			boost::endian::native_to_big_inplace (count);
+			auto count_bytes (reinterpret_cast<uint8_t const *> (&count));
+			runs.insert (runs.end (), count_bytes, count_bytes + sizeof (count));
+			runs.insert (runs.end (), begin, begin + width);
+			begin = end;
+		}
+		auto run_length (runs.size () < column.size ());
+		auto const & values (run_length ? runs : column);
+		stream.put (static_cast<char> (run_length ? codec_run_length : codec_none));
+		stream.write (reinterpret_cast<char const *> (values.data ()), values.size ());
+		column.clear ();
+	}
+	rows = 0;
+}
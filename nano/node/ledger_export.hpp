@@ -0,0 +1,68 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace nano
+{
+class block_store;
+
+/**
+ * Writes the accounts, blocks, pending entries and confirmation heights of a ledger to columnar files for analytics.
+ * Accounts are split in key ranges exported in parallel, each shard writes one file per table. The shards open their read transactions
+ * while the write lock is held, so they all export the same ledger state. Blocks are written per account, from the open block to the frontier.
+ *
+ * A file starts with the "NANOCOL1" magic and the column count, then each column as a name length, name and value width in bytes.
+ * Chunks of up to chunk_rows rows follow, each made of a 4 byte row count followed by each column as a codec byte and its values.
+ * Values are fixed width and big endian. Columns are stored as is (codec 0) or as runs of a 4 byte repeat count and a value (codec 1),
+ * whichever is smaller. A chunk of 0 rows ends the file.
+ */
+class ledger_export final
+{
+public:
+	ledger_export (nano::block_store &, boost::filesystem::path const & directory_a, unsigned shards_a);
+	/** Returns true if a file could not be written */
+	bool run ();
+	std::atomic<uint64_t> accounts{ 0 };
+	std::atomic<uint64_t> blocks{ 0 };
+	std::atomic<uint64_t> pending{ 0 };
+	std::atomic<uint64_t> confirmation_heights{ 0 };
+	static size_t constexpr chunk_rows{ 64 * 1024 };
+	static uint8_t constexpr codec_none{ 0 };
+	static uint8_t constexpr codec_run_length{ 1 };
+
+private:
+	class table_file final
+	{
+	public:
+		table_file (boost::filesystem::path const &, std::vector<std::pair<std::string, uint8_t>> const & columns_a);
+		void put (size_t column_a, nano::uint256_union const &);
+		void put (size_t column_a, nano::uint512_union const &);
+		void put (size_t column_a, nano::amount const &);
+		void put (size_t column_a, uint64_t);
+		void put (size_t column_a, uint8_t);
+		void row_end ();
+		/** Returns true if the file could not be written */
+		bool finish ();
+
+	private:
+		void put (size_t column_a, uint8_t const * data_a, size_t size_a);
+		void flush ();
+		std::ofstream stream;
+		std::vector<uint8_t> widths;
+		std::vector<std::vector<uint8_t>> columns;
+		size_t rows{ 0 };
+	};
+	bool export_shard (unsigned shard_a, std::promise<void> & snapshot_a);
+	nano::block_store & store;
+	boost::filesystem::path const directory;
+	unsigned const shards;
+};
+}
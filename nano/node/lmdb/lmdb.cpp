@@ -11,6 +11,7 @@
 #include <boost/format.hpp>
 #include <boost/polymorphic_cast.hpp>
 
+#include <numeric>
 #include <queue>
 
 namespace nano
@@ -44,7 +45,11 @@ nano::mdb_store::mdb_store (nano::logger_mt & logger_a, boost::filesystem::path
 logger (logger_a),
 env (error, path_a, nano::mdb_env::options::make ().set_config (lmdb_config_a).set_use_no_mem_init (true)),
 mdb_txn_tracker (logger_a, txn_tracking_config_a, block_processor_batch_max_time_a),
-txn_tracking_enabled (txn_tracking_config_a.enable)
+txn_tracking_enabled (txn_tracking_config_a.enable),
+compaction (env, path_a, lmdb_config_a, logger_a, [this]() { read_txn_pool.clear (); }, [this]() { return reopen_databases (); }),
+read_txn_pool (lmdb_config_a.read_txn_pool_size),
+sync_strategy (lmdb_config_a.sync),
+group_sync (env, lmdb_config_a.group_sync_interval, lmdb_config_a.group_sync_commits)
 {
 	if (!error)
 	{
@@ -100,6 +105,27 @@ txn_tracking_enabled (txn_tracking_config_a.enable)
 			auto transaction (tx_begin_read ());
 			open_databases (error, transaction, 0);
 		}
+		pool_reads = !error && lmdb_config_a.read_txn_pool_size > 0;
+		summaries_enabled = !error;
+		if (!error && sync_strategy == nano::lmdb_config::sync_strategy::group)
+		{
+			env.on_commit = [this]() { group_sync.committed (); };
+			group_sync.start ();
+		}
+	}
+}
+
+nano::mdb_store::~mdb_store ()
+{
+	read_txn_pool.clear ();
+	// Flushes the last commits, before a compaction swap closes the environment
+	group_sync.stop ();
+	auto compaction_state (compaction.status ());
+	if (compaction_state != nano::mdb_compaction::state::idle && compaction_state != nano::mdb_compaction::state::swapped)
+	{
+		// No transactions are open anymore, so a copy which could not be swapped in while running can replace the database file
+		auto swap_error (compaction.swap ());
+		logger.always_log (swap_error ? "Online compaction did not finish, the database file was left unchanged" : "Replaced the database file with its compacted copy");
 	}
 }
 
@@ -138,19 +164,87 @@ bool nano::mdb_store::vacuum_after_upgrade (boost::filesystem::path const & path
 	return vacuum_success;
 }
 
+bool nano::mdb_store::reopen_databases ()
+{
+	bool error (false);
+	// Not from the pool, database handles opened in a read transaction need it committed
+	auto transaction (env.tx_begin_read ());
+	open_databases (error, transaction, 0);
+	return error;
+}
+
 void nano::mdb_store::serialize_mdb_tracker (boost::property_tree::ptree & json, std::chrono::milliseconds min_read_time, std::chrono::milliseconds min_write_time)
 {
 	mdb_txn_tracker.serialize_json (json, min_read_time, min_write_time);
 }
 
+bool nano::mdb_store::compaction_start ()
+{
+	return compaction.start ();
+}
+
+bool nano::mdb_store::compaction_pause (bool paused_a)
+{
+	return compaction.pause (paused_a);
+}
+
+void nano::mdb_store::compaction_status (boost::property_tree::ptree & json_a)
+{
+	compaction.serialize (json_a);
+}
+
+std::unique_ptr<nano::container_info_component> nano::mdb_store::read_txn_pool_info (std::string const & name_a)
+{
+	return collect_container_info (read_txn_pool, name_a);
+}
+
+void nano::mdb_store::defer_sync_set (std::function<bool()> const & defer_sync_a)
+{
+	env.defer_sync = defer_sync_a;
+}
+
+void nano::mdb_store::sync ()
+{
+	env.txn_enter ();
+	auto status (mdb_env_sync (env, 1));
+	release_assert (status == MDB_SUCCESS);
+	env.txn_leave ();
+}
+
+void nano::mdb_store::durability_status (boost::property_tree::ptree & json_a)
+{
+	MDB_envinfo info;
+	env.txn_enter ();
+	auto status (mdb_env_info (env, &info));
+	release_assert (status == MDB_SUCCESS);
+	env.txn_leave ();
+	json_a.put ("sync", nano::lmdb_config::sync_strategy_string (sync_strategy));
+	json_a.put ("last_txn_id", info.me_last_txnid);
+	if (sync_strategy == nano::lmdb_config::sync_strategy::group)
+	{
+		group_sync.serialize (json_a);
+	}
+	else if (sync_strategy == nano::lmdb_config::sync_strategy::always && !env.defer_sync)
+	{
+		// Every commit is on disk when it returns
+		json_a.put ("durable_txn_id", info.me_last_txnid);
+	}
+}
+
 nano::write_transaction nano::mdb_store::tx_begin_write (std::vector<nano::tables> const &, std::vector<nano::tables> const &)
 {
-	return env.tx_begin_write (create_txn_callbacks ());
+	auto result (env.tx_begin_write (create_txn_callbacks ()));
+	// LMDB allows a single writer, so blocks committed while waiting for the lock are served from the cache
+	result.block_cache_attach_exclusive (block_cache);
+	return result;
 }
 
 nano::read_transaction nano::mdb_store::tx_begin_read ()
 {
-	return env.tx_begin_read (create_txn_callbacks ());
+	auto generation (block_cache.generation ());
+	auto result (env.tx_begin_read (create_txn_callbacks (), pool_reads ? &read_txn_pool : nullptr));
+	result.block_cache_attach (block_cache, generation);
+	return result;
 }
 
 std::string nano::mdb_store::vendor_get () const
@@ -186,6 +280,7 @@ void nano::mdb_store::open_databases (bool & error_a, nano::transaction const &
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "meta", flags, &meta) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "peers", flags, &peers) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "confirmation_height", flags, &confirmation_height) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "block_summaries", flags, &block_summaries) != 0;
 	if (!full_sideband (transaction_a))
 	{
 		// The blocks_info database is no longer used, but need opening so that it can be deleted during an upgrade
@@ -261,6 +356,8 @@ bool nano::mdb_store::do_upgrades (nano::write_transaction & transaction_a, bool
 			upgrade_v17_to_v18 (transaction_a);
 			needs_vacuuming = true;
 		case 18:
+			upgrade_v18_to_v19 (transaction_a);
+		case 19:
 			break;
 		default:
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
@@ -848,6 +945,20 @@ void nano::mdb_store::upgrade_v17_to_v18 (nano::write_transaction const & transa
 	logger.always_log ("Finished upgrading the sideband");
 }
 
+void nano::mdb_store::upgrade_v18_to_v19 (nano::write_transaction const & transaction_a)
+{
+	logger.always_log ("Preparing v18 to v19 database upgrade...");
+
+	// Earlier upgrades rewrite block entries without updating their summaries, start over and let the node summarize every block in the background
+	auto status (mdb_drop (env.tx (transaction_a), block_summaries, 0));
+	release_assert (success (status));
+	status = mdb_del (env.tx (transaction_a), meta, nano::mdb_val (nano::uint256_union (block_summaries_cursor_key)), nullptr);
+	release_assert (success (status) || not_found (status));
+
+	version_put (transaction_a, 19);
+	logger.always_log ("Finished creating the block summary table");
+}
+
 /** Takes a filepath, appends '_backup_<timestamp>' to the end (but before any extension) and saves that file in the same directory */
 void nano::mdb_store::create_backup_file (nano::mdb_env & env_a, boost::filesystem::path const & filepath_a, nano::logger_mt & logger_a)
 {
@@ -933,14 +1044,45 @@ int nano::mdb_store::get (nano::transaction const & transaction_a, tables table_
 	return mdb_get (env.tx (transaction_a), table_to_dbi (table_a), key_a, value_a);
 }
 
+void nano::mdb_store::get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::mdb_val> const & keys_a, std::vector<nano::mdb_val> & values_a) const
+{
+	values_a.assign (keys_a.size (), nano::mdb_val{});
+	auto dbi (table_to_dbi (table_a));
+	std::vector<size_t> order (keys_a.size ());
+	std::iota (order.begin (), order.end (), 0);
+	std::sort (order.begin (), order.end (), [this, &transaction_a, dbi, &keys_a](size_t lhs_a, size_t rhs_a) {
+		return mdb_cmp (env.tx (transaction_a), dbi, keys_a[lhs_a], keys_a[rhs_a]) < 0;
+	});
+	// A positioned cursor only searches from the root again when the key is off its current page, so sorted keys mostly stay on the same leaf
+	MDB_cursor * cursor;
+	auto status (mdb_cursor_open (env.tx (transaction_a), dbi, &cursor));
+	release_assert (success (status));
+	for (auto index : order)
+	{
+		status = mdb_cursor_get (cursor, keys_a[index], values_a[index], MDB_SET);
+		release_assert (success (status) || not_found (status));
+	}
+	mdb_cursor_close (cursor);
+}
+
 int nano::mdb_store::put (nano::write_transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a, const nano::mdb_val & value_a) const
 {
-	return (mdb_put (env.tx (transaction_a), table_to_dbi (table_a), key_a, value_a, 0));
+	auto status (mdb_put (env.tx (transaction_a), table_to_dbi (table_a), key_a, value_a, 0));
+	if (status == MDB_SUCCESS && compaction.recording ())
+	{
+		compaction.record_put (table_to_dbi (table_a), key_a, value_a);
+	}
+	return status;
 }
 
 int nano::mdb_store::del (nano::write_transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a) const
 {
-	return (mdb_del (env.tx (transaction_a), table_to_dbi (table_a), key_a, nullptr));
+	auto status (mdb_del (env.tx (transaction_a), table_to_dbi (table_a), key_a, nullptr));
+	if (status == MDB_SUCCESS && compaction.recording ())
+	{
+		compaction.record_del (table_to_dbi (table_a), key_a);
+	}
+	return status;
 }
 
 int nano::mdb_store::drop (nano::write_transaction const & transaction_a, tables table_a)
@@ -950,7 +1092,12 @@ int nano::mdb_store::drop (nano::write_transaction const & transaction_a, tables
 
 int nano::mdb_store::clear (nano::write_transaction const & transaction_a, MDB_dbi handle_a)
 {
-	return mdb_drop (env.tx (transaction_a), handle_a, 0);
+	auto status (mdb_drop (env.tx (transaction_a), handle_a, 0));
+	if (status == MDB_SUCCESS && compaction.recording ())
+	{
+		compaction.record_drop (handle_a);
+	}
+	return status;
 }
 
 size_t nano::mdb_store::count (nano::transaction const & transaction_a, tables table_a) const
@@ -974,6 +1121,8 @@ MDB_dbi nano::mdb_store::table_to_dbi (tables table_a) const
 			return frontiers;
 		case tables::accounts:
 			return accounts;
+		case tables::block_summaries:
+			return block_summaries;
 		case tables::send_blocks:
 			return send_blocks;
 		case tables::receive_blocks:
@@ -1029,7 +1178,7 @@ bool nano::mdb_store::copy_db (boost::filesystem::path const & destination_file)
 void nano::mdb_store::rebuild_db (nano::write_transaction const & transaction_a)
 {
 	// Tables with uint256_union key
-	std::vector<MDB_dbi> tables = { accounts, send_blocks, receive_blocks, open_blocks, change_blocks, state_blocks, vote, confirmation_height };
+	std::vector<MDB_dbi> tables = { accounts, send_blocks, receive_blocks, open_blocks, change_blocks, state_blocks, vote, confirmation_height, block_summaries };
 	for (auto const & table : tables)
 	{
 		MDB_dbi temp;
@@ -4,7 +4,9 @@
 #include <nano/lib/lmdbconfig.hpp>
 #include <nano/lib/logger_mt.hpp>
 #include <nano/lib/numbers.hpp>
+#include <nano/node/lmdb/lmdb_compaction.hpp>
 #include <nano/node/lmdb/lmdb_env.hpp>
+#include <nano/node/lmdb/lmdb_group_sync.hpp>
 #include <nano/node/lmdb/lmdb_iterator.hpp>
 #include <nano/node/lmdb/lmdb_txn.hpp>
 #include <nano/secure/blockstore_partial.hpp>
@@ -38,6 +40,7 @@ public:
 	using block_store_partial::unchecked_put;
 
 	mdb_store (nano::logger_mt &, boost::filesystem::path const &, nano::txn_tracking_config const & txn_tracking_config_a = nano::txn_tracking_config{}, std::chrono::milliseconds block_processor_batch_max_time_a = std::chrono::milliseconds (5000), nano::lmdb_config const & lmdb_config_a = nano::lmdb_config{}, size_t batch_size = 512, bool backup_before_upgrade = false);
+	~mdb_store ();
 	nano::write_transaction tx_begin_write (std::vector<nano::tables> const & tables_requiring_lock = {}, std::vector<nano::tables> const & tables_no_lock = {}) override;
 	nano::read_transaction tx_begin_read () override;
 
@@ -49,6 +52,16 @@ public:
 
 	void serialize_mdb_tracker (boost::property_tree::ptree &, std::chrono::milliseconds, std::chrono::milliseconds) override;
 
+	bool compaction_start () override;
+	bool compaction_pause (bool) override;
+	void compaction_status (boost::property_tree::ptree &) override;
+
+	std::unique_ptr<nano::container_info_component> read_txn_pool_info (std::string const &) override;
+
+	void defer_sync_set (std::function<bool()> const &) override;
+	void sync () override;
+	void durability_status (boost::property_tree::ptree &) override;
+
 	static void create_backup_file (nano::mdb_env &, boost::filesystem::path const &, nano::logger_mt &);
 
 private:
@@ -124,6 +137,12 @@ public:
 	 */
 	MDB_dbi state_blocks{ 0 };
 
+	/**
+	 * Maps block hash to the fixed width summary of its sideband, filled in the background for blocks written before version 19
+	 * nano::block_hash -> nano::account, uint64_t, nano::amount, nano::block_hash, nano::block_details
+	 */
+	MDB_dbi block_summaries{ 0 };
+
 	/**
 	 * Maps min_version 0 (destination account, pending block) to (source account, amount). (Removed)
 	 * nano::account, nano::block_hash -> nano::account, nano::amount
@@ -193,6 +212,7 @@ public:
 	bool exists (nano::transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a) const;
 
 	int get (nano::transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a, nano::mdb_val & value_a) const;
+	void get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::mdb_val> const & keys_a, std::vector<nano::mdb_val> & values_a) const;
 	int put (nano::write_transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a, const nano::mdb_val & value_a) const;
 	int del (nano::write_transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a) const;
 
@@ -202,13 +222,19 @@ public:
 	template <typename Key, typename Value>
 	nano::store_iterator<Key, Value> make_iterator (nano::transaction const & transaction_a, tables table_a) const
 	{
-		return nano::store_iterator<Key, Value> (std::make_unique<nano::mdb_iterator<Key, Value>> (transaction_a, table_to_dbi (table_a)));
+		auto start (profile.start ());
+		auto result (std::make_unique<nano::mdb_iterator<Key, Value>> (transaction_a, table_to_dbi (table_a)));
+		result->profile_set (profile, table_a, start);
+		return nano::store_iterator<Key, Value> (std::move (result));
 	}
 
 	template <typename Key, typename Value>
 	nano::store_iterator<Key, Value> make_iterator (nano::transaction const & transaction_a, tables table_a, nano::mdb_val const & key) const
 	{
-		return nano::store_iterator<Key, Value> (std::make_unique<nano::mdb_iterator<Key, Value>> (transaction_a, table_to_dbi (table_a), key));
+		auto start (profile.start ());
+		auto result (std::make_unique<nano::mdb_iterator<Key, Value>> (transaction_a, table_to_dbi (table_a), key));
+		result->profile_set (profile, table_a, start);
+		return nano::store_iterator<Key, Value> (std::move (result));
 	}
 
 	bool init_error () const override;
@@ -244,6 +270,7 @@ private:
 	void upgrade_v15_to_v16 (nano::write_transaction const &);
 	void upgrade_v16_to_v17 (nano::write_transaction const &);
 	void upgrade_v17_to_v18 (nano::write_transaction const &);
+	void upgrade_v18_to_v19 (nano::write_transaction const &);
 
 	void open_databases (bool &, nano::transaction const &, unsigned);
 
@@ -259,10 +286,19 @@ private:
 	nano::mdb_txn_tracker mdb_txn_tracker;
 	nano::mdb_txn_callbacks create_txn_callbacks ();
 	bool txn_tracking_enabled;
+	mutable nano::mdb_compaction compaction;
+	nano::mdb_read_txn_pool read_txn_pool;
+	nano::lmdb_config::sync_strategy const sync_strategy;
+	/** Flushes commits in the background with the group sync strategy */
+	nano::mdb_group_sync group_sync;
+	/** Only set once databases are opened, as database handles opened in a read transaction need it committed */
+	bool pool_reads{ false };
 
 	size_t count (nano::transaction const & transaction_a, tables table_a) const override;
 
 	bool vacuum_after_upgrade (boost::filesystem::path const & path_a, nano::lmdb_config const & lmdb_config_a);
+	/** Opens the databases again after the environment was replaced by an online compaction, returns true on error */
+	bool reopen_databases ();
 
 	class upgrade_counters
 	{
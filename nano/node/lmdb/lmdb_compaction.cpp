@@ -0,0 +1,471 @@
+#include <nano/lib/logger_mt.hpp>
+#include <nano/lib/threading.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/node/lmdb/lmdb_compaction.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+
+size_t constexpr nano::mdb_compaction::copy_batch_size;
+size_t constexpr nano::mdb_compaction::max_pending_bytes;
+std::chrono::milliseconds constexpr nano::mdb_compaction::swap_timeout;
+std::chrono::milliseconds constexpr nano::mdb_compaction::swap_retry_interval;
+
+namespace
+{
+std::vector<uint8_t> to_bytes (MDB_val const & val_a)
+{
+	auto data (static_cast<uint8_t const *> (val_a.mv_data));
+	return std::vector<uint8_t> (data, data + val_a.mv_size);
+}
+
+MDB_val from_bytes (std::vector<uint8_t> & bytes_a)
+{
+	return MDB_val{ bytes_a.size (), bytes_a.data () };
+}
+}
+
+nano::mdb_compaction::mdb_compaction (nano::mdb_env & env_a, boost::filesystem::path const & path_a, nano::lmdb_config const & config_a, nano::logger_mt & logger_a, std::function<void()> closing_a, std::function<bool()> reopened_a) :
+env (env_a),
+path (path_a),
+copy_path (path_a.string () + ".compact"),
+config (config_a),
+logger (logger_a),
+closing (closing_a),
+reopened (reopened_a)
+{
+}
+
+nano::mdb_compaction::~mdb_compaction ()
+{
+	stop ();
+}
+
+bool nano::mdb_compaction::start ()
+{
+	auto result (true);
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		if (!stopped && (state_m == nano::mdb_compaction::state::idle || state_m == nano::mdb_compaction::state::swapped || state_m == nano::mdb_compaction::state::failed))
+		{
+			state_m = nano::mdb_compaction::state::copying;
+			result = false;
+		}
+	}
+	if (!result)
+	{
+		// A swapped or failed run has already finished, its thread only needs joining
+		if (thread.joinable ())
+		{
+			thread.join ();
+		}
+		// The environment of a failed run must be closed before its file is opened again
+		copy_env.reset ();
+		handles.clear ();
+		boost::system::error_code ec;
+		boost::filesystem::remove (copy_path, ec);
+		boost::filesystem::remove (copy_path.string () + "-lock", ec);
+		// The copy is synced once before it replaces the database file
+		auto options (nano::mdb_env::options::make ().set_config (config).set_use_no_mem_init (true).override_config_sync (nano::lmdb_config::sync_strategy::nosync_unsafe));
+		copy_env = std::make_unique<nano::mdb_env> (result, copy_path, options);
+		if (!result)
+		{
+			MDB_txn * snapshot;
+			{
+				// Holding the write lock, so no commit can land between the snapshot and the first recorded write
+				auto transaction (env.tx_begin_write ());
+				auto status (mdb_txn_begin (env, nullptr, MDB_RDONLY, &snapshot));
+				release_assert (status == MDB_SUCCESS);
+				recording_m = true;
+			}
+			entries_copied = 0;
+			writes_applied = 0;
+			swap_attempts = 0;
+			thread = std::thread ([this, snapshot]() {
+				nano::thread_role::set (nano::thread_role::name::db_compaction);
+				run (snapshot);
+			});
+		}
+		else
+		{
+			nano::lock_guard<std::mutex> lock (mutex);
+			copy_env.reset ();
+			state_m = nano::mdb_compaction::state::failed;
+		}
+	}
+	return result;
+}
+
+bool nano::mdb_compaction::pause (bool paused_a)
+{
+	auto result (true);
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		if (state_m == nano::mdb_compaction::state::copying || state_m == nano::mdb_compaction::state::paused)
+		{
+			state_m = paused_a ? nano::mdb_compaction::state::paused : nano::mdb_compaction::state::copying;
+			result = false;
+		}
+	}
+	condition.notify_all ();
+	return result;
+}
+
+void nano::mdb_compaction::record_put (MDB_dbi dbi_a, MDB_val const & key_a, MDB_val const & value_a)
+{
+	record ({ nano::mdb_compaction::operation::put, dbi_a, to_bytes (key_a), to_bytes (value_a) });
+}
+
+void nano::mdb_compaction::record_del (MDB_dbi dbi_a, MDB_val const & key_a)
+{
+	record ({ nano::mdb_compaction::operation::del, dbi_a, to_bytes (key_a), {} });
+}
+
+void nano::mdb_compaction::record_drop (MDB_dbi dbi_a)
+{
+	record ({ nano::mdb_compaction::operation::drop, dbi_a, {}, {} });
+}
+
+void nano::mdb_compaction::record (nano::mdb_compaction::recorded_write && write_a)
+{
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		if (recording_m)
+		{
+			pending_bytes += write_a.key.size () + write_a.value.size ();
+			pending.push_back (std::move (write_a));
+			if (pending_bytes > max_pending_bytes)
+			{
+				fail ("writes made while copying exceeded the limit of pending writes");
+			}
+		}
+	}
+	condition.notify_all ();
+}
+
+bool nano::mdb_compaction::swap ()
+{
+	stop ();
+	auto result (state_m != nano::mdb_compaction::state::swapped);
+	if (state_m == nano::mdb_compaction::state::ready)
+	{
+		result = replace ();
+	}
+	else if (copy_env != nullptr)
+	{
+		// The copy is abandoned, it can be in an inconsistent state
+		copy_env.reset ();
+		boost::system::error_code ec;
+		boost::filesystem::remove (copy_path, ec);
+		boost::filesystem::remove (copy_path.string () + "-lock", ec);
+	}
+	pending.clear ();
+	pending_bytes = 0;
+	return result;
+}
+
+bool nano::mdb_compaction::replace ()
+{
+	std::deque<nano::mdb_compaction::recorded_write> writes;
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		// No transactions are open, nothing is written until the swap is over
+		recording_m = false;
+		writes.swap (pending);
+		pending_bytes = 0;
+	}
+	auto result (apply (writes));
+	if (!result)
+	{
+		result = mdb_env_sync (*copy_env, 1) != MDB_SUCCESS;
+	}
+	copy_env.reset ();
+	if (!result)
+	{
+		if (closing)
+		{
+			closing ();
+		}
+		// Need to close the database to release the file handle
+		mdb_env_sync (env.environment, 1);
+		mdb_env_close (env.environment);
+		env.environment = nullptr;
+		boost::system::error_code ec;
+		boost::filesystem::rename (copy_path, path, ec);
+		result = static_cast<bool> (ec);
+	}
+	boost::system::error_code ec;
+	if (result)
+	{
+		// The copy is abandoned, it can be in an inconsistent state
+		boost::filesystem::remove (copy_path, ec);
+	}
+	boost::filesystem::remove (copy_path.string () + "-lock", ec);
+	return result;
+}
+
+bool nano::mdb_compaction::swap_live ()
+{
+	auto result (replace ());
+	if (env.environment == nullptr)
+	{
+		// Reopened on the compacted file, or on the original one if renaming failed
+		bool error (false);
+		env.init (error, path, nano::mdb_env::options::make ().set_config (config).set_use_no_mem_init (true));
+		release_assert (!error);
+		error = reopened && reopened ();
+		release_assert (!error);
+	}
+	return result;
+}
+
+nano::mdb_compaction::state nano::mdb_compaction::status () const
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	return state_m;
+}
+
+void nano::mdb_compaction::serialize (boost::property_tree::ptree & json_a) const
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	json_a.put ("state", state_name (state_m));
+	json_a.put ("entries_total", entries_total);
+	json_a.put ("entries_copied", entries_copied.load ());
+	json_a.put ("progress", entries_total > 0 ? static_cast<double> (entries_copied.load ()) / entries_total : 0.0);
+	json_a.put ("writes_pending", pending.size ());
+	json_a.put ("writes_pending_bytes", pending_bytes);
+	json_a.put ("writes_applied", writes_applied.load ());
+	json_a.put ("swap_attempts", swap_attempts);
+}
+
+std::string nano::mdb_compaction::state_name (nano::mdb_compaction::state state_a)
+{
+	std::string result;
+	switch (state_a)
+	{
+		case nano::mdb_compaction::state::idle:
+			result = "idle";
+			break;
+		case nano::mdb_compaction::state::copying:
+			result = "copying";
+			break;
+		case nano::mdb_compaction::state::paused:
+			result = "paused";
+			break;
+		case nano::mdb_compaction::state::ready:
+			result = "ready";
+			break;
+		case nano::mdb_compaction::state::swapped:
+			result = "swapped";
+			break;
+		case nano::mdb_compaction::state::failed:
+			result = "failed";
+			break;
+	}
+	return result;
+}
+
+void nano::mdb_compaction::run (MDB_txn * snapshot_a)
+{
+	auto error (copy (snapshot_a));
+	mdb_txn_abort (snapshot_a);
+	nano::unique_lock<std::mutex> lock (mutex);
+	if (!error && state_m != nano::mdb_compaction::state::failed)
+	{
+		// From here the copy replaces the database file at the first quiescent point, or when the store is closed
+		state_m = nano::mdb_compaction::state::ready;
+		auto next_swap (std::chrono::steady_clock::now ());
+		while (!stopped && state_m == nano::mdb_compaction::state::ready)
+		{
+			if (!pending.empty ())
+			{
+				std::deque<nano::mdb_compaction::recorded_write> writes;
+				writes.swap (pending);
+				pending_bytes = 0;
+				lock.unlock ();
+				error = apply (writes);
+				lock.lock ();
+				if (error)
+				{
+					fail ("writes could not be applied to the copy");
+				}
+			}
+			else if (std::chrono::steady_clock::now () >= next_swap)
+			{
+				// Writers record with the mutex held, so it can't be held while waiting for their transactions to end
+				lock.unlock ();
+				auto swap_error (false);
+				auto busy (env.quiesce (swap_timeout, [this, &swap_error]() { swap_error = swap_live (); }));
+				lock.lock ();
+				++swap_attempts;
+				if (!busy)
+				{
+					state_m = swap_error ? nano::mdb_compaction::state::failed : nano::mdb_compaction::state::swapped;
+					logger.always_log (swap_error ? "Online compaction could not replace the database file" : "Replaced the database file with its compacted copy");
+				}
+				// Backs off while long lived transactions keep the environment busy, as every attempt holds back new transactions
+				next_swap = std::chrono::steady_clock::now () + swap_retry_interval * (1 << std::min<uint64_t> (swap_attempts - 1, 6));
+			}
+			else
+			{
+				condition.wait_until (lock, next_swap);
+			}
+		}
+	}
+	else if (!stopped)
+	{
+		fail ("copying failed");
+	}
+}
+
+bool nano::mdb_compaction::copy (MDB_txn * snapshot_a)
+{
+	// Named databases are the keys of the main database
+	MDB_dbi main;
+	auto error (mdb_dbi_open (snapshot_a, nullptr, 0, &main) != MDB_SUCCESS);
+	std::vector<std::pair<MDB_dbi, MDB_dbi>> tables;
+	if (!error)
+	{
+		MDB_cursor * cursor;
+		error = mdb_cursor_open (snapshot_a, main, &cursor) != MDB_SUCCESS;
+		if (!error)
+		{
+			auto transaction (copy_env->tx_begin_write ());
+			MDB_val name;
+			MDB_val junk;
+			uint64_t total (0);
+			for (auto status (mdb_cursor_get (cursor, &name, &junk, MDB_FIRST)); !error && status == MDB_SUCCESS; status = mdb_cursor_get (cursor, &name, &junk, MDB_NEXT))
+			{
+				std::string name_l (static_cast<char const *> (name.mv_data), name.mv_size);
+				MDB_dbi dbi;
+				MDB_dbi copy_dbi;
+				unsigned flags;
+				MDB_stat stat;
+				error = mdb_dbi_open (snapshot_a, name_l.c_str (), 0, &dbi) != MDB_SUCCESS || mdb_dbi_flags (snapshot_a, dbi, &flags) != MDB_SUCCESS || mdb_stat (snapshot_a, dbi, &stat) != MDB_SUCCESS || mdb_dbi_open (copy_env->tx (transaction), name_l.c_str (), flags | MDB_CREATE, &copy_dbi) != MDB_SUCCESS;
+				if (!error)
+				{
+					tables.emplace_back (dbi, copy_dbi);
+					total += stat.ms_entries;
+				}
+			}
+			mdb_cursor_close (cursor);
+			nano::lock_guard<std::mutex> lock (mutex);
+			entries_total = total;
+			handles.insert (tables.begin (), tables.end ());
+		}
+	}
+	for (auto i (tables.begin ()), n (tables.end ()); !error && i != n; ++i)
+	{
+		error = copy_table (snapshot_a, i->first, i->second);
+	}
+	if (!error)
+	{
+		auto status (mdb_env_sync (*copy_env, 1));
+		error = status != MDB_SUCCESS;
+	}
+	return error;
+}
+
+bool nano::mdb_compaction::copy_table (MDB_txn * snapshot_a, MDB_dbi dbi_a, MDB_dbi copy_dbi_a)
+{
+	unsigned flags;
+	MDB_cursor * cursor;
+	auto error (mdb_dbi_flags (snapshot_a, dbi_a, &flags) != MDB_SUCCESS || mdb_cursor_open (snapshot_a, dbi_a, &cursor) != MDB_SUCCESS);
+	if (!error)
+	{
+		// Entries are read in key order so they can be appended, which leaves every page full
+		auto put_flags ((flags & MDB_DUPSORT) ? 0 : MDB_APPEND);
+		MDB_val key;
+		MDB_val value;
+		auto status (mdb_cursor_get (cursor, &key, &value, MDB_FIRST));
+		while (!error && status == MDB_SUCCESS)
+		{
+			{
+				auto transaction (copy_env->tx_begin_write ());
+				size_t count (0);
+				for (; !error && status == MDB_SUCCESS && count < copy_batch_size; ++count)
+				{
+					error = mdb_put (copy_env->tx (transaction), copy_dbi_a, &key, &value, put_flags) != MDB_SUCCESS;
+					status = mdb_cursor_get (cursor, &key, &value, MDB_NEXT);
+				}
+				entries_copied += count;
+			}
+			error |= status != MDB_SUCCESS && status != MDB_NOTFOUND;
+			error |= wait_paused ();
+		}
+		mdb_cursor_close (cursor);
+	}
+	return error;
+}
+
+bool nano::mdb_compaction::apply (std::deque<nano::mdb_compaction::recorded_write> & writes_a)
+{
+	auto error (false);
+	if (!writes_a.empty ())
+	{
+		auto transaction (copy_env->tx_begin_write ());
+		for (auto i (writes_a.begin ()), n (writes_a.end ()); !error && i != n; ++i)
+		{
+			auto existing (handles.find (i->dbi));
+			error = existing == handles.end ();
+			if (!error)
+			{
+				auto key (from_bytes (i->key));
+				auto value (from_bytes (i->value));
+				int status (MDB_SUCCESS);
+				switch (i->type)
+				{
+					case nano::mdb_compaction::operation::put:
+						status = mdb_put (copy_env->tx (transaction), existing->second, &key, &value, 0);
+						break;
+					case nano::mdb_compaction::operation::del:
+						status = mdb_del (copy_env->tx (transaction), existing->second, &key, nullptr);
+						break;
+					case nano::mdb_compaction::operation::drop:
+						status = mdb_drop (copy_env->tx (transaction), existing->second, 0);
+						break;
+				}
+				error = status != MDB_SUCCESS && status != MDB_NOTFOUND;
+			}
+		}
+		writes_applied += writes_a.size ();
+		writes_a.clear ();
+	}
+	return error;
+}
+
+void nano::mdb_compaction::fail (std::string const & reason_a)
+{
+	// Called with the mutex held
+	logger.always_log (boost::str (boost::format ("Online compaction abandoned, %1%") % reason_a));
+	state_m = nano::mdb_compaction::state::failed;
+	recording_m = false;
+	pending.clear ();
+	pending_bytes = 0;
+	condition.notify_all ();
+}
+
+bool nano::mdb_compaction::wait_paused ()
+{
+	nano::unique_lock<std::mutex> lock (mutex);
+	condition.wait (lock, [this]() { return stopped || state_m != nano::mdb_compaction::state::paused; });
+	return stopped || state_m == nano::mdb_compaction::state::failed;
+}
+
+void nano::mdb_compaction::stop ()
+{
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		stopped = true;
+		// Writes keep being recorded while a finished copy waits to be swapped in
+		recording_m = recording_m && state_m == nano::mdb_compaction::state::ready;
+	}
+	condition.notify_all ();
+	if (thread.joinable ())
+	{
+		thread.join ();
+	}
+}
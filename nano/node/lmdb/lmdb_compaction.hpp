@@ -0,0 +1,127 @@
+#pragma once
+
+#include <nano/lib/lmdbconfig.hpp>
+#include <nano/node/lmdb/lmdb_env.hpp>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <lmdb/libraries/liblmdb/lmdb.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace nano
+{
+class logger_mt;
+/**
+ * Compacts a live LMDB environment into a new file next to it. Every table is copied from a single read transaction, begun while holding
+ * the write lock so it sees exactly the commits made before writes started being recorded. Writes committed afterwards are buffered and
+ * applied to the copy once it has caught up. The copy then replaces the database file as soon as the environment can be quiesced with
+ * no transactions open, which ends the recording, or when the store is closed if that never happens.
+ */
+class mdb_compaction final
+{
+public:
+	enum class state
+	{
+		idle,
+		copying,
+		paused,
+		ready,
+		swapped,
+		failed
+	};
+	/** closing_a is called before the environment is closed, reopened_a after it is opened on the compacted file and returns true on error */
+	mdb_compaction (nano::mdb_env &, boost::filesystem::path const &, nano::lmdb_config const &, nano::logger_mt &, std::function<void()> closing_a, std::function<bool()> reopened_a);
+	~mdb_compaction ();
+	/** Begins copying on a background thread, returns true if a compaction is already running or the copy could not be created */
+	bool start ();
+	/** Returns true if there is no copy in progress to pause or resume */
+	bool pause (bool paused_a);
+	/** Called with the write lock held so writes are recorded in commit order */
+	void record_put (MDB_dbi, MDB_val const & key_a, MDB_val const & value_a);
+	void record_del (MDB_dbi, MDB_val const & key_a);
+	void record_drop (MDB_dbi);
+	/** Whether writes need recording, checked before every write */
+	bool recording () const
+	{
+		return recording_m.load (std::memory_order_relaxed);
+	}
+	/**
+	 * Called when the store is closed. Replaces the database file with the copy if it has finished but could not be swapped in while running,
+	 * otherwise an unfinished copy is abandoned. The environment is closed when swapping, no transactions may be open. Returns true if the
+	 * database file was not replaced.
+	 */
+	bool swap ();
+	nano::mdb_compaction::state status () const;
+	void serialize (boost::property_tree::ptree &) const;
+	static std::string state_name (nano::mdb_compaction::state);
+	/** Entries copied in each write transaction of the copy */
+	static size_t constexpr copy_batch_size{ 16 * 1024 };
+	/** The compaction is abandoned if writes waiting to be applied to the copy exceed this */
+	static size_t constexpr max_pending_bytes{ 512 * 1024 * 1024 };
+	/** How long a swap waits for open transactions to end, new transactions are held back meanwhile */
+	static std::chrono::milliseconds constexpr swap_timeout{ 100 };
+	/** Time between the first attempts to swap in a finished copy, doubling after each attempt up to 64 times this */
+	static std::chrono::milliseconds constexpr swap_retry_interval{ 1000 };
+
+private:
+	enum class operation
+	{
+		put,
+		del,
+		drop
+	};
+	class recorded_write final
+	{
+	public:
+		nano::mdb_compaction::operation type;
+		MDB_dbi dbi;
+		std::vector<uint8_t> key;
+		std::vector<uint8_t> value;
+	};
+	void record (nano::mdb_compaction::recorded_write &&);
+	void run (MDB_txn *);
+	bool copy (MDB_txn *);
+	bool copy_table (MDB_txn *, MDB_dbi, MDB_dbi);
+	bool apply (std::deque<nano::mdb_compaction::recorded_write> &);
+	/** Applies the remaining writes and renames the copy over the database file, closing the environment. Returns true on error */
+	bool replace ();
+	/** Replaces the database file and reopens the environment, no transactions may be open */
+	bool swap_live ();
+	void fail (std::string const &);
+	/** Blocks while paused, returns true if stopping */
+	bool wait_paused ();
+	void stop ();
+	nano::mdb_env & env;
+	boost::filesystem::path const path;
+	boost::filesystem::path const copy_path;
+	nano::lmdb_config const config;
+	nano::logger_mt & logger;
+	std::function<void()> const closing;
+	std::function<bool()> const reopened;
+	std::unique_ptr<nano::mdb_env> copy_env;
+	/** Database handles of the live environment mapped to the matching handles of the copy */
+	std::unordered_map<MDB_dbi, MDB_dbi> handles;
+	std::deque<nano::mdb_compaction::recorded_write> pending;
+	size_t pending_bytes{ 0 };
+	nano::mdb_compaction::state state_m{ nano::mdb_compaction::state::idle };
+	bool stopped{ false };
+	std::atomic<bool> recording_m{ false };
+	uint64_t entries_total{ 0 };
+	std::atomic<uint64_t> entries_copied{ 0 };
+	std::atomic<uint64_t> writes_applied{ 0 };
+	uint64_t swap_attempts{ 0 };
+	mutable std::mutex mutex;
+	nano::condition_variable condition;
+	std::thread thread;
+};
+}
@@ -38,7 +38,7 @@ void nano::mdb_env::init (bool & error_a, boost::filesystem::path const & path_a
 			{
 				environment_flags |= MDB_NOMETASYNC;
 			}
-			else if (options_a.config.sync == nano::lmdb_config::sync_strategy::nosync_unsafe)
+			else if (options_a.config.sync == nano::lmdb_config::sync_strategy::nosync_unsafe || options_a.config.sync == nano::lmdb_config::sync_strategy::group)
 			{
 				environment_flags |= MDB_NOSYNC;
 			}
@@ -47,6 +47,8 @@ void nano::mdb_env::init (bool & error_a, boost::filesystem::path const & path_a
 				environment_flags |= MDB_NOSYNC | MDB_WRITEMAP | MDB_MAPASYNC;
 			}
 
+			syncs_on_commit = (environment_flags & MDB_NOSYNC) == 0;
+
 			if (!running_within_valgrind () && options_a.use_no_mem_init)
 			{
 				environment_flags |= MDB_NOMEMINIT;
@@ -93,9 +95,9 @@ nano::mdb_env::operator MDB_env * () const
 	return environment;
 }
 
-nano::read_transaction nano::mdb_env::tx_begin_read (mdb_txn_callbacks mdb_txn_callbacks) const
+nano::read_transaction nano::mdb_env::tx_begin_read (mdb_txn_callbacks mdb_txn_callbacks, nano::mdb_read_txn_pool * pool_a) const
 {
-	return nano::read_transaction{ std::make_unique<nano::read_mdb_txn> (*this, mdb_txn_callbacks) };
+	return nano::read_transaction{ std::make_unique<nano::read_mdb_txn> (*this, mdb_txn_callbacks, pool_a) };
 }
 
 nano::write_transaction nano::mdb_env::tx_begin_write (mdb_txn_callbacks mdb_txn_callbacks) const
@@ -107,3 +109,51 @@ MDB_txn * nano::mdb_env::tx (nano::transaction const & transaction_a) const
 {
 	return static_cast<MDB_txn *> (transaction_a.get_handle ());
 }
+
+void nano::mdb_env::txn_enter () const
+{
+	++open_txns;
+	while (quiescing && quiescing_thread.load () != std::this_thread::get_id ())
+	{
+		txn_leave ();
+		{
+			nano::unique_lock<std::mutex> lock (quiesce_mutex);
+			quiesce_condition.wait (lock, [this]() { return !quiescing; });
+		}
+		++open_txns;
+	}
+}
+
+void nano::mdb_env::txn_leave () const
+{
+	if (--open_txns == 0 && quiescing)
+	{
+		{
+			// Taken so the quiescing thread can't miss the wakeup between checking the count and waiting
+			nano::lock_guard<std::mutex> lock (quiesce_mutex);
+		}
+		quiesce_condition.notify_all ();
+	}
+}
+
+bool nano::mdb_env::quiesce (std::chrono::milliseconds timeout_a, std::function<void()> const & action_a) const
+{
+	auto result (true);
+	{
+		nano::unique_lock<std::mutex> lock (quiesce_mutex);
+		quiescing_thread = std::this_thread::get_id ();
+		quiescing = true;
+		result = !quiesce_condition.wait_for (lock, timeout_a, [this]() { return open_txns == 0; });
+		if (!result)
+		{
+			// Transactions begun by the action take the mutex when the last of them ends
+			lock.unlock ();
+			action_a ();
+			lock.lock ();
+		}
+		quiescing = false;
+		quiescing_thread = std::thread::id ();
+	}
+	quiesce_condition.notify_all ();
+	return result;
+}
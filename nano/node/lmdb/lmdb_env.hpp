@@ -1,9 +1,14 @@
 #pragma once
 
 #include <nano/lib/lmdbconfig.hpp>
+#include <nano/lib/locks.hpp>
 #include <nano/node/lmdb/lmdb_txn.hpp>
 #include <nano/secure/blockstore.hpp>
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 namespace nano
 {
 /**
@@ -58,9 +63,30 @@ public:
 	void init (bool &, boost::filesystem::path const &, nano::mdb_env::options options_a = nano::mdb_env::options::make ());
 	~mdb_env ();
 	operator MDB_env * () const;
-	nano::read_transaction tx_begin_read (mdb_txn_callbacks txn_callbacks = mdb_txn_callbacks{}) const;
+	nano::read_transaction tx_begin_read (mdb_txn_callbacks txn_callbacks = mdb_txn_callbacks{}, nano::mdb_read_txn_pool * pool_a = nullptr) const;
 	nano::write_transaction tx_begin_write (mdb_txn_callbacks txn_callbacks = mdb_txn_callbacks{}) const;
 	MDB_txn * tx (nano::transaction const & transaction_a) const;
+	/** Called when a transaction is created and destroyed, or around using the environment outside of one. Waits while the environment is quiesced */
+	void txn_enter () const;
+	void txn_leave () const;
+	/**
+	 * Holds back new transactions and waits up to timeout_a for the open ones to end, then calls action_a which may replace the environment.
+	 * Transactions begun by action_a itself are not held back. Returns true if transactions were still open, action_a isn't called then.
+	 */
+	bool quiesce (std::chrono::milliseconds timeout_a, std::function<void()> const & action_a) const;
 	MDB_env * environment;
+	/** Whether commits sync to disk, otherwise deferring syncs has no effect */
+	bool syncs_on_commit{ false };
+	/** Checked on commit when set, returning true skips syncing that commit to disk */
+	std::function<bool()> defer_sync;
+	/** Called after every write commit when set. The commit has released the write lock, so other writers may already be running */
+	std::function<void()> on_commit;
+
+private:
+	mutable std::atomic<uint64_t> open_txns{ 0 };
+	mutable std::atomic<bool> quiescing{ false };
+	mutable std::atomic<std::thread::id> quiescing_thread;
+	mutable std::mutex quiesce_mutex;
+	mutable nano::condition_variable quiesce_condition;
 };
 }
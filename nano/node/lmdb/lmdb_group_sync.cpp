@@ -0,0 +1,115 @@
+#include <nano/lib/threading.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/node/lmdb/lmdb_group_sync.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+
+nano::mdb_group_sync::mdb_group_sync (nano::mdb_env & env_a, std::chrono::milliseconds interval_a, uint64_t max_commits_a) :
+env (env_a),
+interval (interval_a),
+max_commits (std::max<uint64_t> (max_commits_a, 1)),
+last_sync (std::chrono::steady_clock::now ())
+{
+}
+
+nano::mdb_group_sync::~mdb_group_sync ()
+{
+	stop ();
+}
+
+void nano::mdb_group_sync::start ()
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	if (!started && !stopped)
+	{
+		started = true;
+		thread = std::thread ([this]() {
+			nano::thread_role::set (nano::thread_role::name::db_group_sync);
+			run ();
+		});
+	}
+}
+
+void nano::mdb_group_sync::stop ()
+{
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		stopped = true;
+	}
+	condition.notify_all ();
+	if (thread.joinable ())
+	{
+		thread.join ();
+	}
+}
+
+void nano::mdb_group_sync::committed ()
+{
+	if (++pending_commits == max_commits)
+	{
+		// Only the commit reaching the threshold wakes the thread, the count is reset when flushing.
+		// Taking the mutex keeps the wakeup from landing between the thread checking the count and waiting.
+		{
+			nano::lock_guard<std::mutex> lock (mutex);
+		}
+		condition.notify_all ();
+	}
+}
+
+uint64_t nano::mdb_group_sync::durable_txn_id () const
+{
+	return durable.load ();
+}
+
+void nano::mdb_group_sync::serialize (boost::property_tree::ptree & json_a) const
+{
+	std::chrono::steady_clock::time_point last_sync_l;
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		last_sync_l = last_sync;
+	}
+	json_a.put ("durable_txn_id", durable.load ());
+	json_a.put ("pending_commits", pending_commits.load ());
+	json_a.put ("syncs", syncs.load ());
+	json_a.put ("last_sync_age", std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - last_sync_l).count ());
+	json_a.put ("interval", interval.count ());
+	json_a.put ("max_commits", max_commits);
+}
+
+void nano::mdb_group_sync::run ()
+{
+	nano::unique_lock<std::mutex> lock (mutex);
+	while (!stopped)
+	{
+		condition.wait_until (lock, last_sync + interval, [this]() { return stopped || pending_commits >= max_commits; });
+		lock.unlock ();
+		sync ();
+		lock.lock ();
+	}
+	lock.unlock ();
+	// Flush whatever was committed while stopping
+	sync ();
+}
+
+void nano::mdb_group_sync::sync ()
+{
+	// Commits made after reading the id are not covered by this flush, they're counted towards the next one
+	auto commits (pending_commits.exchange (0));
+	// The environment can be replaced by an online compaction otherwise
+	env.txn_enter ();
+	MDB_envinfo info;
+	auto status (mdb_env_info (env, &info));
+	release_assert (status == MDB_SUCCESS);
+	if (commits > 0 || durable.load () != info.me_last_txnid)
+	{
+		status = mdb_env_sync (env, 1);
+		release_assert (status == MDB_SUCCESS);
+		durable = info.me_last_txnid;
+		++syncs;
+	}
+	env.txn_leave ();
+	nano::lock_guard<std::mutex> lock (mutex);
+	last_sync = std::chrono::steady_clock::now ();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <nano/node/lmdb/lmdb_env.hpp>
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace nano
+{
+/**
+ * Flushes commits of an environment opened with MDB_NOSYNC on a background thread, once every interval or as soon as enough commits are
+ * waiting. Commits return without waiting for the disk, the commits made after the last flush are lost if the operating system crashes.
+ */
+class mdb_group_sync final
+{
+public:
+	mdb_group_sync (nano::mdb_env &, std::chrono::milliseconds interval_a, uint64_t max_commits_a);
+	~mdb_group_sync ();
+	void start ();
+	/** Flushes the remaining commits and joins the thread */
+	void stop ();
+	/** Called after every write commit */
+	void committed ();
+	/** Id of the last transaction known to be on disk */
+	uint64_t durable_txn_id () const;
+	void serialize (boost::property_tree::ptree &) const;
+
+private:
+	void run ();
+	void sync ();
+	nano::mdb_env & env;
+	std::chrono::milliseconds const interval;
+	uint64_t const max_commits;
+	std::atomic<uint64_t> pending_commits{ 0 };
+	std::atomic<uint64_t> durable{ 0 };
+	std::atomic<uint64_t> syncs{ 0 };
+	std::chrono::steady_clock::time_point last_sync;
+	bool stopped{ false };
+	bool started{ false };
+	mutable std::mutex mutex;
+	nano::condition_variable condition;
+	std::thread thread;
+};
+}
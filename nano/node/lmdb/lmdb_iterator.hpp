@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nano/secure/blockstore.hpp>
+#include <nano/secure/store_profile.hpp>
 
 #include <lmdb/libraries/liblmdb/lmdb.h>
 
@@ -60,6 +61,8 @@ public:
 		cursor = other_a.cursor;
 		other_a.cursor = nullptr;
 		current = other_a.current;
+		profile = other_a.profile;
+		table = other_a.table;
 	}
 
 	mdb_iterator (nano::mdb_iterator<T, U> const &) = delete;
@@ -72,9 +75,21 @@ public:
 		}
 	}
 
+	/** Records the seek which positioned the iterator when profiling, and from then on every step */
+	void profile_set (nano::store_profile & profile_a, nano::tables table_a, std::chrono::steady_clock::time_point start_a)
+	{
+		if (start_a != std::chrono::steady_clock::time_point{})
+		{
+			profile = &profile_a;
+			table = table_a;
+			profile_a.record (table_a, nano::store_profile::operation::iterate, start_a, current.first.size () + current.second.size ());
+		}
+	}
+
 	nano::store_iterator_impl<T, U> & operator++ () override
 	{
 		debug_assert (cursor != nullptr);
+		auto start (profile != nullptr ? profile->start () : std::chrono::steady_clock::time_point{});
 		auto status (mdb_cursor_get (cursor, &current.first.value, &current.second.value, MDB_NEXT));
 		release_assert (status == 0 || status == MDB_NOTFOUND);
 		if (status == MDB_NOTFOUND)
@@ -85,6 +100,10 @@ public:
 		{
 			clear ();
 		}
+		if (profile != nullptr)
+		{
+			profile->record (table, nano::store_profile::operation::next, start, current.first.size () + current.second.size ());
+		}
 		return *this;
 	}
 
@@ -142,6 +161,8 @@ public:
 		cursor = other_a.cursor;
 		other_a.cursor = nullptr;
 		current = other_a.current;
+		profile = other_a.profile;
+		table = other_a.table;
 		other_a.clear ();
 		return *this;
 	}
@@ -151,6 +172,9 @@ public:
 	std::pair<nano::db_val<MDB_val>, nano::db_val<MDB_val>> current;
 
 private:
+	nano::store_profile * profile{ nullptr };
+	nano::tables table{ nano::tables::accounts };
+
 	MDB_txn * tx (nano::transaction const & transaction_a) const
 	{
 		return static_cast<MDB_txn *> (transaction_a.get_handle ());
@@ -49,25 +49,140 @@ private:
 };
 }
 
-nano::read_mdb_txn::read_mdb_txn (nano::mdb_env const & environment_a, nano::mdb_txn_callbacks txn_callbacks_a) :
-txn_callbacks (txn_callbacks_a)
+size_t constexpr nano::mdb_read_txn_pool::shard_count;
+
+nano::mdb_read_txn_pool::mdb_read_txn_pool (size_t max_idle_a) :
+max_idle_per_shard ((max_idle_a + shard_count - 1) / shard_count)
 {
-	auto status (mdb_txn_begin (environment_a, nullptr, MDB_RDONLY, &handle));
-	release_assert (status == 0);
+}
+
+nano::mdb_read_txn_pool::~mdb_read_txn_pool ()
+{
+	clear ();
+}
+
+MDB_txn * nano::mdb_read_txn_pool::take ()
+{
+	MDB_txn * result (nullptr);
+	{
+		auto & shard (shard_for_thread ());
+		nano::lock_guard<std::mutex> guard (shard.mutex);
+		if (!shard.idle.empty ())
+		{
+			result = shard.idle.back ();
+			shard.idle.pop_back ();
+		}
+	}
+	if (result != nullptr)
+	{
+		++reused;
+	}
+	else
+	{
+		++created;
+	}
+	return result;
+}
+
+void nano::mdb_read_txn_pool::put (MDB_txn * txn_a)
+{
+	auto & shard (shard_for_thread ());
+	nano::unique_lock<std::mutex> lock (shard.mutex);
+	if (shard.idle.size () < max_idle_per_shard)
+	{
+		shard.idle.push_back (txn_a);
+	}
+	else
+	{
+		lock.unlock ();
+		mdb_txn_abort (txn_a);
+	}
+}
+
+void nano::mdb_read_txn_pool::clear ()
+{
+	for (auto & shard : shards)
+	{
+		nano::lock_guard<std::mutex> guard (shard.mutex);
+		for (auto txn : shard.idle)
+		{
+			mdb_txn_abort (txn);
+		}
+		shard.idle.clear ();
+	}
+}
+
+size_t nano::mdb_read_txn_pool::size ()
+{
+	size_t result (0);
+	for (auto & shard : shards)
+	{
+		nano::lock_guard<std::mutex> guard (shard.mutex);
+		result += shard.idle.size ();
+	}
+	return result;
+}
+
+nano::mdb_read_txn_pool::shard & nano::mdb_read_txn_pool::shard_for_thread ()
+{
+	return shards[std::hash<std::thread::id> () (std::this_thread::get_id ()) % shard_count];
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (mdb_read_txn_pool & pool, std::string const & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "idle", pool.size (), sizeof (MDB_txn *) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "created", pool.created, 0 }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "reused", pool.reused, 0 }));
+	return composite;
+}
+
+nano::read_mdb_txn::read_mdb_txn (nano::mdb_env const & environment_a, nano::mdb_txn_callbacks txn_callbacks_a, nano::mdb_read_txn_pool * pool_a) :
+env (environment_a),
+txn_callbacks (txn_callbacks_a),
+pool (pool_a)
+{
+	// Counted until destroyed, even while reset, as renewing needs the same environment
+	env.txn_enter ();
+	handle = pool != nullptr ? pool->take () : nullptr;
+	if (handle != nullptr)
+	{
+		auto status (mdb_txn_renew (handle));
+		release_assert (status == 0);
+	}
+	else
+	{
+		auto status (mdb_txn_begin (environment_a, nullptr, MDB_RDONLY, &handle));
+		release_assert (status == 0);
+	}
 	txn_callbacks.txn_start (this);
 }
 
 nano::read_mdb_txn::~read_mdb_txn ()
 {
-	// This uses commit rather than abort, as it is needed when opening databases with a read only transaction
-	auto status (mdb_txn_commit (handle));
-	release_assert (status == MDB_SUCCESS);
+	if (pool != nullptr)
+	{
+		// A reset transaction keeps its reader slot, renewing it only takes a new snapshot
+		if (active)
+		{
+			mdb_txn_reset (handle);
+		}
+		pool->put (handle);
+	}
+	else
+	{
+		// This uses commit rather than abort, as it is needed when opening databases with a read only transaction
+		auto status (mdb_txn_commit (handle));
+		release_assert (status == MDB_SUCCESS);
+	}
 	txn_callbacks.txn_end (this);
+	env.txn_leave ();
 }
 
 void nano::read_mdb_txn::reset ()
 {
 	mdb_txn_reset (handle);
+	active = false;
 	txn_callbacks.txn_end (this);
 }
 
@@ -75,6 +190,7 @@ void nano::read_mdb_txn::renew ()
 {
 	auto status (mdb_txn_renew (handle));
 	release_assert (status == 0);
+	active = true;
 	txn_callbacks.txn_start (this);
 }
 
@@ -87,18 +203,30 @@ nano::write_mdb_txn::write_mdb_txn (nano::mdb_env const & environment_a, nano::m
 env (environment_a),
 txn_callbacks (txn_callbacks_a)
 {
+	env.txn_enter ();
 	renew ();
 }
 
 nano::write_mdb_txn::~write_mdb_txn ()
 {
 	commit ();
+	env.txn_leave ();
 }
 
 void nano::write_mdb_txn::commit () const
 {
+	if (env.syncs_on_commit && env.defer_sync)
+	{
+		// Still holding the write lock, so no other commit can observe the flag change
+		auto status (mdb_env_set_flags (env, MDB_NOSYNC, env.defer_sync () ? 1 : 0));
+		release_assert (status == MDB_SUCCESS);
+	}
 	auto status (mdb_txn_commit (handle));
 	release_assert (status == MDB_SUCCESS);
+	if (env.on_commit)
+	{
+		env.on_commit ();
+	}
 	txn_callbacks.txn_end (this);
 }
 
@@ -7,7 +7,10 @@
 #include <boost/property_tree/ptree_fwd.hpp>
 #include <boost/stacktrace/stacktrace_fwd.hpp>
 
+#include <array>
+#include <atomic>
 #include <mutex>
+#include <vector>
 
 #include <lmdb/libraries/liblmdb/lmdb.h>
 
@@ -24,16 +27,58 @@ public:
 	std::function<void(const nano::transaction_impl *)> txn_end{ [](const nano::transaction_impl *) {} };
 };
 
+/**
+ * Keeps reset read transactions so later readers renew them instead of beginning new ones, which avoids taking the reader table lock
+ * to find a free slot. Idle transactions are split into shards by thread so concurrent readers rarely contend.
+ */
+class mdb_read_txn_pool final
+{
+public:
+	explicit mdb_read_txn_pool (size_t max_idle_a);
+	~mdb_read_txn_pool ();
+	/** Returns an idle transaction needing renewal, or nullptr if a new one has to be started */
+	MDB_txn * take ();
+	/** Takes back a reset transaction, it is aborted if the pool is full */
+	void put (MDB_txn *);
+	/** Aborts the idle transactions, required before closing the environment */
+	void clear ();
+	size_t size ();
+	std::atomic<uint64_t> created{ 0 };
+	std::atomic<uint64_t> reused{ 0 };
+	static size_t constexpr shard_count{ 8 };
+
+private:
+	class shard final
+	{
+	public:
+		std::mutex mutex;
+		std::vector<MDB_txn *> idle;
+	};
+	nano::mdb_read_txn_pool::shard & shard_for_thread ();
+	size_t const max_idle_per_shard;
+	std::array<nano::mdb_read_txn_pool::shard, shard_count> shards;
+
+	friend std::unique_ptr<nano::container_info_component> collect_container_info (mdb_read_txn_pool &, std::string const &);
+};
+
+std::unique_ptr<nano::container_info_component> collect_container_info (mdb_read_txn_pool & pool, std::string const & name);
+
 class read_mdb_txn final : public read_transaction_impl
 {
 public:
-	read_mdb_txn (nano::mdb_env const &, mdb_txn_callbacks mdb_txn_callbacks);
+	read_mdb_txn (nano::mdb_env const &, mdb_txn_callbacks mdb_txn_callbacks, nano::mdb_read_txn_pool * pool_a = nullptr);
 	~read_mdb_txn ();
 	void reset () override;
 	void renew () override;
 	void * get_handle () const override;
 	MDB_txn * handle;
+	nano::mdb_env const & env;
 	mdb_txn_callbacks txn_callbacks;
+
+private:
+	/** Returned to on destruction when set, otherwise the transaction ends */
+	nano::mdb_read_txn_pool * pool;
+	bool active{ true };
 };
 
 class write_mdb_txn final : public write_transaction_impl
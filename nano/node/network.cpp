@@ -15,9 +15,10 @@ syn_cookies (node_a.network_params.node.max_peers_per_ip),
 buffer_container (node_a.stats, nano::network::buffer_size, 4096), // 2Mb receive buffer
 resolver (node_a.io_ctx),
 limiter (node_a.config.bandwidth_limit_burst_ratio, node_a.config.bandwidth_limit),
-tcp_message_manager (node_a.config.tcp_incoming_connections_max),
+tcp_message_manager (node_a.stats, node_a.config.tcp_incoming_connections_max),
 node (node_a),
 publish_filter (256 * 1024),
+vote_filter (256 * 1024),
 udp_channels (node_a, port_a),
 tcp_channels (node_a),
 port (port_a),
@@ -483,7 +484,11 @@ public:
 					}
 				}
 			}
-			node.vote_processor.vote (message_a.vote, channel);
+			if (node.vote_processor.vote (message_a.vote, channel))
+			{
+				// Let a replay of the dropped vote through once there is room again
+				node.network.vote_filter.clear (message_a.digest);
+			}
 		}
 	}
 	void bulk_pull (nano::bulk_pull const &) override
@@ -720,6 +725,16 @@ void nano::network::cleanup (std::chrono::steady_clock::time_point const & cutof
 void nano::network::ongoing_cleanup ()
 {
 	cleanup (std::chrono::steady_clock::now () - node.network_params.node.cutoff);
+	// Representatives get a larger share of realtime message processing, a peer may host several of them
+	std::unordered_map<nano::tcp_endpoint, nano::uint128_t> weights;
+	for (auto const & representative : node.rep_crawler.representatives ())
+	{
+		if (representative.channel->get_type () == nano::transport::transport_type::tcp)
+		{
+			weights[representative.channel->get_tcp_endpoint ()] += representative.weight.number ();
+		}
+	}
+	tcp_message_manager.set_weights (weights);
 	std::weak_ptr<nano::node> node_w (node.shared ());
 	node.alarm.add (std::chrono::steady_clock::now () + node.network_params.node.period, [node_w]() {
 		if (auto node_l = node_w.lock ())
@@ -798,8 +813,7 @@ stats (stats_a),
 free (count),
 full (count),
 slab (size * count),
-entries (count),
-stopped (false)
+entries (count)
 {
 	debug_assert (count > 0);
 	debug_assert (size > 0);
@@ -808,56 +822,111 @@ stopped (false)
 	for (auto i (0); i < count; ++i, ++entry_data)
 	{
 		*entry_data = { slab_data + i * size, 0, nano::endpoint () };
-		free.push_back (entry_data);
+		auto pushed (free.push (entry_data));
+		debug_assert (pushed);
 	}
 }
 
-nano::message_buffer * nano::message_buffer_manager::allocate ()
+template <typename Take>
+void nano::message_buffer_manager::wait (Take const & take_a)
 {
 	nano::unique_lock<std::mutex> lock (mutex);
-	if (!stopped && free.empty () && full.empty ())
+	++waiters;
+	// Pairs with the fence in notify, either the waiter sees the new buffer or the producer sees the waiter
+	std::atomic_thread_fence (std::memory_order_seq_cst);
+	condition.wait (lock, [this, &take_a] { return take_a () || stopped; });
+	--waiters;
+}
+
+void nano::message_buffer_manager::notify ()
+{
+	std::atomic_thread_fence (std::memory_order_seq_cst);
+	if (waiters.load () > 0)
 	{
-		stats.inc (nano::stat::type::udp, nano::stat::detail::blocking, nano::stat::dir::in);
-		condition.wait (lock, [& stopped = stopped, &free = free, &full = full] { return stopped || !free.empty () || !full.empty (); });
+		// A waiter which checked before the buffer was pushed is either still holding the mutex or already waiting
+		{
+			nano::lock_guard<std::mutex> lock (mutex);
+		}
+		condition.notify_all ();
 	}
+}
+
+nano::message_buffer * nano::message_buffer_manager::allocate ()
+{
 	nano::message_buffer * result (nullptr);
-	if (!free.empty ())
+	auto overflow (false);
+	auto take ([this, &result, &overflow]() {
+		auto found (free.pop (result));
+		if (!found)
+		{
+			found = full.pop (result);
+			overflow = found;
+		}
+		return found;
+	});
+	if (!take () && !stopped)
 	{
-		result = free.front ();
-		free.pop_front ();
+		stats.inc (nano::stat::type::udp, nano::stat::detail::blocking, nano::stat::dir::in);
+		wait (take);
 	}
-	if (result == nullptr && !full.empty ())
+	if (overflow)
 	{
-		result = full.front ();
-		full.pop_front ();
 		stats.inc (nano::stat::type::udp, nano::stat::detail::overflow, nano::stat::dir::in);
 	}
 	release_assert (result || stopped);
 	return result;
 }
 
+void nano::message_buffer_manager::allocate (std::vector<nano::message_buffer *> & buffers_a, size_t count_a)
+{
+	auto initial_size (buffers_a.size ());
+	nano::message_buffer * buffer (nullptr);
+	for (; count_a > 0 && free.pop (buffer); --count_a)
+	{
+		buffers_a.push_back (buffer);
+	}
+	if (buffers_a.size () == initial_size && count_a > 0)
+	{
+		buffer = allocate ();
+		if (buffer != nullptr)
+		{
+			buffers_a.push_back (buffer);
+		}
+	}
+}
+
 void nano::message_buffer_manager::enqueue (nano::message_buffer * data_a)
 {
 	debug_assert (data_a != nullptr);
+	// Every buffer is in at most one ring, so neither can fill up
+	auto pushed (full.push (data_a));
+	release_assert (pushed);
+	notify ();
+}
+
+void nano::message_buffer_manager::enqueue (std::vector<nano::message_buffer *> const & buffers_a)
+{
+	if (!buffers_a.empty ())
 	{
-		nano::lock_guard<std::mutex> lock (mutex);
-		full.push_back (data_a);
+		for (auto buffer : buffers_a)
+		{
+			debug_assert (buffer != nullptr);
+			auto pushed (full.push (buffer));
+			release_assert (pushed);
+		}
+		notify ();
 	}
-	condition.notify_all ();
 }
 
 nano::message_buffer * nano::message_buffer_manager::dequeue ()
 {
-	nano::unique_lock<std::mutex> lock (mutex);
-	while (!stopped && full.empty ())
-	{
-		condition.wait (lock);
-	}
 	nano::message_buffer * result (nullptr);
-	if (!full.empty ())
+	auto take ([this, &result]() {
+		return full.pop (result);
+	});
+	if (!take () && !stopped)
 	{
-		result = full.front ();
-		full.pop_front ();
+		wait (take);
 	}
 	return result;
 }
@@ -865,11 +934,23 @@ nano::message_buffer * nano::message_buffer_manager::dequeue ()
 void nano::message_buffer_manager::release (nano::message_buffer * data_a)
 {
 	debug_assert (data_a != nullptr);
+	auto pushed (free.push (data_a));
+	release_assert (pushed);
+	notify ();
+}
+
+void nano::message_buffer_manager::release (std::vector<nano::message_buffer *> const & buffers_a)
+{
+	if (!buffers_a.empty ())
 	{
-		nano::lock_guard<std::mutex> lock (mutex);
-		free.push_back (data_a);
+		for (auto buffer : buffers_a)
+		{
+			debug_assert (buffer != nullptr);
+			auto pushed (free.push (buffer));
+			release_assert (pushed);
+		}
+		notify ();
 	}
-	condition.notify_all ();
 }
 
 void nano::message_buffer_manager::stop ()
@@ -881,7 +962,8 @@ void nano::message_buffer_manager::stop ()
 	condition.notify_all ();
 }
 
-nano::tcp_message_manager::tcp_message_manager (unsigned incoming_connections_max_a) :
+nano::tcp_message_manager::tcp_message_manager (nano::stat & stats_a, unsigned incoming_connections_max_a) :
+stats (stats_a),
 max_entries (incoming_connections_max_a * nano::tcp_message_manager::max_entries_per_connection + 1)
 {
 	debug_assert (max_entries > 0);
@@ -889,13 +971,32 @@ max_entries (incoming_connections_max_a * nano::tcp_message_manager::max_entries
 
 void nano::tcp_message_manager::put_message (nano::tcp_message_item const & item_a)
 {
+	auto dropped (false);
 	{
 		nano::unique_lock<std::mutex> lock (mutex);
-		while (entries.size () > max_entries && !stopped)
+		while (entries_count > max_entries && !stopped)
 		{
 			condition.wait (lock);
 		}
+		auto existing (queues.find (item_a.endpoint));
+		if (existing == queues.end ())
+		{
+			existing = queues.emplace (item_a.endpoint, endpoint_queue{}).first;
+			active.push_back (item_a.endpoint);
+		}
+		auto & entries (existing->second.entries);
+		if (entries.size () >= max_entries_per_connection * quantum (item_a.endpoint))
+		{
+			entries.pop_front ();
+			--entries_count;
+			dropped = true;
+		}
 		entries.push_back (item_a);
+		++entries_count;
+	}
+	if (dropped)
+	{
+		stats.inc (nano::stat::type::tcp, nano::stat::detail::tcp_message_drop, nano::stat::dir::in);
 	}
 	condition.notify_all ();
 }
@@ -903,14 +1004,15 @@ void nano::tcp_message_manager::put_message (nano::tcp_message_item const & item
 nano::tcp_message_item nano::tcp_message_manager::get_message ()
 {
 	nano::unique_lock<std::mutex> lock (mutex);
-	while (entries.empty () && !stopped)
+	while (entries_count == 0 && !stopped)
 	{
 		condition.wait (lock);
 	}
-	if (!entries.empty ())
+	if (entries_count > 0)
 	{
-		auto result (entries.front ());
-		entries.pop_front ();
+		auto result (pop ());
+		lock.unlock ();
+		condition.notify_all ();
 		return result;
 	}
 	else
@@ -919,6 +1021,82 @@ nano::tcp_message_item nano::tcp_message_manager::get_message ()
 	}
 }
 
+void nano::tcp_message_manager::get_messages (std::vector<nano::tcp_message_item> & items_a, size_t count_a)
+{
+	{
+		nano::unique_lock<std::mutex> lock (mutex);
+		while (entries_count == 0 && !stopped)
+		{
+			condition.wait (lock);
+		}
+		for (; count_a > 0 && entries_count > 0; --count_a)
+		{
+			items_a.push_back (pop ());
+		}
+	}
+	condition.notify_all ();
+}
+
+nano::tcp_message_item nano::tcp_message_manager::pop ()
+{
+	debug_assert (!active.empty ());
+	auto endpoint (active.front ());
+	auto existing (queues.find (endpoint));
+	debug_assert (existing != queues.end ());
+	auto & queue (existing->second);
+	if (queue.deficit == 0)
+	{
+		queue.deficit = quantum (endpoint);
+	}
+	auto result (std::move (queue.entries.front ()));
+	queue.entries.pop_front ();
+	--queue.deficit;
+	--entries_count;
+	if (queue.entries.empty ())
+	{
+		queues.erase (existing);
+		active.pop_front ();
+	}
+	else if (queue.deficit == 0)
+	{
+		active.pop_front ();
+		active.push_back (endpoint);
+	}
+	return result;
+}
+
+unsigned nano::tcp_message_manager::quantum (nano::tcp_endpoint const & endpoint_a) const
+{
+	auto existing (quanta.find (endpoint_a));
+	return existing != quanta.end () ? existing->second : 1;
+}
+
+void nano::tcp_message_manager::set_weights (std::unordered_map<nano::tcp_endpoint, nano::uint128_t> const & weights_a)
+{
+	nano::uint128_t max_weight (0);
+	for (auto const & weight : weights_a)
+	{
+		max_weight = std::max (max_weight, weight.second);
+	}
+	std::unordered_map<nano::tcp_endpoint, unsigned> quanta_l;
+	if (max_weight > 0)
+	{
+		for (auto const & weight : weights_a)
+		{
+			// The heaviest representative takes max_quantum messages per round, lighter ones proportionally fewer
+			quanta_l[weight.first] = 1 + static_cast<unsigned> ((weight.second * (max_quantum - 1)) / max_weight);
+		}
+	}
+	nano::lock_guard<std::mutex> lock (mutex);
+	quanta.swap (quanta_l);
+}
+
+size_t nano::tcp_message_manager::size ()
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	return entries_count;
+}
+
 void nano::tcp_message_manager::stop ()
 {
 	{
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <nano/lib/mpmc_ring.hpp>
 #include <nano/node/common.hpp>
 #include <nano/node/peer_exclusion.hpp>
 #include <nano/node/transport/tcp.hpp>
@@ -10,6 +11,7 @@
 
 #include <memory>
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 namespace nano
 {
@@ -30,6 +32,8 @@ public:
   * buffers which are serviced by internal threads.
   * If buffers are not serviced fast enough they're internally dropped.
   * This container has a maximum space to hold N buffers of M size and will allocate them in round-robin order.
+  * Free and filled buffers are kept in rings which don't lock, the mutex is only taken to sleep when both are empty
+  * and by producers waking sleeping threads.
   * All public methods are thread-safe
 */
 class message_buffer_manager final
@@ -45,40 +49,83 @@ public:
 	// Function will block if there are no free or unserviced buffers
 	// Return nullptr if the container has stopped
 	nano::message_buffer * allocate ();
+	// Append up to count free buffers to the vector for receiving a batch of messages
+	// Unserviced buffers are only taken, and the function only blocks, if there are no free buffers and then a single buffer is returned
+	// Nothing is appended if the container has stopped
+	void allocate (std::vector<nano::message_buffer *> &, size_t);
 	// Queue a buffer that has been filled with message data and notify servicing threads
 	void enqueue (nano::message_buffer *);
+	// Queue filled buffers in order, waking servicing threads once
+	void enqueue (std::vector<nano::message_buffer *> const &);
 	// Return a buffer that has been filled with message data
 	// Function will block until a buffer has been added
 	// Return nullptr if the container has stopped
 	nano::message_buffer * dequeue ();
 	// Return a buffer to the freelist after is has been serviced
 	void release (nano::message_buffer *);
+	// Return unused buffers of a batch to the freelist
+	void release (std::vector<nano::message_buffer *> const &);
 	// Stop container and notify waiting threads
 	void stop ();
 
 private:
+	// Blocks until take returns true or the container stops
+	template <typename Take>
+	void wait (Take const &);
+	// Wakes threads blocked in wait, if there are any
+	void notify ();
 	nano::stat & stats;
 	std::mutex mutex;
 	nano::condition_variable condition;
-	boost::circular_buffer<nano::message_buffer *> free;
-	boost::circular_buffer<nano::message_buffer *> full;
+	std::atomic<unsigned> waiters{ 0 };
+	nano::mpmc_ring<nano::message_buffer *> free;
+	nano::mpmc_ring<nano::message_buffer *> full;
 	std::vector<uint8_t> slab;
 	std::vector<nano::message_buffer> entries;
-	bool stopped;
+	std::atomic<bool> stopped{ false };
 };
+/**
+  * Realtime messages received over TCP, queued per remote endpoint so a single peer can't monopolise processing.
+  * Endpoints with queued messages are serviced in deficit round robin order, representatives take up to max_quantum
+  * messages per round in proportion to their voting weight and other peers take one.
+  * When an endpoint has max_entries_per_connection messages per quantum queued its oldest message is dropped,
+  * producers block while the total exceeds the limit for all connections.
+*/
 class tcp_message_manager final
 {
 public:
-	tcp_message_manager (unsigned incoming_connections_max_a);
+	tcp_message_manager (nano::stat &, unsigned incoming_connections_max_a);
 	void put_message (nano::tcp_message_item const & item_a);
 	nano::tcp_message_item get_message ();
+	// Append up to count messages to the vector in service order, blocking until there is at least one
+	// Nothing is appended if the container has stopped
+	void get_messages (std::vector<nano::tcp_message_item> &, size_t);
+	// Replace the voting weights of representative endpoints, other endpoints have no weight
+	void set_weights (std::unordered_map<nano::tcp_endpoint, nano::uint128_t> const &);
+	size_t size ();
 	// Stop container and notify waiting threads
 	void stop ();
+	static unsigned constexpr max_quantum = 8;
 
 private:
+	class endpoint_queue final
+	{
+	public:
+		std::deque<nano::tcp_message_item> entries;
+		// Messages left to take from this endpoint in the current round
+		unsigned deficit{ 0 };
+	};
+	unsigned quantum (nano::tcp_endpoint const &) const;
+	// Takes the next message in service order, requires a queued message
+	nano::tcp_message_item pop ();
+	nano::stat & stats;
 	std::mutex mutex;
 	nano::condition_variable condition;
-	std::deque<nano::tcp_message_item> entries;
+	std::unordered_map<nano::tcp_endpoint, endpoint_queue> queues;
+	// Endpoints with queued messages in round robin order, the front endpoint is being serviced
+	std::deque<nano::tcp_endpoint> active;
+	std::unordered_map<nano::tcp_endpoint, unsigned> quanta;
+	size_t entries_count{ 0 };
 	unsigned max_entries;
 	static unsigned const max_entries_per_connection = 16;
 	bool stopped{ false };
@@ -178,6 +225,7 @@ public:
 	nano::tcp_message_manager tcp_message_manager;
 	nano::node & node;
 	nano::network_filter publish_filter;
+	nano::network_filter vote_filter;
 	nano::transport::udp_channels udp_channels;
 	nano::transport::tcp_channels tcp_channels;
 	std::atomic<uint16_t> port{ 0 };
@@ -9,6 +9,7 @@
 #include <nano/node/telemetry.hpp>
 #include <nano/node/websocket.hpp>
 #include <nano/rpc/rpc.hpp>
+#include <nano/secure/block_cache.hpp>
 #include <nano/secure/buffer.hpp>
 
 #if NANO_ROCKSDB
@@ -104,8 +105,10 @@ wallets_store_impl (std::make_unique<nano::mdb_wallets_store> (application_path_
 wallets_store (*wallets_store_impl),
 gap_cache (*this),
 ledger (store, stats, flags_a.generate_cache, [this]() { this->network.erase_below_version (network_params.protocol.protocol_version_min (true)); }),
+unchecked (store, ledger.cache.unchecked_count, config.unchecked_memory_budget, config.unchecked_spill),
 checker (config.signature_checker_threads),
 network (*this, config.peering_port),
+unchecked_cleaner (store, unchecked, write_database_queue, network.publish_filter, stats, std::min (4u, std::thread::hardware_concurrency ())),
 telemetry (std::make_shared<nano::telemetry> (network, alarm, worker, observers.telemetry, stats, network_params, flags.disable_ongoing_telemetry_requests)),
 bootstrap_initiator (*this),
 bootstrap (config.peering_port, *this),
@@ -132,6 +135,13 @@ wallets (wallets_store.init_error (), *this),
 startup_time (std::chrono::steady_clock::now ()),
 node_seq (seq)
 {
+	store.block_cache_get ().capacity_set (config.block_cache_size);
+	store.profile_get ().enable (config.diagnostics_config.store_profile.enable);
+	if (config.group_commit_max_latency.count () > 0)
+	{
+		write_database_queue.group_commit (config.group_commit_max_latency, [this]() { store.sync (); });
+		store.defer_sync_set ([this]() { return write_database_queue.defer_sync (); });
+	}
 	if (!init_error ())
 	{
 		telemetry->start ();
@@ -337,6 +347,7 @@ node_seq (seq)
 		logger.always_log ("Node starting, version: ", NANO_VERSION_STRING);
 		logger.always_log ("Build information: ", BUILD_INFO);
 		logger.always_log ("Database backend: ", store.vendor_get ());
+		logger.always_log ("Ledger cache generated", ledger.cache_counters_loaded ? " from stored counters" : "", ":\n", ledger.cache_timing);
 
 		auto network_label = network_params.network.get_current_network_as_string ();
 		logger.always_log ("Active network: ", network_label);
@@ -366,11 +377,33 @@ node_seq (seq)
 		if (!is_initialized)
 		{
 			release_assert (!flags.read_only);
-			auto transaction (store.tx_begin_write ({ tables::accounts, tables::cached_counts, tables::confirmation_height, tables::frontiers, tables::open_blocks }));
+			auto transaction (store.tx_begin_write ({ tables::accounts, tables::block_summaries, tables::cached_counts, tables::confirmation_height, tables::frontiers, tables::open_blocks }));
 			// Store was empty meaning we just created it, add the genesis block
 			store.initialize (transaction, genesis, ledger.cache);
 		}
 
+		if (!ledger.cache_counters_loaded && !flags.read_only)
+		{
+			// Write the counters now instead of at the first cementing so the next start can use them
+			auto transaction (store.tx_begin_write ({ tables::meta }));
+			ledger.cache_counters_write (transaction);
+		}
+
+		if (!flags.read_only)
+		{
+			// Nothing else runs yet, so no key can be put between reading the stored filters and installing them
+			// Stored filters are consumed here either way, a run without them would put keys they don't contain
+			auto transaction (store.tx_begin_write ({ tables::meta }));
+			if (!config.membership_filters)
+			{
+				store.membership_filters_checkpoint_del (transaction);
+			}
+			else if (!store.membership_filters_checkpoint_load (transaction))
+			{
+				logger.always_log (boost::str (boost::format ("Loaded block and pending filters from the database, using %1% bytes") % store.membership_filters_size ()));
+			}
+		}
+
 		if (!ledger.block_exists (genesis.hash ()))
 		{
 			std::stringstream ss;
@@ -424,8 +457,7 @@ node_seq (seq)
 			if (!flags.disable_unchecked_drop && !use_bootstrap_weight && !flags.read_only)
 			{
 				auto transaction (store.tx_begin_write ({ tables::unchecked }));
-				store.unchecked_clear (transaction);
-				ledger.cache.unchecked_count = 0;
+				unchecked.clear (transaction);
 				logger.always_log ("Dropping unchecked blocks");
 			}
 		}
@@ -586,6 +618,10 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (no
 	composite->add_component (collect_container_info (node.worker, "worker"));
 	composite->add_component (collect_container_info (node.distributed_work, "distributed_work"));
 	composite->add_component (collect_container_info (node.aggregator, "request_aggregator"));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "membership_filters", node.store.membership_filters_size (), 1 }));
+	composite->add_component (collect_container_info (node.store.block_cache_get (), "block_cache"));
+	composite->add_component (node.store.read_txn_pool_info ("read_txn_pool"));
+	composite->add_component (collect_container_info (node.unchecked, "unchecked"));
 	return composite;
 }
 
@@ -597,8 +633,14 @@ void nano::node::process_active (std::shared_ptr<nano::block> incoming)
 
 nano::process_return nano::node::process (nano::block & block_a)
 {
-	auto transaction (store.tx_begin_write ({ tables::accounts, tables::cached_counts, tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks }, { tables::confirmation_height }));
-	auto result (ledger.process (transaction, block_a));
+	// Blocks written here invalidate snapshot verdicts the block processor computed concurrently
+	++block_processor.external_writes_started;
+	nano::process_return result;
+	{
+		auto transaction (store.tx_begin_write ({ tables::accounts, tables::block_summaries, tables::cached_counts, tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks }, { tables::confirmation_height }));
+		result = ledger.process (transaction, block_a);
+	}
+	++block_processor.external_writes_finished;
 	return result;
 }
 
@@ -610,10 +652,16 @@ nano::process_return nano::node::process_local (std::shared_ptr<nano::block> blo
 	nano::unchecked_info info (block_a, block_a->account (), nano::seconds_since_epoch (), nano::signature_verification::unknown);
 	// Notify block processor to release write lock
 	block_processor.wait_write ();
-	// Process block
+	// Process block, the post events run once the write is committed and counted
 	block_post_events events;
-	auto transaction (store.tx_begin_write ({ tables::accounts, tables::cached_counts, tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks }, { tables::confirmation_height }));
-	return block_processor.process_one (transaction, events, info, work_watcher_a, nano::block_origin::local);
+	++block_processor.external_writes_started;
+	nano::process_return result;
+	{
+		auto transaction (store.tx_begin_write ({ tables::accounts, tables::block_summaries, tables::cached_counts, tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks }, { tables::confirmation_height }));
+		result = block_processor.process_one (transaction, events, info, work_watcher_a, nano::block_origin::local);
+	}
+	++block_processor.external_writes_finished;
+	return result;
 }
 
 void nano::node::start ()
@@ -639,6 +687,25 @@ void nano::node::start ()
 	}
 	ongoing_rep_calculation ();
 	ongoing_peer_store ();
+	if (config.membership_filters)
+	{
+		ongoing_membership_filters_build ();
+	}
+	if (!flags.read_only)
+	{
+		block_summaries_build ();
+	}
+	if (ledger.cache_counters_loaded && flags.validate_cache_counters)
+	{
+		// Recounting holds a read transaction over all confirmation heights, so it runs on its own thread
+		*cache_counters_validating.lock () = std::async (std::launch::async, [this]() {
+			nano::thread_role::set (nano::thread_role::name::cache_counters);
+			if (ledger.cache_counters_validate (stopped))
+			{
+				logger.always_log ("Stored ledger cache counters were out of date and have been corrected");
+			}
+		});
+	}
 	ongoing_online_weight_calculation_queue ();
 	bool tcp_enabled (false);
 	if (config.tcp_incoming_connections_max > 0 && !(flags.disable_bootstrap_listener && flags.disable_tcp_realtime))
@@ -705,6 +772,24 @@ void nano::node::stop ()
 		{
 			epoch_upgrade->wait ();
 		}
+		auto filters_build = membership_filters_building.lock ();
+		if (filters_build->valid ())
+		{
+			filters_build->wait ();
+		}
+		auto summaries_build = block_summaries_building.lock ();
+		if (summaries_build->valid ())
+		{
+			summaries_build->wait ();
+		}
+		auto counters_validation = cache_counters_validating.lock ();
+		if (counters_validation->valid ())
+		{
+			counters_validation->wait ();
+		}
+		// Nothing writes to the ledger anymore, so the next start can skip rebuilding the weights and filters
+		rep_weights_checkpoint ();
+		membership_filters_checkpoint ();
 		// work pool is not stopped on purpose due to testing setup
 	}
 }
@@ -863,6 +948,78 @@ void nano::node::ongoing_peer_store ()
 	});
 }
 
+void nano::node::ongoing_membership_filters_build ()
+{
+	if (!stopped)
+	{
+		auto filters_build = membership_filters_building.lock ();
+		// Filters stop being useful once they hold more keys than they were sized for, rebuild them from the tables
+		if ((!filters_build->valid () || filters_build->wait_for (std::chrono::seconds (0)) == std::future_status::ready) && store.membership_filters_stale ())
+		{
+			*filters_build = std::async (std::launch::async, [this]() {
+				nano::thread_role::set (nano::thread_role::name::membership_filters);
+				nano::timer<std::chrono::milliseconds> timer_l (nano::timer_state::started);
+				if (!store.membership_filters_build (stopped))
+				{
+					logger.always_log (boost::str (boost::format ("Built block and pending filters in %1% %2%, using %3% bytes") % timer_l.stop ().count () % timer_l.unit () % store.membership_filters_size ()));
+				}
+			});
+		}
+	}
+	std::weak_ptr<nano::node> node_w (shared_from_this ());
+	alarm.add (std::chrono::steady_clock::now () + std::chrono::minutes (5), [node_w]() {
+		if (auto node_l = node_w.lock ())
+		{
+			node_l->ongoing_membership_filters_build ();
+		}
+	});
+}
+
+void nano::node::block_summaries_build ()
+{
+	auto summaries_build = block_summaries_building.lock ();
+	*summaries_build = std::async (std::launch::async, [this]() {
+		nano::thread_role::set (nano::thread_role::name::block_summaries);
+		// Blocks per write transaction, the write queue is released in between so ledger writers aren't held up
+		size_t constexpr batch_size{ 16 * 1024 };
+		nano::timer<std::chrono::milliseconds> timer_l (nano::timer_state::started);
+		uint64_t batches (0);
+		auto done (false);
+		while (!done && !stopped)
+		{
+			auto scoped_write_guard = write_database_queue.wait (nano::writer::block_summaries);
+			auto transaction (store.tx_begin_write ({ tables::block_summaries }, { tables::meta }));
+			done = store.block_summaries_build (transaction, batch_size);
+			++batches;
+		}
+		// A single batch means the table was already complete
+		if (done && batches > 1)
+		{
+			logger.always_log (boost::str (boost::format ("Summarized blocks written before the block summary table in %1% %2%") % timer_l.stop ().count () % timer_l.unit ()));
+		}
+	});
+}
+
+void nano::node::rep_weights_checkpoint ()
+{
+	// Ledger write transactions on RocksDB don't lock the meta table, so they couldn't invalidate the checkpoint
+	if (config.rep_weights_checkpoint && !flags.read_only && !config.rocksdb_config.enable && !store.init_error () && !ledger.rep_weights_checkpointed)
+	{
+		auto transaction (store.tx_begin_write ({ tables::meta }));
+		ledger.rep_weights_checkpoint (transaction);
+	}
+}
+
+void nano::node::membership_filters_checkpoint ()
+{
+	// Written last so no block or pending entry can be put after it, the next start deletes it again
+	if (config.membership_filters && !flags.read_only && !store.init_error () && !store.membership_filters_stale ())
+	{
+		auto transaction (store.tx_begin_write ({ tables::meta }));
+		store.membership_filters_checkpoint (transaction);
+	}
+}
+
 void nano::node::backup_wallet ()
 {
 	auto transaction (wallets.tx_begin_read ());
@@ -920,50 +1077,16 @@ void nano::node::bootstrap_wallet ()
 
 void nano::node::unchecked_cleanup ()
 {
-	std::vector<nano::uint128_t> digests;
-	std::deque<nano::unchecked_key> cleaning_list;
 	auto attempt (bootstrap_initiator.current_attempt ());
 	bool long_attempt (attempt != nullptr && std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now () - attempt->attempt_start).count () > config.unchecked_cutoff_time.count ());
-	// Collect old unchecked keys
 	if (!flags.disable_unchecked_cleanup && ledger.cache.block_count >= ledger.bootstrap_weight_max_blocks && !long_attempt)
 	{
-		auto now (nano::seconds_since_epoch ());
-		auto transaction (store.tx_begin_read ());
-		// Max 1M records to clean, max 2 minutes reading to prevent slow i/o systems issues
-		for (auto i (store.unchecked_begin (transaction)), n (store.unchecked_end ()); i != n && cleaning_list.size () < 1024 * 1024 && nano::seconds_since_epoch () - now < 120; ++i)
-		{
-			nano::unchecked_key const & key (i->first);
-			nano::unchecked_info const & info (i->second);
-			if ((now - info.modified) > static_cast<uint64_t> (config.unchecked_cutoff_time.count ()))
-			{
-				digests.push_back (network.publish_filter.hash (info.block));
-				cleaning_list.push_back (key);
-			}
-		}
-	}
-	if (!cleaning_list.empty ())
-	{
-		logger.always_log (boost::str (boost::format ("Deleting %1% old unchecked blocks") % cleaning_list.size ()));
-	}
-	// Delete old unchecked keys in batches
-	while (!cleaning_list.empty ())
-	{
-		size_t deleted_count (0);
-		auto transaction (store.tx_begin_write ({ tables::unchecked }));
-		while (deleted_count++ < 2 * 1024 && !cleaning_list.empty ())
+		auto deleted (unchecked_cleaner.run (nano::seconds_since_epoch () - config.unchecked_cutoff_time.count ()));
+		if (deleted > 0)
 		{
-			auto key (cleaning_list.front ());
-			cleaning_list.pop_front ();
-			if (store.unchecked_exists (transaction, key))
-			{
-				store.unchecked_del (transaction, key);
-				debug_assert (ledger.cache.unchecked_count > 0);
-				--ledger.cache.unchecked_count;
-			}
+			logger.always_log (boost::str (boost::format ("Deleted %1% old unchecked blocks, unchecked table cleanup %2$.1f%% through") % deleted % (unchecked_cleaner.progress () * 100)));
 		}
 	}
-	// Delete from the duplicate filter
-	network.publish_filter.clear (digests);
 }
 
 void nano::node::ongoing_unchecked_cleanup ()
@@ -23,6 +23,8 @@
 #include <nano/node/request_aggregator.hpp>
 #include <nano/node/signatures.hpp>
 #include <nano/node/telemetry.hpp>
+#include <nano/node/unchecked_cleaner.hpp>
+#include <nano/node/unchecked_map.hpp>
 #include <nano/node/vote_processor.hpp>
 #include <nano/node/wallet.hpp>
 #include <nano/node/write_database_queue.hpp>
@@ -120,6 +122,10 @@ public:
 	void ongoing_bootstrap ();
 	void ongoing_store_flush ();
 	void ongoing_peer_store ();
+	void rep_weights_checkpoint ();
+	void membership_filters_checkpoint ();
+	void ongoing_membership_filters_build ();
+	void block_summaries_build ();
 	void ongoing_unchecked_cleanup ();
 	void backup_wallet ();
 	void search_pending ();
@@ -167,8 +173,10 @@ public:
 	nano::wallets_store & wallets_store;
 	nano::gap_cache gap_cache;
 	nano::ledger ledger;
+	nano::unchecked_map unchecked;
 	nano::signature_checker checker;
 	nano::network network;
+	nano::unchecked_cleaner unchecked_cleaner;
 	std::shared_ptr<nano::telemetry> telemetry;
 	nano::bootstrap_initiator bootstrap_initiator;
 	nano::bootstrap_listener bootstrap;
@@ -210,6 +218,9 @@ private:
 	void long_inactivity_cleanup ();
 	void epoch_upgrader_impl (nano::private_key const &, nano::epoch, uint64_t, uint64_t);
 	nano::locked<std::future<void>> epoch_upgrading;
+	nano::locked<std::future<void>> membership_filters_building;
+	nano::locked<std::future<void>> block_summaries_building;
+	nano::locked<std::future<void>> cache_counters_validating;
 };
 
 std::unique_ptr<container_info_component> collect_container_info (node & node, const std::string & name);
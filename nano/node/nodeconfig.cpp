@@ -86,17 +86,24 @@ nano::error nano::node_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("vote_generator_delay", vote_generator_delay.count (), "Delay before votes are sent to allow for efficient bundling of hashes in votes.\ntype:milliseconds");
 	toml.put ("vote_generator_threshold", vote_generator_threshold, "Number of bundled hashes required for an additional generator delay.\ntype:uint64,[1..11]");
 	toml.put ("unchecked_cutoff_time", unchecked_cutoff_time.count (), "Number of seconds before deleting an unchecked entry.\nWarning: lower values (e.g., 3600 seconds, or 1 hour) may result in unsuccessful bootstraps, especially a bootstrap from scratch.\ntype:seconds");
+	toml.put ("unchecked_memory_budget", unchecked_memory_budget, "Approximate memory in bytes used to keep unchecked blocks, which wait for their previous or source block, before the oldest are spilled to the database or dropped.\ntype:uint64");
+	toml.put ("unchecked_spill", unchecked_spill, "Move the oldest unchecked blocks to the database when over the memory budget instead of dropping them.\ntype:bool");
 	toml.put ("tcp_io_timeout", tcp_io_timeout.count (), "Timeout for TCP connect-, read- and write operations.\nWarning: a low value (e.g., below 5 seconds) may result in TCP connections failing.\ntype:seconds");
 	toml.put ("pow_sleep_interval", pow_sleep_interval.count (), "Time to sleep between batch work generation attempts. Reduces max CPU usage at the expense of a longer generation time.\ntype:nanoseconds");
 	toml.put ("external_address", external_address, "The external address of this node (NAT). If not set, the node will request this information via UPnP.\ntype:string,ip");
 	toml.put ("external_port", external_port, "The external port number of this node (NAT). Only used if external_address is set.\ntype:uint16");
 	toml.put ("tcp_incoming_connections_max", tcp_incoming_connections_max, "Maximum number of incoming TCP connections.\ntype:uint64");
+	toml.put ("udp_batch_size", udp_batch_size, "Maximum number of UDP datagrams received or sent with a single system call, Linux only. 0 or 1 disables batching.\ntype:uint64");
 	toml.put ("use_memory_pools", use_memory_pools, "If true, allocate memory from memory pools. Enabling this may improve performance. Memory is never released to the OS.\ntype:bool");
 	toml.put ("confirmation_history_size", confirmation_history_size, "Maximum confirmation history size. If tracking the rate of block confirmations, the websocket feature is recommended instead.\ntype:uint64");
 	toml.put ("active_elections_size", active_elections_size, "Number of active elections. Elections beyond this limit have limited survival time.\nWarning: modifying this value may result in a lower confirmation rate.\ntype:uint64,[250..]");
 	toml.put ("bandwidth_limit", bandwidth_limit, "Outbound traffic limit in bytes/sec after which messages will be dropped.\nNote: changing to unlimited bandwidth (0) is not recommended for limited connections.\ntype:uint64");
 	toml.put ("bandwidth_limit_burst_ratio", bandwidth_limit_burst_ratio, "Burst ratio for outbound traffic shaping.\ntype:double");
 	toml.put ("conf_height_processor_batch_min_time", conf_height_processor_batch_min_time.count (), "Minimum write batching time when there are blocks pending confirmation height.\ntype:milliseconds");
+	toml.put ("group_commit_max_latency", group_commit_max_latency.count (), "Maximum time a database commit can wait for its sync to disk to be shared with the next block processing or confirmation height write. 0 disables grouping.\nWarning: an operating system crash may lose the grouped commits not yet synced, LMDB only.\ntype:milliseconds");
+	toml.put ("membership_filters", membership_filters, "Keep in-memory filters of block hashes and pending entries, stored on shutdown or otherwise built in the background on start, so lookups of missing entries skip the database. Uses about 2 bytes per block and pending entry.\ntype:bool");
+	toml.put ("block_cache_size", block_cache_size, "Maximum number of recently read blocks kept decoded in memory, served to reads which see the latest ledger. 0 disables the cache.\ntype:uint64");
+	toml.put ("rep_weights_checkpoint", rep_weights_checkpoint, "Write a checkpoint of representative weights on shutdown, loaded on the next start instead of scanning all accounts. A checkpoint is discarded by the first block processed after it, LMDB only.\ntype:bool");
 	toml.put ("backup_before_upgrade", backup_before_upgrade, "Backup the ledger database before performing upgrades.\nWarning: uses more disk storage and increases startup time when upgrading.\ntype:bool");
 	toml.put ("work_watcher_period", work_watcher_period.count (), "Time between checks for confirmation and re-generating higher difficulty work if unconfirmed, for blocks in the work watcher.\ntype:seconds");
 	toml.put ("max_work_generate_multiplier", max_work_generate_multiplier, "Maximum allowed difficulty multiplier for work generation.\ntype:double,[1..]");
@@ -293,6 +300,9 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		toml.get ("unchecked_cutoff_time", unchecked_cutoff_time_l);
 		unchecked_cutoff_time = std::chrono::seconds (unchecked_cutoff_time_l);
 
+		toml.get<size_t> ("unchecked_memory_budget", unchecked_memory_budget);
+		toml.get<bool> ("unchecked_spill", unchecked_spill);
+
 		auto tcp_io_timeout_l = static_cast<unsigned long> (tcp_io_timeout.count ());
 		toml.get ("tcp_io_timeout", tcp_io_timeout_l);
 		tcp_io_timeout = std::chrono::seconds (tcp_io_timeout_l);
@@ -339,6 +349,7 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		external_address = external_address_l.to_string ();
 		toml.get<uint16_t> ("external_port", external_port);
 		toml.get<unsigned> ("tcp_incoming_connections_max", tcp_incoming_connections_max);
+		toml.get<unsigned> ("udp_batch_size", udp_batch_size);
 
 		auto pow_sleep_interval_l (pow_sleep_interval.count ());
 		toml.get (pow_sleep_interval_key, pow_sleep_interval_l);
@@ -358,6 +369,15 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		toml.get ("conf_height_processor_batch_min_time", conf_height_processor_batch_min_time_l);
 		conf_height_processor_batch_min_time = std::chrono::milliseconds (conf_height_processor_batch_min_time_l);
 
+		auto group_commit_max_latency_l (group_commit_max_latency.count ());
+		toml.get ("group_commit_max_latency", group_commit_max_latency_l);
+		group_commit_max_latency = std::chrono::milliseconds (group_commit_max_latency_l);
+
+		toml.get<bool> ("rep_weights_checkpoint", rep_weights_checkpoint);
+
+		toml.get<bool> ("membership_filters", membership_filters);
+		toml.get<size_t> ("block_cache_size", block_cache_size);
+
 		nano::network_constants network;
 		toml.get<double> ("max_work_generate_multiplier", max_work_generate_multiplier);
 
@@ -0,0 +1,18 @@
+#include <nano/node/transport/udp_batch.hpp>
+
+bool nano::transport::udp_batch_supported ()
+{
+	return false;
+}
+
+size_t nano::transport::udp_receive_batch (boost::asio::ip::udp::socket &, std::vector<nano::message_buffer *> const &, size_t, boost::system::error_code & ec_a)
+{
+	ec_a = boost::asio::error::operation_not_supported;
+	return 0;
+}
+
+size_t nano::transport::udp_send_batch (boost::asio::ip::udp::socket &, nano::transport::udp_send_item const *, size_t, std::vector<size_t> &, boost::system::error_code & ec_a)
+{
+	ec_a = boost::asio::error::operation_not_supported;
+	return 0;
+}
@@ -0,0 +1,90 @@
+#include <nano/node/network.hpp>
+#include <nano/node/transport/udp_batch.hpp>
+
+#include <sys/socket.h>
+
+#include <algorithm>
+
+namespace
+{
+// Reused by every batch of the calling thread to avoid allocating headers per system call
+thread_local std::vector<mmsghdr> headers;
+thread_local std::vector<iovec> vectors;
+
+void prepare (size_t count_a)
+{
+	headers.resize (std::max (headers.size (), count_a));
+	vectors.resize (std::max (vectors.size (), count_a));
+	std::fill (headers.begin (), headers.begin () + count_a, mmsghdr{});
+}
+}
+
+bool nano::transport::udp_batch_supported ()
+{
+	return true;
+}
+
+size_t nano::transport::udp_receive_batch (boost::asio::ip::udp::socket & socket_a, std::vector<nano::message_buffer *> const & buffers_a, size_t buffer_size_a, boost::system::error_code & ec_a)
+{
+	size_t result (0);
+	auto count (buffers_a.size ());
+	prepare (count);
+	for (size_t i (0); i < count; ++i)
+	{
+		auto buffer (buffers_a[i]);
+		vectors[i].iov_base = buffer->buffer;
+		vectors[i].iov_len = buffer_size_a;
+		headers[i].msg_hdr.msg_iov = &vectors[i];
+		headers[i].msg_hdr.msg_iovlen = 1;
+		headers[i].msg_hdr.msg_name = buffer->endpoint.data ();
+		headers[i].msg_hdr.msg_namelen = static_cast<socklen_t> (buffer->endpoint.capacity ());
+	}
+	auto status (recvmmsg (socket_a.native_handle (), headers.data (), static_cast<unsigned> (count), MSG_DONTWAIT, nullptr));
+	if (status >= 0)
+	{
+		result = static_cast<size_t> (status);
+		for (size_t i (0); i < result; ++i)
+		{
+			auto buffer (buffers_a[i]);
+			buffer->size = headers[i].msg_len;
+			buffer->endpoint.resize (headers[i].msg_hdr.msg_namelen);
+		}
+	}
+	else
+	{
+		ec_a = boost::system::error_code (errno, boost::system::system_category ());
+	}
+	return result;
+}
+
+size_t nano::transport::udp_send_batch (boost::asio::ip::udp::socket & socket_a, nano::transport::udp_send_item const * items_a, size_t count_a, std::vector<size_t> & sizes_a, boost::system::error_code & ec_a)
+{
+	size_t result (0);
+	prepare (count_a);
+	for (size_t i (0); i < count_a; ++i)
+	{
+		auto & item (items_a[i]);
+		auto buffer (item.buffer.begin ());
+		vectors[i].iov_base = const_cast<void *> (buffer->data ());
+		vectors[i].iov_len = buffer->size ();
+		headers[i].msg_hdr.msg_iov = &vectors[i];
+		headers[i].msg_hdr.msg_iovlen = 1;
+		headers[i].msg_hdr.msg_name = const_cast<sockaddr *> (item.endpoint.data ());
+		headers[i].msg_hdr.msg_namelen = static_cast<socklen_t> (item.endpoint.size ());
+	}
+	auto status (sendmmsg (socket_a.native_handle (), headers.data (), static_cast<unsigned> (count_a), MSG_DONTWAIT));
+	if (status >= 0)
+	{
+		result = static_cast<size_t> (status);
+		sizes_a.clear ();
+		for (size_t i (0); i < result; ++i)
+		{
+			sizes_a.push_back (headers[i].msg_len);
+		}
+	}
+	else
+	{
+		ec_a = boost::system::error_code (errno, boost::system::system_category ());
+	}
+	return result;
+}
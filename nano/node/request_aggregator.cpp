@@ -150,10 +150,25 @@ std::vector<nano::block_hash> nano::request_aggregator::aggregate (nano::transac
 	size_t cached_hashes = 0;
 	std::vector<nano::block_hash> to_generate;
 	std::vector<std::shared_ptr<nano::vote>> cached_votes;
+	// Blocks of the requests without cached votes are read from the ledger in one batch
+	std::vector<std::vector<std::shared_ptr<nano::vote>>> requests_votes;
+	std::vector<nano::block_hash> uncached_hashes;
+	requests_votes.reserve (requests_a.size ());
 	for (auto const & hash_root : requests_a)
 	{
+		requests_votes.push_back (votes_cache.find (hash_root.first));
+		if (requests_votes.back ().empty ())
+		{
+			uncached_hashes.push_back (hash_root.first);
+		}
+	}
+	auto ledger_blocks (ledger.store.blocks_get (transaction_a, uncached_hashes));
+	auto ledger_block (ledger_blocks.begin ());
+	for (size_t i (0), n (requests_a.size ()); i < n; ++i)
+	{
+		auto const & hash_root (requests_a[i]);
 		// 1. Votes in cache
-		auto find_votes (votes_cache.find (hash_root.first));
+		auto const & find_votes (requests_votes[i]);
 		if (!find_votes.empty ())
 		{
 			++cached_hashes;
@@ -167,8 +182,9 @@ std::vector<nano::block_hash> nano::request_aggregator::aggregate (nano::transac
 			// 3. Ledger by hash
 			if (block == nullptr)
 			{
-				block = ledger.store.block_get (transaction_a, hash_root.first);
+				block = *ledger_block;
 			}
+			++ledger_block;
 
 			// 4. Ledger by root
 			if (block == nullptr && !hash_root.second.is_zero ())
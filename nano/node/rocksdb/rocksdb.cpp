@@ -8,9 +8,12 @@
 #include <boost/format.hpp>
 #include <boost/polymorphic_cast.hpp>
 
+#include <rocksdb/cache.h>
 #include <rocksdb/merge_operator.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/slice_transform.h>
 #include <rocksdb/utilities/backupable_db.h>
+#include <rocksdb/utilities/options_util.h>
 #include <rocksdb/utilities/transaction.h>
 #include <rocksdb/utilities/transaction_db.h>
 
@@ -43,6 +46,7 @@ void rocksdb_val::convert_buffer_to_value ()
 
 nano::rocksdb_store::rocksdb_store (nano::logger_mt & logger_a, boost::filesystem::path const & path_a, nano::rocksdb_config const & rocksdb_config_a, bool open_read_only_a) :
 logger (logger_a),
+write_batch (rocksdb_config_a.write_batch && !open_read_only_a),
 rocksdb_config (rocksdb_config_a)
 {
 	boost::system::error_code error_mkdir, error_chmod;
@@ -52,8 +56,12 @@ rocksdb_config (rocksdb_config_a)
 
 	if (!error)
 	{
-		auto table_options = get_table_options ();
-		table_factory.reset (rocksdb::NewBlockBasedTableFactory (table_options));
+		hot_block_cache = rocksdb::NewLRUCache (rocksdb_config.block_cache * 1024 * 1024ULL);
+		cold_block_cache = rocksdb::NewLRUCache (rocksdb_config.cold_block_cache * 1024 * 1024ULL);
+		for (auto profile_l : { table_profile::point_lookup, table_profile::prefix, table_profile::fifo, table_profile::standard })
+		{
+			table_factories[profile_l].reset (rocksdb::NewBlockBasedTableFactory (get_table_options (profile_l)));
+		}
 		if (!open_read_only_a)
 		{
 			construct_column_family_mutexes ();
@@ -74,11 +82,32 @@ nano::rocksdb_store::~rocksdb_store ()
 
 void nano::rocksdb_store::open (bool & error_a, boost::filesystem::path const & path_a, bool open_read_only_a)
 {
-	std::initializer_list<const char *> names{ rocksdb::kDefaultColumnFamilyName.c_str (), "frontiers", "accounts", "send", "receive", "open", "change", "state_blocks", "pending", "representation", "unchecked", "vote", "online_weight", "meta", "peers", "cached_counts", "confirmation_height" };
+	std::initializer_list<const char *> names{ rocksdb::kDefaultColumnFamilyName.c_str (), "frontiers", "accounts", "send", "receive", "open", "change", "state_blocks", "pending", "representation", "unchecked", "vote", "online_weight", "meta", "peers", "cached_counts", "confirmation_height", "block_summaries" };
+	// Column families have to be opened with the compaction style they were created with, FIFO ones can't have files below level 0
+	std::unordered_map<std::string, rocksdb::CompactionStyle> stored_styles;
+	{
+		rocksdb::DBOptions stored_db_options;
+		std::vector<rocksdb::ColumnFamilyDescriptor> stored_column_families;
+		if (rocksdb::LoadLatestOptions (path_a.string (), rocksdb::Env::Default (), &stored_db_options, &stored_column_families).ok ())
+		{
+			for (auto const & column_family : stored_column_families)
+			{
+				stored_styles.emplace (column_family.name, column_family.options.compaction_style);
+			}
+		}
+	}
 	std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
+	std::vector<std::string> restyled;
 	for (const auto & cf_name : names)
 	{
-		column_families.emplace_back (cf_name, get_cf_options ());
+		auto cf_options (get_cf_options (cf_name));
+		auto stored (stored_styles.find (cf_name));
+		if (stored != stored_styles.end () && stored->second != cf_options.compaction_style)
+		{
+			cf_options.compaction_style = stored->second;
+			restyled.push_back (cf_name);
+		}
+		column_families.emplace_back (cf_name, cf_options);
 	}
 
 	auto options = get_db_options ();
@@ -88,6 +117,10 @@ void nano::rocksdb_store::open (bool & error_a, boost::filesystem::path const &
 	{
 		s = rocksdb::DB::OpenForReadOnly (options, path_a.string (), column_families, &handles, &db);
 	}
+	else if (write_batch)
+	{
+		s = rocksdb::DB::Open (options, path_a.string (), column_families, &handles, &db);
+	}
 	else
 	{
 		s = rocksdb::OptimisticTransactionDB::Open (options, path_a.string (), column_families, &handles, &optimistic_db);
@@ -100,6 +133,18 @@ void nano::rocksdb_store::open (bool & error_a, boost::filesystem::path const &
 	// Assign handles to supplied
 	error_a |= !s.ok ();
 
+	if (!error_a && !open_read_only_a)
+	{
+		// Only online weight changes style, with fifo_max_size, and its samples are taken again
+		for (auto const & cf_name : restyled)
+		{
+			auto handle (std::find_if (handles.begin (), handles.end (), [&cf_name](auto handle_a) { return handle_a->GetName () == cf_name; }));
+			debug_assert (handle != handles.end ());
+			clear (*handle);
+			logger.always_log (boost::str (boost::format ("Cleared the %1% table to change its compaction style") % cf_name));
+		}
+	}
+
 	if (!error_a)
 	{
 		auto transaction = tx_begin_read ();
@@ -109,32 +154,54 @@ void nano::rocksdb_store::open (bool & error_a, boost::filesystem::path const &
 			error_a = true;
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
 		}
+		// There are no upgrades which rewrite blocks in place, summaries missing from older ledgers are built by the node
+		summaries_enabled = !error_a;
+		if (write_batch)
+		{
+			for (auto table : all_tables ())
+			{
+				if (is_caching_counts (table))
+				{
+					batch_counts[table] = count (transaction, table_to_column_family (table));
+				}
+			}
+		}
 	}
 }
 
 nano::write_transaction nano::rocksdb_store::tx_begin_write (std::vector<nano::tables> const & tables_requiring_locks_a, std::vector<nano::tables> const & tables_no_locks_a)
 {
-	std::unique_ptr<nano::write_rocksdb_txn> txn;
-	release_assert (optimistic_db != nullptr);
-	if (tables_requiring_locks_a.empty () && tables_no_locks_a.empty ())
+	auto generation (block_cache.generation ());
+	std::unique_ptr<nano::write_transaction_impl> txn;
+	// Use all tables if none are specified
+	auto all (tables_requiring_locks_a.empty () && tables_no_locks_a.empty ());
+	auto const & tables_requiring_locks_l (all ? all_tables () : tables_requiring_locks_a);
+	if (write_batch)
 	{
-		// Use all tables if none are specified
-		txn = std::make_unique<nano::write_rocksdb_txn> (optimistic_db, all_tables (), tables_no_locks_a, write_lock_mutexes);
+		txn = std::make_unique<nano::write_rocksdb_batch> (db, tables_requiring_locks_l, tables_no_locks_a, write_lock_mutexes, [this](rocksdb::WriteBatchWithIndex & batch_a, nano::write_rocksdb_batch::count_deltas_t & count_deltas_a) {
+			batch_counts_checkpoint (batch_a, count_deltas_a);
+		});
 	}
 	else
 	{
-		txn = std::make_unique<nano::write_rocksdb_txn> (optimistic_db, tables_requiring_locks_a, tables_no_locks_a, write_lock_mutexes);
+		release_assert (optimistic_db != nullptr);
+		txn = std::make_unique<nano::write_rocksdb_txn> (optimistic_db, tables_requiring_locks_l, tables_no_locks_a, write_lock_mutexes);
 	}
 
 	// Tables must be kept in alphabetical order. These can be used for mutex locking, so order is important to prevent deadlocking
 	debug_assert (std::is_sorted (tables_requiring_locks_a.begin (), tables_requiring_locks_a.end ()));
 
-	return nano::write_transaction{ std::move (txn) };
+	nano::write_transaction result{ std::move (txn) };
+	result.block_cache_attach (block_cache, generation);
+	return result;
 }
 
 nano::read_transaction nano::rocksdb_store::tx_begin_read ()
 {
-	return nano::read_transaction{ std::make_unique<nano::read_rocksdb_txn> (db) };
+	auto generation (block_cache.generation ());
+	nano::read_transaction result{ std::make_unique<nano::read_rocksdb_txn> (db) };
+	result.block_cache_attach (block_cache, generation);
+	return result;
 }
 
 std::string nano::rocksdb_store::vendor_get () const
@@ -159,6 +226,8 @@ rocksdb::ColumnFamilyHandle * nano::rocksdb_store::table_to_column_family (table
 			return get_handle ("frontiers");
 		case tables::accounts:
 			return get_handle ("accounts");
+		case tables::block_summaries:
+			return get_handle ("block_summaries");
 		case tables::send_blocks:
 			return get_handle ("send");
 		case tables::receive_blocks:
@@ -203,6 +272,11 @@ bool nano::rocksdb_store::exists (nano::transaction const & transaction_a, table
 	{
 		status = db->Get (snapshot_options (transaction_a), table_to_column_family (table_a), key_a, &slice);
 	}
+	else if (write_batch)
+	{
+		rocksdb::ReadOptions options;
+		status = batch (transaction_a)->batch.GetFromBatchAndDB (db, options, table_to_column_family (table_a), key_a, &slice);
+	}
 	else
 	{
 		rocksdb::ReadOptions options;
@@ -221,10 +295,26 @@ int nano::rocksdb_store::del (nano::write_transaction const & transaction_a, tab
 	// Removing an entry so counts may need adjusting
 	if (is_caching_counts (table_a))
 	{
-		decrement (transaction_a, tables::cached_counts, rocksdb_val (rocksdb::Slice (table_to_column_family (table_a)->GetName ())), 1);
+		if (write_batch)
+		{
+			--batch (transaction_a)->count_deltas[table_a];
+		}
+		else
+		{
+			decrement (transaction_a, tables::cached_counts, rocksdb_val (rocksdb::Slice (table_to_column_family (table_a)->GetName ())), 1);
+		}
 	}
 
-	return tx (transaction_a)->Delete (table_to_column_family (table_a), key_a).code ();
+	rocksdb::Status status;
+	if (write_batch)
+	{
+		status = batch (transaction_a)->batch.Delete (table_to_column_family (table_a), key_a);
+	}
+	else
+	{
+		status = tx (transaction_a)->Delete (table_to_column_family (table_a), key_a);
+	}
+	return status.code ();
 }
 
 bool nano::rocksdb_store::block_info_get (nano::transaction const &, nano::block_hash const &, nano::block_info &) const
@@ -245,10 +335,29 @@ void nano::rocksdb_store::version_put (nano::write_transaction const & transacti
 
 rocksdb::Transaction * nano::rocksdb_store::tx (nano::transaction const & transaction_a) const
 {
-	debug_assert (!is_read (transaction_a));
+	debug_assert (!is_read (transaction_a) && !write_batch);
 	return static_cast<rocksdb::Transaction *> (transaction_a.get_handle ());
 }
 
+nano::write_rocksdb_batch * nano::rocksdb_store::batch (nano::transaction const & transaction_a) const
+{
+	debug_assert (!is_read (transaction_a) && write_batch);
+	return static_cast<nano::write_rocksdb_batch *> (transaction_a.get_handle ());
+}
+
+void nano::rocksdb_store::batch_counts_checkpoint (rocksdb::WriteBatchWithIndex & batch_a, nano::write_rocksdb_batch::count_deltas_t & count_deltas_a)
+{
+	// Table locks are held by the committing batch so counts of its tables aren't changed by anyone else
+	for (auto const & delta : count_deltas_a)
+	{
+		auto & count_l (batch_counts.at (delta.first));
+		count_l.fetch_add (static_cast<uint64_t> (delta.second));
+		auto status (batch_a.Put (table_to_column_family (tables::cached_counts), table_to_column_family (delta.first)->GetName (), nano::rocksdb_val (count_l.load ())));
+		release_assert (status.ok ());
+	}
+	count_deltas_a.clear ();
+}
+
 int nano::rocksdb_store::get (nano::transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, nano::rocksdb_val & value_a) const
 {
 	rocksdb::ReadOptions options;
@@ -259,6 +368,10 @@ int nano::rocksdb_store::get (nano::transaction const & transaction_a, tables ta
 	{
 		status = db->Get (snapshot_options (transaction_a), handle, key_a, &slice);
 	}
+	else if (write_batch)
+	{
+		status = batch (transaction_a)->batch.GetFromBatchAndDB (db, options, handle, key_a, &slice);
+	}
 	else
 	{
 		status = tx (transaction_a)->Get (options, handle, key_a, &slice);
@@ -273,6 +386,36 @@ int nano::rocksdb_store::get (nano::transaction const & transaction_a, tables ta
 	return status.code ();
 }
 
+void nano::rocksdb_store::get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::rocksdb_val> const & keys_a, std::vector<nano::rocksdb_val> & values_a) const
+{
+	values_a.assign (keys_a.size (), nano::rocksdb_val{});
+	if (is_read (transaction_a))
+	{
+		std::vector<rocksdb::ColumnFamilyHandle *> handles_l (keys_a.size (), table_to_column_family (table_a));
+		std::vector<rocksdb::Slice> keys_l (keys_a.begin (), keys_a.end ());
+		std::vector<std::string> values_l;
+		auto statuses (db->MultiGet (snapshot_options (transaction_a), handles_l, keys_l, &values_l));
+		for (size_t i (0), n (statuses.size ()); i < n; ++i)
+		{
+			release_assert (statuses[i].ok () || statuses[i].IsNotFound ());
+			if (statuses[i].ok ())
+			{
+				values_a[i].buffer = std::make_shared<std::vector<uint8_t>> (values_l[i].begin (), values_l[i].end ());
+				values_a[i].convert_buffer_to_value ();
+			}
+		}
+	}
+	else
+	{
+		// Lookups have to see the writes of the transaction
+		for (size_t i (0), n (keys_a.size ()); i < n; ++i)
+		{
+			auto status (get (transaction_a, table_a, keys_a[i], values_a[i]));
+			release_assert (success (status) || not_found (status));
+		}
+	}
+}
+
 /** The column families which need to have their counts cached for later querying */
 bool nano::rocksdb_store::is_caching_counts (nano::tables table_a) const
 {
@@ -320,17 +463,32 @@ int nano::rocksdb_store::put (nano::write_transaction const & transaction_a, tab
 {
 	debug_assert (transaction_a.contains (table_a));
 
-	auto txn = tx (transaction_a);
 	if (is_caching_counts (table_a))
 	{
 		if (!exists (transaction_a, table_a, key_a))
 		{
 			// Adding a new entry so counts need adjusting
-			increment (transaction_a, tables::cached_counts, rocksdb_val (rocksdb::Slice (table_to_column_family (table_a)->GetName ())), 1);
+			if (write_batch)
+			{
+				++batch (transaction_a)->count_deltas[table_a];
+			}
+			else
+			{
+				increment (transaction_a, tables::cached_counts, rocksdb_val (rocksdb::Slice (table_to_column_family (table_a)->GetName ())), 1);
+			}
 		}
 	}
 
-	return txn->Put (table_to_column_family (table_a), key_a, value_a).code ();
+	rocksdb::Status status;
+	if (write_batch)
+	{
+		status = batch (transaction_a)->batch.Put (table_to_column_family (table_a), key_a, value_a);
+	}
+	else
+	{
+		status = tx (transaction_a)->Put (table_to_column_family (table_a), key_a, value_a);
+	}
+	return status.code ();
 }
 
 bool nano::rocksdb_store::not_found (int status) const
@@ -398,6 +556,18 @@ size_t nano::rocksdb_store::count (nano::transaction const & transaction_a, tabl
 			++sum;
 		}
 	}
+	else if (write_batch)
+	{
+		debug_assert (is_caching_counts (table_a));
+		sum = batch_counts.at (table_a);
+		if (!is_read (transaction_a))
+		{
+			// Include changes not committed yet
+			auto const & count_deltas (batch (transaction_a)->count_deltas);
+			auto existing (count_deltas.find (table_a));
+			sum += existing != count_deltas.end () ? existing->second : 0;
+		}
+	}
 	else
 	{
 		debug_assert (is_caching_counts (table_a));
@@ -412,11 +582,24 @@ int nano::rocksdb_store::drop (nano::write_transaction const & transaction_a, ta
 	debug_assert (transaction_a.contains (table_a));
 	auto col = table_to_column_family (table_a);
 
+	if (write_batch && table_a != tables::peers)
+	{
+		// The column family is dropped outside of the batch, earlier writes to it must be in the database first
+		batch (transaction_a)->commit ();
+	}
+
 	int status = static_cast<int> (rocksdb::Status::Code::kOk);
 	if (is_caching_counts (table_a))
 	{
 		// Reset counter to 0
-		status = put (transaction_a, tables::cached_counts, nano::rocksdb_val (rocksdb::Slice (col->GetName ())), nano::rocksdb_val (uint64_t{ 0 }));
+		if (write_batch)
+		{
+			batch (transaction_a)->count_deltas[table_a] -= static_cast<int64_t> (batch_counts.at (table_a).load ());
+		}
+		else
+		{
+			status = put (transaction_a, tables::cached_counts, nano::rocksdb_val (rocksdb::Slice (col->GetName ())), nano::rocksdb_val (uint64_t{ 0 }));
+		}
 	}
 
 	if (success (status))
@@ -451,7 +634,7 @@ int nano::rocksdb_store::clear (rocksdb::ColumnFamilyHandle * column_family)
 	// Need to add it back as we just want to clear the contents
 	auto handle_it = std::find (handles.begin (), handles.end (), column_family);
 	debug_assert (handle_it != handles.cend ());
-	status = db->CreateColumnFamily (get_cf_options (), name, &column_family);
+	status = db->CreateColumnFamily (get_cf_options (name), name, &column_family);
 	release_assert (status.ok ());
 	*handle_it = column_family;
 	return status.code ();
@@ -490,20 +673,55 @@ rocksdb::Options nano::rocksdb_store::get_db_options () const
 	return db_options;
 }
 
-rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_table_options () const
+nano::rocksdb_store::table_profile nano::rocksdb_store::profile (std::string const & column_family_a)
+{
+	static std::unordered_map<std::string, table_profile> const profiles{
+		{ "accounts", table_profile::point_lookup },
+		{ "send", table_profile::point_lookup },
+		{ "receive", table_profile::point_lookup },
+		{ "open", table_profile::point_lookup },
+		{ "change", table_profile::point_lookup },
+		{ "state_blocks", table_profile::point_lookup },
+		{ "confirmation_height", table_profile::point_lookup },
+		{ "block_summaries", table_profile::point_lookup },
+		{ "pending", table_profile::prefix },
+		// Only tables whose counts are found by iterating them, FIFO compaction drops files behind any cached count
+		{ "online_weight", table_profile::fifo }
+	};
+	auto existing (profiles.find (column_family_a));
+	return existing != profiles.end () ? existing->second : table_profile::standard;
+}
+
+rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_table_options (table_profile profile_a) const
 {
 	rocksdb::BlockBasedTableOptions table_options;
 
-	// Block cache for reads
-	table_options.block_cache = rocksdb::NewLRUCache (rocksdb_config.block_cache * 1024 * 1024ULL);
+	// Block cache for reads, the large one is kept for tables read while processing blocks
+	auto hot (profile_a == table_profile::point_lookup || profile_a == table_profile::prefix);
+	table_options.block_cache = hot ? hot_block_cache : cold_block_cache;
 
 	// Bloom filter to help with point reads
 	auto bloom_filter_bits = rocksdb_config.bloom_filter_bits;
+	if (profile_a == table_profile::point_lookup)
+	{
+		bloom_filter_bits = rocksdb_config.point_lookup_bloom_filter_bits;
+	}
+	else if (profile_a == table_profile::prefix)
+	{
+		bloom_filter_bits = rocksdb_config.pending_prefix_bloom_filter_bits;
+	}
 	if (bloom_filter_bits > 0)
 	{
 		table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (bloom_filter_bits, false));
 	}
 
+	// Hash index inside data blocks, point reads find their key without a binary search of the block
+	if (profile_a == table_profile::point_lookup && rocksdb_config.point_lookup_hash_index)
+	{
+		table_options.data_block_index_type = rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+		table_options.data_block_hash_table_util_ratio = 0.75;
+	}
+
 	// Increasing block_size decreases memory usage and space amplification, but increases read amplification.
 	table_options.block_size = rocksdb_config.block_size * 1024ULL;
 
@@ -514,10 +732,11 @@ rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_table_options () const
 	return table_options;
 }
 
-rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options () const
+rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options (std::string const & column_family_a) const
 {
 	rocksdb::ColumnFamilyOptions cf_options;
-	cf_options.table_factory = table_factory;
+	auto profile_l (profile (column_family_a));
+	cf_options.table_factory = table_factories.at (profile_l);
 
 	// Number of files in level which triggers compaction. Size of L0 and L1 should be kept similar as this is the only compaction which is single threaded
 	cf_options.level0_file_num_compaction_trigger = 4;
@@ -543,12 +762,29 @@ rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options () const
 	// Number of memtables to keep in memory (1 active, rest inactive/immutable)
 	cf_options.max_write_buffer_number = rocksdb_config.num_memtables;
 
+	if (profile_l == table_profile::prefix)
+	{
+		// Pending keys start with the account, the filters also hold account prefixes and the memtable gets its own prefix bloom filter.
+		// Iterators use total order seek so they can still go past an account.
+		cf_options.prefix_extractor.reset (rocksdb::NewFixedPrefixTransform (sizeof (nano::account)));
+		cf_options.memtable_prefix_bloom_size_ratio = 0.02;
+	}
+	else if (profile_l == table_profile::fifo && rocksdb_config.fifo_max_size > 0)
+	{
+		// Only the newest files are kept, old entries are dropped with their file rather than compacted
+		cf_options.compaction_style = rocksdb::kCompactionStyleFIFO;
+		cf_options.compaction_options_fifo.max_table_files_size = rocksdb_config.fifo_max_size * 1024 * 1024ULL;
+		cf_options.compaction_options_fifo.allow_compaction = true;
+		cf_options.ttl = rocksdb_config.fifo_ttl * 60 * 60;
+		cf_options.level_compaction_dynamic_level_bytes = false;
+	}
+
 	return cf_options;
 }
 
 std::vector<nano::tables> nano::rocksdb_store::all_tables () const
 {
-	return std::vector<nano::tables>{ tables::accounts, tables::cached_counts, tables::change_blocks, tables::confirmation_height, tables::frontiers, tables::meta, tables::online_weight, tables::open_blocks, tables::peers, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::vote };
+	return std::vector<nano::tables>{ tables::accounts, tables::block_summaries, tables::cached_counts, tables::change_blocks, tables::confirmation_height, tables::frontiers, tables::meta, tables::online_weight, tables::open_blocks, tables::peers, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::vote };
 }
 
 bool nano::rocksdb_store::copy_db (boost::filesystem::path const & destination_path)
@@ -4,6 +4,7 @@
 #include <nano/lib/logger_mt.hpp>
 #include <nano/lib/numbers.hpp>
 #include <nano/node/rocksdb/rocksdb_iterator.hpp>
+#include <nano/node/rocksdb/rocksdb_txn.hpp>
 #include <nano/secure/blockstore_partial.hpp>
 #include <nano/secure/common.hpp>
 
@@ -39,6 +40,7 @@ public:
 
 	bool exists (nano::transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a) const;
 	int get (nano::transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, nano::rocksdb_val & value_a) const;
+	void get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::rocksdb_val> const & keys_a, std::vector<nano::rocksdb_val> & values_a) const;
 	int put (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, nano::rocksdb_val const & value_a);
 	int del (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a);
 
@@ -47,6 +49,43 @@ public:
 		// Do nothing
 	}
 
+	bool compaction_start () override
+	{
+		// RocksDB compacts in the background
+		return true;
+	}
+
+	bool compaction_pause (bool) override
+	{
+		return true;
+	}
+
+	void compaction_status (boost::property_tree::ptree &) override
+	{
+		// Do nothing
+	}
+
+	std::unique_ptr<nano::container_info_component> read_txn_pool_info (std::string const & name_a) override
+	{
+		// Read transactions are snapshots, which are cheap to take
+		return std::make_unique<nano::container_info_composite> (name_a);
+	}
+
+	void defer_sync_set (std::function<bool()> const &) override
+	{
+		// Do nothing, commits do not sync the write-ahead log
+	}
+
+	void sync () override
+	{
+		// Do nothing
+	}
+
+	void durability_status (boost::property_tree::ptree &) override
+	{
+		// Do nothing
+	}
+
 	std::shared_ptr<nano::block> block_get_v14 (nano::transaction const &, nano::block_hash const &, nano::block_sideband_v14 * = nullptr, bool * = nullptr) const override
 	{
 		// Should not be called as RocksDB has no such upgrade path
@@ -60,13 +99,19 @@ public:
 	template <typename Key, typename Value>
 	nano::store_iterator<Key, Value> make_iterator (nano::transaction const & transaction_a, tables table_a) const
 	{
-		return nano::store_iterator<Key, Value> (std::make_unique<nano::rocksdb_iterator<Key, Value>> (db, transaction_a, table_to_column_family (table_a)));
+		auto start (profile.start ());
+		auto result (std::make_unique<nano::rocksdb_iterator<Key, Value>> (db, transaction_a, table_to_column_family (table_a), write_batch));
+		result->profile_set (profile, table_a, start);
+		return nano::store_iterator<Key, Value> (std::move (result));
 	}
 
 	template <typename Key, typename Value>
 	nano::store_iterator<Key, Value> make_iterator (nano::transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key) const
 	{
-		return nano::store_iterator<Key, Value> (std::make_unique<nano::rocksdb_iterator<Key, Value>> (db, transaction_a, table_to_column_family (table_a), key));
+		auto start (profile.start ());
+		auto result (std::make_unique<nano::rocksdb_iterator<Key, Value>> (db, transaction_a, table_to_column_family (table_a), write_batch, key));
+		result->profile_set (profile, table_a, start);
+		return nano::store_iterator<Key, Value> (std::move (result));
 	}
 
 	bool init_error () const override;
@@ -78,10 +123,28 @@ private:
 	// Optimistic transactions are used in write mode
 	rocksdb::OptimisticTransactionDB * optimistic_db = nullptr;
 	rocksdb::DB * db = nullptr;
-	std::shared_ptr<rocksdb::TableFactory> table_factory;
+	/** Groups of tables sharing column family options */
+	enum class table_profile
+	{
+		point_lookup, // Accounts, blocks and confirmation height, mostly read by key
+		prefix, // Pending, also iterated by account
+		fifo, // Online weight, only recent entries matter
+		standard
+	};
+	static table_profile profile (std::string const & column_family_a);
+	// Block caches for tables read in normal operation and for the rest
+	std::shared_ptr<rocksdb::Cache> hot_block_cache;
+	std::shared_ptr<rocksdb::Cache> cold_block_cache;
+	std::unordered_map<table_profile, std::shared_ptr<rocksdb::TableFactory>> table_factories;
 	std::unordered_map<nano::tables, std::mutex> write_lock_mutexes;
+	// Writes go through indexed batches on a plain database instead of optimistic transactions
+	bool const write_batch;
+	// Counts of the tables caching them when writing batches, updated on commit and written with each batch
+	std::unordered_map<nano::tables, std::atomic<uint64_t>> batch_counts;
 
 	rocksdb::Transaction * tx (nano::transaction const & transaction_a) const;
+	nano::write_rocksdb_batch * batch (nano::transaction const & transaction_a) const;
+	void batch_counts_checkpoint (rocksdb::WriteBatchWithIndex &, nano::write_rocksdb_batch::count_deltas_t &);
 	std::vector<nano::tables> all_tables () const;
 
 	bool not_found (int status) const override;
@@ -98,10 +161,10 @@ private:
 
 	int increment (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, uint64_t amount_a);
 	int decrement (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, uint64_t amount_a);
-	rocksdb::ColumnFamilyOptions get_cf_options () const;
+	rocksdb::ColumnFamilyOptions get_cf_options (std::string const & column_family_a) const;
 	void construct_column_family_mutexes ();
 	rocksdb::Options get_db_options () const;
-	rocksdb::BlockBasedTableOptions get_table_options () const;
+	rocksdb::BlockBasedTableOptions get_table_options (table_profile profile_a) const;
 	nano::rocksdb_config rocksdb_config;
 };
 
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <nano/node/rocksdb/rocksdb_txn.hpp>
 #include <nano/secure/blockstore.hpp>
+#include <nano/secure/store_profile.hpp>
 
 #include <rocksdb/db.h>
 #include <rocksdb/filter_policy.h>
@@ -31,7 +33,7 @@ template <typename T, typename U>
 class rocksdb_iterator : public store_iterator_impl<T, U>
 {
 public:
-	rocksdb_iterator (rocksdb::DB * db, nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a)
+	rocksdb_iterator (rocksdb::DB * db, nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a, bool write_batch_a)
 	{
 		rocksdb::Iterator * iter;
 		if (is_read (transaction_a))
@@ -42,7 +44,8 @@ public:
 		{
 			rocksdb::ReadOptions ropts;
 			ropts.fill_cache = false;
-			iter = tx (transaction_a)->GetIterator (ropts, handle_a);
+			ropts.total_order_seek = true;
+			iter = write_iterator (db, transaction_a, handle_a, ropts, write_batch_a);
 		}
 
 		cursor.reset (iter);
@@ -61,7 +64,7 @@ public:
 
 	rocksdb_iterator () = default;
 
-	rocksdb_iterator (rocksdb::DB * db, nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a, rocksdb_val const & val_a)
+	rocksdb_iterator (rocksdb::DB * db, nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a, bool write_batch_a, rocksdb_val const & val_a)
 	{
 		rocksdb::Iterator * iter;
 		if (is_read (transaction_a))
@@ -70,7 +73,9 @@ public:
 		}
 		else
 		{
-			iter = tx (transaction_a)->GetIterator (rocksdb::ReadOptions (), handle_a);
+			rocksdb::ReadOptions ropts;
+			ropts.total_order_seek = true;
+			iter = write_iterator (db, transaction_a, handle_a, ropts, write_batch_a);
 		}
 
 		cursor.reset (iter);
@@ -92,12 +97,26 @@ public:
 		cursor = other_a.cursor;
 		other_a.cursor = nullptr;
 		current = other_a.current;
+		profile = other_a.profile;
+		table = other_a.table;
 	}
 
 	rocksdb_iterator (nano::rocksdb_iterator<T, U> const &) = delete;
 
+	/** Records the seek which positioned the iterator when profiling, and from then on every step */
+	void profile_set (nano::store_profile & profile_a, nano::tables table_a, std::chrono::steady_clock::time_point start_a)
+	{
+		if (start_a != std::chrono::steady_clock::time_point{})
+		{
+			profile = &profile_a;
+			table = table_a;
+			profile_a.record (table_a, nano::store_profile::operation::iterate, start_a, current.first.size () + current.second.size ());
+		}
+	}
+
 	nano::store_iterator_impl<T, U> & operator++ () override
 	{
+		auto start (profile != nullptr ? profile->start () : std::chrono::steady_clock::time_point{});
 		cursor->Next ();
 		if (cursor->Valid ())
 		{
@@ -113,6 +132,10 @@ public:
 		{
 			clear ();
 		}
+		if (profile != nullptr)
+		{
+			profile->record (table, nano::store_profile::operation::next, start, current.first.size () + current.second.size ());
+		}
 
 		return *this;
 	}
@@ -178,6 +201,8 @@ public:
 	{
 		cursor = std::move (other_a.cursor);
 		current = other_a.current;
+		profile = other_a.profile;
+		table = other_a.table;
 		return *this;
 	}
 	nano::store_iterator_impl<T, U> & operator= (nano::store_iterator_impl<T, U> const &) = delete;
@@ -186,9 +211,23 @@ public:
 	std::pair<nano::rocksdb_val, nano::rocksdb_val> current;
 
 private:
-	rocksdb::Transaction * tx (nano::transaction const & transaction_a) const
+	nano::store_profile * profile{ nullptr };
+	nano::tables table{ nano::tables::accounts };
+
+	/** Iterates the database with the changes of the write transaction on top */
+	rocksdb::Iterator * write_iterator (rocksdb::DB * db, nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a, rocksdb::ReadOptions const & options_a, bool write_batch_a) const
 	{
-		return static_cast<rocksdb::Transaction *> (transaction_a.get_handle ());
+		rocksdb::Iterator * result;
+		if (write_batch_a)
+		{
+			auto batch (static_cast<nano::write_rocksdb_batch *> (transaction_a.get_handle ()));
+			result = batch->batch.NewIteratorWithBase (handle_a, db->NewIterator (options_a, handle_a));
+		}
+		else
+		{
+			result = static_cast<rocksdb::Transaction *> (transaction_a.get_handle ())->GetIterator (options_a, handle_a);
+		}
+		return result;
 	}
 };
 }
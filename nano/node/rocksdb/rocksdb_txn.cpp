@@ -4,6 +4,8 @@ nano::read_rocksdb_txn::read_rocksdb_txn (rocksdb::DB * db_a) :
 db (db_a)
 {
 	options.snapshot = db_a->GetSnapshot ();
+	// Tables with a prefix extractor are still iterated past the end of a prefix
+	options.total_order_seek = true;
 }
 
 nano::read_rocksdb_txn::~read_rocksdb_txn ()
@@ -93,3 +95,64 @@ bool nano::write_rocksdb_txn::contains (nano::tables table_a) const
 {
 	return (std::find (tables_requiring_locks.begin (), tables_requiring_locks.end (), table_a) != tables_requiring_locks.end ()) || (std::find (tables_no_locks.begin (), tables_no_locks.end (), table_a) != tables_no_locks.end ());
 }
+
+nano::write_rocksdb_batch::write_rocksdb_batch (rocksdb::DB * db_a, std::vector<nano::tables> const & tables_requiring_locks_a, std::vector<nano::tables> const & tables_no_locks_a, std::unordered_map<nano::tables, std::mutex> & mutexes_a, std::function<void(rocksdb::WriteBatchWithIndex &, count_deltas_t &)> const & before_commit_a) :
+// Keys are overwritten in the index so iterators see each key once
+batch (rocksdb::BytewiseComparator (), 0, true),
+db (db_a),
+tables_requiring_locks (tables_requiring_locks_a),
+tables_no_locks (tables_no_locks_a),
+mutexes (mutexes_a),
+before_commit (before_commit_a)
+{
+	lock ();
+}
+
+nano::write_rocksdb_batch::~write_rocksdb_batch ()
+{
+	commit ();
+	unlock ();
+}
+
+void nano::write_rocksdb_batch::commit () const
+{
+	before_commit (batch, count_deltas);
+	if (batch.GetWriteBatch ()->Count () > 0)
+	{
+		auto status (db->Write (rocksdb::WriteOptions (), batch.GetWriteBatch ()));
+		release_assert (status.ok ());
+		batch.Clear ();
+	}
+}
+
+void nano::write_rocksdb_batch::renew ()
+{
+	// The batch is emptied on commit
+	debug_assert (batch.GetWriteBatch ()->Count () == 0);
+}
+
+void * nano::write_rocksdb_batch::get_handle () const
+{
+	return const_cast<nano::write_rocksdb_batch *> (this);
+}
+
+void nano::write_rocksdb_batch::lock ()
+{
+	for (auto table : tables_requiring_locks)
+	{
+		mutexes.at (table).lock ();
+	}
+}
+
+void nano::write_rocksdb_batch::unlock ()
+{
+	for (auto table : tables_requiring_locks)
+	{
+		mutexes.at (table).unlock ();
+	}
+}
+
+bool nano::write_rocksdb_batch::contains (nano::tables table_a) const
+{
+	return (std::find (tables_requiring_locks.begin (), tables_requiring_locks.end (), table_a) != tables_requiring_locks.end ()) || (std::find (tables_no_locks.begin (), tables_no_locks.end (), table_a) != tables_no_locks.end ());
+}
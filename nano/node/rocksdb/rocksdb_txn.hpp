@@ -8,6 +8,9 @@
 #include <rocksdb/slice.h>
 #include <rocksdb/utilities/optimistic_transaction_db.h>
 #include <rocksdb/utilities/transaction.h>
+#include <rocksdb/utilities/write_batch_with_index.h>
+
+#include <functional>
 
 namespace nano
 {
@@ -45,4 +48,34 @@ private:
 	void lock ();
 	void unlock ();
 };
+
+/**
+ * Write transaction collecting changes in an indexed batch written on commit, reads see the batch on top of the database.
+ * There is no conflict detection, writers are kept apart by the table locks and the write database queue.
+ */
+class write_rocksdb_batch final : public write_transaction_impl
+{
+public:
+	using count_deltas_t = std::unordered_map<nano::tables, int64_t>;
+	/** \p before_commit_a is called with the batch and count changes before the batch is written */
+	write_rocksdb_batch (rocksdb::DB * db_a, std::vector<nano::tables> const & tables_requiring_locks_a, std::vector<nano::tables> const & tables_no_locks_a, std::unordered_map<nano::tables, std::mutex> & mutexes_a, std::function<void(rocksdb::WriteBatchWithIndex &, count_deltas_t &)> const & before_commit_a);
+	~write_rocksdb_batch ();
+	void commit () const override;
+	void renew () override;
+	void * get_handle () const override;
+	bool contains (nano::tables table_a) const override;
+	mutable rocksdb::WriteBatchWithIndex batch;
+	/** Changes this batch makes to the entry counts of the tables caching them */
+	mutable count_deltas_t count_deltas;
+
+private:
+	rocksdb::DB * db;
+	std::vector<nano::tables> tables_requiring_locks;
+	std::vector<nano::tables> tables_no_locks;
+	std::unordered_map<nano::tables, std::mutex> & mutexes;
+	std::function<void(rocksdb::WriteBatchWithIndex &, count_deltas_t &)> before_commit;
+
+	void lock ();
+	void unlock ();
+};
 }
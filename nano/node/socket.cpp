@@ -133,11 +133,20 @@ void nano::socket::write_queued_messages ()
 	if (!closed)
 	{
 		std::weak_ptr<nano::socket> this_w (shared_from_this ());
-		auto msg (send_queue.front ());
+		// Gather queued buffers up to the byte budget in to a single write, the first buffer is always written
+		std::vector<nano::shared_const_buffer> buffers;
+		std::vector<boost::asio::const_buffer> sequence;
+		size_t bytes (0);
+		for (auto i (send_queue.begin ()), n (send_queue.end ()); i != n && (buffers.empty () || bytes + i->buffer.size () <= write_batch_bytes_max); ++i)
+		{
+			buffers.push_back (i->buffer);
+			sequence.insert (sequence.end (), i->buffer.begin (), i->buffer.end ());
+			bytes += i->buffer.size ();
+		}
 		start_timer ();
-		nano::async_write (tcp_socket, msg.buffer,
+		nano::unsafe_async_write (tcp_socket, sequence,
 		boost::asio::bind_executor (strand,
-		[msg, this_w](boost::system::error_code ec, std::size_t size_a) {
+		[buffers, this_w](boost::system::error_code ec, std::size_t size_a) {
 			if (auto this_l = this_w.lock ())
 			{
 				if (auto node = this_l->node.lock ())
@@ -148,12 +157,23 @@ void nano::socket::write_queued_messages ()
 
 					if (!this_l->closed)
 					{
-						if (msg.callback)
+						// Written items are removed before their callbacks run as a callback may close the socket, each is given the bytes written from its own buffer
+						std::vector<std::pair<std::function<void(boost::system::error_code const &, size_t)>, size_t>> completed;
+						auto remaining (size_a);
+						for (auto const & buffer : buffers)
 						{
-							msg.callback (ec, size_a);
+							auto written (std::min (remaining, buffer.size ()));
+							remaining -= written;
+							completed.emplace_back (std::move (this_l->send_queue.front ().callback), written);
+							this_l->send_queue.pop_front ();
+						}
+						for (auto const & item : completed)
+						{
+							if (item.first)
+							{
+								item.first (ec, item.second);
+							}
 						}
-
-						this_l->send_queue.pop_front ();
 						if (!ec && !this_l->send_queue.empty ())
 						{
 							this_l->write_queued_messages ();
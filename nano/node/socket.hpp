@@ -93,6 +93,8 @@ protected:
 	std::atomic<bool> timed_out{ false };
 	boost::optional<std::chrono::seconds> io_timeout;
 	size_t const queue_size_max = 128;
+	/** Queued buffers are combined in to a single write up to this many bytes */
+	size_t const write_batch_bytes_max = 64 * 1024;
 
 	/** Set by close() - completion handlers must check this. This is more reliable than checking
 	 error codes as the OS may have already completed the async operation. */
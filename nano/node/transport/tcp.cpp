@@ -261,10 +261,12 @@ nano::tcp_endpoint nano::transport::tcp_channels::bootstrap_peer (uint8_t connec
 
 void nano::transport::tcp_channels::process_messages ()
 {
+	std::vector<nano::tcp_message_item> items;
 	while (!stopped)
 	{
-		auto item (node.network.tcp_message_manager.get_message ());
-		if (item.message != nullptr)
+		items.clear ();
+		node.network.tcp_message_manager.get_messages (items, nano::transport::tcp_channels::process_batch_size);
+		for (auto const & item : items)
 		{
 			process_message (*item.message, item.endpoint, item.node_id, item.socket, item.type);
 		}
@@ -105,6 +105,8 @@ namespace transport
 		void start ();
 		void stop ();
 		void process_messages ();
+		// Realtime messages taken from the message manager at once by each processing thread
+		static size_t constexpr process_batch_size{ 64 };
 		void process_message (nano::message const &, nano::tcp_endpoint const &, nano::account const &, std::shared_ptr<nano::socket>, nano::bootstrap_server_type);
 		bool max_ip_connections (nano::tcp_endpoint const &);
 		// Should we reach out to this endpoint with a keepalive message
@@ -80,6 +80,17 @@ strand (node_a.io_ctx.get_executor ())
 			node.logger.try_log ("Unable to retrieve port: ", ec.message ());
 		}
 		local_endpoint = nano::endpoint (boost::asio::ip::address_v6::loopback (), port);
+		if (node.config.udp_batch_size > 1)
+		{
+			if (nano::transport::udp_batch_supported ())
+			{
+				batch_size = node.config.udp_batch_size;
+			}
+			else
+			{
+				node.logger.always_log ("UDP batching is not supported on this platform, datagrams are received and sent one at a time");
+			}
+		}
 	}
 	else
 	{
@@ -94,12 +105,70 @@ void nano::transport::udp_channels::send (nano::shared_const_buffer const & buff
 	[this, buffer_a, endpoint_a, callback_a]() {
 		if (!this->stopped)
 		{
-			this->socket->async_send_to (buffer_a, endpoint_a,
-			boost::asio::bind_executor (strand, callback_a));
+			if (this->batch_size > 1)
+			{
+				this->send_queue.push_back ({ buffer_a, endpoint_a, callback_a });
+				// Sends posted before the batch runs, such as the rest of a flood, join it
+				if (this->send_queue.size () == 1)
+				{
+					boost::asio::post (strand, [this]() {
+						this->send_batch ();
+					});
+				}
+			}
+			else
+			{
+				this->socket->async_send_to (buffer_a, endpoint_a,
+				boost::asio::bind_executor (strand, callback_a));
+			}
 		}
 	});
 }
 
+void nano::transport::udp_channels::send_batch ()
+{
+	std::vector<nano::transport::udp_send_item> items;
+	items.swap (send_queue);
+	size_t offset (0);
+	while (offset < items.size () && !stopped)
+	{
+		boost::system::error_code ec;
+		auto sent (nano::transport::udp_send_batch (*socket, items.data () + offset, std::min (items.size () - offset, batch_size), send_sizes, ec));
+		for (size_t i (0); i < sent; ++i)
+		{
+			if (items[offset + i].callback)
+			{
+				items[offset + i].callback (boost::system::error_code (), send_sizes[i]);
+			}
+		}
+		offset += sent;
+		if (sent == 0)
+		{
+			if (ec == boost::asio::error::would_block || ec == boost::asio::error::try_again)
+			{
+				// The socket send buffer is full, the rest are sent once it has room
+				for (; offset < items.size (); ++offset)
+				{
+					auto & item (items[offset]);
+					socket->async_send_to (item.buffer, item.endpoint, boost::asio::bind_executor (strand, item.callback));
+				}
+			}
+			else
+			{
+				// Only this datagram failed, for instance if its destination is unreachable
+				if (items[offset].callback)
+				{
+					items[offset].callback (ec, 0);
+				}
+				++offset;
+			}
+		}
+	}
+	// Keeps the allocated capacity, nothing can be queued while this runs on the strand
+	items.clear ();
+	send_queue.swap (items);
+}
+
 std::shared_ptr<nano::transport::channel_udp> nano::transport::udp_channels::insert (nano::endpoint const & endpoint_a, unsigned network_version_a)
 {
 	debug_assert (endpoint_a.address ().is_v6 ());
@@ -284,40 +353,90 @@ void nano::transport::udp_channels::receive ()
 			node.logger.try_log ("Receiving packet");
 		}
 
-		auto data (node.network.buffer_container.allocate ());
+		if (batch_size > 1)
+		{
+			receive_batch ();
+		}
+		else
+		{
+			auto data (node.network.buffer_container.allocate ());
 
-		socket->async_receive_from (boost::asio::buffer (data->buffer, nano::network::buffer_size), data->endpoint,
-		boost::asio::bind_executor (strand,
-		[this, data](boost::system::error_code const & error, std::size_t size_a) {
-			if (!error && !this->stopped)
-			{
-				data->size = size_a;
-				this->node.network.buffer_container.enqueue (data);
-				this->receive ();
-			}
-			else
-			{
-				this->node.network.buffer_container.release (data);
-				if (error)
+			socket->async_receive_from (boost::asio::buffer (data->buffer, nano::network::buffer_size), data->endpoint,
+			boost::asio::bind_executor (strand,
+			[this, data](boost::system::error_code const & error, std::size_t size_a) {
+				if (!error && !this->stopped)
+				{
+					data->size = size_a;
+					this->node.network.buffer_container.enqueue (data);
+					this->receive ();
+				}
+				else
 				{
-					if (this->node.config.logging.network_logging ())
+					this->node.network.buffer_container.release (data);
+					if (error)
+					{
+						if (this->node.config.logging.network_logging ())
+						{
+							this->node.logger.try_log (boost::str (boost::format ("UDP Receive error: %1%") % error.message ()));
+						}
+					}
+					if (!this->stopped)
 					{
-						this->node.logger.try_log (boost::str (boost::format ("UDP Receive error: %1%") % error.message ()));
+						this->node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [this]() { this->receive (); });
 					}
 				}
-				if (!this->stopped)
+			}));
+		}
+	}
+}
+
+void nano::transport::udp_channels::receive_batch ()
+{
+	socket->async_wait (boost::asio::ip::udp::socket::wait_read,
+	boost::asio::bind_executor (strand,
+	[this](boost::system::error_code const & error) {
+		auto retry (static_cast<bool> (error));
+		if (!error && !this->stopped)
+		{
+			std::vector<nano::message_buffer *> buffers;
+			buffers.reserve (batch_size);
+			this->node.network.buffer_container.allocate (buffers, batch_size);
+			if (!buffers.empty ())
+			{
+				boost::system::error_code ec;
+				auto count (nano::transport::udp_receive_batch (*this->socket, buffers, nano::network::buffer_size, ec));
+				std::vector<nano::message_buffer *> unused (buffers.begin () + count, buffers.end ());
+				buffers.resize (count);
+				this->node.network.buffer_container.enqueue (buffers);
+				this->node.network.buffer_container.release (unused);
+				retry = ec && ec != boost::asio::error::would_block && ec != boost::asio::error::try_again;
+				if (retry && this->node.config.logging.network_logging ())
+				{
+					this->node.logger.try_log (boost::str (boost::format ("UDP Receive error: %1%") % ec.message ()));
+				}
+				if (!retry)
 				{
-					this->node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [this]() { this->receive (); });
+					this->receive ();
 				}
 			}
-		}));
-	}
+		}
+		else if (error && this->node.config.logging.network_logging ())
+		{
+			this->node.logger.try_log (boost::str (boost::format ("UDP Receive error: %1%") % error.message ()));
+		}
+		if (retry && !this->stopped)
+		{
+			this->node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [this]() { this->receive (); });
+		}
+	}));
 }
 
 void nano::transport::udp_channels::start ()
 {
 	debug_assert (!node.flags.disable_udp);
-	for (size_t i = 0; i < node.config.io_threads && !stopped; ++i)
+	// A single batched receive drains the socket for every wakeup, more would only wake up to find it empty
+	auto receivers (batch_size > 1 ? 1 : node.config.io_threads);
+	for (size_t i = 0; i < receivers && !stopped; ++i)
 	{
 		boost::asio::post (strand, [this]() {
 			receive ();
@@ -544,7 +663,7 @@ void nano::transport::udp_channels::receive_action (nano::message_buffer * data_
 	if (allowed_sender)
 	{
 		udp_message_visitor visitor (node, data_a->endpoint);
-		nano::message_parser parser (node.network.publish_filter, node.block_uniquer, node.vote_uniquer, visitor, node.work, node.ledger.cache.epoch_2_started);
+		nano::message_parser parser (node.network.publish_filter, node.network.vote_filter, node.block_uniquer, node.vote_uniquer, visitor, node.work, node.ledger.cache.epoch_2_started);
 		parser.deserialize_buffer (data_a->buffer, data_a->size);
 		if (parser.status == nano::message_parser::parse_status::success)
 		{
@@ -554,6 +673,10 @@ void nano::transport::udp_channels::receive_action (nano::message_buffer * data_
 		{
 			node.stats.inc (nano::stat::type::filter, nano::stat::detail::duplicate_publish);
 		}
+		else if (parser.status == nano::message_parser::parse_status::duplicate_confirm_ack_message)
+		{
+			node.stats.inc (nano::stat::type::filter, nano::stat::detail::duplicate_confirm_ack);
+		}
 		else
 		{
 			node.stats.inc (nano::stat::type::error);
@@ -601,6 +724,7 @@ void nano::transport::udp_channels::receive_action (nano::message_buffer * data_
 					node.stats.inc (nano::stat::type::udp, nano::stat::detail::outdated_version);
 					break;
 				case nano::message_parser::parse_status::duplicate_publish_message:
+				case nano::message_parser::parse_status::duplicate_confirm_ack_message:
 				case nano::message_parser::parse_status::success:
 					/* Already checked, unreachable */
 					break;
@@ -2,6 +2,7 @@
 
 #include <nano/node/common.hpp>
 #include <nano/node/transport/transport.hpp>
+#include <nano/node/transport/udp_batch.hpp>
 
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
@@ -110,6 +111,10 @@ namespace transport
 
 	private:
 		void close_socket ();
+		/** Receives up to batch_size datagrams with one system call each time the socket becomes readable */
+		void receive_batch ();
+		/** Sends the queued datagrams with as few system calls as possible */
+		void send_batch ();
 		class endpoint_tag
 		{
 		};
@@ -205,6 +210,11 @@ namespace transport
 		std::unique_ptr<boost::asio::ip::udp::socket> socket;
 		nano::endpoint local_endpoint;
 		std::atomic<bool> stopped{ false };
+		/** Datagrams per system call, 0 if batching is disabled or not supported */
+		size_t batch_size{ 0 };
+		/** Sends waiting for the next batch, only accessed on the strand */
+		std::vector<nano::transport::udp_send_item> send_queue;
+		std::vector<size_t> send_sizes;
 	};
 } // namespace transport
 } // namespace nano
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <nano/lib/asio.hpp>
+#include <nano/node/common.hpp>
+
+#include <boost/asio/ip/udp.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace nano
+{
+class message_buffer;
+namespace transport
+{
+	class udp_send_item final
+	{
+	public:
+		nano::shared_const_buffer buffer;
+		nano::endpoint endpoint;
+		std::function<void(boost::system::error_code const &, size_t)> callback;
+	};
+	/**
+	 * Batched datagram system calls, recvmmsg and sendmmsg on Linux. Neither call blocks, on other platforms they fail with operation_not_supported.
+	 */
+	bool udp_batch_supported ();
+	/**
+	 * Receives up to one datagram into each buffer, setting its size and endpoint. Returns the number of buffers filled, which are
+	 * the first ones, or 0 with \p ec_a set. would_block is set if no datagram was waiting.
+	 */
+	size_t udp_receive_batch (boost::asio::ip::udp::socket &, std::vector<nano::message_buffer *> const &, size_t buffer_size_a, boost::system::error_code & ec_a);
+	/**
+	 * Sends up to \p count_a datagrams starting at \p items_a in order, stopping at the first one which fails. Returns the number sent and
+	 * writes their sizes to \p sizes_a, if none were sent \p ec_a holds the error of the first datagram.
+	 */
+	size_t udp_send_batch (boost::asio::ip::udp::socket &, nano::transport::udp_send_item const * items_a, size_t count_a, std::vector<size_t> & sizes_a, boost::system::error_code & ec_a);
+}
+}
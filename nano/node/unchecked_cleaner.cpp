@@ -0,0 +1,155 @@
+#include <nano/lib/stats.hpp>
+#include <nano/node/unchecked_cleaner.hpp>
+#include <nano/node/unchecked_map.hpp>
+#include <nano/node/write_database_queue.hpp>
+#include <nano/secure/blockstore.hpp>
+#include <nano/secure/network_filter.hpp>
+
+#include <boost/optional.hpp>
+
+#include <future>
+#include <limits>
+
+size_t constexpr nano::unchecked_cleaner::max_scan_keys;
+std::chrono::seconds constexpr nano::unchecked_cleaner::max_scan_duration;
+size_t constexpr nano::unchecked_cleaner::batch_max_keys;
+std::chrono::milliseconds constexpr nano::unchecked_cleaner::batch_max_duration;
+
+nano::unchecked_cleaner::unchecked_cleaner (nano::block_store & store_a, nano::unchecked_map & unchecked_a, nano::write_database_queue & write_database_queue_a, nano::network_filter & filter_a, nano::stat & stats_a, unsigned threads_a) :
+store (store_a),
+unchecked (unchecked_a),
+write_database_queue (write_database_queue_a),
+filter (filter_a),
+stats (stats_a),
+threads (std::max (1u, threads_a))
+{
+}
+
+uint64_t nano::unchecked_cleaner::run (uint64_t cutoff_a)
+{
+	auto start (std::chrono::steady_clock::now ());
+	std::vector<nano::uint128_t> digests;
+	for (auto const & block : unchecked.erase_older (cutoff_a))
+	{
+		digests.push_back (filter.hash (block));
+	}
+	if (unchecked.spilled () > 0)
+	{
+		nano::unchecked_key cursor;
+		{
+			auto transaction (store.tx_begin_read ());
+			if (store.unchecked_cleanup_cursor_get (transaction, cursor))
+			{
+				cursor = nano::unchecked_key ();
+			}
+		}
+		// Ranges split what is left of the key space after the cursor, the last one extends to the end of the table
+		nano::uint256_t first (cursor.previous.number ());
+		auto step ((std::numeric_limits<nano::uint256_t>::max () - first) / threads);
+		auto deadline (start + max_scan_duration);
+		std::vector<std::future<range_result>> results;
+		for (auto i (0u); i < threads; ++i)
+		{
+			auto begin (i == 0 ? cursor : nano::unchecked_key (nano::block_hash (first + step * i), 0));
+			nano::uint256_t end (first + step * (i + 1));
+			auto last (i + 1 == threads);
+			results.push_back (std::async (std::launch::async, [this, begin, end, last, cutoff_a, deadline]() {
+				return scan (begin, end, last, max_scan_keys / threads, cutoff_a, deadline);
+			}));
+		}
+		std::vector<nano::unchecked_key> keys;
+		// The cursor moves to where the first unfinished range stopped, later ranges are scanned again next run
+		boost::optional<nano::unchecked_key> next;
+		for (auto & result_future : results)
+		{
+			auto result (result_future.get ());
+			stats.add (nano::stat::type::unchecked, nano::stat::detail::cleanup_scanned, nano::stat::dir::in, result.scanned);
+			keys.insert (keys.end (), result.keys.begin (), result.keys.end ());
+			digests.insert (digests.end (), result.digests.begin (), result.digests.end ());
+			if (!result.finished && !next)
+			{
+				next = result.next;
+			}
+		}
+		if (!next)
+		{
+			stats.inc (nano::stat::type::unchecked, nano::stat::detail::cleanup_passes);
+		}
+		auto cursor_l (next.value_or (nano::unchecked_key ()));
+		erase (keys, cursor_l);
+		cursor_position = static_cast<uint64_t> (nano::uint256_t (cursor_l.previous.number () >> 192));
+	}
+	filter.clear (digests);
+	stats.add (nano::stat::type::unchecked, nano::stat::detail::cleanup_deleted, nano::stat::dir::in, digests.size ());
+	stats.add (nano::stat::type::unchecked, nano::stat::detail::cleanup_time_ms, nano::stat::dir::in, std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - start).count ());
+	return digests.size ();
+}
+
+double nano::unchecked_cleaner::progress () const
+{
+	return static_cast<double> (cursor_position.load ()) / std::numeric_limits<uint64_t>::max ();
+}
+
+nano::unchecked_cleaner::range_result nano::unchecked_cleaner::scan (nano::unchecked_key const & begin_a, nano::uint256_t const & end_a, bool last_a, size_t max_keys_a, uint64_t cutoff_a, std::chrono::steady_clock::time_point deadline_a)
+{
+	range_result result;
+	auto transaction (store.tx_begin_read ());
+	for (auto i (store.unchecked_begin (transaction, begin_a)), n (store.unchecked_end ()); i != n && (last_a || i->first.previous.number () < end_a); ++i)
+	{
+		nano::unchecked_key const & key (i->first);
+		if (result.keys.size () >= max_keys_a || std::chrono::steady_clock::now () >= deadline_a)
+		{
+			result.next = key;
+			result.finished = false;
+			break;
+		}
+		++result.scanned;
+		nano::unchecked_info const & info (i->second);
+		if (info.modified < cutoff_a)
+		{
+			result.keys.push_back (key);
+			result.digests.push_back (filter.hash (info.block));
+		}
+	}
+	return result;
+}
+
+void nano::unchecked_cleaner::erase (std::vector<nano::unchecked_key> const & keys_a, nano::unchecked_key const & cursor_a)
+{
+	auto i (keys_a.begin ());
+	auto n (keys_a.end ());
+	// The cursor is stored with the last batch so an interrupted run scans its keys again
+	do
+	{
+		auto scoped_write_guard = write_database_queue.wait (nano::writer::unchecked_cleanup);
+		auto transaction (store.tx_begin_write ({ tables::unchecked }, { tables::meta }));
+		auto batch_end (std::chrono::steady_clock::now () + batch_max_duration);
+		for (size_t count (0); i != n && count < batch_max_keys; ++i, ++count)
+		{
+			// Checked every few keys to keep the cost of polling low
+			if (count > 0 && count % 64 == 0)
+			{
+				if (writers_waiting ())
+				{
+					stats.inc (nano::stat::type::unchecked, nano::stat::detail::cleanup_yields);
+					break;
+				}
+				if (std::chrono::steady_clock::now () >= batch_end)
+				{
+					break;
+				}
+			}
+			unchecked.del (transaction, *i);
+		}
+		if (i == n)
+		{
+			store.unchecked_cleanup_cursor_put (transaction, cursor_a);
+		}
+		stats.inc (nano::stat::type::unchecked, nano::stat::detail::cleanup_batches);
+	} while (i != n);
+}
+
+bool nano::unchecked_cleaner::writers_waiting ()
+{
+	return write_database_queue.contains (nano::writer::process_batch) || write_database_queue.contains (nano::writer::confirmation_height);
+}
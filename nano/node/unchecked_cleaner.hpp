@@ -0,0 +1,60 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+#include <nano/secure/common.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace nano
+{
+class block_store;
+class network_filter;
+class stat;
+class unchecked_map;
+class write_database_queue;
+
+/**
+ * Removes unchecked entries modified before a cutoff. Entries in memory are swept directly, the unchecked table is scanned from a cursor
+ * kept in the meta table so each run resumes where the previous one stopped. The key space after the cursor is split by dependency hash
+ * into ranges scanned in parallel, each under its own read transaction. Expired keys are deleted in short write batches which end early
+ * when block processing or cementing is waiting on the write queue.
+ */
+class unchecked_cleaner final
+{
+public:
+	unchecked_cleaner (nano::block_store &, nano::unchecked_map &, nano::write_database_queue &, nano::network_filter &, nano::stat &, unsigned threads_a);
+	/** Deletes entries modified before \p cutoff_a seconds since epoch and clears them from the publish filter, returns how many were deleted */
+	uint64_t run (uint64_t cutoff_a);
+	/** Fraction of the table key space the current pass has gone through */
+	double progress () const;
+	static size_t constexpr max_scan_keys{ 1024 * 1024 };
+	static std::chrono::seconds constexpr max_scan_duration{ 120 };
+	static size_t constexpr batch_max_keys{ 2 * 1024 };
+	static std::chrono::milliseconds constexpr batch_max_duration{ 50 };
+
+private:
+	class range_result final
+	{
+	public:
+		std::vector<nano::unchecked_key> keys;
+		std::vector<nano::uint128_t> digests;
+		/** Where the scan stopped if it did not reach the end of its range */
+		nano::unchecked_key next;
+		bool finished{ true };
+		uint64_t scanned{ 0 };
+	};
+	range_result scan (nano::unchecked_key const & begin_a, nano::uint256_t const & end_a, bool last_a, size_t max_keys_a, uint64_t cutoff_a, std::chrono::steady_clock::time_point deadline_a);
+	void erase (std::vector<nano::unchecked_key> const &, nano::unchecked_key const & cursor_a);
+	bool writers_waiting ();
+	nano::block_store & store;
+	nano::unchecked_map & unchecked;
+	nano::write_database_queue & write_database_queue;
+	nano::network_filter & filter;
+	nano::stat & stats;
+	unsigned const threads;
+	/** Upper 64 bits of the cursor dependency, dependencies are hashes so this tracks progress through the key space */
+	std::atomic<uint64_t> cursor_position{ 0 };
+};
+}
@@ -0,0 +1,195 @@
+#include <nano/node/unchecked_map.hpp>
+#include <nano/secure/blockstore.hpp>
+
+#include <boost/tuple/tuple.hpp>
+
+#include <tuple>
+
+nano::unchecked_map::unchecked_map (nano::block_store & store_a, std::atomic<uint64_t> & count_a, size_t memory_budget_a, bool spill_a) :
+store (store_a),
+count_m (count_a),
+memory_budget (memory_budget_a),
+spill (spill_a),
+// Entries counted on start are left over in the table, the count is 0 if the ledger cache didn't include it
+spilled_m (count_a > 0 ? count_a.load () : store_a.unchecked_count (store_a.tx_begin_read ()))
+{
+}
+
+void nano::unchecked_map::put (nano::write_transaction const & transaction_a, nano::unchecked_key const & key_a, nano::unchecked_info const & info_a)
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	auto existing (entries.find (boost::make_tuple (key_a.previous, key_a.hash)));
+	if (existing != entries.end ())
+	{
+		memory -= existing->size;
+		entries.modify (existing, [&info_a](entry & entry_a) {
+			entry_a.info = info_a;
+			entry_a.size = entry_size (info_a);
+			entry_a.modified = info_a.modified;
+		});
+		memory += existing->size;
+	}
+	else if (spilled_m > 0 && store.unchecked_exists (transaction_a, key_a))
+	{
+		store.unchecked_put (transaction_a, key_a, info_a);
+	}
+	else
+	{
+		auto size (entry_size (info_a));
+		entries.insert (entry{ key_a.previous, key_a.hash, info_a, size, info_a.modified });
+		memory += size;
+		++count_m;
+	}
+	enforce_budget (transaction_a);
+}
+
+bool nano::unchecked_map::exists (nano::transaction const & transaction_a, nano::unchecked_key const & key_a)
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	return entries.find (boost::make_tuple (key_a.previous, key_a.hash)) != entries.end () || (spilled_m > 0 && store.unchecked_exists (transaction_a, key_a));
+}
+
+std::vector<nano::unchecked_info> nano::unchecked_map::get (nano::transaction const & transaction_a, nano::block_hash const & hash_a)
+{
+	std::vector<nano::unchecked_info> result;
+	nano::lock_guard<std::mutex> lock (mutex);
+	auto range (entries.equal_range (boost::make_tuple (hash_a)));
+	for (auto i (range.first); i != range.second; ++i)
+	{
+		result.push_back (i->info);
+	}
+	if (spilled_m > 0)
+	{
+		auto stored (store.unchecked_get (transaction_a, hash_a));
+		result.insert (result.end (), stored.begin (), stored.end ());
+	}
+	return result;
+}
+
+void nano::unchecked_map::del (nano::write_transaction const & transaction_a, nano::unchecked_key const & key_a)
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	auto existing (entries.find (boost::make_tuple (key_a.previous, key_a.hash)));
+	if (existing != entries.end ())
+	{
+		memory -= existing->size;
+		entries.erase (existing);
+		debug_assert (count_m > 0);
+		--count_m;
+	}
+	else if (spilled_m > 0 && store.unchecked_exists (transaction_a, key_a))
+	{
+		store.unchecked_del (transaction_a, key_a);
+		--spilled_m;
+		debug_assert (count_m > 0);
+		--count_m;
+	}
+}
+
+void nano::unchecked_map::clear (nano::write_transaction const & transaction_a)
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	entries.clear ();
+	memory = 0;
+	store.unchecked_clear (transaction_a);
+	spilled_m = 0;
+	count_m = 0;
+}
+
+size_t nano::unchecked_map::count (nano::transaction const & transaction_a)
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	return entries.size () + (spilled_m > 0 ? store.unchecked_count (transaction_a) : 0);
+}
+
+void nano::unchecked_map::for_each (nano::transaction const & transaction_a, nano::unchecked_key const & start_a, std::function<bool(nano::unchecked_key const &, nano::unchecked_info const &)> const & action_a)
+{
+	auto proceed (true);
+	nano::lock_guard<std::mutex> lock (mutex);
+	auto i (entries.lower_bound (boost::make_tuple (start_a.previous, start_a.hash)));
+	auto n (entries.end ());
+	auto j (spilled_m > 0 ? store.unchecked_begin (transaction_a, start_a) : store.unchecked_end ());
+	auto m (store.unchecked_end ());
+	// A key is either in memory or in the table, both are in the same key order
+	while (proceed && (i != n || j != m))
+	{
+		if (i != n && (j == m || std::tie (i->dependency, i->hash) < std::tie (j->first.previous, j->first.hash)))
+		{
+			proceed = action_a (nano::unchecked_key (i->dependency, i->hash), i->info);
+			++i;
+		}
+		else
+		{
+			proceed = action_a (j->first, j->second);
+			++j;
+		}
+	}
+}
+
+std::vector<std::shared_ptr<nano::block>> nano::unchecked_map::erase_older (uint64_t cutoff_a)
+{
+	std::vector<std::shared_ptr<nano::block>> result;
+	nano::lock_guard<std::mutex> lock (mutex);
+	auto & modified (entries.get<tag_modified> ());
+	for (auto i (modified.begin ()), n (modified.lower_bound (cutoff_a)); i != n;)
+	{
+		result.push_back (i->info.block);
+		memory -= i->size;
+		i = modified.erase (i);
+		debug_assert (count_m > 0);
+		--count_m;
+	}
+	return result;
+}
+
+uint64_t nano::unchecked_map::spilled () const
+{
+	return spilled_m;
+}
+
+size_t nano::unchecked_map::memory_size ()
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	return memory;
+}
+
+void nano::unchecked_map::enforce_budget (nano::write_transaction const & transaction_a)
+{
+	debug_assert (!mutex.try_lock ());
+	auto & sequence (entries.get<tag_sequence> ());
+	while (memory > memory_budget && !sequence.empty ())
+	{
+		auto const & oldest (sequence.front ());
+		if (spill)
+		{
+			store.unchecked_put (transaction_a, nano::unchecked_key (oldest.dependency, oldest.hash), oldest.info);
+			++spilled_m;
+		}
+		else
+		{
+			debug_assert (count_m > 0);
+			--count_m;
+		}
+		memory -= oldest.size;
+		sequence.pop_front ();
+	}
+}
+
+size_t nano::unchecked_map::entry_size (nano::unchecked_info const & info_a)
+{
+	// Approximate, container nodes and allocator overhead aren't counted
+	return sizeof (entry) + nano::block::size (info_a.block->type ());
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (unchecked_map & unchecked_map, std::string const & name)
+{
+	size_t entries_count;
+	{
+		nano::lock_guard<std::mutex> guard (unchecked_map.mutex);
+		entries_count = unchecked_map.entries.size ();
+	}
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "entries", entries_count, sizeof (decltype (unchecked_map.entries)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "memory", unchecked_map.memory_size (), 1 }));
+	return composite;
+}
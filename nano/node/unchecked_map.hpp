@@ -0,0 +1,90 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/secure/common.hpp>
+
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+namespace mi = boost::multi_index;
+
+namespace nano
+{
+class block_store;
+class transaction;
+class write_transaction;
+
+/**
+ * Blocks waiting for a dependency, kept in memory up to a budget instead of in the unchecked table.
+ * Over budget the oldest entries are moved to the table if spilling is enabled, otherwise they are dropped and will be requested again by bootstrap.
+ * The table is only read while it holds entries, which it does after spilling or when left over from a previous run.
+ * Keeps the ledger cache unchecked count up to date with entries in memory and in the table.
+ */
+class unchecked_map final
+{
+public:
+	unchecked_map (nano::block_store &, std::atomic<uint64_t> & count_a, size_t memory_budget_a, bool spill_a);
+	void put (nano::write_transaction const &, nano::unchecked_key const &, nano::unchecked_info const &);
+	bool exists (nano::transaction const &, nano::unchecked_key const &);
+	/** Entries depending on \p hash_a */
+	std::vector<nano::unchecked_info> get (nano::transaction const &, nano::block_hash const &);
+	void del (nano::write_transaction const &, nano::unchecked_key const &);
+	void clear (nano::write_transaction const &);
+	size_t count (nano::transaction const &);
+	/** Calls \p action_a in key order from \p start_a, merging entries in memory and in the table, until it returns false */
+	void for_each (nano::transaction const &, nano::unchecked_key const & start_a, std::function<bool(nano::unchecked_key const &, nano::unchecked_info const &)> const & action_a);
+	/** Removes entries in memory modified before \p cutoff_a seconds since epoch and returns their blocks, the table is left to the caller */
+	std::vector<std::shared_ptr<nano::block>> erase_older (uint64_t cutoff_a);
+	/** Number of entries in the table */
+	uint64_t spilled () const;
+	size_t memory_size ();
+
+private:
+	class entry final
+	{
+	public:
+		nano::block_hash dependency;
+		nano::block_hash hash;
+		nano::unchecked_info info;
+		size_t size;
+		// Copy of info.modified for the index
+		uint64_t modified;
+	};
+	void enforce_budget (nano::write_transaction const &);
+	static size_t entry_size (nano::unchecked_info const &);
+	nano::block_store & store;
+	std::atomic<uint64_t> & count_m;
+	size_t const memory_budget;
+	bool const spill;
+	size_t memory{ 0 };
+	std::atomic<uint64_t> spilled_m;
+	// clang-format off
+	class tag_key {};
+	class tag_sequence {};
+	class tag_modified {};
+	boost::multi_index_container<entry,
+	mi::indexed_by<
+		mi::ordered_unique<mi::tag<tag_key>,
+			mi::composite_key<entry,
+				mi::member<entry, nano::block_hash, &entry::dependency>,
+				mi::member<entry, nano::block_hash, &entry::hash>>>,
+		mi::sequenced<mi::tag<tag_sequence>>,
+		mi::ordered_non_unique<mi::tag<tag_modified>,
+			mi::member<entry, uint64_t, &entry::modified>>>>
+	entries;
+	// clang-format on
+	std::mutex mutex;
+
+	friend std::unique_ptr<nano::container_info_component> collect_container_info (unchecked_map &, std::string const &);
+};
+
+std::unique_ptr<nano::container_info_component> collect_container_info (unchecked_map & unchecked_map, std::string const & name);
+}
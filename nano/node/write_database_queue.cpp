@@ -50,12 +50,23 @@ void nano::write_guard::release ()
 }
 
 nano::write_database_queue::write_database_queue () :
-guard_finish_callback ([& queue = queue, &mutex = mutex, &cv = cv]() {
+guard_finish_callback ([this]() {
+	auto sync_l (false);
 	{
 		nano::lock_guard<std::mutex> guard (mutex);
 		queue.pop_front ();
+		// Deferred commits are synced here when nobody left in the queue is going to commit them
+		if (deferred && (queue.empty () || !groupable (queue.front ())))
+		{
+			deferred = false;
+			sync_l = true;
+		}
 	}
 	cv.notify_all ();
+	if (sync_l)
+	{
+		sync ();
+	}
 })
 {
 }
@@ -111,3 +122,41 @@ nano::write_guard nano::write_database_queue::pop ()
 {
 	return write_guard (guard_finish_callback);
 }
+
+void nano::write_database_queue::group_commit (std::chrono::milliseconds max_batch_latency_a, std::function<void()> sync_a)
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	max_batch_latency = max_batch_latency_a;
+	sync = sync_a;
+}
+
+bool nano::write_database_queue::defer_sync ()
+{
+	auto result (false);
+	nano::lock_guard<std::mutex> guard (mutex);
+	if (max_batch_latency.count () > 0)
+	{
+		auto now (std::chrono::steady_clock::now ());
+		if (queue.size () > 1 && groupable (queue[0]) && groupable (queue[1]) && (!deferred || now - deferred_since < max_batch_latency))
+		{
+			if (!deferred)
+			{
+				deferred = true;
+				deferred_since = now;
+			}
+			++deferred_syncs;
+			result = true;
+		}
+		else
+		{
+			// This commit syncs, covering the commits deferred before it
+			deferred = false;
+		}
+	}
+	return result;
+}
+
+bool nano::write_database_queue::groupable (nano::writer writer_a)
+{
+	return writer_a == nano::writer::process_batch || writer_a == nano::writer::confirmation_height;
+}
@@ -2,6 +2,8 @@
 
 #include <nano/lib/locks.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <functional>
@@ -14,6 +16,8 @@ enum class writer
 {
 	confirmation_height,
 	process_batch,
+	unchecked_cleanup,
+	block_summaries,
 	testing // Used in tests to emulate a write lock
 };
 
@@ -50,10 +54,27 @@ public:
 	/** Doesn't actually pop anything until the returned write_guard is out of scope */
 	write_guard pop ();
 
+	/**
+	 * Lets block processing and cementing share a sync to disk: a commit made while the other one is queued behind it skips syncing,
+	 * leaving it to the last commit of the group. \p sync_a is called when the group ends without a syncing commit.
+	 * The first deferred commit is synced at most \p max_batch_latency_a later, a zero latency disables grouping.
+	 */
+	void group_commit (std::chrono::milliseconds max_batch_latency_a, std::function<void()> sync_a);
+
+	/** Called on commit, returns true if the commit can skip syncing to disk */
+	bool defer_sync ();
+
+	std::atomic<uint64_t> deferred_syncs{ 0 };
+
 private:
+	static bool groupable (nano::writer);
 	std::deque<nano::writer> queue;
 	std::mutex mutex;
 	nano::condition_variable cv;
 	std::function<void()> guard_finish_callback;
+	std::chrono::milliseconds max_batch_latency{ 0 };
+	std::function<void()> sync;
+	bool deferred{ false };
+	std::chrono::steady_clock::time_point deferred_since;
 };
 }
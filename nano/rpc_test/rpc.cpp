@@ -7179,6 +7179,38 @@ TEST (rpc, stats_clear)
 	ASSERT_LE (node->stats.last_reset ().count (), 5);
 }
 
+TEST (rpc, stats_store)
+{
+	nano::system system;
+	auto node = add_ipc_enabled_node (system);
+	scoped_io_thread_name_change scoped_thread_name_io;
+	nano::node_rpc_config node_rpc_config;
+	nano::ipc::ipc_server ipc_server (*node, node_rpc_config);
+	nano::rpc_config rpc_config (nano::get_available_port (), true);
+	rpc_config.rpc_process.ipc_port = node->config.ipc_config.transport_tcp.port;
+	nano::ipc_rpc_processor ipc_rpc_processor (system.io_ctx, rpc_config);
+	nano::rpc rpc (system.io_ctx, rpc_config, ipc_rpc_processor);
+	rpc.start ();
+	node->store.profile_get ().enable (true);
+	{
+		auto transaction (node->store.tx_begin_read ());
+		nano::account_info info;
+		ASSERT_FALSE (node->store.account_get (transaction, nano::genesis_account, info));
+	}
+	boost::property_tree::ptree request;
+	request.put ("action", "stats");
+	request.put ("type", "store");
+	test_response response (request, rpc.config.port, system.io_ctx);
+	system.deadline_set (5s);
+	while (response.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response.status);
+	ASSERT_EQ ("true", response.json.get<std::string> ("enabled"));
+	ASSERT_LE (1, response.json.get<uint64_t> ("tables.accounts.get.count"));
+}
+
 TEST (rpc, unchecked)
 {
 	nano::system system;
@@ -7293,7 +7325,7 @@ TEST (rpc, unchecked_clear)
 	ASSERT_EQ (node.ledger.cache.unchecked_count, 1);
 	{
 		auto transaction = node.store.tx_begin_read ();
-		ASSERT_EQ (node.store.unchecked_count (transaction), 1);
+		ASSERT_EQ (node.unchecked.count (transaction), 1);
 	}
 	request.put ("action", "unchecked_clear");
 	test_response response (request, rpc.config.port, system.io_ctx);
@@ -7308,7 +7340,7 @@ TEST (rpc, unchecked_clear)
 	while (true)
 	{
 		auto transaction = node.store.tx_begin_read ();
-		if (node.store.unchecked_count (transaction) == 0)
+		if (node.unchecked.count (transaction) == 0)
 		{
 			break;
 		}
@@ -7902,6 +7934,98 @@ TEST (rpc, database_txn_tracker)
 	thread.join ();
 }
 
+TEST (rpc, database_compaction)
+{
+	// Don't test this in rocksdb mode
+	auto use_rocksdb_str = std::getenv ("TEST_USE_ROCKSDB");
+	if (use_rocksdb_str && boost::lexical_cast<int> (use_rocksdb_str) == 1)
+	{
+		return;
+	}
+
+	nano::system system;
+	auto node = add_ipc_enabled_node (system);
+	scoped_io_thread_name_change scoped_thread_name_io;
+	nano::node_rpc_config node_rpc_config;
+	nano::ipc::ipc_server ipc_server (*node, node_rpc_config);
+	nano::rpc_config rpc_config (nano::get_available_port (), true);
+	rpc_config.rpc_process.ipc_port = node->config.ipc_config.transport_tcp.port;
+	nano::ipc_rpc_processor ipc_rpc_processor (system.io_ctx, rpc_config);
+	nano::rpc rpc (system.io_ctx, rpc_config, ipc_rpc_processor);
+	rpc.start ();
+
+	boost::property_tree::ptree request;
+	auto send_request = [&system, &request, &rpc_port = rpc.config.port]() {
+		test_response response (request, rpc_port, system.io_ctx);
+		system.deadline_set (5s);
+		// Stops polling once the deadline passes, the status check then fails
+		while (response.status == 0 && !system.poll ())
+		{
+		}
+		EXPECT_EQ (200, response.status);
+		return response.json;
+	};
+
+	request.put ("action", "database_compaction");
+	ASSERT_EQ ("idle", send_request ().get<std::string> ("compaction.state"));
+
+	request.put ("command", "pause");
+	std::error_code ec_not_copying (nano::error_rpc::compaction_not_copying);
+	ASSERT_EQ (ec_not_copying.message (), send_request ().get<std::string> ("error"));
+
+	request.put ("command", "compact");
+	std::error_code ec_invalid (nano::error_rpc::invalid_compaction_command);
+	ASSERT_EQ (ec_invalid.message (), send_request ().get<std::string> ("error"));
+
+	request.put ("command", "start");
+	auto response (send_request ());
+	ASSERT_EQ (0, response.count ("error"));
+	request.put ("command", "status");
+	// Each request polls the system with its own deadline
+	auto deadline (std::chrono::steady_clock::now () + 10s);
+	// The copy replaces the database file while the node keeps running
+	while (send_request ().get<std::string> ("compaction.state") != "swapped")
+	{
+		ASSERT_LT (std::chrono::steady_clock::now (), deadline);
+	}
+	request.put ("command", "pause");
+	ASSERT_EQ (ec_not_copying.message (), send_request ().get<std::string> ("error"));
+	ASSERT_EQ (nano::genesis_hash, node->latest (nano::genesis_account));
+}
+
+TEST (rpc, database_durability)
+{
+	// Don't test this in rocksdb mode
+	auto use_rocksdb_str = std::getenv ("TEST_USE_ROCKSDB");
+	if (use_rocksdb_str && boost::lexical_cast<int> (use_rocksdb_str) == 1)
+	{
+		return;
+	}
+
+	nano::system system;
+	auto node = add_ipc_enabled_node (system);
+	scoped_io_thread_name_change scoped_thread_name_io;
+	nano::node_rpc_config node_rpc_config;
+	nano::ipc::ipc_server ipc_server (*node, node_rpc_config);
+	nano::rpc_config rpc_config (nano::get_available_port (), true);
+	rpc_config.rpc_process.ipc_port = node->config.ipc_config.transport_tcp.port;
+	nano::ipc_rpc_processor ipc_rpc_processor (system.io_ctx, rpc_config);
+	nano::rpc rpc (system.io_ctx, rpc_config, ipc_rpc_processor);
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "database_durability");
+	test_response response (request, rpc.config.port, system.io_ctx);
+	system.deadline_set (5s);
+	while (response.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response.status);
+	auto & durability (response.json.get_child ("durability"));
+	ASSERT_EQ (nano::lmdb_config::sync_strategy_string (node->config.lmdb_config.sync), durability.get<std::string> ("sync"));
+	ASSERT_NE (0, durability.get<uint64_t> ("last_txn_id"));
+}
+
 TEST (rpc, active_difficulty)
 {
 	nano::system system;
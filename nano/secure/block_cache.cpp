@@ -0,0 +1,165 @@
+#include <nano/lib/blocks.hpp>
+#include <nano/secure/block_cache.hpp>
+#include <nano/secure/blockstore.hpp>
+
+#include <algorithm>
+
+size_t constexpr nano::block_cache::shard_count;
+size_t constexpr nano::block_cache::recent_max;
+
+void nano::block_cache::capacity_set (size_t capacity_a)
+{
+	shard_capacity = capacity_a == 0 ? 0 : std::max<size_t> (capacity_a / shard_count, 1);
+	for (auto & shard : shards)
+	{
+		nano::lock_guard<std::mutex> guard (shard.mutex);
+		while (shard.entries.size () > shard_capacity)
+		{
+			shard.lookup.erase (shard.entries.back ().hash);
+			shard.entries.pop_back ();
+		}
+	}
+}
+
+uint64_t nano::block_cache::generation () const
+{
+	return generation_m;
+}
+
+std::shared_ptr<nano::block> nano::block_cache::get (nano::transaction const & transaction_a, nano::block_hash const & hash_a)
+{
+	std::shared_ptr<nano::block> result;
+	if (shard_capacity > 0)
+	{
+		auto & shard (shard_for (hash_a));
+		nano::lock_guard<std::mutex> guard (shard.mutex);
+		auto existing (shard.lookup.find (hash_a));
+		// Snapshots taken before the cached version was committed read the table instead
+		if (existing != shard.lookup.end () && existing->second->generation <= transaction_a.block_cache_generation ())
+		{
+			shard.entries.splice (shard.entries.begin (), shard.entries, existing->second);
+			result = existing->second->block;
+		}
+		if (result != nullptr)
+		{
+			++hits;
+		}
+		else
+		{
+			++misses;
+		}
+	}
+	return result;
+}
+
+void nano::block_cache::put (nano::transaction const & transaction_a, nano::block_hash const & hash_a, std::shared_ptr<nano::block> const & block_a)
+{
+	auto capacity_l (shard_capacity.load ());
+	if (capacity_l > 0)
+	{
+		auto & shard (shard_for (hash_a));
+		nano::lock_guard<std::mutex> guard (shard.mutex);
+		// Commits record the generation of their blocks before unmarking them, so checking both under the lock rejects versions read before a commit
+		auto generation_l (shard.committed_generation (hash_a));
+		if (generation_l <= transaction_a.block_cache_generation () && shard.uncommitted.count (hash_a) == 0 && shard.lookup.count (hash_a) == 0)
+		{
+			shard.entries.push_front ({ hash_a, block_a, generation_l });
+			shard.lookup.emplace (hash_a, shard.entries.begin ());
+			if (shard.entries.size () > capacity_l)
+			{
+				shard.lookup.erase (shard.entries.back ().hash);
+				shard.entries.pop_back ();
+			}
+		}
+	}
+}
+
+void nano::block_cache::modify (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a)
+{
+	{
+		nano::lock_guard<std::mutex> guard (modified_mutex);
+		modified[transaction_a.get_handle ()].push_back (hash_a);
+	}
+	auto & shard (shard_for (hash_a));
+	nano::lock_guard<std::mutex> guard (shard.mutex);
+	++shard.uncommitted[hash_a];
+	auto existing (shard.lookup.find (hash_a));
+	if (existing != shard.lookup.end ())
+	{
+		shard.entries.erase (existing->second);
+		shard.lookup.erase (existing);
+	}
+}
+
+void nano::block_cache::committed (void * handle_a)
+{
+	std::vector<nano::block_hash> hashes;
+	{
+		nano::lock_guard<std::mutex> guard (modified_mutex);
+		auto existing (modified.find (handle_a));
+		if (existing != modified.end ())
+		{
+			hashes.swap (existing->second);
+			modified.erase (existing);
+		}
+	}
+	if (!hashes.empty ())
+	{
+		auto generation_l (++generation_m);
+		for (auto const & hash : hashes)
+		{
+			auto & shard (shard_for (hash));
+			nano::lock_guard<std::mutex> guard (shard.mutex);
+			shard.recent.emplace_back (hash, generation_l);
+			shard.recent_lookup[hash] = generation_l;
+			if (shard.recent.size () > recent_max)
+			{
+				auto const & oldest (shard.recent.front ());
+				shard.recent_floor = std::max (shard.recent_floor, oldest.second);
+				auto existing (shard.recent_lookup.find (oldest.first));
+				if (existing->second == oldest.second)
+				{
+					shard.recent_lookup.erase (existing);
+				}
+				shard.recent.pop_front ();
+			}
+			auto existing (shard.uncommitted.find (hash));
+			debug_assert (existing != shard.uncommitted.end ());
+			if (--existing->second == 0)
+			{
+				shard.uncommitted.erase (existing);
+			}
+		}
+	}
+}
+
+size_t nano::block_cache::size ()
+{
+	size_t result (0);
+	for (auto & shard : shards)
+	{
+		nano::lock_guard<std::mutex> guard (shard.mutex);
+		result += shard.entries.size ();
+	}
+	return result;
+}
+
+uint64_t nano::block_cache::shard::committed_generation (nano::block_hash const & hash_a) const
+{
+	auto existing (recent_lookup.find (hash_a));
+	return existing != recent_lookup.end () ? existing->second : recent_floor;
+}
+
+nano::block_cache::shard & nano::block_cache::shard_for (nano::block_hash const & hash_a)
+{
+	return shards[hash_a.bytes[0] % shard_count];
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (block_cache & block_cache, std::string const & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "blocks", block_cache.size (), sizeof (decltype (block_cache.shards[0].entries)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "hits", block_cache.hits, 0 }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "misses", block_cache.misses, 0 }));
+	return composite;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+#include <nano/lib/utility.hpp>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace nano
+{
+class block;
+class transaction;
+class write_transaction;
+
+/**
+ * Bounded, sharded LRU of decoded blocks with their sideband, in front of the block tables.
+ * Every commit which wrote or deleted blocks bumps the generation and records it for each of those blocks.
+ * Entries remember the generation their version was committed at and are only served to transactions whose snapshot includes it,
+ * so a commit only makes the blocks it touched unavailable to older snapshots.
+ * Blocks written by a transaction are kept out of the cache until it commits.
+ * Returned blocks are shared between callers and must not be modified.
+ * @note This class is thread-safe.
+ */
+class block_cache final
+{
+public:
+	/** Sets the maximum number of blocks, 0 disables the cache */
+	void capacity_set (size_t);
+	/** Value to store in a transaction before its snapshot is taken */
+	uint64_t generation () const;
+	std::shared_ptr<nano::block> get (nano::transaction const &, nano::block_hash const &);
+	void put (nano::transaction const &, nano::block_hash const &, std::shared_ptr<nano::block> const &);
+	/** Drops a block written or deleted by \p transaction_a and keeps it out of the cache until the transaction commits */
+	void modify (nano::write_transaction const &, nano::block_hash const &);
+	/** Called after a write transaction committed, with the handle it had */
+	void committed (void * handle_a);
+	size_t size ();
+	std::atomic<uint64_t> hits{ 0 };
+	std::atomic<uint64_t> misses{ 0 };
+
+private:
+	class entry final
+	{
+	public:
+		nano::block_hash hash;
+		std::shared_ptr<nano::block> block;
+		// Generation the cached version was committed at, or an upper bound of it
+		uint64_t generation;
+	};
+	class shard final
+	{
+	public:
+		/** Generation the current version of \p hash_a was committed at, or an upper bound of it */
+		uint64_t committed_generation (nano::block_hash const & hash_a) const;
+		std::mutex mutex;
+		std::list<entry> entries;
+		std::unordered_map<nano::block_hash, decltype (entries)::iterator> lookup;
+		std::unordered_map<nano::block_hash, unsigned> uncommitted;
+		// Blocks of the latest commits with their generation, older commits are only known to be at or below the floor
+		std::deque<std::pair<nano::block_hash, uint64_t>> recent;
+		std::unordered_map<nano::block_hash, uint64_t> recent_lookup;
+		uint64_t recent_floor{ 0 };
+	};
+	static size_t constexpr shard_count{ 16 };
+	static size_t constexpr recent_max{ 4 * 1024 };
+	shard & shard_for (nano::block_hash const &);
+	std::array<shard, shard_count> shards;
+	std::atomic<size_t> shard_capacity{ 0 };
+	std::atomic<uint64_t> generation_m{ 0 };
+	std::mutex modified_mutex;
+	// Blocks written by each write transaction not yet committed, by transaction handle
+	std::unordered_map<void *, std::vector<nano::block_hash>> modified;
+
+	friend std::unique_ptr<nano::container_info_component> collect_container_info (block_cache &, std::string const &);
+};
+
+std::unique_ptr<nano::container_info_component> collect_container_info (block_cache & block_cache, std::string const & name);
+}
@@ -1,6 +1,9 @@
 #include <nano/lib/threading.hpp>
+#include <nano/secure/block_cache.hpp>
 #include <nano/secure/blockstore.hpp>
 
+#include <cstring>
+
 nano::summation_visitor::summation_visitor (nano::transaction const & transaction_a, nano::block_store const & store_a, bool is_v14_upgrade_a) :
 transaction (transaction_a),
 store (store_a),
@@ -256,9 +259,19 @@ void nano::representative_visitor::compute (nano::block_hash const & hash_a)
 	current = hash_a;
 	while (result.is_zero ())
 	{
-		auto block (store.block_get (transaction, current));
-		debug_assert (block != nullptr);
-		block->visit (*this);
+		// Only the type and previous are needed to find the representative block, no need to deserialize
+		auto view (store.block_view_get (transaction, current));
+		debug_assert (view.exists ());
+		switch (view.type ())
+		{
+			case nano::block_type::send:
+			case nano::block_type::receive:
+				current = view.previous ();
+				break;
+			default:
+				result = current;
+				break;
+		}
 	}
 }
 
@@ -287,6 +300,301 @@ void nano::representative_visitor::state_block (nano::state_block const & block_
 	result = block_a.hash ();
 }
 
+nano::block_view::block_view (nano::block_type type_a, uint8_t const * data_a, size_t size_a, std::shared_ptr<std::vector<uint8_t>> const & buffer_a) :
+type_m (type_a),
+data (data_a),
+size (size_a),
+buffer (buffer_a)
+{
+	debug_assert (size >= nano::block::size (type_m));
+}
+
+bool nano::block_view::exists () const
+{
+	return type_m != nano::block_type::invalid;
+}
+
+bool nano::block_view::has_sideband () const
+{
+	return exists () && size == nano::block::size (type_m) + nano::block_sideband::size (type_m);
+}
+
+nano::block_type nano::block_view::type () const
+{
+	return type_m;
+}
+
+template <typename T>
+T nano::block_view::read (size_t offset_a) const
+{
+	debug_assert (offset_a + sizeof (T) <= size);
+	T result;
+	std::memcpy (&result, data + offset_a, sizeof (T));
+	return result;
+}
+
+size_t nano::block_view::sideband_offset () const
+{
+	return nano::block::size (type_m);
+}
+
+nano::block_hash nano::block_view::previous () const
+{
+	nano::block_hash result (0);
+	switch (type_m)
+	{
+		case nano::block_type::send:
+		case nano::block_type::receive:
+		case nano::block_type::change:
+			result = read<nano::block_hash> (0);
+			break;
+		case nano::block_type::state:
+			result = read<nano::block_hash> (sizeof (nano::account));
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+
+nano::account nano::block_view::account () const
+{
+	nano::account result (0);
+	switch (type_m)
+	{
+		case nano::block_type::open:
+			result = read<nano::account> (sizeof (nano::block_hash) + sizeof (nano::account));
+			break;
+		case nano::block_type::state:
+			result = read<nano::account> (0);
+			break;
+		case nano::block_type::send:
+		case nano::block_type::receive:
+		case nano::block_type::change:
+			debug_assert (has_sideband ());
+			result = read<nano::account> (sideband_offset () + sizeof (nano::block_hash));
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+
+nano::amount nano::block_view::balance () const
+{
+	nano::amount result (0);
+	switch (type_m)
+	{
+		case nano::block_type::send:
+			result = read<nano::amount> (sizeof (nano::block_hash) + sizeof (nano::account));
+			break;
+		case nano::block_type::state:
+			result = read<nano::amount> (sizeof (nano::account) + sizeof (nano::block_hash) + sizeof (nano::account));
+			break;
+		case nano::block_type::open:
+			debug_assert (has_sideband ());
+			result = read<nano::amount> (sideband_offset () + sizeof (nano::block_hash));
+			break;
+		case nano::block_type::receive:
+		case nano::block_type::change:
+			debug_assert (has_sideband ());
+			result = read<nano::amount> (sideband_offset () + sizeof (nano::block_hash) + sizeof (nano::account) + sizeof (uint64_t));
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+
+nano::block_hash nano::block_view::source () const
+{
+	nano::block_hash result (0);
+	switch (type_m)
+	{
+		case nano::block_type::receive:
+			result = read<nano::block_hash> (sizeof (nano::block_hash));
+			break;
+		case nano::block_type::open:
+			result = read<nano::block_hash> (0);
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+
+nano::link nano::block_view::link () const
+{
+	nano::link result (0);
+	if (type_m == nano::block_type::state)
+	{
+		result = read<nano::link> (sizeof (nano::account) + sizeof (nano::block_hash) + sizeof (nano::account) + sizeof (nano::amount));
+	}
+	return result;
+}
+
+nano::account nano::block_view::representative () const
+{
+	nano::account result (0);
+	switch (type_m)
+	{
+		case nano::block_type::open:
+		case nano::block_type::change:
+			result = read<nano::account> (sizeof (nano::block_hash));
+			break;
+		case nano::block_type::state:
+			result = read<nano::account> (sizeof (nano::account) + sizeof (nano::block_hash));
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+
+nano::block_hash nano::block_view::successor () const
+{
+	debug_assert (has_sideband ());
+	return read<nano::block_hash> (sideband_offset ());
+}
+
+uint64_t nano::block_view::height () const
+{
+	debug_assert (has_sideband ());
+	uint64_t result (1);
+	switch (type_m)
+	{
+		case nano::block_type::state:
+			result = boost::endian::big_to_native (read<uint64_t> (sideband_offset () + sizeof (nano::block_hash)));
+			break;
+		case nano::block_type::send:
+		case nano::block_type::receive:
+		case nano::block_type::change:
+			result = boost::endian::big_to_native (read<uint64_t> (sideband_offset () + sizeof (nano::block_hash) + sizeof (nano::account)));
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+
+uint64_t nano::block_view::timestamp () const
+{
+	debug_assert (has_sideband ());
+	auto offset (sideband_offset () + sizeof (nano::block_hash));
+	if (type_m != nano::block_type::state && type_m != nano::block_type::open)
+	{
+		offset += sizeof (nano::account);
+	}
+	if (type_m != nano::block_type::open)
+	{
+		offset += sizeof (uint64_t);
+	}
+	if (type_m == nano::block_type::receive || type_m == nano::block_type::change || type_m == nano::block_type::open)
+	{
+		offset += sizeof (nano::amount);
+	}
+	return boost::endian::big_to_native (read<uint64_t> (offset));
+}
+
+nano::block_details nano::block_view::details () const
+{
+	nano::block_details result;
+	if (type_m == nano::block_type::state)
+	{
+		debug_assert (has_sideband ());
+		// Details follow the successor, height and timestamp of a state block sideband
+		auto offset (sideband_offset () + sizeof (nano::block_hash) + sizeof (uint64_t) + sizeof (uint64_t));
+		nano::bufferstream stream (data + offset, size - offset);
+		auto error (result.deserialize (stream));
+		(void)error;
+		debug_assert (!error);
+	}
+	return result;
+}
+
+void nano::block_view::serialize (nano::stream & stream_a) const
+{
+	debug_assert (exists ());
+	nano::write (stream_a, type_m);
+	auto amount_written (stream_a.sputn (data, nano::block::size (type_m)));
+	(void)amount_written;
+	debug_assert (amount_written == nano::block::size (type_m));
+}
+
+std::shared_ptr<nano::block> nano::block_view::block () const
+{
+	std::shared_ptr<nano::block> result;
+	if (exists ())
+	{
+		nano::bufferstream stream (data, size);
+		result = nano::deserialize_block (stream, type_m);
+		debug_assert (result != nullptr);
+		if (has_sideband ())
+		{
+			nano::block_sideband sideband;
+			auto error (sideband.deserialize (stream, type_m));
+			(void)error;
+			debug_assert (!error);
+			result->sideband_set (sideband);
+		}
+	}
+	return result;
+}
+
+nano::block_summary::block_summary (nano::block_view const & view_a) :
+account (view_a.account ()),
+height (view_a.height ()),
+balance (view_a.balance ()),
+successor (view_a.successor ()),
+details (view_a.details ())
+{
+	debug_assert (view_a.has_sideband ());
+}
+
+void nano::block_summary::serialize (nano::stream & stream_a) const
+{
+	nano::write (stream_a, account.bytes);
+	nano::write (stream_a, boost::endian::native_to_big (height));
+	nano::write (stream_a, balance.bytes);
+	nano::write (stream_a, successor.bytes);
+	details.serialize (stream_a);
+}
+
+bool nano::block_summary::deserialize (nano::stream & stream_a)
+{
+	bool result (false);
+	try
+	{
+		nano::read (stream_a, account.bytes);
+		nano::read (stream_a, height);
+		boost::endian::big_to_native_inplace (height);
+		nano::read (stream_a, balance.bytes);
+		nano::read (stream_a, successor.bytes);
+		result = details.deserialize (stream_a);
+	}
+	catch (std::runtime_error const &)
+	{
+		result = true;
+	}
+	return result;
+}
+
+bool nano::block_summary::operator== (nano::block_summary const & other_a) const
+{
+	return account == other_a.account && height == other_a.height && balance == other_a.balance && successor == other_a.successor && details == other_a.details;
+}
+
+void nano::transaction::block_cache_attach (nano::block_cache & block_cache_a, uint64_t generation_a)
+{
+	block_cache = &block_cache_a;
+	cache_generation = generation_a;
+}
+
+uint64_t nano::transaction::block_cache_generation () const
+{
+	return cache_generation;
+}
+
 nano::read_transaction::read_transaction (std::unique_ptr<nano::read_transaction_impl> read_transaction_impl) :
 impl (std::move (read_transaction_impl))
 {
@@ -304,6 +612,10 @@ void nano::read_transaction::reset () const
 
 void nano::read_transaction::renew () const
 {
+	if (block_cache != nullptr)
+	{
+		cache_generation = block_cache->generation ();
+	}
 	impl->renew ();
 }
 
@@ -327,14 +639,47 @@ void * nano::write_transaction::get_handle () const
 	return impl->get_handle ();
 }
 
+nano::write_transaction::~write_transaction ()
+{
+	// Moved from transactions have no implementation
+	if (impl != nullptr)
+	{
+		auto handle (impl->get_handle ());
+		impl.reset ();
+		if (block_cache != nullptr)
+		{
+			block_cache->committed (handle);
+		}
+	}
+}
+
 void nano::write_transaction::commit () const
 {
 	impl->commit ();
+	if (block_cache != nullptr)
+	{
+		block_cache->committed (impl->get_handle ());
+	}
 }
 
 void nano::write_transaction::renew ()
 {
+	// Other writers may commit while the lock is acquired unless it is exclusive, so the generation has to be taken before
+	if (block_cache != nullptr && !exclusive)
+	{
+		cache_generation = block_cache->generation ();
+	}
 	impl->renew ();
+	if (block_cache != nullptr && exclusive)
+	{
+		cache_generation = block_cache->generation ();
+	}
+}
+
+void nano::write_transaction::block_cache_attach_exclusive (nano::block_cache & block_cache_a)
+{
+	exclusive = true;
+	block_cache_attach (block_cache_a, block_cache_a.generation ());
 }
 
 bool nano::write_transaction::contains (nano::tables table_a) const
@@ -8,11 +8,13 @@
 #include <nano/lib/rocksdbconfig.hpp>
 #include <nano/secure/buffer.hpp>
 #include <nano/secure/common.hpp>
+#include <nano/secure/store_profile.hpp>
 #include <nano/secure/versioning.hpp>
 
 #include <boost/endian/conversion.hpp>
 #include <boost/polymorphic_cast.hpp>
 
+#include <limits>
 #include <stack>
 
 namespace nano
@@ -25,6 +27,70 @@ public:
 	nano::block_sideband sideband;
 };
 
+/**
+ * Read-only view of a block entry as stored in the database, fields are decoded from the stored bytes on access
+ * instead of deserializing the whole block. Points into memory owned by the database so it is only valid for the
+ * lifetime of the transaction it was read with.
+ */
+class block_view final
+{
+public:
+	block_view () = default;
+	block_view (nano::block_type, uint8_t const *, size_t, std::shared_ptr<std::vector<uint8_t>> const & = nullptr);
+	bool exists () const;
+	bool has_sideband () const;
+	nano::block_type type () const;
+	// Previous block in account's chain, zero for open block
+	nano::block_hash previous () const;
+	// Account field of the block or the sideband for legacy blocks without one
+	nano::account account () const;
+	// Balance field of the block or the sideband for legacy blocks without one
+	nano::amount balance () const;
+	// Source block for open/receive blocks, zero otherwise
+	nano::block_hash source () const;
+	// Link field for state blocks, zero otherwise
+	nano::link link () const;
+	// Representative field for open/change/state blocks, zero otherwise
+	nano::account representative () const;
+	nano::block_hash successor () const;
+	uint64_t height () const;
+	uint64_t timestamp () const;
+	nano::block_details details () const;
+	/** Writes the block in its network format, type followed by the block without sideband */
+	void serialize (nano::stream &) const;
+	/** Deserializes the full block including its sideband */
+	std::shared_ptr<nano::block> block () const;
+
+private:
+	template <typename T>
+	T read (size_t) const;
+	size_t sideband_offset () const;
+	nano::block_type type_m{ nano::block_type::invalid };
+	uint8_t const * data{ nullptr };
+	size_t size{ 0 };
+	// Keeps the value alive for backends that copy it out of the database
+	std::shared_ptr<std::vector<uint8_t>> buffer;
+};
+
+/**
+ * Fixed width copy of the sideband fields looked up most often, kept in its own table so they can be read without touching the block entry
+ */
+class block_summary final
+{
+public:
+	block_summary () = default;
+	explicit block_summary (nano::block_view const &);
+	void serialize (nano::stream &) const;
+	bool deserialize (nano::stream &);
+	bool operator== (nano::block_summary const &) const;
+	nano::account account{ 0 };
+	uint64_t height{ 0 };
+	nano::amount balance{ 0 };
+	nano::block_hash successor{ 0 };
+	nano::block_details details;
+	static size_t constexpr size{ sizeof (nano::account) + sizeof (uint64_t) + sizeof (nano::amount) + sizeof (nano::block_hash) + 1 };
+};
+
 /**
  * Encapsulates database specific container
  */
@@ -111,6 +177,16 @@ public:
 		convert_buffer_to_value ();
 	}
 
+	db_val (nano::block_summary const & val_a) :
+	buffer (std::make_shared<std::vector<uint8_t>> ())
+	{
+		{
+			nano::vectorstream stream (*buffer);
+			val_a.serialize (stream);
+		}
+		convert_buffer_to_value ();
+	}
+
 	db_val (nano::block_info const & val_a) :
 	db_val (sizeof (val_a), const_cast<nano::block_info *> (&val_a))
 	{
@@ -212,6 +288,16 @@ public:
 		return result;
 	}
 
+	explicit operator nano::block_summary () const
+	{
+		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
+		nano::block_summary result;
+		bool error (result.deserialize (stream));
+		(void)error;
+		debug_assert (!error);
+		return result;
+	}
+
 	explicit operator nano::unchecked_info () const
 	{
 		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
@@ -572,6 +658,7 @@ private:
 enum class tables
 {
 	accounts,
+	block_summaries,
 	blocks_info, // LMDB only
 	cached_counts, // RocksDB only
 	change_blocks,
@@ -612,11 +699,21 @@ public:
 	virtual bool contains (nano::tables table_a) const = 0;
 };
 
+class block_cache;
+
 class transaction
 {
 public:
 	virtual ~transaction () = default;
 	virtual void * get_handle () const = 0;
+	/** Lets \p block_cache_a serve reads, \p generation_a must have been taken from it before the snapshot started */
+	void block_cache_attach (nano::block_cache & block_cache_a, uint64_t generation_a);
+	uint64_t block_cache_generation () const;
+
+protected:
+	nano::block_cache * block_cache{ nullptr };
+	// Never matches the cache unless attached
+	mutable uint64_t cache_generation{ std::numeric_limits<uint64_t>::max () };
 };
 
 /**
@@ -644,13 +741,18 @@ class write_transaction final : public transaction
 {
 public:
 	explicit write_transaction (std::unique_ptr<nano::write_transaction_impl> write_transaction_impl);
+	write_transaction (write_transaction &&) = default;
+	~write_transaction ();
 	void * get_handle () const override;
 	void commit () const;
 	void renew ();
 	bool contains (nano::tables table_a) const;
+	/** Lets \p block_cache_a serve reads to a transaction holding a lock which excludes every other writer, the generation is taken after each time the lock is acquired */
+	void block_cache_attach_exclusive (nano::block_cache & block_cache_a);
 
 private:
 	std::unique_ptr<nano::write_transaction_impl> impl;
+	bool exclusive{ false };
 };
 
 class ledger_cache;
@@ -667,7 +769,20 @@ public:
 	virtual nano::block_hash block_successor (nano::transaction const &, nano::block_hash const &) const = 0;
 	virtual void block_successor_clear (nano::write_transaction const &, nano::block_hash const &) = 0;
 	virtual std::shared_ptr<nano::block> block_get (nano::transaction const &, nano::block_hash const &) const = 0;
+	/**
+	 * Batched lookups return one result per key in the order of the keys, empty for keys which weren't found.
+	 * Keys are read in sorted order so neighbouring lookups share pages, or in a single call on backends which support it.
+	 */
+	virtual std::vector<std::shared_ptr<nano::block>> blocks_get (nano::transaction const &, std::vector<nano::block_hash> const &) const = 0;
 	virtual std::shared_ptr<nano::block> block_get_no_sideband (nano::transaction const &, nano::block_hash const &) const = 0;
+	virtual nano::block_view block_view_get (nano::transaction const &, nano::block_hash const &) const = 0;
+	/** Reads the summary of a block without touching its entry, returns true if the block has not been summarized */
+	virtual bool block_summary_get (nano::transaction const &, nano::block_hash const &, nano::block_summary &) const = 0;
+	/**
+	 * Summarizes up to \p max_blocks_a blocks written before the summary table existed, resuming where the previous call stopped.
+	 * Blocks written since are summarized as they are put. Returns true once every block table has been walked.
+	 */
+	virtual bool block_summaries_build (nano::write_transaction const &, size_t max_blocks_a) = 0;
 	virtual std::shared_ptr<nano::block> block_get_v14 (nano::transaction const &, nano::block_hash const &, nano::block_sideband_v14 * = nullptr, bool * = nullptr) const = 0;
 	virtual std::shared_ptr<nano::block> block_random (nano::transaction const &) = 0;
 	virtual void block_del (nano::write_transaction const &, nano::block_hash const &, nano::block_type) = 0;
@@ -685,6 +800,7 @@ public:
 
 	virtual void account_put (nano::write_transaction const &, nano::account const &, nano::account_info const &) = 0;
 	virtual bool account_get (nano::transaction const &, nano::account const &, nano::account_info &) = 0;
+	virtual std::vector<boost::optional<nano::account_info>> accounts_get (nano::transaction const &, std::vector<nano::account> const &) = 0;
 	virtual void account_del (nano::write_transaction const &, nano::account const &) = 0;
 	virtual bool account_exists (nano::transaction const &, nano::account const &) = 0;
 	virtual size_t account_count (nano::transaction const &) = 0;
@@ -697,6 +813,7 @@ public:
 	virtual void pending_put (nano::write_transaction const &, nano::pending_key const &, nano::pending_info const &) = 0;
 	virtual void pending_del (nano::write_transaction const &, nano::pending_key const &) = 0;
 	virtual bool pending_get (nano::transaction const &, nano::pending_key const &, nano::pending_info &) = 0;
+	virtual std::vector<boost::optional<nano::pending_info>> pending_get_many (nano::transaction const &, std::vector<nano::pending_key> const &) = 0;
 	virtual bool pending_exists (nano::transaction const &, nano::pending_key const &) = 0;
 	virtual bool pending_any (nano::transaction const &, nano::account const &) = 0;
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const &, nano::pending_key const &) = 0;
@@ -742,6 +859,38 @@ public:
 	virtual void version_put (nano::write_transaction const &, int) = 0;
 	virtual int version_get (nano::transaction const &) const = 0;
 
+	virtual void rep_weights_checkpoint_put (nano::write_transaction const &, std::vector<uint8_t> const &) = 0;
+	/** Calls the action with the stored checkpoint, the data is only valid during the call. Returns true if there is no checkpoint */
+	virtual bool rep_weights_checkpoint_get (nano::transaction const &, std::function<void(uint8_t const *, size_t)> const &) const = 0;
+	virtual void rep_weights_checkpoint_del (nano::write_transaction const &) = 0;
+
+	/**
+	 * Builds the in-memory filters of block hashes and pending keys which let lookups of missing entries skip the database, replacing previous ones.
+	 * Lookups use the database until the first build completes. Returns true if \p stopped_a was set before the build completed.
+	 */
+	virtual bool membership_filters_build (std::atomic<bool> const & stopped_a) = 0;
+	/** True if the filters were not built yet or have more entries than they were sized for */
+	virtual bool membership_filters_stale () const = 0;
+	virtual size_t membership_filters_size () const = 0;
+	/** Stores the filters if they are built and not stale, they must only be stored when no more blocks or pending entries will be put */
+	virtual void membership_filters_checkpoint (nano::write_transaction const &) = 0;
+	/** Replaces the filters with stored ones written at the current block count and deletes those, returns true if there were none or they couldn't be used */
+	virtual bool membership_filters_checkpoint_load (nano::write_transaction const &) = 0;
+	virtual void membership_filters_checkpoint_del (nano::write_transaction const &) = 0;
+	/** Recently read blocks, disabled until given a capacity */
+	virtual nano::block_cache & block_cache_get () = 0;
+
+	/** Ledger cache counters which can't be read from table sizes, the cemented block count and whether epoch 2 has started */
+	virtual void cache_counters_put (nano::write_transaction const &, uint64_t, bool) = 0;
+	/** Returns true if no counters are stored */
+	virtual bool cache_counters_get (nano::transaction const &, uint64_t &, bool &) const = 0;
+	virtual void cache_counters_del (nano::write_transaction const &) = 0;
+
+	/** Unchecked key the cleanup of the unchecked table resumes from */
+	virtual void unchecked_cleanup_cursor_put (nano::write_transaction const &, nano::unchecked_key const &) = 0;
+	/** Returns true if no cursor is stored */
+	virtual bool unchecked_cleanup_cursor_get (nano::transaction const &, nano::unchecked_key &) const = 0;
+
 	virtual void peer_put (nano::write_transaction const & transaction_a, nano::endpoint_key const & endpoint_a) = 0;
 	virtual void peer_del (nano::write_transaction const & transaction_a, nano::endpoint_key const & endpoint_a) = 0;
 	virtual bool peer_exists (nano::transaction const & transaction_a, nano::endpoint_key const & endpoint_a) const = 0;
@@ -768,6 +917,15 @@ public:
 	/** Not applicable to all sub-classes */
 	virtual void serialize_mdb_tracker (boost::property_tree::ptree &, std::chrono::milliseconds, std::chrono::milliseconds) = 0;
 
+	/** Starts compacting the database into a copy which replaces it when the store is closed, returns true on error. Not applicable to all sub-classes */
+	virtual bool compaction_start () = 0;
+	/** Pauses or resumes copying, returns true if no copy is in progress */
+	virtual bool compaction_pause (bool) = 0;
+	virtual void compaction_status (boost::property_tree::ptree &) = 0;
+
+	/** Idle read transactions kept for reuse and how often readers were created or reused. Not applicable to all sub-classes */
+	virtual std::unique_ptr<nano::container_info_component> read_txn_pool_info (std::string const &) = 0;
+
 	virtual bool init_error () const = 0;
 
 	/** Start read-write transaction */
@@ -776,6 +934,18 @@ public:
 	/** Start read-only transaction */
 	virtual nano::read_transaction tx_begin_read () = 0;
 
+	/** Called on every write transaction commit, a commit skips syncing to disk when it returns true. Not applicable to all sub-classes */
+	virtual void defer_sync_set (std::function<bool()> const &) = 0;
+
+	/** Syncs commits which skipped syncing to disk */
+	virtual void sync () = 0;
+
+	/** Sync strategy and the last transaction known to be on disk. Not applicable to all sub-classes */
+	virtual void durability_status (boost::property_tree::ptree &) = 0;
+
+	/** Operation counts, latencies and bytes per table, only recorded while enabled */
+	virtual nano::store_profile & profile_get () = 0;
+
 	virtual std::string vendor_get () const = 0;
 };
 
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <nano/crypto/blake2/blake2.h>
 #include <nano/lib/rep_weights.hpp>
+#include <nano/secure/block_cache.hpp>
 #include <nano/secure/blockstore.hpp>
 #include <nano/secure/buffer.hpp>
+#include <nano/secure/membership_filter.hpp>
 
 #include <crypto/cryptopp/words.h>
 
+#include <array>
+
 namespace nano
 {
 template <typename Val, typename Derived_Store>
@@ -44,9 +49,22 @@ public:
 
 	nano::uint128_t block_balance (nano::transaction const & transaction_a, nano::block_hash const & hash_a) override
 	{
-		auto block (block_get (transaction_a, hash_a));
-		release_assert (block);
-		nano::uint128_t result (block_balance_calculated (block));
+		nano::uint128_t result;
+		nano::block_summary summary;
+		if (!block_summary_get (transaction_a, hash_a, summary))
+		{
+			return summary.balance.number ();
+		}
+		auto view (block_view_get (transaction_a, hash_a));
+		release_assert (view.exists ());
+		if (view.has_sideband ())
+		{
+			result = view.balance ().number ();
+		}
+		else
+		{
+			result = block_balance_calculated (block_get (transaction_a, hash_a));
+		}
 		return result;
 	}
 
@@ -74,6 +92,10 @@ public:
 
 	bool pending_exists (nano::transaction const & transaction_a, nano::pending_key const & key_a) override
 	{
+		if (!pending_filter.may_contain (key_a.hash))
+		{
+			return false;
+		}
 		auto iterator (pending_begin (transaction_a, key_a));
 		return iterator != pending_end () && nano::pending_key (iterator->first) == key_a;
 	}
@@ -121,38 +143,120 @@ public:
 	// Converts a block hash to a block height
 	uint64_t block_account_height (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
 	{
-		auto block = block_get (transaction_a, hash_a);
-		debug_assert (block != nullptr);
-		return block->sideband ().height;
+		nano::block_summary summary;
+		if (!block_summary_get (transaction_a, hash_a, summary))
+		{
+			return summary.height;
+		}
+		auto view (block_view_get (transaction_a, hash_a));
+		debug_assert (view.exists ());
+		return view.has_sideband () ? view.height () : 0;
 	}
 
 	std::shared_ptr<nano::block> block_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
 	{
-		nano::block_type type;
-		auto value (block_raw_get (transaction_a, hash_a, type));
-		std::shared_ptr<nano::block> result;
-		if (value.size () != 0)
+		auto result (block_cache.get (transaction_a, hash_a));
+		if (result == nullptr)
 		{
-			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
-			result = nano::deserialize_block (stream, type);
-			debug_assert (result != nullptr);
-			nano::block_sideband sideband;
-			if (full_sideband (transaction_a) || entry_has_sideband (value.size (), type))
+			nano::block_type type;
+			auto value (block_raw_get (transaction_a, hash_a, type));
+			if (value.size () != 0)
 			{
-				auto error (sideband.deserialize (stream, type));
-				(void)error;
-				debug_assert (!error);
+				nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+				result = nano::deserialize_block (stream, type);
+				debug_assert (result != nullptr);
+				nano::block_sideband sideband;
+				if (full_sideband (transaction_a) || entry_has_sideband (value.size (), type))
+				{
+					auto error (sideband.deserialize (stream, type));
+					(void)error;
+					debug_assert (!error);
+					result->sideband_set (sideband);
+					block_cache.put (transaction_a, hash_a, result);
+				}
+				else
+				{
+					// Reconstruct sideband data for block.
+					sideband.account = block_account_computed (transaction_a, hash_a);
+					sideband.balance = block_balance_computed (transaction_a, hash_a);
+					sideband.successor = block_successor (transaction_a, hash_a);
+					sideband.height = 0;
+					sideband.timestamp = 0;
+					result->sideband_set (sideband);
+				}
 			}
-			else
+		}
+		return result;
+	}
+
+	std::vector<std::shared_ptr<nano::block>> blocks_get (nano::transaction const & transaction_a, std::vector<nano::block_hash> const & hashes_a) const override
+	{
+		std::vector<std::shared_ptr<nano::block>> result (hashes_a.size ());
+		// Indices of hashes which haven't been found yet, each block table is searched for all of them at once
+		std::vector<size_t> remaining;
+		for (size_t i (0), n (hashes_a.size ()); i < n; ++i)
+		{
+			result[i] = block_cache.get (transaction_a, hashes_a[i]);
+			if (result[i] == nullptr && block_filter.may_contain (hashes_a[i]))
 			{
-				// Reconstruct sideband data for block.
-				sideband.account = block_account_computed (transaction_a, hash_a);
-				sideband.balance = block_balance_computed (transaction_a, hash_a);
-				sideband.successor = block_successor (transaction_a, hash_a);
-				sideband.height = 0;
-				sideband.timestamp = 0;
+				remaining.push_back (i);
 			}
-			result->sideband_set (sideband);
+		}
+		// Table lookups are ordered by match probability
+		nano::block_type block_types[]{ nano::block_type::state, nano::block_type::send, nano::block_type::receive, nano::block_type::open, nano::block_type::change };
+		std::vector<nano::db_val<Val>> keys;
+		std::vector<nano::db_val<Val>> values;
+		for (auto type : block_types)
+		{
+			if (remaining.empty ())
+			{
+				break;
+			}
+			keys.clear ();
+			for (auto index : remaining)
+			{
+				keys.emplace_back (hashes_a[index]);
+			}
+			get_many (transaction_a, block_database (type), keys, values);
+			std::vector<size_t> missing;
+			for (size_t i (0), n (remaining.size ()); i < n; ++i)
+			{
+				auto index (remaining[i]);
+				if (values[i].size () == 0)
+				{
+					missing.push_back (index);
+				}
+				else if (entry_has_sideband (values[i].size (), type))
+				{
+					nano::bufferstream stream (reinterpret_cast<uint8_t const *> (values[i].data ()), values[i].size ());
+					result[index] = nano::deserialize_block (stream, type);
+					debug_assert (result[index] != nullptr);
+					nano::block_sideband sideband;
+					auto error (sideband.deserialize (stream, type));
+					(void)error;
+					debug_assert (!error);
+					result[index]->sideband_set (sideband);
+					block_cache.put (transaction_a, hashes_a[index], result[index]);
+				}
+				else
+				{
+					// Entries from before the sideband existed need it reconstructed
+					result[index] = block_get (transaction_a, hashes_a[index]);
+				}
+			}
+			remaining.swap (missing);
+		}
+		return result;
+	}
+
+	nano::block_view block_view_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
+	{
+		nano::block_type type;
+		auto value (block_raw_get (transaction_a, hash_a, type));
+		nano::block_view result;
+		if (value.size () != 0)
+		{
+			result = nano::block_view (type, reinterpret_cast<uint8_t const *> (value.data ()), value.size (), value.buffer);
 		}
 		return result;
 	}
@@ -173,6 +277,10 @@ public:
 
 	bool block_exists (nano::transaction const & transaction_a, nano::block_type type, nano::block_hash const & hash_a) override
 	{
+		if (!block_filter.may_contain (hash_a))
+		{
+			return false;
+		}
 		auto junk = block_raw_get_by_type (transaction_a, hash_a, type);
 		return junk.is_initialized ();
 	}
@@ -182,11 +290,12 @@ public:
 		// Table lookups are ordered by match probability
 		// clang-format off
 		return
+			block_filter.may_contain (hash_a) && (
 			block_exists (tx_a, nano::block_type::state, hash_a) ||
 			block_exists (tx_a, nano::block_type::send, hash_a) ||
 			block_exists (tx_a, nano::block_type::receive, hash_a) ||
 			block_exists (tx_a, nano::block_type::open, hash_a) ||
-			block_exists (tx_a, nano::block_type::change, hash_a);
+			block_exists (tx_a, nano::block_type::change, hash_a));
 		// clang-format on
 	}
 
@@ -202,9 +311,26 @@ public:
 
 	nano::account block_account (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
 	{
-		auto block (block_get (transaction_a, hash_a));
-		debug_assert (block != nullptr);
-		return block_account_calculated (*block);
+		nano::account result;
+		nano::block_summary summary;
+		if (!block_summary_get (transaction_a, hash_a, summary))
+		{
+			return summary.account;
+		}
+		auto view (block_view_get (transaction_a, hash_a));
+		debug_assert (view.exists ());
+		if (view.has_sideband ())
+		{
+			result = view.account ();
+		}
+		else
+		{
+			auto block (block_get (transaction_a, hash_a));
+			debug_assert (block != nullptr);
+			result = block_account_calculated (*block);
+		}
+		debug_assert (!result.is_zero ());
+		return result;
 	}
 
 	nano::account block_account_calculated (nano::block const & block_a) const override
@@ -245,6 +371,11 @@ public:
 
 	nano::block_hash block_successor (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
 	{
+		nano::block_summary summary;
+		if (!block_summary_get (transaction_a, hash_a, summary))
+		{
+			return summary.successor;
+		}
 		nano::block_type type;
 		auto value (block_raw_get (transaction_a, hash_a, type));
 		nano::block_hash result;
@@ -409,6 +540,12 @@ public:
 
 		auto status = del (transaction_a, table, hash_a);
 		release_assert (success (status));
+		if (summaries_enabled && exists (transaction_a, tables::block_summaries, nano::db_val<Val> (hash_a)))
+		{
+			auto summary_status (del (transaction_a, tables::block_summaries, hash_a));
+			release_assert (success (summary_status));
+		}
+		block_cache.modify (transaction_a, hash_a);
 	}
 
 	int version_get (nano::transaction const & transaction_a) const override
@@ -426,13 +563,228 @@ public:
 		return result;
 	}
 
-	nano::epoch block_version (nano::transaction const & transaction_a, nano::block_hash const & hash_a) override
+	void rep_weights_checkpoint_put (nano::write_transaction const & transaction_a, std::vector<uint8_t> const & data_a) override
+	{
+		nano::uint256_union checkpoint_key (rep_weights_checkpoint_key);
+		nano::db_val<Val> value{ data_a.size (), (void *)data_a.data () };
+		auto status (put (transaction_a, tables::meta, nano::db_val<Val> (checkpoint_key), value));
+		release_assert (success (status));
+	}
+
+	bool rep_weights_checkpoint_get (nano::transaction const & transaction_a, std::function<void(uint8_t const *, size_t)> const & action_a) const override
+	{
+		nano::uint256_union checkpoint_key (rep_weights_checkpoint_key);
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::meta, nano::db_val<Val> (checkpoint_key), value));
+		auto result (not_found (status));
+		if (!result)
+		{
+			action_a (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+		}
+		return result;
+	}
+
+	void rep_weights_checkpoint_del (nano::write_transaction const & transaction_a) override
+	{
+		nano::uint256_union checkpoint_key (rep_weights_checkpoint_key);
+		auto status (del (transaction_a, tables::meta, nano::db_val<Val> (checkpoint_key)));
+		release_assert (success (status));
+	}
+
+	bool membership_filters_build (std::atomic<bool> const & stopped_a) override
+	{
+		size_t block_capacity;
+		size_t pending_capacity (0);
+		{
+			auto transaction (tx_begin_read ());
+			block_capacity = block_count (transaction).sum ();
+			for (auto i (pending_begin (transaction)), n (pending_end ()); i != n && !stopped_a; ++i)
+			{
+				++pending_capacity;
+			}
+		}
+		// Leave room for growth before the filters need another rebuild
+		block_filter.rebuild_begin (block_capacity + block_capacity / 2 + membership_filter_headroom);
+		pending_filter.rebuild_begin (pending_capacity + pending_capacity / 2 + membership_filter_headroom);
+		{
+			// Writers which started before the new filters were installed may have put keys the filters haven't seen, wait for them to commit
+			auto transaction (tx_begin_write ({ tables::change_blocks, tables::open_blocks, tables::pending, tables::receive_blocks, tables::send_blocks, tables::state_blocks }));
+		}
+		auto transaction (tx_begin_read ());
+		nano::tables block_tables[]{ tables::state_blocks, tables::send_blocks, tables::receive_blocks, tables::open_blocks, tables::change_blocks };
+		for (auto table : block_tables)
+		{
+			for (auto i (make_iterator<nano::block_hash, nano::no_value> (transaction, table)), n (nano::store_iterator<nano::block_hash, nano::no_value> (nullptr)); i != n && !stopped_a; ++i)
+			{
+				block_filter.rebuild_insert (i->first);
+			}
+		}
+		for (auto i (pending_begin (transaction)), n (pending_end ()); i != n && !stopped_a; ++i)
+		{
+			pending_filter.rebuild_insert (i->first.hash);
+		}
+		if (!stopped_a)
+		{
+			block_filter.rebuild_end ();
+			pending_filter.rebuild_end ();
+		}
+		else
+		{
+			block_filter.rebuild_abort ();
+			pending_filter.rebuild_abort ();
+		}
+		return stopped_a;
+	}
+
+	bool membership_filters_stale () const override
+	{
+		return block_filter.stale () || pending_filter.stale ();
+	}
+
+	size_t membership_filters_size () const override
+	{
+		return block_filter.size () + pending_filter.size ();
+	}
+
+	/*
+	 * Layout, integers are big endian:
+	 * block count (8) | block filter | pending filter | blake2b checksum of the preceding bytes (32)
+	 */
+	void membership_filters_checkpoint (nano::write_transaction const & transaction_a) override
+	{
+		if (!membership_filters_stale ())
+		{
+			std::vector<uint8_t> data;
+			{
+				nano::vectorstream stream (data);
+				nano::write (stream, boost::endian::native_to_big (block_count (transaction_a).sum ()));
+				block_filter.serialize (stream);
+				pending_filter.serialize (stream);
+			}
+			auto checksum (membership_filters_checksum (data.data (), data.size ()));
+			data.insert (data.end (), checksum.bytes.begin (), checksum.bytes.end ());
+			nano::uint256_union filters_key (membership_filters_key);
+			nano::db_val<Val> value{ data.size (), (void *)data.data () };
+			auto status (put (transaction_a, tables::meta, nano::db_val<Val> (filters_key), value));
+			release_assert (success (status));
+		}
+	}
+
+	bool membership_filters_checkpoint_load (nano::write_transaction const & transaction_a) override
+	{
+		nano::uint256_union filters_key (membership_filters_key);
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::meta, nano::db_val<Val> (filters_key), value));
+		auto result (not_found (status));
+		if (!result)
+		{
+			nano::block_hash checksum;
+			result = value.size () < sizeof (uint64_t) + sizeof (checksum);
+			if (!result)
+			{
+				auto data (reinterpret_cast<uint8_t const *> (value.data ()));
+				auto content_size (value.size () - sizeof (checksum));
+				std::copy (data + content_size, data + value.size (), checksum.bytes.begin ());
+				nano::bufferstream stream (data, content_size);
+				uint64_t block_count_l;
+				result = nano::try_read (stream, block_count_l) || boost::endian::big_to_native (block_count_l) != block_count (transaction_a).sum () || membership_filters_checksum (data, content_size) != checksum || block_filter.deserialize (stream) || pending_filter.deserialize (stream);
+			}
+			// Puts from here on aren't in the stored filters, they are written again on a clean shutdown
+			membership_filters_checkpoint_del (transaction_a);
+		}
+		return result;
+	}
+
+	void membership_filters_checkpoint_del (nano::write_transaction const & transaction_a) override
+	{
+		nano::uint256_union filters_key (membership_filters_key);
+		if (exists (transaction_a, tables::meta, nano::db_val<Val> (filters_key)))
+		{
+			auto status (del (transaction_a, tables::meta, nano::db_val<Val> (filters_key)));
+			release_assert (success (status));
+		}
+	}
+
+	nano::block_cache & block_cache_get () override
+	{
+		return block_cache;
+	}
+
+	nano::store_profile & profile_get () override
+	{
+		return profile;
+	}
+
+	void cache_counters_put (nano::write_transaction const & transaction_a, uint64_t cemented_count_a, bool epoch_2_started_a) override
+	{
+		nano::uint256_union counters_key (cache_counters_key);
+		std::vector<uint8_t> data;
+		{
+			nano::vectorstream stream (data);
+			nano::write (stream, boost::endian::native_to_big (cemented_count_a));
+			nano::write (stream, static_cast<uint8_t> (epoch_2_started_a));
+		}
+		nano::db_val<Val> value{ data.size (), data.data () };
+		auto status (put (transaction_a, tables::meta, nano::db_val<Val> (counters_key), value));
+		release_assert (success (status));
+	}
+
+	bool cache_counters_get (nano::transaction const & transaction_a, uint64_t & cemented_count_a, bool & epoch_2_started_a) const override
 	{
+		nano::uint256_union counters_key (cache_counters_key);
 		nano::db_val<Val> value;
-		auto block = block_get (transaction_a, hash_a);
-		if (block && block->type () == nano::block_type::state)
+		auto status (get (transaction_a, tables::meta, nano::db_val<Val> (counters_key), value));
+		auto result (not_found (status));
+		if (!result)
 		{
-			return block->sideband ().details.epoch;
+			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+			uint8_t epoch_2_started_l;
+			result = nano::try_read (stream, cemented_count_a) || nano::try_read (stream, epoch_2_started_l);
+			boost::endian::big_to_native_inplace (cemented_count_a);
+			epoch_2_started_a = epoch_2_started_l != 0;
+		}
+		return result;
+	}
+
+	void cache_counters_del (nano::write_transaction const & transaction_a) override
+	{
+		nano::uint256_union counters_key (cache_counters_key);
+		auto status (del (transaction_a, tables::meta, nano::db_val<Val> (counters_key)));
+		release_assert (success (status) || not_found (status));
+	}
+
+	void unchecked_cleanup_cursor_put (nano::write_transaction const & transaction_a, nano::unchecked_key const & cursor_a) override
+	{
+		nano::uint256_union cursor_key (unchecked_cleanup_cursor_key);
+		auto status (put (transaction_a, tables::meta, nano::db_val<Val> (cursor_key), nano::db_val<Val> (cursor_a)));
+		release_assert (success (status));
+	}
+
+	bool unchecked_cleanup_cursor_get (nano::transaction const & transaction_a, nano::unchecked_key & cursor_a) const override
+	{
+		nano::uint256_union cursor_key (unchecked_cleanup_cursor_key);
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::meta, nano::db_val<Val> (cursor_key), value));
+		auto result (not_found (status) || value.size () != sizeof (nano::unchecked_key));
+		if (!result)
+		{
+			cursor_a = static_cast<nano::unchecked_key> (value);
+		}
+		return result;
+	}
+
+	nano::epoch block_version (nano::transaction const & transaction_a, nano::block_hash const & hash_a) override
+	{
+		nano::block_summary summary;
+		if (!block_summary_get (transaction_a, hash_a, summary))
+		{
+			// Legacy blocks are summarized with default details, which are epoch 0
+			return summary.details.epoch;
+		}
+		auto view (block_view_get (transaction_a, hash_a));
+		if (view.type () == nano::block_type::state && view.has_sideband ())
+		{
+			return view.details ().epoch;
 		}
 
 		return nano::epoch::epoch_0;
@@ -444,6 +796,59 @@ public:
 		nano::db_val<Val> value{ data.size (), (void *)data.data () };
 		auto status = put (transaction_a, database_a, hash_a, value);
 		release_assert (success (status));
+		block_summary_put (transaction_a, hash_a, nano::block_view (block_type_a, data.data (), data.size ()));
+		block_filter.insert (hash_a);
+		block_cache.modify (transaction_a, hash_a);
+	}
+
+	bool block_summary_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_summary & summary_a) const override
+	{
+		auto result (true);
+		if (summaries_enabled)
+		{
+			nano::db_val<Val> value;
+			auto status (get (transaction_a, tables::block_summaries, nano::db_val<Val> (hash_a), value));
+			release_assert (success (status) || not_found (status));
+			if (success (status))
+			{
+				summary_a = static_cast<nano::block_summary> (value);
+				result = false;
+			}
+		}
+		return result;
+	}
+
+	bool block_summaries_build (nano::write_transaction const & transaction_a, size_t max_blocks_a) override
+	{
+		// Block tables in the order they are walked, the cursor stores the index into this
+		std::array<nano::block_type, 5> const block_types{ { nano::block_type::state, nano::block_type::send, nano::block_type::receive, nano::block_type::open, nano::block_type::change } };
+		uint8_t table_index (0);
+		nano::block_hash next (0);
+		block_summaries_cursor_get (transaction_a, table_index, next);
+		size_t built (0);
+		while (table_index < block_types.size () && built < max_blocks_a)
+		{
+			auto type (block_types[table_index]);
+			auto i (make_iterator<nano::block_hash, nano::no_value> (transaction_a, block_database (type), nano::db_val<Val> (next)));
+			nano::store_iterator<nano::block_hash, nano::no_value> n (nullptr);
+			for (; i != n && built < max_blocks_a; ++i, ++built)
+			{
+				auto value (block_raw_get_by_type (transaction_a, i->first, type));
+				debug_assert (value.is_initialized ());
+				block_summary_put (transaction_a, i->first, nano::block_view (type, reinterpret_cast<uint8_t const *> (value->data ()), value->size (), value->buffer));
+			}
+			if (i != n)
+			{
+				next = i->first;
+			}
+			else
+			{
+				++table_index;
+				next.clear ();
+			}
+		}
+		block_summaries_cursor_put (transaction_a, table_index, next);
+		return table_index >= block_types.size ();
 	}
 
 	void pending_put (nano::write_transaction const & transaction_a, nano::pending_key const & key_a, nano::pending_info const & pending_info_a) override
@@ -451,6 +856,7 @@ public:
 		nano::db_val<Val> pending (pending_info_a);
 		auto status = put (transaction_a, tables::pending, key_a, pending);
 		release_assert (success (status));
+		pending_filter.insert (key_a.hash);
 	}
 
 	void pending_del (nano::write_transaction const & transaction_a, nano::pending_key const & key_a) override
@@ -461,6 +867,10 @@ public:
 
 	bool pending_get (nano::transaction const & transaction_a, nano::pending_key const & key_a, nano::pending_info & pending_a) override
 	{
+		if (!pending_filter.may_contain (key_a.hash))
+		{
+			return true;
+		}
 		nano::db_val<Val> value;
 		nano::db_val<Val> key (key_a);
 		auto status1 = get (transaction_a, tables::pending, key, value);
@@ -474,6 +884,36 @@ public:
 		return result;
 	}
 
+	std::vector<boost::optional<nano::pending_info>> pending_get_many (nano::transaction const & transaction_a, std::vector<nano::pending_key> const & keys_a) override
+	{
+		std::vector<boost::optional<nano::pending_info>> result (keys_a.size ());
+		std::vector<size_t> indices;
+		std::vector<nano::db_val<Val>> keys;
+		for (size_t i (0), n (keys_a.size ()); i < n; ++i)
+		{
+			if (pending_filter.may_contain (keys_a[i].hash))
+			{
+				indices.push_back (i);
+				keys.emplace_back (keys_a[i]);
+			}
+		}
+		std::vector<nano::db_val<Val>> values;
+		get_many (transaction_a, tables::pending, keys, values);
+		for (size_t i (0), n (values.size ()); i < n; ++i)
+		{
+			if (values[i].size () != 0)
+			{
+				nano::bufferstream stream (reinterpret_cast<uint8_t const *> (values[i].data ()), values[i].size ());
+				nano::pending_info info;
+				auto error (info.deserialize (stream));
+				(void)error;
+				debug_assert (!error);
+				result[indices[i]] = info;
+			}
+		}
+		return result;
+	}
+
 	void frontier_put (nano::write_transaction const & transaction_a, nano::block_hash const & block_a, nano::account const & account_a) override
 	{
 		nano::db_val<Val> account (account_a);
@@ -590,6 +1030,27 @@ public:
 		return result;
 	}
 
+	std::vector<boost::optional<nano::account_info>> accounts_get (nano::transaction const & transaction_a, std::vector<nano::account> const & accounts_a) override
+	{
+		std::vector<nano::db_val<Val>> keys (accounts_a.begin (), accounts_a.end ());
+		std::vector<nano::db_val<Val>> values;
+		get_many (transaction_a, tables::accounts, keys, values);
+		std::vector<boost::optional<nano::account_info>> result (accounts_a.size ());
+		for (size_t i (0), n (values.size ()); i < n; ++i)
+		{
+			if (values[i].size () != 0)
+			{
+				nano::bufferstream stream (reinterpret_cast<uint8_t const *> (values[i].data ()), values[i].size ());
+				nano::account_info info;
+				auto error (info.deserialize (stream));
+				(void)error;
+				debug_assert (!error);
+				result[i] = info;
+			}
+		}
+		return result;
+	}
+
 	void unchecked_clear (nano::write_transaction const & transaction_a) override
 	{
 		auto status = drop (transaction_a, tables::unchecked);
@@ -638,7 +1099,10 @@ public:
 
 	bool exists (nano::transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key_a) const
 	{
-		return static_cast<const Derived_Store &> (*this).exists (transaction_a, table_a, key_a);
+		auto start (profile.start ());
+		auto result (static_cast<const Derived_Store &> (*this).exists (transaction_a, table_a, key_a));
+		profile.record (table_a, nano::store_profile::operation::get, start, 0);
+		return result;
 	}
 
 	nano::block_counts block_count (nano::transaction const & transaction_a) override
@@ -801,7 +1265,23 @@ protected:
 	nano::network_params network_params;
 	std::unordered_map<nano::account, std::shared_ptr<nano::vote>> vote_cache_l1;
 	std::unordered_map<nano::account, std::shared_ptr<nano::vote>> vote_cache_l2;
-	static int constexpr version{ 18 };
+	static int constexpr version{ 19 };
+	// Meta table keys besides the database version, which uses key 1
+	static uint64_t constexpr rep_weights_checkpoint_key{ 2 };
+	static uint64_t constexpr cache_counters_key{ 3 };
+	static uint64_t constexpr unchecked_cleanup_cursor_key{ 4 };
+	static uint64_t constexpr block_summaries_cursor_key{ 5 };
+	static uint64_t constexpr membership_filters_key{ 6 };
+	/**
+	 * Summaries are only maintained once the store is at the current version, upgrades rewrite block entries
+	 * in place without going through block_raw_put and the upgrade to version 19 discards whatever was there
+	 */
+	bool summaries_enabled{ false };
+	static size_t constexpr membership_filter_headroom{ 64 * 1024 };
+	nano::membership_filter block_filter;
+	nano::membership_filter pending_filter;
+	mutable nano::block_cache block_cache;
+	mutable nano::store_profile profile;
 
 	template <typename T>
 	std::shared_ptr<nano::block> block_random (nano::transaction const & transaction_a, tables table_a)
@@ -818,6 +1298,7 @@ protected:
 		return block_get (transaction_a, nano::block_hash (existing->first));
 	}
 
+	// The backend iterators record their seek and each step in the profile
 	template <typename Key, typename Value>
 	nano::store_iterator<Key, Value> make_iterator (nano::transaction const & transaction_a, tables table_a) const
 	{
@@ -838,6 +1319,10 @@ protected:
 	nano::db_val<Val> block_raw_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type & type_a) const
 	{
 		nano::db_val<Val> result;
+		if (!block_filter.may_contain (hash_a))
+		{
+			return result;
+		}
 		// Table lookups are ordered by match probability
 		nano::block_type block_types[]{ nano::block_type::state, nano::block_type::send, nano::block_type::receive, nano::block_type::open, nano::block_type::change };
 		for (auto current_type : block_types)
@@ -968,7 +1453,60 @@ protected:
 		return result;
 	}
 
-	tables block_database (nano::block_type type_a)
+	void block_summary_put (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_view const & view_a)
+	{
+		if (summaries_enabled && view_a.has_sideband ())
+		{
+			auto status (put (transaction_a, tables::block_summaries, hash_a, nano::db_val<Val> (nano::block_summary (view_a))));
+			release_assert (success (status));
+		}
+	}
+
+	/** The cursor is the index of the block table being walked followed by the next hash to summarize in it */
+	void block_summaries_cursor_put (nano::write_transaction const & transaction_a, uint8_t table_index_a, nano::block_hash const & next_a)
+	{
+		std::vector<uint8_t> data;
+		{
+			nano::vectorstream stream (data);
+			nano::write (stream, table_index_a);
+			nano::write (stream, next_a.bytes);
+		}
+		nano::uint256_union cursor_key (block_summaries_cursor_key);
+		auto status (put (transaction_a, tables::meta, nano::db_val<Val> (cursor_key), nano::db_val<Val> (data.size (), data.data ())));
+		release_assert (success (status));
+	}
+
+	void block_summaries_cursor_get (nano::transaction const & transaction_a, uint8_t & table_index_a, nano::block_hash & next_a) const
+	{
+		nano::uint256_union cursor_key (block_summaries_cursor_key);
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::meta, nano::db_val<Val> (cursor_key), value));
+		release_assert (success (status) || not_found (status));
+		if (success (status) && value.size () == sizeof (uint8_t) + sizeof (nano::block_hash))
+		{
+			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+			auto error (nano::try_read (stream, table_index_a) || nano::try_read (stream, next_a.bytes));
+			(void)error;
+			debug_assert (!error);
+		}
+		else
+		{
+			table_index_a = 0;
+			next_a.clear ();
+		}
+	}
+
+	static nano::block_hash membership_filters_checksum (uint8_t const * data_a, size_t size_a)
+	{
+		nano::block_hash result;
+		blake2b_state hash;
+		blake2b_init (&hash, sizeof (result.bytes));
+		blake2b_update (&hash, data_a, size_a);
+		blake2b_final (&hash, result.bytes.data (), sizeof (result.bytes));
+		return result;
+	}
+
+	tables block_database (nano::block_type type_a) const
 	{
 		tables result = tables::frontiers;
 		switch (type_a)
@@ -1007,17 +1545,42 @@ protected:
 
 	int get (nano::transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key_a, nano::db_val<Val> & value_a) const
 	{
-		return static_cast<Derived_Store const &> (*this).get (transaction_a, table_a, key_a, value_a);
+		auto start (profile.start ());
+		auto result (static_cast<Derived_Store const &> (*this).get (transaction_a, table_a, key_a, value_a));
+		profile.record (table_a, nano::store_profile::operation::get, start, success (result) ? value_a.size () : 0);
+		return result;
+	}
+
+	/** Looks up every key in \p table_a, values of keys which weren't found are left empty */
+	void get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::db_val<Val>> const & keys_a, std::vector<nano::db_val<Val>> & values_a) const
+	{
+		auto start (profile.start ());
+		static_cast<Derived_Store const &> (*this).get_many (transaction_a, table_a, keys_a, values_a);
+		if (start != std::chrono::steady_clock::time_point{})
+		{
+			size_t bytes (0);
+			for (auto const & value : values_a)
+			{
+				bytes += value.size ();
+			}
+			profile.record (table_a, nano::store_profile::operation::get, start, bytes, keys_a.size ());
+		}
 	}
 
 	int put (nano::write_transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key_a, nano::db_val<Val> const & value_a)
 	{
-		return static_cast<Derived_Store &> (*this).put (transaction_a, table_a, key_a, value_a);
+		auto start (profile.start ());
+		auto result (static_cast<Derived_Store &> (*this).put (transaction_a, table_a, key_a, value_a));
+		profile.record (table_a, nano::store_profile::operation::put, start, key_a.size () + value_a.size ());
+		return result;
 	}
 
 	int del (nano::write_transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key_a)
 	{
-		return static_cast<Derived_Store &> (*this).del (transaction_a, table_a, key_a);
+		auto start (profile.start ());
+		auto result (static_cast<Derived_Store &> (*this).del (transaction_a, table_a, key_a));
+		profile.record (table_a, nano::store_profile::operation::del, start, key_a.size ());
+		return result;
 	}
 
 	virtual size_t count (nano::transaction const & transaction_a, tables table_a) const = 0;
@@ -1,11 +1,16 @@
+#include <nano/crypto/blake2/blake2.h>
 #include <nano/lib/rep_weights.hpp>
 #include <nano/lib/stats.hpp>
+#include <nano/lib/timer.hpp>
 #include <nano/lib/utility.hpp>
 #include <nano/lib/work.hpp>
 #include <nano/secure/blockstore.hpp>
 #include <nano/secure/common.hpp>
 #include <nano/secure/ledger.hpp>
 
+#include <algorithm>
+#include <numeric>
+
 namespace
 {
 /**
@@ -91,11 +96,10 @@ public:
 		(void)error;
 		debug_assert (!error);
 		auto balance (ledger.balance (transaction, block_a.hashables.previous));
-		auto block = ledger.store.block_get (transaction, rep_block);
-		release_assert (block != nullptr);
-		auto representative = block->representative ();
-		ledger.cache.rep_weights.representation_add (block_a.representative (), 0 - balance);
-		ledger.cache.rep_weights.representation_add (representative, balance);
+		auto rep_view (ledger.store.block_view_get (transaction, rep_block));
+		release_assert (rep_view.exists ());
+		auto representative = rep_view.representative ();
+		ledger.cache.rep_weights.representation_add_dual (block_a.representative (), 0 - balance, representative, balance);
 		ledger.store.block_del (transaction, hash, block_a.type ());
 		nano::account_info new_info (block_a.hashables.previous, representative, info.open_block, info.balance, nano::seconds_since_epoch (), info.block_count - 1, nano::epoch::epoch_0);
 		ledger.change_latest (transaction, account, info, new_info);
@@ -114,16 +118,19 @@ public:
 		}
 		auto balance (ledger.balance (transaction, block_a.hashables.previous));
 		auto is_send (block_a.hashables.balance < balance);
-		// Add in amount delta
-		ledger.cache.rep_weights.representation_add (block_a.representative (), 0 - block_a.hashables.balance.number ());
 		nano::account representative{ 0 };
 		if (!rep_block_hash.is_zero ())
 		{
 			// Move existing representation
-			auto block (ledger.store.block_get (transaction, rep_block_hash));
-			debug_assert (block != nullptr);
-			representative = block->representative ();
-			ledger.cache.rep_weights.representation_add (representative, balance);
+			auto rep_view (ledger.store.block_view_get (transaction, rep_block_hash));
+			debug_assert (rep_view.exists ());
+			representative = rep_view.representative ();
+			ledger.cache.rep_weights.representation_add_dual (block_a.representative (), 0 - block_a.hashables.balance.number (), representative, balance);
+		}
+		else
+		{
+			// Add in amount delta
+			ledger.cache.rep_weights.representation_add (block_a.representative (), 0 - block_a.hashables.balance.number ());
 		}
 
 		nano::account_info info;
@@ -177,6 +184,7 @@ class ledger_processor : public nano::mutable_block_visitor
 {
 public:
 	ledger_processor (nano::ledger &, nano::write_transaction const &, nano::signature_verification = nano::signature_verification::unknown);
+	ledger_processor (nano::ledger &, nano::transaction const &, nano::signature_verification);
 	virtual ~ledger_processor () = default;
 	void send_block (nano::send_block &) override;
 	void receive_block (nano::receive_block &) override;
@@ -186,7 +194,9 @@ public:
 	void state_block_impl (nano::state_block &);
 	void epoch_block_impl (nano::state_block &);
 	nano::ledger & ledger;
-	nano::write_transaction const & transaction;
+	nano::transaction const & transaction;
+	// Null when the block is only checked, a progress result then means it can be added but nothing was written
+	nano::write_transaction const * const write_transaction;
 	nano::signature_verification verification;
 	nano::process_return result;
 
@@ -338,36 +348,39 @@ void ledger_processor::state_block_impl (nano::state_block & block_a)
 				{
 					nano::block_details block_details (epoch, is_send, is_receive, false);
 					result.code = block_a.difficulty () >= nano::work_threshold (block_a.work_version (), block_details) ? nano::process_result::progress : nano::process_result::insufficient_work; // Does this block have sufficient work? (Malformed)
-					if (result.code == nano::process_result::progress)
+					if (result.code == nano::process_result::progress && write_transaction != nullptr)
 					{
 						ledger.stats.inc (nano::stat::type::ledger, nano::stat::detail::state_block);
 						block_a.sideband_set (nano::block_sideband (block_a.hashables.account /* unused */, 0, 0 /* unused */, info.block_count + 1, nano::seconds_since_epoch (), block_details));
-						ledger.store.block_put (transaction, hash, block_a);
+						ledger.store.block_put (*write_transaction, hash, block_a);
 
 						if (!info.head.is_zero ())
 						{
-							// Move existing representation
-							ledger.cache.rep_weights.representation_add (info.representative, 0 - info.balance.number ());
+							// Move existing representation & add in amount delta
+							ledger.cache.rep_weights.representation_add_dual (info.representative, 0 - info.balance.number (), block_a.representative (), block_a.hashables.balance.number ());
+						}
+						else
+						{
+							// Add in amount delta only
+							ledger.cache.rep_weights.representation_add (block_a.representative (), block_a.hashables.balance.number ());
 						}
-						// Add in amount delta
-						ledger.cache.rep_weights.representation_add (block_a.representative (), block_a.hashables.balance.number ());
 
 						if (is_send)
 						{
 							nano::pending_key key (block_a.hashables.link, hash);
 							nano::pending_info info (block_a.hashables.account, result.amount.number (), epoch);
-							ledger.store.pending_put (transaction, key, info);
+							ledger.store.pending_put (*write_transaction, key, info);
 						}
 						else if (!block_a.hashables.link.is_zero ())
 						{
-							ledger.store.pending_del (transaction, nano::pending_key (block_a.hashables.account, block_a.hashables.link));
+							ledger.store.pending_del (*write_transaction, nano::pending_key (block_a.hashables.account, block_a.hashables.link));
 						}
 
 						nano::account_info new_info (hash, block_a.representative (), info.open_block.is_zero () ? hash : info.open_block, block_a.hashables.balance, nano::seconds_since_epoch (), info.block_count + 1, epoch);
-						ledger.change_latest (transaction, block_a.hashables.account, info, new_info);
-						if (!ledger.store.frontier_get (transaction, info.head).is_zero ())
+						ledger.change_latest (*write_transaction, block_a.hashables.account, info, new_info);
+						if (!ledger.store.frontier_get (*write_transaction, info.head).is_zero ())
 						{
-							ledger.store.frontier_del (transaction, info.head);
+							ledger.store.frontier_del (*write_transaction, info.head);
 						}
 						// Frontier table is unnecessary for state blocks and this also prevents old blocks from being inserted on top of state blocks
 						result.account = block_a.hashables.account;
@@ -437,18 +450,18 @@ void ledger_processor::epoch_block_impl (nano::state_block & block_a)
 						{
 							nano::block_details block_details (epoch, false, false, true);
 							result.code = block_a.difficulty () >= nano::work_threshold (block_a.work_version (), block_details) ? nano::process_result::progress : nano::process_result::insufficient_work; // Does this block have sufficient work? (Malformed)
-							if (result.code == nano::process_result::progress)
+							if (result.code == nano::process_result::progress && write_transaction != nullptr)
 							{
 								ledger.stats.inc (nano::stat::type::ledger, nano::stat::detail::epoch_block);
 								result.account = block_a.hashables.account;
 								result.amount = 0;
 								block_a.sideband_set (nano::block_sideband (block_a.hashables.account /* unused */, 0, 0 /* unused */, info.block_count + 1, nano::seconds_since_epoch (), block_details));
-								ledger.store.block_put (transaction, hash, block_a);
+								ledger.store.block_put (*write_transaction, hash, block_a);
 								nano::account_info new_info (hash, block_a.representative (), info.open_block.is_zero () ? hash : info.open_block, info.balance, nano::seconds_since_epoch (), info.block_count + 1, epoch);
-								ledger.change_latest (transaction, block_a.hashables.account, info, new_info);
-								if (!ledger.store.frontier_get (transaction, info.head).is_zero ())
+								ledger.change_latest (*write_transaction, block_a.hashables.account, info, new_info);
+								if (!ledger.store.frontier_get (*write_transaction, info.head).is_zero ())
 								{
-									ledger.store.frontier_del (transaction, info.head);
+									ledger.store.frontier_del (*write_transaction, info.head);
 								}
 								if (epoch == nano::epoch::epoch_2)
 								{
@@ -500,21 +513,20 @@ void ledger_processor::change_block (nano::change_block & block_a)
 					}
 					if (result.code == nano::process_result::progress)
 					{
+						debug_assert (!validate_message (account, hash, block_a.signature));
+						result.verified = nano::signature_verification::valid;
 						nano::block_details block_details (nano::epoch::epoch_0, false /* unused */, false /* unused */, false /* unused */);
 						result.code = block_a.difficulty () >= nano::work_threshold (block_a.work_version (), block_details) ? nano::process_result::progress : nano::process_result::insufficient_work; // Does this block have sufficient work? (Malformed)
-						if (result.code == nano::process_result::progress)
+						if (result.code == nano::process_result::progress && write_transaction != nullptr)
 						{
-							debug_assert (!validate_message (account, hash, block_a.signature));
-							result.verified = nano::signature_verification::valid;
 							block_a.sideband_set (nano::block_sideband (account, 0, info.balance, info.block_count + 1, nano::seconds_since_epoch (), block_details));
-							ledger.store.block_put (transaction, hash, block_a);
-							auto balance (ledger.balance (transaction, block_a.hashables.previous));
-							ledger.cache.rep_weights.representation_add (block_a.representative (), balance);
-							ledger.cache.rep_weights.representation_add (info.representative, 0 - balance);
+							ledger.store.block_put (*write_transaction, hash, block_a);
+							auto balance (ledger.balance (*write_transaction, block_a.hashables.previous));
+							ledger.cache.rep_weights.representation_add_dual (block_a.representative (), balance, info.representative, 0 - balance);
 							nano::account_info new_info (hash, block_a.representative (), info.open_block, info.balance, nano::seconds_since_epoch (), info.block_count + 1, nano::epoch::epoch_0);
-							ledger.change_latest (transaction, account, info, new_info);
-							ledger.store.frontier_del (transaction, block_a.hashables.previous);
-							ledger.store.frontier_put (transaction, hash, account);
+							ledger.change_latest (*write_transaction, account, info, new_info);
+							ledger.store.frontier_del (*write_transaction, block_a.hashables.previous);
+							ledger.store.frontier_put (*write_transaction, hash, account);
 							result.account = account;
 							result.amount = 0;
 							result.previous_balance = info.balance;
@@ -564,17 +576,17 @@ void ledger_processor::send_block (nano::send_block & block_a)
 							debug_assert (!latest_error);
 							debug_assert (info.head == block_a.hashables.previous);
 							result.code = info.balance.number () >= block_a.hashables.balance.number () ? nano::process_result::progress : nano::process_result::negative_spend; // Is this trying to spend a negative amount (Malicious)
-							if (result.code == nano::process_result::progress)
+							if (result.code == nano::process_result::progress && write_transaction != nullptr)
 							{
 								auto amount (info.balance.number () - block_a.hashables.balance.number ());
 								ledger.cache.rep_weights.representation_add (info.representative, 0 - amount);
 								block_a.sideband_set (nano::block_sideband (account, 0, block_a.hashables.balance /* unused */, info.block_count + 1, nano::seconds_since_epoch (), block_details));
-								ledger.store.block_put (transaction, hash, block_a);
+								ledger.store.block_put (*write_transaction, hash, block_a);
 								nano::account_info new_info (hash, info.representative, info.open_block, block_a.hashables.balance, nano::seconds_since_epoch (), info.block_count + 1, nano::epoch::epoch_0);
-								ledger.change_latest (transaction, account, info, new_info);
-								ledger.store.pending_put (transaction, nano::pending_key (block_a.hashables.destination, hash), { account, amount, nano::epoch::epoch_0 });
-								ledger.store.frontier_del (transaction, block_a.hashables.previous);
-								ledger.store.frontier_put (transaction, hash, account);
+								ledger.change_latest (*write_transaction, account, info, new_info);
+								ledger.store.pending_put (*write_transaction, nano::pending_key (block_a.hashables.destination, hash), { account, amount, nano::epoch::epoch_0 });
+								ledger.store.frontier_del (*write_transaction, block_a.hashables.previous);
+								ledger.store.frontier_put (*write_transaction, hash, account);
 								result.account = account;
 								result.amount = amount;
 								result.pending_account = block_a.hashables.destination;
@@ -634,21 +646,21 @@ void ledger_processor::receive_block (nano::receive_block & block_a)
 									{
 										nano::block_details block_details (nano::epoch::epoch_0, false /* unused */, false /* unused */, false /* unused */);
 										result.code = block_a.difficulty () >= nano::work_threshold (block_a.work_version (), block_details) ? nano::process_result::progress : nano::process_result::insufficient_work; // Does this block have sufficient work? (Malformed)
-										if (result.code == nano::process_result::progress)
+										if (result.code == nano::process_result::progress && write_transaction != nullptr)
 										{
 											auto new_balance (info.balance.number () + pending.amount.number ());
 											nano::account_info source_info;
-											auto error (ledger.store.account_get (transaction, pending.source, source_info));
+											auto error (ledger.store.account_get (*write_transaction, pending.source, source_info));
 											(void)error;
 											debug_assert (!error);
-											ledger.store.pending_del (transaction, key);
+											ledger.store.pending_del (*write_transaction, key);
 											block_a.sideband_set (nano::block_sideband (account, 0, new_balance, info.block_count + 1, nano::seconds_since_epoch (), block_details));
-											ledger.store.block_put (transaction, hash, block_a);
+											ledger.store.block_put (*write_transaction, hash, block_a);
 											nano::account_info new_info (hash, info.representative, info.open_block, new_balance, nano::seconds_since_epoch (), info.block_count + 1, nano::epoch::epoch_0);
-											ledger.change_latest (transaction, account, info, new_info);
+											ledger.change_latest (*write_transaction, account, info, new_info);
 											ledger.cache.rep_weights.representation_add (info.representative, pending.amount.number ());
-											ledger.store.frontier_del (transaction, block_a.hashables.previous);
-											ledger.store.frontier_put (transaction, hash, account);
+											ledger.store.frontier_del (*write_transaction, block_a.hashables.previous);
+											ledger.store.frontier_put (*write_transaction, hash, account);
 											result.account = account;
 											result.amount = pending.amount;
 											result.previous_balance = info.balance;
@@ -705,19 +717,19 @@ void ledger_processor::open_block (nano::open_block & block_a)
 							{
 								nano::block_details block_details (nano::epoch::epoch_0, false /* unused */, false /* unused */, false /* unused */);
 								result.code = block_a.difficulty () >= nano::work_threshold (block_a.work_version (), block_details) ? nano::process_result::progress : nano::process_result::insufficient_work; // Does this block have sufficient work? (Malformed)
-								if (result.code == nano::process_result::progress)
+								if (result.code == nano::process_result::progress && write_transaction != nullptr)
 								{
 									nano::account_info source_info;
-									auto error (ledger.store.account_get (transaction, pending.source, source_info));
+									auto error (ledger.store.account_get (*write_transaction, pending.source, source_info));
 									(void)error;
 									debug_assert (!error);
-									ledger.store.pending_del (transaction, key);
+									ledger.store.pending_del (*write_transaction, key);
 									block_a.sideband_set (nano::block_sideband (block_a.hashables.account, 0, pending.amount, 1, nano::seconds_since_epoch (), block_details));
-									ledger.store.block_put (transaction, hash, block_a);
+									ledger.store.block_put (*write_transaction, hash, block_a);
 									nano::account_info new_info (hash, block_a.representative (), hash, pending.amount.number (), nano::seconds_since_epoch (), 1, nano::epoch::epoch_0);
-									ledger.change_latest (transaction, block_a.hashables.account, info, new_info);
+									ledger.change_latest (*write_transaction, block_a.hashables.account, info, new_info);
 									ledger.cache.rep_weights.representation_add (block_a.representative (), pending.amount.number ());
-									ledger.store.frontier_put (transaction, hash, block_a.hashables.account);
+									ledger.store.frontier_put (*write_transaction, hash, block_a.hashables.account);
 									result.account = block_a.hashables.account;
 									result.amount = pending.amount;
 									result.previous_balance = 0;
@@ -735,6 +747,16 @@ void ledger_processor::open_block (nano::open_block & block_a)
 ledger_processor::ledger_processor (nano::ledger & ledger_a, nano::write_transaction const & transaction_a, nano::signature_verification verification_a) :
 ledger (ledger_a),
 transaction (transaction_a),
+write_transaction (&transaction_a),
+verification (verification_a)
+{
+	result.verified = verification;
+}
+
+ledger_processor::ledger_processor (nano::ledger & ledger_a, nano::transaction const & transaction_a, nano::signature_verification verification_a) :
+ledger (ledger_a),
+transaction (transaction_a),
+write_transaction (nullptr),
 verification (verification_a)
 {
 	result.verified = verification;
@@ -749,34 +771,62 @@ epoch_2_started_cb (epoch_2_started_cb_a)
 {
 	if (!store.init_error ())
 	{
+		nano::timer<std::chrono::milliseconds> timer_l (nano::timer_state::started, "ledger cache");
 		auto transaction = store.tx_begin_read ();
+		auto block_count_l (store.block_count (transaction).sum ());
+		uint64_t cemented_count_l{ 0 };
+		bool counters_epoch_2_started_l{ false };
+		// Counters can't be ahead of the ledger, a database modified by an older version is corrected by cache_counters_validate (--validate_cache_counters)
+		cache_counters_loaded = !store.cache_counters_get (transaction, cemented_count_l, counters_epoch_2_started_l) && cemented_count_l <= block_count_l;
 		if (generate_cache_a.reps || generate_cache_a.account_count || generate_cache_a.epoch_2)
 		{
+			auto & timer_accounts (timer_l.start_child ("accounts"));
 			bool epoch_2_started_l{ false };
-			for (auto i (store.latest_begin (transaction)), n (store.latest_end ()); i != n; ++i)
+			if (generate_cache_a.reps && !rep_weights_checkpoint_load (transaction, block_count_l, epoch_2_started_l))
 			{
-				nano::account_info const & info (i->second);
-				cache.rep_weights.representation_add (info.representative, info.balance.number ());
-				++cache.account_count;
-				epoch_2_started_l = epoch_2_started_l || info.epoch () == nano::epoch::epoch_2;
+				cache.account_count = store.account_count (transaction);
+			}
+			else
+			{
+				for (auto i (store.latest_begin (transaction)), n (store.latest_end ()); i != n; ++i)
+				{
+					nano::account_info const & info (i->second);
+					cache.rep_weights.representation_add (info.representative, info.balance.number ());
+					++cache.account_count;
+					epoch_2_started_l = epoch_2_started_l || info.epoch () == nano::epoch::epoch_2;
+				}
 			}
-			cache.epoch_2_started.store (epoch_2_started_l);
+			cache.epoch_2_started.store (epoch_2_started_l || (cache_counters_loaded && counters_epoch_2_started_l));
+			timer_accounts.pause ();
 		}
 
 		if (generate_cache_a.cemented_count)
 		{
-			for (auto i (store.confirmation_height_begin (transaction)), n (store.confirmation_height_end ()); i != n; ++i)
+			auto & timer_cemented (timer_l.start_child ("cemented count"));
+			if (cache_counters_loaded)
 			{
-				cache.cemented_count += i->second.height;
+				cache.cemented_count = cemented_count_l;
+			}
+			else
+			{
+				for (auto i (store.confirmation_height_begin (transaction)), n (store.confirmation_height_end ()); i != n; ++i)
+				{
+					cache.cemented_count += i->second.height;
+				}
 			}
+			timer_cemented.pause ();
 		}
+		cache_counters_enabled = generate_cache_a.cemented_count;
 
 		if (generate_cache_a.unchecked_count)
 		{
+			auto & timer_unchecked (timer_l.start_child ("unchecked count"));
 			cache.unchecked_count = store.unchecked_count (transaction);
+			timer_unchecked.pause ();
 		}
 
-		cache.block_count = store.block_count (transaction).sum ();
+		cache.block_count = block_count_l;
+		timer_l.stop (cache_timing);
 	}
 }
 
@@ -811,9 +861,52 @@ nano::uint128_t nano::ledger::account_pending (nano::transaction const & transac
 	return result;
 }
 
+std::vector<nano::uint128_t> nano::ledger::accounts_pending (nano::transaction const & transaction_a, std::vector<nano::account> const & accounts_a)
+{
+	std::vector<nano::uint128_t> result (accounts_a.size (), 0);
+	std::vector<size_t> order (accounts_a.size ());
+	std::iota (order.begin (), order.end (), 0);
+	std::sort (order.begin (), order.end (), [&accounts_a](size_t lhs, size_t rhs) {
+		return accounts_a[lhs] < accounts_a[rhs];
+	});
+	// Entries of accounts in between are stepped over when there are only a few, otherwise the iterator seeks to the next account
+	size_t constexpr max_skipped (16);
+	nano::store_iterator<nano::pending_key, nano::pending_info> i (nullptr);
+	auto n (store.pending_end ());
+	auto positioned (false);
+	for (size_t j (0), m (order.size ()); j < m; ++j)
+	{
+		auto index (order[j]);
+		auto const & account (accounts_a[index]);
+		if (j > 0 && accounts_a[order[j - 1]] == account)
+		{
+			// The iterator is already past a repeated account
+			result[index] = result[order[j - 1]];
+		}
+		else
+		{
+			for (size_t skipped (0); positioned && i != n && i->first.account < account && skipped < max_skipped; ++skipped)
+			{
+				++i;
+			}
+			if (!positioned || (i != n && i->first.account < account))
+			{
+				i = store.pending_begin (transaction_a, nano::pending_key (account, 0));
+				positioned = true;
+			}
+			for (; i != n && i->first.account == account; ++i)
+			{
+				result[index] += i->second.amount.number ();
+			}
+		}
+	}
+	return result;
+}
+
 nano::process_return nano::ledger::process (nano::write_transaction const & transaction_a, nano::block & block_a, nano::signature_verification verification)
 {
 	debug_assert (!nano::work_validate_entry (block_a) || network_params.network.is_test_network ());
+	rep_weights_checkpoint_invalidate (transaction_a);
 	ledger_processor processor (*this, transaction_a, verification);
 	block_a.visit (processor);
 	if (processor.result.code == nano::process_result::progress)
@@ -823,6 +916,117 @@ nano::process_return nano::ledger::process (nano::write_transaction const & tran
 	return processor.result;
 }
 
+/**
+ * Groups positions of a batch of blocks so that no block depends on a block from another group.
+ * Blocks on the same account or competing for the same root end up in the same group, as do blocks linked through dependent_blocks.
+ * Positions inside a group keep the batch order.
+ */
+std::vector<std::vector<size_t>> nano::ledger::partition (nano::transaction const & transaction_a, std::vector<std::shared_ptr<nano::block>> const & blocks_a)
+{
+	std::vector<size_t> parents (blocks_a.size ());
+	std::iota (parents.begin (), parents.end (), 0);
+	auto find = [&parents](size_t position_a) {
+		while (parents[position_a] != position_a)
+		{
+			parents[position_a] = parents[parents[position_a]];
+			position_a = parents[position_a];
+		}
+		return position_a;
+	};
+	auto unite = [&parents, &find](size_t first_a, size_t second_a) {
+		auto first (find (first_a));
+		auto second (find (second_a));
+		if (first != second)
+		{
+			parents[std::max (first, second)] = std::min (first, second);
+		}
+	};
+	std::unordered_map<nano::block_hash, size_t> positions;
+	for (auto i (0); i < blocks_a.size (); ++i)
+	{
+		positions.emplace (blocks_a[i]->hash (), i);
+	}
+	std::unordered_map<nano::root, size_t> roots;
+	std::unordered_map<nano::account, size_t> accounts;
+	for (auto i (0); i < blocks_a.size (); ++i)
+	{
+		auto const & block (*blocks_a[i]);
+		auto root (roots.emplace (block.root (), i));
+		if (!root.second)
+		{
+			unite (root.first->second, i);
+		}
+		if (!block.account ().is_zero ())
+		{
+			auto account (accounts.emplace (block.account (), i));
+			if (!account.second)
+			{
+				unite (account.first->second, i);
+			}
+		}
+		for (auto const & dependency : dependent_blocks (transaction_a, block))
+		{
+			if (!dependency.is_zero ())
+			{
+				auto existing (positions.find (dependency));
+				if (existing != positions.end ())
+				{
+					unite (existing->second, i);
+				}
+			}
+		}
+	}
+	std::vector<std::vector<size_t>> result;
+	std::unordered_map<size_t, size_t> groups;
+	for (auto i (0); i < blocks_a.size (); ++i)
+	{
+		auto group (groups.emplace (find (i), result.size ()));
+		if (group.second)
+		{
+			result.emplace_back ();
+		}
+		result[group.first->second].push_back (i);
+	}
+	return result;
+}
+
+/**
+ * Runs every check of ledger::process on a block against a snapshot of the ledger taken when the write transaction started, without writing it.
+ * \p earlier_a holds the blocks of the same partition checked before this one which may still be added, those change the ledger the block is checked against.
+ * The returned code is what ledger::process is bound to return, or progress when the block has to go through ledger::process.
+ * The signature verification result holds either way.
+ */
+nano::process_return nano::ledger::snapshot_check (nano::transaction const & transaction_a, nano::block & block_a, nano::signature_verification verification_a, std::unordered_set<nano::block_hash> const & earlier_a)
+{
+	ledger_processor processor (*this, transaction_a, verification_a);
+	block_a.visit (processor);
+	auto & result (processor.result);
+	auto trusted (false);
+	switch (result.code)
+	{
+		case nano::process_result::progress:
+		case nano::process_result::old:
+			trusted = true;
+			break;
+		case nano::process_result::gap_previous:
+			// Only the previous block itself can fill the gap, and it's in the same partition
+			trusted = earlier_a.find (block_a.previous ()) == earlier_a.end ();
+			break;
+		case nano::process_result::block_position:
+			// Sends to an unopened account come from any partition, they can make its epoch open block valid
+			trusted = earlier_a.empty () && !(block_a.type () == nano::block_type::state && block_a.previous ().is_zero () && is_epoch_link (block_a.link ()));
+			break;
+		default:
+			trusted = earlier_a.empty ();
+			break;
+	}
+	if (!trusted)
+	{
+		result.code = nano::process_result::progress;
+	}
+	return result;
+}
+
 nano::block_hash nano::ledger::representative (nano::transaction const & transaction_a, nano::block_hash const & hash_a)
 {
 	auto result (representative_calculated (transaction_a, hash_a));
@@ -953,6 +1157,7 @@ nano::uint128_t nano::ledger::weight (nano::account const & account_a)
 bool nano::ledger::rollback (nano::write_transaction const & transaction_a, nano::block_hash const & block_a, std::vector<std::shared_ptr<nano::block>> & list_a)
 {
 	debug_assert (store.block_exists (transaction_a, block_a));
+	rep_weights_checkpoint_invalidate (transaction_a);
 	auto account_l (account (transaction_a, block_a));
 	auto block_account_height (store.block_account_height (transaction_a, block_a));
 	rollback_visitor rollback (transaction_a, *this, list_a);
@@ -1006,9 +1211,9 @@ nano::uint128_t nano::ledger::amount (nano::transaction const & transaction_a, n
 
 nano::uint128_t nano::ledger::amount (nano::transaction const & transaction_a, nano::block_hash const & hash_a)
 {
-	auto block (store.block_get (transaction_a, hash_a));
+	auto view (store.block_view_get (transaction_a, hash_a));
 	auto block_balance (balance (transaction_a, hash_a));
-	auto previous_balance (balance (transaction_a, block->previous ()));
+	auto previous_balance (balance (transaction_a, view.previous ()));
 	return block_balance > previous_balance ? block_balance - previous_balance : previous_balance - block_balance;
 }
 
@@ -1040,10 +1245,10 @@ void nano::ledger::dump_account_chain (nano::account const & account_a, std::ost
 	auto hash (latest (transaction, account_a));
 	while (!hash.is_zero ())
 	{
-		auto block (store.block_get (transaction, hash));
-		debug_assert (block != nullptr);
+		auto view (store.block_view_get (transaction, hash));
+		debug_assert (view.exists ());
 		stream << hash.to_string () << std::endl;
-		hash = block->previous ();
+		hash = view.previous ();
 	}
 }
 
@@ -1063,13 +1268,13 @@ bool nano::ledger::can_vote (nano::transaction const & transaction_a, nano::bloc
 		if (!result)
 		{
 			result = false;
-			auto block (store.block_get (transaction_a, hash_a));
-			if (block != nullptr)
+			auto view (store.block_view_get (transaction_a, hash_a));
+			if (view.exists ())
 			{
 				nano::confirmation_height_info height;
-				auto error = store.confirmation_height_get (transaction_a, block->account ().is_zero () ? block->sideband ().account : block->account (), height);
+				auto error = store.confirmation_height_get (transaction_a, view.account (), height);
 				debug_assert (!error);
-				result = block->sideband ().height <= height.height;
+				result = view.height () <= height.height;
 			}
 		}
 		return result;
@@ -1223,11 +1428,21 @@ std::shared_ptr<nano::block> nano::ledger::forked_block (nano::transaction const
 std::shared_ptr<nano::block> nano::ledger::backtrack (nano::transaction const & transaction_a, std::shared_ptr<nano::block> const & start_a, uint64_t jumps_a)
 {
 	auto block = start_a;
-	while (jumps_a > 0 && block != nullptr && !block->previous ().is_zero ())
+	if (jumps_a > 0 && block != nullptr && !block->previous ().is_zero ())
 	{
-		block = store.block_get (transaction_a, block->previous ());
-		debug_assert (block != nullptr);
+		// Walk the chain on views and only deserialize the block landed on
+		auto hash (block->previous ());
+		auto view (store.block_view_get (transaction_a, hash));
 		--jumps_a;
+		while (jumps_a > 0 && view.exists () && !view.previous ().is_zero ())
+		{
+			hash = view.previous ();
+			view = store.block_view_get (transaction_a, hash);
+			debug_assert (view.exists ());
+			--jumps_a;
+		}
+		block = view.block ();
+		debug_assert (block != nullptr);
 	}
 	debug_assert (block == nullptr || block->previous ().is_zero () || jumps_a == 0);
 	return block;
@@ -1258,6 +1473,139 @@ bool nano::ledger::block_not_confirmed_or_not_exists (nano::block const & block_
 	return result;
 }
 
+namespace
+{
+nano::block_hash checkpoint_checksum (uint8_t const * data_a, size_t size_a)
+{
+	nano::block_hash result;
+	blake2b_state hash;
+	blake2b_init (&hash, sizeof (result.bytes));
+	blake2b_update (&hash, data_a, size_a);
+	blake2b_final (&hash, result.bytes.data (), sizeof (result.bytes));
+	return result;
+}
+}
+
+/*
+ * Checkpoint layout, integers are big endian:
+ * block count (8) | epoch 2 started (1) | representative count (8) | count * (representative (32) | weight (16)) | blake2b checksum of the preceding bytes (32)
+ */
+void nano::ledger::rep_weights_checkpoint (nano::write_transaction const & transaction_a)
+{
+	// No other write transaction is open so the weights match the ledger state in this transaction
+	auto rep_amounts (cache.rep_weights.get_rep_amounts ());
+	std::vector<uint8_t> data;
+	{
+		nano::vectorstream stream (data);
+		nano::write (stream, boost::endian::native_to_big (store.block_count (transaction_a).sum ()));
+		nano::write (stream, static_cast<uint8_t> (cache.epoch_2_started.load ()));
+		nano::write (stream, boost::endian::native_to_big (static_cast<uint64_t> (rep_amounts->size ())));
+		for (auto const & rep_amount : *rep_amounts)
+		{
+			nano::write (stream, rep_amount.first.bytes);
+			nano::write (stream, nano::amount (rep_amount.second).bytes);
+		}
+	}
+	auto checksum (checkpoint_checksum (data.data (), data.size ()));
+	data.insert (data.end (), checksum.bytes.begin (), checksum.bytes.end ());
+	store.rep_weights_checkpoint_put (transaction_a, data);
+	rep_weights_checkpointed = true;
+}
+
+bool nano::ledger::rep_weights_checkpoint_load (nano::transaction const & transaction_a, uint64_t block_count_a, bool & epoch_2_started_a)
+{
+	auto error (true);
+	store.rep_weights_checkpoint_get (transaction_a, [this, &error, block_count_a, &epoch_2_started_a](uint8_t const * data_a, size_t size_a) {
+		// Stays in the store until the next ledger write even if it can't be used
+		rep_weights_checkpointed = true;
+		size_t constexpr header_size (sizeof (uint64_t) + sizeof (uint8_t) + sizeof (uint64_t));
+		size_t constexpr entry_size (sizeof (nano::account) + sizeof (nano::amount));
+		nano::block_hash checksum;
+		if (size_a >= header_size + sizeof (checksum))
+		{
+			auto content_size (size_a - sizeof (checksum));
+			std::copy (data_a + content_size, data_a + size_a, checksum.bytes.begin ());
+			nano::bufferstream stream (data_a, content_size);
+			uint64_t block_count_l;
+			uint8_t epoch_2_started_l;
+			uint64_t count_l;
+			auto read_error (nano::try_read (stream, block_count_l) || nano::try_read (stream, epoch_2_started_l) || nano::try_read (stream, count_l));
+			boost::endian::big_to_native_inplace (block_count_l);
+			boost::endian::big_to_native_inplace (count_l);
+			if (!read_error && block_count_l == block_count_a && content_size == header_size + count_l * entry_size && checkpoint_checksum (data_a, content_size) == checksum)
+			{
+				for (uint64_t i (0); i < count_l; ++i)
+				{
+					nano::account representative;
+					nano::amount weight;
+					nano::read (stream, representative.bytes);
+					nano::read (stream, weight.bytes);
+					cache.rep_weights.representation_put (representative, weight);
+				}
+				epoch_2_started_a = epoch_2_started_l != 0;
+				error = false;
+			}
+		}
+	});
+	return error;
+}
+
+void nano::ledger::rep_weights_checkpoint_invalidate (nano::write_transaction const & transaction_a)
+{
+	if (rep_weights_checkpointed.exchange (false))
+	{
+		store.rep_weights_checkpoint_del (transaction_a);
+	}
+}
+
+void nano::ledger::cache_counters_write (nano::write_transaction const & transaction_a)
+{
+	if (cache_counters_enabled)
+	{
+		store.cache_counters_put (transaction_a, cache.cemented_count, cache.epoch_2_started);
+	}
+}
+
+bool nano::ledger::cache_counters_validate (std::atomic<bool> const & stopped_a)
+{
+	auto result (false);
+	auto transaction (store.tx_begin_read ());
+	uint64_t stored_cemented_count;
+	bool stored_epoch_2_started;
+	if (cache_counters_enabled && !store.cache_counters_get (transaction, stored_cemented_count, stored_epoch_2_started))
+	{
+		uint64_t cemented_count_l (0);
+		for (auto i (store.confirmation_height_begin (transaction)), n (store.confirmation_height_end ()); i != n && !stopped_a; ++i)
+		{
+			cemented_count_l += i->second.height;
+		}
+		if (!stopped_a && cemented_count_l != stored_cemented_count)
+		{
+			// Both counts come from the same snapshot, the difference still applies to a cache which moved on since
+			cache.cemented_count += cemented_count_l - stored_cemented_count;
+			result = true;
+		}
+		if (!cache.epoch_2_started)
+		{
+			auto epoch_2_started_l (false);
+			for (auto i (store.latest_begin (transaction)), n (store.latest_end ()); i != n && !stopped_a && !epoch_2_started_l; ++i)
+			{
+				nano::account_info const & info (i->second);
+				epoch_2_started_l = info.epoch () == nano::epoch::epoch_2;
+			}
+			if (epoch_2_started_l && !cache.epoch_2_started.exchange (true))
+			{
+				if (epoch_2_started_cb)
+				{
+					epoch_2_started_cb ();
+				}
+				result = true;
+			}
+		}
+	}
+	return result;
+}
+
 std::unique_ptr<nano::container_info_component> nano::collect_container_info (ledger & ledger, const std::string & name)
 {
 	auto count = ledger.bootstrap_weights_size.load ();
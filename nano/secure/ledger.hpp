@@ -4,6 +4,7 @@
 #include <nano/secure/common.hpp>
 
 #include <map>
+#include <unordered_set>
 
 namespace nano
 {
@@ -22,6 +23,8 @@ public:
 	nano::uint128_t balance (nano::transaction const &, nano::block_hash const &) const;
 	nano::uint128_t account_balance (nano::transaction const &, nano::account const &);
 	nano::uint128_t account_pending (nano::transaction const &, nano::account const &);
+	/** Pending amounts of each account in the order given, from a single pass over the pending table in account order */
+	std::vector<nano::uint128_t> accounts_pending (nano::transaction const &, std::vector<nano::account> const &);
 	nano::uint128_t weight (nano::account const &);
 	std::shared_ptr<nano::block> successor (nano::transaction const &, nano::qualified_root const &);
 	std::shared_ptr<nano::block> forked_block (nano::transaction const &, nano::block const &);
@@ -40,6 +43,8 @@ public:
 	nano::account const & block_destination (nano::transaction const &, nano::block const &);
 	nano::block_hash block_source (nano::transaction const &, nano::block const &);
 	nano::process_return process (nano::write_transaction const &, nano::block &, nano::signature_verification = nano::signature_verification::unknown);
+	std::vector<std::vector<size_t>> partition (nano::transaction const &, std::vector<std::shared_ptr<nano::block>> const &);
+	nano::process_return snapshot_check (nano::transaction const &, nano::block &, nano::signature_verification, std::unordered_set<nano::block_hash> const &);
 	bool rollback (nano::write_transaction const &, nano::block_hash const &, std::vector<std::shared_ptr<nano::block>> &);
 	bool rollback (nano::write_transaction const &, nano::block_hash const &);
 	void change_latest (nano::write_transaction const &, nano::account const &, nano::account_info const &, nano::account_info const &);
@@ -50,6 +55,18 @@ public:
 	std::array<nano::block_hash, 2> dependent_blocks (nano::transaction const &, nano::block const &);
 	nano::account const & epoch_signer (nano::link const &) const;
 	nano::link const & epoch_link (nano::epoch) const;
+	/**
+	 * Stores the current representative weights so the next start can load them instead of scanning every account.
+	 * The checkpoint is deleted by the first block processed or rolled back after it, in the same transaction.
+	 */
+	void rep_weights_checkpoint (nano::write_transaction const &);
+	/** Stores the cemented count and epoch 2 flag so the next start doesn't need to scan for them, written in every cementing transaction */
+	void cache_counters_write (nano::write_transaction const &);
+	/**
+	 * Recounts cemented blocks and looks for epoch 2 accounts to check the counters loaded on start, correcting the cache if they diverged.
+	 * Returns true if a correction was made.
+	 */
+	bool cache_counters_validate (std::atomic<bool> const &);
 	static nano::uint128_t const unit;
 	nano::network_params network_params;
 	nano::block_store & store;
@@ -60,6 +77,15 @@ public:
 	uint64_t bootstrap_weight_max_blocks{ 1 };
 	std::atomic<bool> check_bootstrap_weights;
 	std::function<void()> epoch_2_started_cb;
+	std::atomic<bool> rep_weights_checkpointed{ false };
+	bool cache_counters_loaded{ false };
+	/** Time spent generating each part of the cache on construction */
+	std::string cache_timing;
+
+private:
+	bool cache_counters_enabled{ false };
+	bool rep_weights_checkpoint_load (nano::transaction const &, uint64_t, bool &);
+	void rep_weights_checkpoint_invalidate (nano::write_transaction const &);
 };
 
 std::unique_ptr<container_info_component> collect_container_info (ledger & ledger, const std::string & name);
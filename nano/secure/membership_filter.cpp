@@ -0,0 +1,165 @@
+#include <nano/crypto_lib/random_pool.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/secure/membership_filter.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+namespace
+{
+// Finalizer of splitmix64, keys are hashes already but the salt has to be mixed in so positions can't be targeted
+uint64_t mix (uint64_t value_a)
+{
+	value_a = (value_a ^ (value_a >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value_a = (value_a ^ (value_a >> 27)) * 0x94d049bb133111ebULL;
+	return value_a ^ (value_a >> 31);
+}
+}
+
+size_t constexpr nano::membership_filter::bits_per_key;
+unsigned constexpr nano::membership_filter::hash_count;
+size_t constexpr nano::membership_filter::generation::block_words;
+
+nano::membership_filter::generation::generation (size_t capacity_a) :
+capacity (std::max<size_t> (capacity_a, 1)),
+words ((capacity * bits_per_key / (block_words * 64) + 1) * block_words)
+{
+	nano::random_pool::generate_block (reinterpret_cast<unsigned char *> (salt.data ()), sizeof (salt));
+}
+
+void nano::membership_filter::generation::insert (nano::uint256_union const & key_a)
+{
+	auto block (mix (key_a.qwords[0] ^ salt[0]) % (words.size () / block_words) * block_words);
+	auto bits (mix (key_a.qwords[1] ^ salt[1]));
+	uint32_t bit (static_cast<uint32_t> (bits));
+	uint32_t step (static_cast<uint32_t> (bits >> 32) | 1);
+	for (auto i (0u); i < hash_count; ++i, bit += step)
+	{
+		auto position (bit % (block_words * 64));
+		words[block + position / 64].fetch_or (uint64_t{ 1 } << (position % 64), std::memory_order_release);
+	}
+	++inserted;
+}
+
+bool nano::membership_filter::generation::may_contain (nano::uint256_union const & key_a) const
+{
+	auto block (mix (key_a.qwords[0] ^ salt[0]) % (words.size () / block_words) * block_words);
+	auto bits (mix (key_a.qwords[1] ^ salt[1]));
+	uint32_t bit (static_cast<uint32_t> (bits));
+	uint32_t step (static_cast<uint32_t> (bits >> 32) | 1);
+	auto result (true);
+	for (auto i (0u); i < hash_count && result; ++i, bit += step)
+	{
+		auto position (bit % (block_words * 64));
+		result = (words[block + position / 64].load (std::memory_order_acquire) & (uint64_t{ 1 } << (position % 64))) != 0;
+	}
+	return result;
+}
+
+void nano::membership_filter::insert (nano::uint256_union const & key_a)
+{
+	// The generation being rebuilt goes first, if it's swapped in after this then the key is inserted in to it again as the current one
+	if (auto next_l = std::atomic_load (&next))
+	{
+		next_l->insert (key_a);
+	}
+	if (auto current_l = std::atomic_load (&current))
+	{
+		current_l->insert (key_a);
+	}
+}
+
+bool nano::membership_filter::may_contain (nano::uint256_union const & key_a) const
+{
+	auto current_l (std::atomic_load (&current));
+	return current_l == nullptr || current_l->may_contain (key_a);
+}
+
+void nano::membership_filter::rebuild_begin (size_t capacity_a)
+{
+	std::atomic_store (&next, std::make_shared<generation> (capacity_a));
+}
+
+void nano::membership_filter::rebuild_insert (nano::uint256_union const & key_a)
+{
+	auto next_l (std::atomic_load (&next));
+	debug_assert (next_l != nullptr);
+	next_l->insert (key_a);
+}
+
+void nano::membership_filter::rebuild_end ()
+{
+	std::atomic_store (&current, std::atomic_exchange (&next, std::shared_ptr<generation> ()));
+}
+
+void nano::membership_filter::rebuild_abort ()
+{
+	std::atomic_store (&next, std::shared_ptr<generation> ());
+}
+
+bool nano::membership_filter::stale () const
+{
+	auto current_l (std::atomic_load (&current));
+	return current_l == nullptr || current_l->inserted > current_l->capacity;
+}
+
+size_t nano::membership_filter::size () const
+{
+	size_t result (0);
+	if (auto current_l = std::atomic_load (&current))
+	{
+		result += current_l->words.size () * sizeof (uint64_t);
+	}
+	if (auto next_l = std::atomic_load (&next))
+	{
+		result += next_l->words.size () * sizeof (uint64_t);
+	}
+	return result;
+}
+
+/*
+ * Layout, integers are big endian:
+ * capacity (8) | inserted (8) | salt (2 * 8) | words (capacity dependent count * 8)
+ */
+void nano::membership_filter::serialize (nano::stream & stream_a) const
+{
+	auto current_l (std::atomic_load (&current));
+	debug_assert (current_l != nullptr);
+	nano::write (stream_a, boost::endian::native_to_big (static_cast<uint64_t> (current_l->capacity)));
+	nano::write (stream_a, boost::endian::native_to_big (static_cast<uint64_t> (current_l->inserted.load ())));
+	for (auto salt_l : current_l->salt)
+	{
+		nano::write (stream_a, boost::endian::native_to_big (salt_l));
+	}
+	for (auto const & word : current_l->words)
+	{
+		nano::write (stream_a, boost::endian::native_to_big (word.load (std::memory_order_acquire)));
+	}
+}
+
+bool nano::membership_filter::deserialize (nano::stream & stream_a)
+{
+	uint64_t capacity_l;
+	uint64_t inserted_l;
+	auto error (nano::try_read (stream_a, capacity_l) || nano::try_read (stream_a, inserted_l));
+	if (!error)
+	{
+		auto generation_l (std::make_shared<generation> (boost::endian::big_to_native (capacity_l)));
+		generation_l->inserted = boost::endian::big_to_native (inserted_l);
+		for (auto i (generation_l->salt.begin ()), n (generation_l->salt.end ()); i != n && !error; ++i)
+		{
+			error = nano::try_read (stream_a, *i);
+			boost::endian::big_to_native_inplace (*i);
+		}
+		for (auto i (generation_l->words.begin ()), n (generation_l->words.end ()); i != n && !error; ++i)
+		{
+			uint64_t word;
+			error = nano::try_read (stream_a, word);
+			i->store (boost::endian::big_to_native (word), std::memory_order_relaxed);
+		}
+		if (!error)
+		{
+			std::atomic_store (&current, generation_l);
+		}
+	}
+	return error;
+}
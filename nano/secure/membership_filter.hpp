@@ -0,0 +1,61 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+#include <nano/lib/stream.hpp>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace nano
+{
+/**
+ * A blocked bloom filter of 256-bit keys, used in front of store tables to answer lookups of missing keys without touching the database.
+ * Keys are never removed so there are no false negatives, deleted keys are dropped by rebuilding the filter from the table.
+ * A rebuild runs alongside lookups, which use the previous generation until the new one is complete.
+ * @note This class is thread-safe.
+ */
+class membership_filter final
+{
+public:
+	/** Inserts into the current generation and the one being rebuilt, if any */
+	void insert (nano::uint256_union const &);
+	/** Returns false if \p key_a was never inserted, true if it may have been or no generation has been built yet */
+	bool may_contain (nano::uint256_union const &) const;
+	/** Starts a new generation sized for \p capacity_a keys, it receives every insert from here on */
+	void rebuild_begin (size_t capacity_a);
+	/** Inserts into the generation being rebuilt only */
+	void rebuild_insert (nano::uint256_union const &);
+	/** Replaces the current generation with the rebuilt one */
+	void rebuild_end ();
+	void rebuild_abort ();
+	/** True if no generation was built yet or more keys were inserted than the current one was sized for */
+	bool stale () const;
+	size_t size () const;
+	/** Writes the current generation, which must have been built */
+	void serialize (nano::stream &) const;
+	/** Replaces the current generation with one written by serialize, returns true on error */
+	bool deserialize (nano::stream &);
+
+	static size_t constexpr bits_per_key{ 10 };
+	static unsigned constexpr hash_count{ 7 };
+
+private:
+	class generation final
+	{
+	public:
+		explicit generation (size_t capacity_a);
+		void insert (nano::uint256_union const &);
+		bool may_contain (nano::uint256_union const &) const;
+		size_t const capacity;
+		std::atomic<size_t> inserted{ 0 };
+		// Each key sets bits in a single cache line sized block
+		static size_t constexpr block_words{ 8 };
+		std::vector<std::atomic<uint64_t>> words;
+		std::array<uint64_t, 2> salt;
+	};
+	std::shared_ptr<generation> current;
+	std::shared_ptr<generation> next;
+};
+}
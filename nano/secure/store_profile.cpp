@@ -0,0 +1,211 @@
+#include <nano/lib/utility.hpp>
+#include <nano/secure/blockstore.hpp>
+#include <nano/secure/store_profile.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <array>
+
+size_t constexpr nano::store_profile::bucket_count;
+size_t constexpr nano::store_profile::shard_count;
+
+namespace
+{
+size_t constexpr table_count{ static_cast<size_t> (nano::tables::vote) + 1 };
+size_t constexpr operation_count{ static_cast<size_t> (nano::store_profile::operation::next) + 1 };
+std::atomic<size_t> next_shard{ 0 };
+thread_local size_t const shard{ next_shard++ % nano::store_profile::shard_count };
+
+size_t bucket (std::chrono::steady_clock::duration duration_a)
+{
+	auto microseconds (static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::microseconds> (duration_a).count ()));
+	size_t result (0);
+	while (microseconds > 0 && result < nano::store_profile::bucket_count - 1)
+	{
+		microseconds >>= 1;
+		++result;
+	}
+	return result;
+}
+}
+
+nano::store_profile::store_profile () :
+counters_m (shard_count * table_count * operation_count)
+{
+}
+
+void nano::store_profile::enable (bool enabled_a)
+{
+	enabled_m = enabled_a;
+}
+
+bool nano::store_profile::enabled () const
+{
+	return enabled_m;
+}
+
+void nano::store_profile::record_impl (nano::tables table_a, nano::store_profile::operation operation_a, std::chrono::steady_clock::duration duration_a, size_t bytes_a, size_t count_a)
+{
+	debug_assert (static_cast<size_t> (table_a) < table_count);
+	auto & counters (counters_m[(shard * table_count + static_cast<size_t> (table_a)) * operation_count + static_cast<size_t> (operation_a)]);
+	// Threads can share a shard so adds are atomic, relaxed ordering is enough as the counters are only summed
+	counters.count.fetch_add (count_a, std::memory_order_relaxed);
+	counters.bytes.fetch_add (bytes_a, std::memory_order_relaxed);
+	counters.nanoseconds.fetch_add (std::chrono::duration_cast<std::chrono::nanoseconds> (duration_a).count (), std::memory_order_relaxed);
+	// Batched operations are bucketed by their average latency
+	counters.buckets[bucket (duration_a / std::max<size_t> (count_a, 1))].fetch_add (count_a, std::memory_order_relaxed);
+}
+
+void nano::store_profile::serialize (boost::property_tree::ptree & json_a) const
+{
+	json_a.put ("enabled", enabled ());
+	boost::property_tree::ptree tables_l;
+	for (size_t table (0); table < table_count; ++table)
+	{
+		boost::property_tree::ptree operations_l;
+		for (size_t operation (0); operation < operation_count; ++operation)
+		{
+			uint64_t count (0);
+			uint64_t bytes (0);
+			uint64_t nanoseconds (0);
+			std::array<uint64_t, bucket_count> buckets{};
+			for (size_t shard_l (0); shard_l < shard_count; ++shard_l)
+			{
+				auto & counters (counters_m[(shard_l * table_count + table) * operation_count + operation]);
+				count += counters.count.load (std::memory_order_relaxed);
+				bytes += counters.bytes.load (std::memory_order_relaxed);
+				nanoseconds += counters.nanoseconds.load (std::memory_order_relaxed);
+				for (size_t i (0); i < bucket_count; ++i)
+				{
+					buckets[i] += counters.buckets[i].load (std::memory_order_relaxed);
+				}
+			}
+			if (count > 0)
+			{
+				boost::property_tree::ptree operation_l;
+				operation_l.put ("count", count);
+				operation_l.put ("bytes", bytes);
+				operation_l.put ("total_microseconds", nanoseconds / 1000);
+				operation_l.put ("average_nanoseconds", nanoseconds / count);
+				// Keyed by the upper bound of each bucket in microseconds
+				boost::property_tree::ptree histogram_l;
+				for (size_t i (0); i < bucket_count; ++i)
+				{
+					if (buckets[i] > 0)
+					{
+						histogram_l.put (i < bucket_count - 1 ? std::to_string (1ULL << i) : std::string ("max"), buckets[i]);
+					}
+				}
+				operation_l.add_child ("latency_histogram", histogram_l);
+				operations_l.add_child (operation_name (static_cast<nano::store_profile::operation> (operation)), operation_l);
+			}
+		}
+		if (!operations_l.empty ())
+		{
+			tables_l.add_child (table_name (static_cast<nano::tables> (table)), operations_l);
+		}
+	}
+	json_a.add_child ("tables", tables_l);
+}
+
+void nano::store_profile::clear ()
+{
+	for (auto & counters : counters_m)
+	{
+		counters.count = 0;
+		counters.bytes = 0;
+		counters.nanoseconds = 0;
+		for (auto & bucket_l : counters.buckets)
+		{
+			bucket_l = 0;
+		}
+	}
+}
+
+std::string nano::store_profile::table_name (nano::tables table_a)
+{
+	std::string result;
+	switch (table_a)
+	{
+		case nano::tables::accounts:
+			result = "accounts";
+			break;
+		case nano::tables::block_summaries:
+			result = "block_summaries";
+			break;
+		case nano::tables::blocks_info:
+			result = "blocks_info";
+			break;
+		case nano::tables::cached_counts:
+			result = "cached_counts";
+			break;
+		case nano::tables::change_blocks:
+			result = "change_blocks";
+			break;
+		case nano::tables::confirmation_height:
+			result = "confirmation_height";
+			break;
+		case nano::tables::frontiers:
+			result = "frontiers";
+			break;
+		case nano::tables::meta:
+			result = "meta";
+			break;
+		case nano::tables::online_weight:
+			result = "online_weight";
+			break;
+		case nano::tables::open_blocks:
+			result = "open_blocks";
+			break;
+		case nano::tables::peers:
+			result = "peers";
+			break;
+		case nano::tables::pending:
+			result = "pending";
+			break;
+		case nano::tables::receive_blocks:
+			result = "receive_blocks";
+			break;
+		case nano::tables::representation:
+			result = "representation";
+			break;
+		case nano::tables::send_blocks:
+			result = "send_blocks";
+			break;
+		case nano::tables::state_blocks:
+			result = "state_blocks";
+			break;
+		case nano::tables::unchecked:
+			result = "unchecked";
+			break;
+		case nano::tables::vote:
+			result = "vote";
+			break;
+	}
+	return result;
+}
+
+std::string nano::store_profile::operation_name (nano::store_profile::operation operation_a)
+{
+	std::string result;
+	switch (operation_a)
+	{
+		case nano::store_profile::operation::get:
+			result = "get";
+			break;
+		case nano::store_profile::operation::put:
+			result = "put";
+			break;
+		case nano::store_profile::operation::del:
+			result = "del";
+			break;
+		case nano::store_profile::operation::iterate:
+			result = "iterate";
+			break;
+		case nano::store_profile::operation::next:
+			result = "next";
+			break;
+	}
+	return result;
+}
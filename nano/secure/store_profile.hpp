@@ -0,0 +1,68 @@
+#pragma once
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace nano
+{
+enum class tables;
+/**
+ * Counts store operations per table with their latency and the number of bytes read or written. Each thread adds to one of a fixed
+ * number of shards picked when it first records, so recording threads rarely share counters. Shards are summed when reporting.
+ */
+class store_profile final
+{
+public:
+	enum class operation
+	{
+		get,
+		put,
+		del,
+		/** Positioning a new iterator, bytes are those of the first entry */
+		iterate,
+		/** Stepping an iterator, bytes are those of the entry it lands on */
+		next
+	};
+	store_profile ();
+	/** Returns the start time of an operation, which is empty when profiling is disabled */
+	std::chrono::steady_clock::time_point start () const
+	{
+		return enabled_m.load (std::memory_order_relaxed) ? std::chrono::steady_clock::now () : std::chrono::steady_clock::time_point{};
+	}
+	/** Records \p count operations which began at \p start_a, nothing is recorded if profiling was disabled when they began */
+	void record (nano::tables table_a, nano::store_profile::operation operation_a, std::chrono::steady_clock::time_point start_a, size_t bytes_a, size_t count_a = 1)
+	{
+		if (start_a != std::chrono::steady_clock::time_point{})
+		{
+			record_impl (table_a, operation_a, std::chrono::steady_clock::now () - start_a, bytes_a, count_a);
+		}
+	}
+	void enable (bool enabled_a);
+	bool enabled () const;
+	void serialize (boost::property_tree::ptree &) const;
+	void clear ();
+	static std::string table_name (nano::tables);
+	static std::string operation_name (nano::store_profile::operation);
+	/** Latencies are grouped by powers of two of microseconds, the last bucket holds every slower operation */
+	static size_t constexpr bucket_count{ 16 };
+	static size_t constexpr shard_count{ 16 };
+
+private:
+	class counters final
+	{
+	public:
+		std::atomic<uint64_t> count{ 0 };
+		std::atomic<uint64_t> bytes{ 0 };
+		std::atomic<uint64_t> nanoseconds{ 0 };
+		std::atomic<uint64_t> buckets[bucket_count]{};
+	};
+	void record_impl (nano::tables, nano::store_profile::operation, std::chrono::steady_clock::duration, size_t, size_t);
+	/** Shard major, then table, then operation */
+	std::vector<counters> counters_m;
+	std::atomic<bool> enabled_m{ false };
+};
+}
@@ -10,6 +10,13 @@
 
 #include <boost/format.hpp>
 
+#if NANO_ROCKSDB
+#include <nano/node/rocksdb/rocksdb.hpp>
+
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
+#endif
+
 #include <numeric>
 #include <random>
 
@@ -410,6 +417,116 @@ TEST (store, unchecked_load)
 	ASSERT_EQ (num_unchecked, node.store.unchecked_count (transaction));
 }
 
+#if NANO_ROCKSDB
+namespace
+{
+/** Average number of blocks RocksDB reads from disk for each lookup of an account and of a pending entry, present or missing */
+double rocksdb_read_amplification (nano::rocksdb_config const & config_a)
+{
+	nano::logger_mt logger;
+	auto path (nano::unique_path ());
+	constexpr auto count = 200000;
+	std::vector<nano::account> accounts (count);
+	for (auto & account : accounts)
+	{
+		nano::random_pool::generate_block (account.bytes.data (), account.bytes.size ());
+	}
+	{
+		nano::rocksdb_store store (logger, path, config_a);
+		EXPECT_FALSE (store.init_error ());
+		for (auto i (0); i < count; i += 10000)
+		{
+			auto transaction (store.tx_begin_write ());
+			for (auto j (i); j < i + 10000; ++j)
+			{
+				store.account_put (transaction, accounts[j], nano::account_info (accounts[j], accounts[j], accounts[j], j, 0, 1, nano::epoch::epoch_0));
+				store.pending_put (transaction, nano::pending_key (accounts[j], accounts[j]), nano::pending_info (accounts[j], j, nano::epoch::epoch_0));
+			}
+		}
+	}
+	// Reopening flushes the memtables and starts with empty block caches
+	nano::rocksdb_store store (logger, path, config_a);
+	EXPECT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+	rocksdb::SetPerfLevel (rocksdb::PerfLevel::kEnableCount);
+	rocksdb::get_perf_context ()->Reset ();
+	constexpr auto lookups = 10000;
+	for (auto i (0); i < lookups; ++i)
+	{
+		nano::account missing;
+		nano::random_pool::generate_block (missing.bytes.data (), missing.bytes.size ());
+		nano::account_info account_info;
+		nano::pending_info pending_info;
+		EXPECT_FALSE (store.account_get (transaction, accounts[i], account_info));
+		EXPECT_TRUE (store.account_get (transaction, missing, account_info));
+		EXPECT_FALSE (store.pending_get (transaction, nano::pending_key (accounts[i], accounts[i]), pending_info));
+		EXPECT_TRUE (store.pending_get (transaction, nano::pending_key (missing, missing), pending_info));
+	}
+	auto result (static_cast<double> (rocksdb::get_perf_context ()->block_read_count) / (4 * lookups));
+	rocksdb::SetPerfLevel (rocksdb::PerfLevel::kDisable);
+	return result;
+}
+}
+
+// Compares disk reads with the table profiles against the same options for every table, both use the same number of bloom filter bits
+TEST (store, rocksdb_profiles_read_amplification)
+{
+	nano::rocksdb_config uniform;
+	uniform.enable = true;
+	uniform.memtable_size = 1;
+	uniform.total_memtable_size = 0;
+	uniform.bloom_filter_bits = nano::rocksdb_config{}.point_lookup_bloom_filter_bits;
+	uniform.point_lookup_bloom_filter_bits = uniform.bloom_filter_bits;
+	uniform.point_lookup_hash_index = false;
+	uniform.pending_prefix_bloom_filter_bits = uniform.bloom_filter_bits;
+	auto profiled (uniform);
+	profiled.point_lookup_hash_index = true;
+	// FIFO compaction only applies to the online weight table, reads of other tables are unchanged
+	auto fifo (profiled);
+	fifo.fifo_max_size = 1;
+	auto uniform_reads (rocksdb_read_amplification (uniform));
+	auto profiled_reads (rocksdb_read_amplification (profiled));
+	auto fifo_reads (rocksdb_read_amplification (fifo));
+	std::cout << boost::str (boost::format ("Blocks read per lookup, uniform: %1% profiled: %2% fifo: %3%") % uniform_reads % profiled_reads % fifo_reads) << std::endl;
+	ASSERT_LE (profiled_reads, uniform_reads);
+	ASSERT_LE (fifo_reads, uniform_reads);
+}
+
+// Only the online weight table drops its oldest files, counted tables such as unchecked keep every entry
+TEST (store, rocksdb_fifo_profile)
+{
+	nano::logger_mt logger;
+	auto path (nano::unique_path ());
+	nano::rocksdb_config config;
+	config.enable = true;
+	config.memtable_size = 1;
+	config.total_memtable_size = 0;
+	config.fifo_max_size = 1;
+	auto block (std::make_shared<nano::send_block> (0, 0, 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	constexpr auto count = 200000;
+	{
+		nano::rocksdb_store store (logger, path, config);
+		ASSERT_FALSE (store.init_error ());
+		for (auto i (0); i < count; i += 10000)
+		{
+			auto transaction (store.tx_begin_write ());
+			for (auto j (i); j < i + 10000; ++j)
+			{
+				nano::amount weight;
+				nano::random_pool::generate_block (weight.bytes.data (), weight.bytes.size ());
+				store.online_weight_put (transaction, j, weight);
+				store.unchecked_put (transaction, j, block);
+			}
+		}
+	}
+	nano::rocksdb_store store (logger, path, config);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+	ASSERT_LT (store.online_weight_count (transaction), count);
+	ASSERT_EQ (count, store.unchecked_count (transaction));
+}
+#endif
+
 TEST (store, vote_load)
 {
 	nano::system system (1);